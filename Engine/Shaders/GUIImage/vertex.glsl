@@ -5,6 +5,7 @@ uniform mat4 orthogonalProjectionMatrix;
 
 layout (location = 2) in vec4 position;
 layout (location = 3) in vec2 textureCoordinate;
+layout (location = 4) in vec4 vertexColor;//batched images carry alpha here, single images get the default (0,0,0,1)
 
 out vec2 vs_fs_textureCoord;
 out float externalAlpha;
@@ -13,5 +14,5 @@ void main(void)
 {
     vs_fs_textureCoord = textureCoordinate;
     gl_Position = orthogonalProjectionMatrix * (worldTransformMatrix * position);
-    externalAlpha = 1.0 - worldTransformMatrix[3][2];
+    externalAlpha = (1.0 - worldTransformMatrix[3][2]) * vertexColor.a;
 }
@@ -2,17 +2,20 @@
 
 uniform mat4 worldTransformMatrix;
 uniform mat4 orthogonalProjectionMatrix;
-uniform vec3 inColor;
 
 layout (location = 2) in vec4 position;
 layout (location = 3) in vec2 textureCoordinate;
+layout (location = 4) in vec4 vertexColor;
 
 out vec2 vs_fs_textureCoord;
+out vec3 vs_fs_color;
 out float externalAlpha;
 
 void main(void)
 {
     vs_fs_textureCoord = textureCoordinate;
+    vs_fs_color = vertexColor.rgb;
     gl_Position = orthogonalProjectionMatrix * (worldTransformMatrix * position);
-    externalAlpha = 1.0 - worldTransformMatrix[3][2];
+    //single texts keep alpha in translate z, batched texts in vertex color
+    externalAlpha = (1.0 - worldTransformMatrix[3][2]) * vertexColor.a;
 }
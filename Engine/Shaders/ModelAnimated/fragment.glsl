@@ -162,6 +162,8 @@ vec3 calcViewSpacePos(vec3 screen) {
     return camera_space;
 }
 
+#import "../clusteredLights.glsl"
+
 void main(void) {
         vec4 objectColor;
         if((material.isMap & 0x0004)!=0) {
@@ -221,6 +223,10 @@ void main(void) {
                 ambientColor += LightSources.lights[i].ambient;
             }
         }
+        vec3 clusteredAmbient;
+        vec3 clusteredLighting = calculateClusteredLights(normal, clusteredAmbient);
+        lightingColorFactor += clusteredLighting + clusteredAmbient;
+        ambientColor += clusteredAmbient;
         diffuseAndSpecularLightedColor = vec4(
         min(lightingColorFactor.x, 1.0),
         min(lightingColorFactor.y, 1.0),
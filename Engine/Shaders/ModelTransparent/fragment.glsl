@@ -161,6 +161,8 @@ vec3 calcViewSpacePos(vec3 screen) {
     return camera_space;
 }
 
+#import "../clusteredLights.glsl"
+
 void main(void) {
         vec4 objectColor;
         if((material.isMap & 0x0004)!=0) {
@@ -228,6 +230,9 @@ void main(void) {
                 lightingColorFactor += ((1.0 - shadow) * (diffuseRate + specularRate) * LightSources.lights[i].color) + LightSources.lights[i].ambient;
             }
         }
+        vec3 clusteredAmbient;
+        vec3 clusteredLighting = calculateClusteredLights(normal, clusteredAmbient);
+        lightingColorFactor += clusteredLighting + clusteredAmbient;
         outputColor = vec4(
         min(lightingColorFactor.x, 1.0),
         min(lightingColorFactor.y, 1.0),
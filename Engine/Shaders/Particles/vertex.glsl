@@ -23,6 +23,8 @@ out VS_FS {
 
 uniform sampler2D positions;
 uniform float size;
+uniform int newestParticle;//positions is a ring buffer, instances are rendered from newest to oldest
+uniform int particleCapacity;
 
 vec4 unpackFloat(float value) {
     uint rgba = floatBitsToUint(value);
@@ -35,7 +37,11 @@ vec4 unpackFloat(float value) {
 
 void main(){
     to_fs.textureCoordinates = textureCoordinates;
-    vec4 worldPosition = texelFetch(positions, ivec2(gl_InstanceID, 0), 0);
+    int particleIndex = newestParticle - gl_InstanceID;
+    if(particleIndex < 0) {
+        particleIndex += particleCapacity;
+    }
+    vec4 worldPosition = texelFetch(positions, ivec2(particleIndex, 0), 0);
     to_fs.colorMultiplier = unpackFloat(worldPosition.w);
     worldPosition.w = 1.0;
     vec4 cameraCenterPosition = playerTransforms.cameraProjection * worldPosition;
@@ -0,0 +1,70 @@
+// Clustered point lights, shared by the Model, ModelAnimated and ModelTransparent fragment shaders.
+// Must be imported after playerTransforms, material, from_vs and specularSampler are declared.
+// Cluster sizes must match the definitions in GraphicsInterface.h.
+
+#define NR_MAX_CLUSTERED_LIGHTS 192
+#define LIGHT_CLUSTER_X 16
+#define LIGHT_CLUSTER_Y 9
+#define LIGHT_CLUSTER_Z 24
+#define LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH 1024
+
+struct ClusteredLight {
+    vec4 positionAndRadius;
+    vec4 color;
+    vec4 attenuation;
+    vec4 ambient;
+};
+
+layout (std140) uniform ClusteredLightBlock
+{
+    vec4 depthParameters; //slice = log(viewDepth) * x + y
+    ClusteredLight lights[NR_MAX_CLUSTERED_LIGHTS];
+} clusteredLights;
+
+uniform usampler2D lightClusters;       //offset and count in lightClusterIndices, per cluster
+uniform usampler2D lightClusterIndices;
+
+// Point lights without shadows. Only the lights assigned to the cluster of the fragment are processed.
+// Unlike the light slots, ambient of these lights are only applied in their radius.
+vec3 calculateClusteredLights(vec3 normal, out vec3 clusteredAmbient) {
+    vec4 viewSpacePosition = playerTransforms.camera * vec4(from_vs.fragPos, 1.0);
+    vec4 clipSpacePosition = playerTransforms.projection * viewSpacePosition;
+    vec2 screenPosition = (clipSpacePosition.xy / clipSpacePosition.w) * 0.5 + 0.5;
+    int clusterX = clamp(int(screenPosition.x * float(LIGHT_CLUSTER_X)), 0, LIGHT_CLUSTER_X - 1);
+    int clusterY = clamp(int(screenPosition.y * float(LIGHT_CLUSTER_Y)), 0, LIGHT_CLUSTER_Y - 1);
+    float slice = log(max(-viewSpacePosition.z, 0.0001)) * clusteredLights.depthParameters.x + clusteredLights.depthParameters.y;
+    int clusterZ = clamp(int(floor(slice)), 0, LIGHT_CLUSTER_Z - 1);
+    uvec2 clusterRange = texelFetch(lightClusters, ivec2(clusterX + clusterY * LIGHT_CLUSTER_X, clusterZ), 0).rg;
+
+    vec3 lightingColor = vec3(0.0);
+    clusteredAmbient = vec3(0.0);
+    if(clusterRange.y == 0u) {
+        return lightingColor;
+    }
+    vec3 viewDirectory = normalize(playerTransforms.position - from_vs.fragPos);
+    vec3 specularColor = vec3(texture(specularSampler, from_vs.textureCoord));
+    float specularAverage = (specularColor.x + specularColor.y + specularColor.z) / 3;
+    for(uint i = 0u; i < clusterRange.y; ++i) {
+        highp int indexPosition = int(clusterRange.x + i);
+        uint lightIndex = texelFetch(lightClusterIndices, ivec2(indexPosition % LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, indexPosition / LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH), 0).r;
+        vec3 fragToLight = clusteredLights.lights[lightIndex].positionAndRadius.xyz - from_vs.fragPos;
+        float fragDistance = length(fragToLight);
+        if(fragDistance >= clusteredLights.lights[lightIndex].positionAndRadius.w) {
+            continue;
+        }
+        vec3 lightDirectory = fragToLight / fragDistance;
+        float diffuseRate = max(dot(normal, lightDirectory), 0.0);
+        float specularRate = max(dot(viewDirectory, reflect(-lightDirectory, normal)), 0.0);
+        if(specularRate != 0 && material.shininess != 0) {
+            specularRate = pow(specularRate, material.shininess) * specularAverage;
+        } else {
+            specularRate = 0;
+        }
+        vec3 lightAttenuation = clusteredLights.lights[lightIndex].attenuation.xyz;
+        float attenuation = 1.0 / (lightAttenuation.x + (lightAttenuation.y * fragDistance) + (lightAttenuation.z * fragDistance * fragDistance));
+        attenuation = clamp(attenuation, 0.0, 1.0);
+        lightingColor += attenuation * (diffuseRate + specularRate) * clusteredLights.lights[lightIndex].color.rgb;
+        clusteredAmbient += clusteredLights.lights[lightIndex].ambient.rgb;
+    }
+    return lightingColor;
+}
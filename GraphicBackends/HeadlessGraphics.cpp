@@ -0,0 +1,408 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <sstream>
+#include <algorithm>
+#include <initializer_list>
+#include <iostream>
+#include "HeadlessGraphics.h"
+
+std::shared_ptr<GraphicsInterface> createGraphicsBackend(OptionsUtil::Options* options) {
+    return std::make_shared<HeadlessGraphics>(options);
+}
+
+HeadlessGraphics::HeadlessGraphics(OptionsUtil::Options *options) : GraphicsInterface(options), options(options) {
+    boundTextures.resize(MAX_TEXTURE_IMAGE_UNITS, 0);
+}
+
+GraphicsInterface::ContextInformation HeadlessGraphics::getContextInformation() {
+    GraphicsInterface::ContextInformation contextInformation;
+    contextInformation.shaderHeader = "#version 330";//same with OpenGL backend, so shaders are preprocessed the same way
+    return contextInformation;
+}
+
+bool HeadlessGraphics::createGraphicsBackend() {
+    std::cout << "Headless graphics backend created, nothing will be rendered." << std::endl;
+    reshape();
+    return true;
+}
+
+void HeadlessGraphics::reshape() {
+    float aspect = float(options->getScreenHeight()) / float(options->getScreenWidth());
+    perspectiveProjectionMatrix = glm::perspective(options->PI/3.0f, 1.0f / aspect, 0.01f, 10000.0f);
+    orthogonalProjectionMatrix = glm::ortho(0.0f, (float) options->getScreenWidth(), 0.0f, (float) options->getScreenHeight());
+}
+
+void HeadlessGraphics::clearFrame() {
+    frameStatistics = FrameStatistics();
+    record(CommandTypes::CLEAR_FRAME);
+}
+
+void HeadlessGraphics::bindTexture(unsigned int textureID, unsigned int attachPoint) {
+    if(attachPoint >= boundTextures.size()) {
+        std::cerr << "Texture attach point " << attachPoint << " is over the maximum " << boundTextures.size() << std::endl;
+        return;
+    }
+    if(boundTextures[attachPoint] != textureID) {
+        boundTextures[attachPoint] = textureID;
+        frameStatistics.textureBinds++;
+        record(CommandTypes::TEXTURE_BIND, attachPoint);
+    }
+}
+
+uint32_t HeadlessGraphics::createTexture(int height [[gnu::unused]], int width [[gnu::unused]], TextureTypes type [[gnu::unused]],
+                                         InternalFormatTypes internalFormat [[gnu::unused]], FormatTypes format [[gnu::unused]],
+                                         DataTypes dataType [[gnu::unused]], uint32_t textureLayers [[gnu::unused]]) {
+    return generateID();
+}
+
+bool HeadlessGraphics::deleteTexture(uint32_t textureID) {
+    for (uint32_t &boundTexture : boundTextures) {
+        if(boundTexture == textureID) {
+            boundTexture = 0;
+        }
+    }
+    return true;
+}
+
+void HeadlessGraphics::loadTextureData(uint32_t textureID [[gnu::unused]], int height, int width, TextureTypes type [[gnu::unused]],
+                                       InternalFormatTypes internalFormat [[gnu::unused]], FormatTypes format, DataTypes dataType, uint32_t depth,
+                                       void *data, void *data2, void *data3, void *data4, void *data5, void *data6) {
+    uint64_t channelCount;
+    switch (format) {
+        case FormatTypes::RED:   channelCount = 1; break;
+        case FormatTypes::RGB:   channelCount = 3; break;
+        case FormatTypes::RGBA:  channelCount = 4; break;
+        case FormatTypes::DEPTH: channelCount = 1; break;
+        default: channelCount = 4;
+    }
+    uint64_t channelSize;
+    switch (dataType) {
+        case DataTypes::UNSIGNED_BYTE:  channelSize = 1; break;
+        case DataTypes::HALF_FLOAT:     channelSize = 2; break;
+        case DataTypes::UNSIGNED_SHORT: channelSize = 2; break;
+        default: channelSize = 4;
+    }
+    //cube maps pass each face separately, null data only allocates
+    uint64_t uploadCount = 0;
+    for (void* faceData : {data, data2, data3, data4, data5, data6}) {
+        if(faceData != nullptr) {
+            uploadCount++;
+        }
+    }
+    uint64_t byteCount = (uint64_t)height * (uint64_t)width * std::max<uint64_t>(depth, 1) * channelCount * channelSize * uploadCount;
+    frameStatistics.textureBytesUploaded += byteCount;
+    record(CommandTypes::TEXTURE_UPLOAD, byteCount);
+}
+
+uint32_t HeadlessGraphics::createGraphicsProgram(const std::string &vertexShaderContent, const std::string &geometryShaderContent,
+                                                 const std::string &fragmentShaderContent) {
+    uint32_t programID = generateID();
+    ProgramReflection& reflection = programs[programID];
+    reflectShader(vertexShaderContent, true, false, reflection);
+    reflectShader(geometryShaderContent, false, false, reflection);
+    reflectShader(fragmentShaderContent, false, true, reflection);
+    if(reflection.outputs.find("Depth") == reflection.outputs.end()) {
+        //OpenGL backend assumes depth is always written, keep the same
+        reflection.outputs["Depth"] = std::make_pair(Uniform::VariableTypes::TEXTURE_2D, FrameBufferAttachPoints::DEPTH);
+    }
+    return programID;
+}
+
+/**
+ * Reflection by parsing declarations, line by line. It only understands simple declarations like
+ *      uniform [precision] type name[size];
+ *      layout (location = n) in/out type name;
+ * Uniform blocks and structs are skipped, they are attached by the backend, not through uniform maps.
+ */
+void HeadlessGraphics::reflectShader(const std::string &shaderContent, bool isVertexShader, bool isFragmentShader, ProgramReflection &reflection) {
+    static const std::unordered_map<std::string, Uniform::VariableTypes> typeNames = {
+            {"bool", Uniform::VariableTypes::BOOL},
+            {"int", Uniform::VariableTypes::INT},
+            {"float", Uniform::VariableTypes::FLOAT},
+            {"vec2", Uniform::VariableTypes::FLOAT_VEC2},
+            {"vec3", Uniform::VariableTypes::FLOAT_VEC3},
+            {"vec4", Uniform::VariableTypes::FLOAT_VEC4},
+            {"mat4", Uniform::VariableTypes::FLOAT_MAT4},
+            {"samplerCube", Uniform::VariableTypes::CUBEMAP},
+            {"samplerCubeArray", Uniform::VariableTypes::CUBEMAP_ARRAY},
+            {"samplerCubeArrayShadow", Uniform::VariableTypes::CUBEMAP_ARRAY},
+            {"sampler2D", Uniform::VariableTypes::TEXTURE_2D},
+            {"sampler2DShadow", Uniform::VariableTypes::TEXTURE_2D},
+            {"sampler2DArray", Uniform::VariableTypes::TEXTURE_2D_ARRAY},
+            {"sampler2DArrayShadow", Uniform::VariableTypes::TEXTURE_2D_ARRAY}
+    };
+
+    std::istringstream contentStream(shaderContent);
+    std::string line;
+    while (std::getline(contentStream, line)) {
+        size_t commentStart = line.find("//");
+        if(commentStart != std::string::npos) {
+            line = line.substr(0, commentStart);
+        }
+        if(line.find('{') != std::string::npos || (line.find('(') != std::string::npos && line.find("layout") == std::string::npos)) {
+            continue;//blocks and functions
+        }
+        int32_t location = -1;
+        size_t layoutEnd = line.find(')');
+        if(line.find("layout") != std::string::npos && layoutEnd != std::string::npos) {
+            size_t locationStart = line.find("location");
+            if(locationStart != std::string::npos && locationStart < layoutEnd) {
+                size_t equalsPosition = line.find('=', locationStart);
+                if(equalsPosition != std::string::npos && equalsPosition < layoutEnd) {
+                    location = std::atoi(line.c_str() + equalsPosition + 1);
+                }
+            }
+            line = line.substr(layoutEnd + 1);
+        }
+        for (char &character : line) {
+            if(character == ';' || character == '\t' || character == '\r') {
+                character = ' ';
+            }
+        }
+        std::istringstream lineStream(line);
+        std::string qualifier, typeName, name;
+        lineStream >> qualifier;
+        if(qualifier != "uniform" && qualifier != "in" && qualifier != "out") {
+            continue;
+        }
+        lineStream >> typeName;
+        while (typeName == "lowp" || typeName == "mediump" || typeName == "highp" || typeName == "flat" || typeName == "smooth") {
+            lineStream >> typeName;
+        }
+        lineStream >> name;
+        if(name.empty()) {
+            continue;
+        }
+        uint32_t size = 1;
+        size_t arrayStart = name.find('[');
+        if(arrayStart != std::string::npos) {
+            size = std::max(1, std::atoi(name.c_str() + arrayStart + 1));
+            name = name.substr(0, arrayStart) + "[0]";//GL reports arrays with first element
+        }
+        auto typeIt = typeNames.find(typeName);
+        Uniform::VariableTypes variableType = typeIt == typeNames.end() ? Uniform::VariableTypes::UNDEFINED : typeIt->second;
+        if(qualifier == "uniform") {
+            if(reflection.uniforms.find(name) == reflection.uniforms.end()) {
+                uint32_t uniformLocation = (uint32_t)reflection.uniforms.size();
+                reflection.uniforms[name] = std::make_shared<Uniform>(uniformLocation, name, variableType, size);
+            }
+        } else if(qualifier == "in" && isVertexShader) {
+            reflection.attributes[name] = location < 0 ? (uint32_t)reflection.attributes.size() : (uint32_t)location;
+        } else if(qualifier == "out" && isFragmentShader) {
+            FrameBufferAttachPoints attachPoint;
+            switch (location < 0 ? 0 : location) {
+                case 0:     attachPoint=FrameBufferAttachPoints::COLOR0;  break;
+                case 1:     attachPoint=FrameBufferAttachPoints::COLOR1;  break;
+                case 2:     attachPoint=FrameBufferAttachPoints::COLOR2;  break;
+                case 3:     attachPoint=FrameBufferAttachPoints::COLOR3;  break;
+                case 4:     attachPoint=FrameBufferAttachPoints::COLOR4;  break;
+                case 5:     attachPoint=FrameBufferAttachPoints::COLOR5;  break;
+                case 6:     attachPoint=FrameBufferAttachPoints::COLOR6;  break;
+                default:    attachPoint=FrameBufferAttachPoints::NONE;
+            }
+            //outputs are sampled as textures later, same mapping as OpenGL backend
+            Uniform::VariableTypes outputType = variableType == Uniform::VariableTypes::UNDEFINED || variableType == Uniform::VariableTypes::FLOAT_MAT4 ?
+                                                Uniform::VariableTypes::UNDEFINED : Uniform::VariableTypes::TEXTURE_2D;
+            reflection.outputs[name] = std::make_pair(outputType, attachPoint);
+        }
+    }
+    if(isFragmentShader && shaderContent.find("gl_FragDepth") != std::string::npos) {
+        reflection.outputs["Depth"] = std::make_pair(Uniform::VariableTypes::TEXTURE_2D, FrameBufferAttachPoints::DEPTH);
+    }
+}
+
+void HeadlessGraphics::initializeProgramAsset(const uint32_t programId, std::unordered_map<std::string, std::shared_ptr<Uniform>> &uniformMap,
+                                              std::unordered_map<std::string, uint32_t> &attributesMap,
+                                              std::unordered_map<std::string, std::pair<Uniform::VariableTypes, FrameBufferAttachPoints>> &outputMap) {
+    auto programIt = programs.find(programId);
+    if(programIt == programs.end()) {
+        std::cerr << "Program " << programId << " is not known by headless backend, can't initialize." << std::endl;
+        return;
+    }
+    uniformMap = programIt->second.uniforms;
+    attributesMap = programIt->second.attributes;
+    outputMap = programIt->second.outputs;
+}
+
+bool HeadlessGraphics::getUniformLocation(const uint32_t programID, const std::string &uniformName, uint32_t &location) {
+    auto programIt = programs.find(programID);
+    if(programIt == programs.end()) {
+        return false;
+    }
+    auto uniformIt = programIt->second.uniforms.find(uniformName);
+    if(uniformIt == programIt->second.uniforms.end()) {
+        std::cerr << "No error found, but uniform[" << uniformName << "] can not be located " << std::endl;
+        return false;
+    }
+    location = uniformIt->second->location;
+    return true;
+}
+
+void HeadlessGraphics::recordBufferUpload(uint32_t &vao, uint32_t &vbo, uint64_t byteCount, bool createBuffer) {
+    if(createBuffer) {
+        if(vao == 0) {
+            vao = generateID();
+        }
+        vbo = generateID();
+    }
+    bufferSizes[vbo] = byteCount;
+    frameStatistics.bufferBytesUploaded += byteCount;
+    record(CommandTypes::BUFFER_UPLOAD, byteCount);
+}
+
+void HeadlessGraphics::bufferVertexData(const std::vector<glm::vec3> &vertices, const std::vector<glm::mediump_uvec3> &faces,
+                                        uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer [[gnu::unused]], uint32_t &ebo) {
+    recordBufferUpload(vao, vbo, vertices.size() * sizeof(glm::vec3), true);
+    uint32_t unusedVAO = vao;
+    recordBufferUpload(unusedVAO, ebo, faces.size() * sizeof(glm::mediump_uvec3), true);
+}
+
+void HeadlessGraphics::bufferNormalData(const std::vector<glm::vec3> &normals, uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer [[gnu::unused]]) {
+    recordBufferUpload(vao, vbo, normals.size() * sizeof(glm::vec3), true);
+}
+
+void HeadlessGraphics::bufferExtraVertexData(const std::vector<glm::vec4> &extraData, uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer [[gnu::unused]]) {
+    recordBufferUpload(vao, vbo, extraData.size() * sizeof(glm::vec4), true);
+}
+
+void HeadlessGraphics::bufferExtraVertexData(const std::vector<glm::lowp_uvec4> &extraData, uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer [[gnu::unused]]) {
+    recordBufferUpload(vao, vbo, extraData.size() * sizeof(glm::lowp_uvec4), true);
+}
+
+void HeadlessGraphics::bufferVertexTextureCoordinates(const std::vector<glm::vec2> &textureCoordinates, uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer [[gnu::unused]]) {
+    recordBufferUpload(vao, vbo, textureCoordinates.size() * sizeof(glm::vec2), true);
+}
+
+void HeadlessGraphics::updateVertexData(const std::vector<glm::vec3> &vertices, const std::vector<glm::mediump_uvec3> &faces, uint32_t &vbo, uint32_t &ebo) {
+    uint32_t unusedVAO = 0;
+    recordBufferUpload(unusedVAO, vbo, vertices.size() * sizeof(glm::vec3), false);
+    recordBufferUpload(unusedVAO, ebo, faces.size() * sizeof(glm::mediump_uvec3), false);
+}
+
+void HeadlessGraphics::updateNormalData(const std::vector<glm::vec3> &normals, uint32_t &vbo) {
+    uint32_t unusedVAO = 0;
+    recordBufferUpload(unusedVAO, vbo, normals.size() * sizeof(glm::vec3), false);
+}
+
+void HeadlessGraphics::updateExtraVertexData(const std::vector<glm::vec4> &extraData, uint32_t &vbo) {
+    uint32_t unusedVAO = 0;
+    recordBufferUpload(unusedVAO, vbo, extraData.size() * sizeof(glm::vec4), false);
+}
+
+void HeadlessGraphics::updateExtraVertexData(const std::vector<glm::lowp_uvec4> &extraData, uint32_t &vbo) {
+    uint32_t unusedVAO = 0;
+    recordBufferUpload(unusedVAO, vbo, extraData.size() * sizeof(glm::lowp_uvec4), false);
+}
+
+void HeadlessGraphics::updateVertexTextureCoordinates(const std::vector<glm::vec2> &textureCoordinates, uint32_t &vbo) {
+    uint32_t unusedVAO = 0;
+    recordBufferUpload(unusedVAO, vbo, textureCoordinates.size() * sizeof(glm::vec2), false);
+}
+
+void HeadlessGraphics::createDebugVAOVBO(uint32_t &vao, uint32_t &vbo, uint32_t bufferSize) {
+    vao = generateID();
+    vbo = generateID();
+    bufferSizes[vbo] = bufferSize * sizeof(Line);
+}
+
+void HeadlessGraphics::drawLines(GraphicsProgram &program [[gnu::unused]], uint32_t vao [[gnu::unused]], uint32_t vbo [[gnu::unused]], const std::vector<Line> &lines) {
+    frameStatistics.bufferBytesUploaded += lines.size() * sizeof(Line);
+    frameStatistics.lineDrawCalls++;
+    frameStatistics.lines += lines.size();
+    record(CommandTypes::DRAW_LINES, lines.size());
+}
+
+void HeadlessGraphics::render(const uint32_t program, const uint32_t vao [[gnu::unused]], const uint32_t ebo [[gnu::unused]],
+                              const uint32_t elementCount, const uint32_t* startIndex [[gnu::unused]]) {
+    if (program == 0) {
+        std::cerr << "No program render requested." << std::endl;
+        return;
+    }
+    flushModelTransforms();
+    switchProgram(program);
+    frameStatistics.drawCalls++;
+    frameStatistics.triangles += elementCount;//same with OpenGL backend, element count is used as triangle count
+    record(CommandTypes::DRAW, elementCount);
+}
+
+void HeadlessGraphics::renderInstanced(uint32_t program, uint32_t VAO [[gnu::unused]], uint32_t EBO [[gnu::unused]], uint32_t triangleCount,
+                                       uint32_t startOffset [[gnu::unused]], uint32_t instanceCount) {
+    if (program == 0) {
+        std::cerr << "No program render requested." << std::endl;
+        return;
+    }
+    flushModelTransforms();
+    switchProgram(program);
+    frameStatistics.drawCalls++;
+    frameStatistics.instancedDrawCalls++;
+    frameStatistics.instances += instanceCount;
+    frameStatistics.triangles += (uint64_t)triangleCount * instanceCount;
+    record(CommandTypes::DRAW_INSTANCED, triangleCount, instanceCount);
+}
+
+void HeadlessGraphics::setLight(const int lightIndex, const glm::vec3 &attenuation [[gnu::unused]], const std::vector<glm::mat4> &shadowMatrices [[gnu::unused]],
+                                const glm::vec3 &position [[gnu::unused]], const glm::vec3 &color [[gnu::unused]], const glm::vec3 &ambientColor [[gnu::unused]],
+                                const int32_t lightType, const float farPlane [[gnu::unused]]) {
+    frameStatistics.bufferBytesUploaded += LIGHT_UNIFORM_SIZE;
+    record(CommandTypes::LIGHT, (uint64_t)lightIndex, (uint64_t)lightType);
+}
+
+void HeadlessGraphics::setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                                          const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters [[gnu::unused]]) {
+    frameStatistics.bufferBytesUploaded += sizeof(glm::vec4) * (lights.size() + 1);
+    frameStatistics.textureBytesUploaded += sizeof(uint32_t) * (clusterRanges.size() + lightIndices.size());
+    record(CommandTypes::LIGHT, lights.size() / 4, lightIndices.size());
+}
+
+void HeadlessGraphics::setPlayerMatrices(const glm::vec3 &cameraPosition, const glm::mat4 &cameraMatrix [[gnu::unused]], long currentTime [[gnu::unused]]) {
+    this->cameraPosition = cameraPosition;
+    frameStatistics.bufferBytesUploaded += PLAYER_UNIFORM_SIZE;
+    record(CommandTypes::PLAYER);
+}
+
+void HeadlessGraphics::switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled,
+                                         bool depthWriteEnabled, bool scissorEnabled, bool clearColor, bool clearDepth, CullModes cullMode,
+                                         std::map<uint32_t, std::shared_ptr<Texture>> &inputs, const std::string &name) {
+    const std::map<std::shared_ptr<Texture>, std::pair<FrameBufferAttachPoints, int>> emptyAttachmentLayerMap;
+    switchRenderStage(width, height, frameBufferID, blendEnabled, depthTestEnabled, depthWriteEnabled, scissorEnabled, clearColor, clearDepth,
+                      cullMode, inputs, emptyAttachmentLayerMap, name);
+}
+
+void HeadlessGraphics::switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID [[gnu::unused]], bool blendEnabled [[gnu::unused]],
+                                         bool depthTestEnabled [[gnu::unused]], bool depthWriteEnabled [[gnu::unused]], bool scissorEnabled [[gnu::unused]],
+                                         bool clearColor [[gnu::unused]], bool clearDepth [[gnu::unused]], CullModes cullMode [[gnu::unused]],
+                                         const std::map<uint32_t, std::shared_ptr<Texture>> &inputs,
+                                         const std::map<std::shared_ptr<Texture>, std::pair<FrameBufferAttachPoints, int>> &attachmentLayerMap,
+                                         const std::string &name [[gnu::unused]]) {
+    frameStatistics.renderStageSwitches++;
+    //inputs are attached to their texture units by the stage switch
+    frameStatistics.textureBinds += (uint32_t)inputs.size();
+    record(CommandTypes::RENDER_STAGE, ((uint64_t)width << 32) | height, (inputs.size() << 16) | attachmentLayerMap.size());
+}
+
+void HeadlessGraphics::setMaterial(const Material &material [[gnu::unused]]) {
+    frameStatistics.materialSets++;
+    frameStatistics.bufferBytesUploaded += MATERIAL_UNIFORM_SIZE;
+    record(CommandTypes::MATERIAL);
+}
+
+void HeadlessGraphics::setModel(const uint32_t modelID, const glm::mat4 &worldTransform) {
+    if(!modelTransformStaging.set(modelID, worldTransform)) {
+        std::cerr << "Model ID " << modelID << " is over the maximum model count " << NR_MAX_MODELS << ", transform is not set." << std::endl;
+        return;
+    }
+    frameStatistics.modelTransformSets++;
+}
+
+void HeadlessGraphics::flushModelTransforms() {
+    if(!modelTransformStaging.isDirty()) {
+        return;
+    }
+    modelTransformStaging.flush([this](uint32_t startModelID [[gnu::unused]], uint32_t modelCount, const float* data [[gnu::unused]]) {
+        frameStatistics.modelTransformUploads++;
+        frameStatistics.bufferBytesUploaded += (uint64_t)modelCount * ModelTransformStaging::FLOATS_PER_MODEL_ROW * 2 * sizeof(float);
+        record(CommandTypes::MODEL_TRANSFORM_UPLOAD, modelCount);
+    });
+}
@@ -0,0 +1,339 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_HEADLESSGRAPHICS_H
+#define LIMONENGINE_HEADLESSGRAPHICS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include "Utils/Line.h"
+
+#include "Options.h"
+#include "API/Graphics/GraphicsInterface.h"
+#include "API/Graphics/ModelTransformStaging.h"
+
+extern "C" std::shared_ptr<GraphicsInterface> createGraphicsBackend(OptionsUtil::Options* options);
+
+/**
+ * Graphics backend without any GPU context. Every call is recorded to per frame counters, and hashed, so
+ * CPU cost of the engine can be measured, and 2 runs of the same world can be compared.
+ *
+ * Object IDs are generated in creation order. Uniforms, attributes and outputs are reflected by parsing the
+ * shader sources, so uniform sets reach the backend like they would with a real context.
+ */
+class HeadlessGraphics : public GraphicsInterface {
+    enum class CommandTypes : uint8_t {CLEAR_FRAME, DRAW, DRAW_INSTANCED, DRAW_LINES, UNIFORM, PROGRAM_SWITCH, TEXTURE_BIND,
+                                       RENDER_STAGE, MATERIAL, MODEL_TRANSFORM_UPLOAD, BUFFER_UPLOAD, TEXTURE_UPLOAD, LIGHT, PLAYER};
+
+    struct ProgramReflection {
+        std::unordered_map<std::string, std::shared_ptr<Uniform>> uniforms;
+        std::unordered_map<std::string, uint32_t> attributes;
+        std::unordered_map<std::string, std::pair<Uniform::VariableTypes, FrameBufferAttachPoints>> outputs;
+    };
+
+    OptionsUtil::Options *options;
+    uint32_t nextObjectID = 1;//0 means no object for GL, so it is not used
+    uint32_t nextMaterialIndex = 0;
+    uint32_t activeProgram = 0;
+    std::vector<uint32_t> boundTextures;
+    std::unordered_map<uint32_t, ProgramReflection> programs;
+    std::unordered_map<uint32_t, uint64_t> bufferSizes;
+    ModelTransformStaging modelTransformStaging{NR_MAX_MODELS};
+
+    FrameStatistics frameStatistics;
+
+    glm::mat4 perspectiveProjectionMatrix;
+    glm::mat4 orthogonalProjectionMatrix;
+    glm::vec3 cameraPosition;
+
+    static const int MAX_TEXTURE_IMAGE_UNITS = 32;
+    static const uint32_t LIGHT_UNIFORM_SIZE = (sizeof(glm::mat4) * 6) + (4 * sizeof(glm::vec4));
+    static const uint32_t PLAYER_UNIFORM_SIZE = 6 * sizeof(glm::mat4) + 3 * sizeof(glm::vec4);
+    static const uint32_t MATERIAL_UNIFORM_SIZE = 2 * sizeof(glm::vec3) + sizeof(float) + sizeof(uint32_t);
+
+    uint32_t generateID() {
+        return nextObjectID++;
+    }
+
+    /**
+     * Only call type and counts are hashed. IDs depend on asset load order, which is not deterministic.
+     */
+    void record(CommandTypes type, uint64_t value1 = 0, uint64_t value2 = 0) {
+        const uint64_t fnvPrime = 1099511628211ull;
+        uint64_t &hash = frameStatistics.commandHash;
+        hash = (hash ^ (uint64_t)type) * fnvPrime;
+        hash = (hash ^ value1) * fnvPrime;
+        hash = (hash ^ value2) * fnvPrime;
+    }
+
+    void recordUniformSet(uint32_t programID) {
+        switchProgram(programID);
+        frameStatistics.uniformSets++;
+        record(CommandTypes::UNIFORM);
+    }
+
+    void switchProgram(uint32_t programID) {
+        if(activeProgram != programID) {
+            activeProgram = programID;
+            frameStatistics.programSwitches++;
+            record(CommandTypes::PROGRAM_SWITCH);
+        }
+    }
+
+    void bindTexture(unsigned int textureID, unsigned int attachPoint);
+
+    void recordBufferUpload(uint32_t &vao, uint32_t &vbo, uint64_t byteCount, bool createBuffer);
+
+    static void reflectShader(const std::string &shaderContent, bool isVertexShader, bool isFragmentShader, ProgramReflection &reflection);
+
+protected:
+    uint32_t createTexture(int height, int width, TextureTypes type, InternalFormatTypes internalFormat, FormatTypes format, DataTypes dataType, uint32_t textureLayers) override;
+
+    bool deleteTexture(uint32_t textureID) override;
+
+    void setWrapMode(uint32_t textureID [[gnu::unused]], TextureTypes textureType [[gnu::unused]], TextureWrapModes wrapModeS [[gnu::unused]],
+                     TextureWrapModes wrapModeT [[gnu::unused]], TextureWrapModes wrapModeR [[gnu::unused]]) override {}
+
+    void setTextureBorder(uint32_t textureID [[gnu::unused]], TextureTypes textureType [[gnu::unused]], bool isBorderColorSet [[gnu::unused]],
+                          const std::vector<float> &borderColors [[gnu::unused]]) override {}
+
+    void setFilterMode(uint32_t textureID [[gnu::unused]], TextureTypes textureType [[gnu::unused]], FilterModes filterMode [[gnu::unused]]) override {}
+
+    void loadTextureData(uint32_t textureID, int height, int width, TextureTypes type, InternalFormatTypes internalFormat, FormatTypes format, DataTypes dataType, uint32_t depth,
+                         void *data, void *data2, void *data3, void *data4, void *data5, void *data6) override;
+
+    uint32_t createGraphicsProgram(const std::string &vertexShaderContent, const std::string &geometryShaderContent, const std::string &fragmentShaderContent) override;
+
+public:
+    explicit HeadlessGraphics(OptionsUtil::Options *options);
+
+    GraphicsInterface::ContextInformation getContextInformation() override;
+    std::string getProgramBinaryIdentity() override {
+        return "Headless";//no binaries, cache only keeps reflection
+    }
+    bool createGraphicsBackend() override;
+
+    void getRenderTriangleAndLineCount(uint32_t& triangleCount, uint32_t& lineCount) override {
+        triangleCount = (uint32_t)frameStatistics.triangles;
+        lineCount = (uint32_t)frameStatistics.lines;
+    }
+
+    bool getFrameStatistics(FrameStatistics& statistics) const override {
+        statistics = frameStatistics;
+        return true;
+    }
+
+    void attachModelUBO(const uint32_t program [[gnu::unused]]) override {}
+
+    void attachMaterialUBO(const uint32_t program [[gnu::unused]], const uint32_t materialID [[gnu::unused]]) override {}
+
+    uint32_t getNextMaterialIndex() override {
+        return nextMaterialIndex++;
+    }
+
+    void initializeProgramAsset(const uint32_t programId,
+                                std::unordered_map<std::string, std::shared_ptr<Uniform>> &uniformMap,
+                                std::unordered_map<std::string, uint32_t> &attributesMap,
+                                std::unordered_map<std::string, std::pair<Uniform::VariableTypes, FrameBufferAttachPoints>> &outputMap) override;
+
+    void destroyProgram(uint32_t programID) override {
+        programs.erase(programID);
+    }
+
+    void bufferVertexData(const std::vector<glm::vec3> &vertices,
+                          const std::vector<glm::mediump_uvec3> &faces,
+                          uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer, uint32_t &ebo) override;
+
+    void bufferNormalData(const std::vector<glm::vec3> &normals,
+                          uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer) override;
+
+    void bufferExtraVertexData(const std::vector<glm::vec4> &extraData,
+                               uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer) override;
+
+    void bufferExtraVertexData(const std::vector<glm::lowp_uvec4> &extraData,
+                               uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer) override;
+
+    void bufferVertexTextureCoordinates(const std::vector<glm::vec2> &textureCoordinates,
+                                        uint32_t &vao, uint32_t &vbo, const uint32_t attachPointer) override;
+
+    void updateVertexData(const std::vector<glm::vec3> &vertices, const std::vector<glm::mediump_uvec3> &faces,
+                          uint32_t &vbo, uint32_t &ebo) override;
+    void updateNormalData(const std::vector<glm::vec3> &normals, uint32_t &vbo) override;
+    void updateExtraVertexData(const std::vector<glm::vec4> &extraData, uint32_t &vbo) override;
+    void updateExtraVertexData(const std::vector<glm::lowp_uvec4> &extraData, uint32_t &vbo) override;
+    void updateVertexTextureCoordinates(const std::vector<glm::vec2> &textureCoordinates, uint32_t &vbo) override;
+
+    bool freeBuffer(const uint32_t bufferID) override {
+        return bufferSizes.erase(bufferID) > 0;
+    }
+
+    bool freeVAO(const uint32_t VAO [[gnu::unused]]) override {
+        return true;
+    }
+
+    void backupCurrentState() override {}
+
+    void restoreLastState() override {}
+
+    void clearFrame() override;
+
+    void render(const uint32_t program, const uint32_t vao, const uint32_t ebo, const uint32_t elementCount) override {
+        this->render(program, vao, ebo, elementCount, nullptr);
+    }
+
+    void render(const uint32_t program, const uint32_t vao, const uint32_t ebo, const uint32_t elementCount, const uint32_t* startIndex) override;
+
+    void reshape() override;
+
+    uint32_t createFrameBuffer(uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) override {
+        return generateID();
+    }
+
+    void deleteFrameBuffer(uint32_t frameBufferID [[gnu::unused]]) override {}
+
+    bool copyTexture2DRegion(uint32_t sourceTextureID [[gnu::unused]], uint32_t destinationTextureID [[gnu::unused]],
+                             int32_t destinationX [[gnu::unused]], int32_t destinationY [[gnu::unused]],
+                             uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) override {
+        return true;//pretend, so headless runs exercise the atlas path
+    }
+
+    bool copyDepthLayers(uint32_t sourceTextureID [[gnu::unused]], uint32_t destinationTextureID [[gnu::unused]],
+                         TextureTypes textureType [[gnu::unused]], uint32_t firstLayer [[gnu::unused]],
+                         uint32_t layerCount [[gnu::unused]], uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) override {
+        return true;//same, for the cached shadow path
+    }
+
+    bool loadTextureData2DRegion(uint32_t textureID [[gnu::unused]], int32_t x [[gnu::unused]], int32_t y [[gnu::unused]],
+                                 uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]],
+                                 FormatTypes format [[gnu::unused]], DataTypes dataType [[gnu::unused]], const void *data [[gnu::unused]]) override {
+        return true;
+    }
+
+    void attachDrawTextureToFrameBuffer(uint32_t frameBufferID [[gnu::unused]], TextureTypes textureType [[gnu::unused]], uint32_t textureID [[gnu::unused]],
+                                        FrameBufferAttachPoints attachPoint [[gnu::unused]], int32_t layer [[gnu::unused]] = 0, bool clear [[gnu::unused]] = false) override {}
+
+    void attachTexture(unsigned int textureID, unsigned int attachPoint) override {
+        bindTexture(textureID, attachPoint);
+    }
+
+    void attach2DArrayTexture(unsigned int textureID, unsigned int attachPoint) override {
+        bindTexture(textureID, attachPoint);
+    }
+
+    void attachCubeMap(unsigned int cubeMapID, unsigned int attachPoint) override {
+        bindTexture(cubeMapID, attachPoint);
+    }
+
+    void attachCubeMapArrayTexture(unsigned int textureID, unsigned int attachPoint) override {
+        bindTexture(textureID, attachPoint);
+    }
+
+    bool getUniformLocation(const uint32_t programID, const std::string &uniformName, uint32_t &location) override;
+
+    const glm::vec3& getCameraPosition() const override { return cameraPosition; };
+
+    const glm::mat4& getGUIOrthogonalProjectionMatrix() const override { return orthogonalProjectionMatrix; }
+
+    void createDebugVAOVBO(uint32_t &vao, uint32_t &vbo, uint32_t bufferSize) override;
+
+    void drawLines(GraphicsProgram &program, uint32_t vao, uint32_t vbo, const std::vector<Line> &lines) override;
+
+    void clearDepthBuffer() override {}
+
+    bool setUniform(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const glm::mat4 &matrix [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    bool setUniform(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const glm::vec3 &vector [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    bool setUniform(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const std::vector<glm::vec3> &vectorArray [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    bool setUniform(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const float value [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    bool setUniform(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const int value [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    bool setUniformArray(const uint32_t programID, const uint32_t uniformID [[gnu::unused]], const std::vector<glm::mat4> &matrixArray [[gnu::unused]]) override {
+        recordUniformSet(programID);
+        return true;
+    }
+
+    void setLight(const int lightIndex,
+                  const glm::vec3& attenuation,
+                  const std::vector<glm::mat4>& shadowMatrices,
+                  const glm::vec3& position,
+                  const glm::vec3& color,
+                  const glm::vec3& ambientColor,
+                  const int32_t lightType,
+                  const float farPlane) override;
+
+    void removeLight(const int i) override {
+        frameStatistics.bufferBytesUploaded += sizeof(int32_t);
+        record(CommandTypes::LIGHT, (uint64_t)i);
+    }
+
+    void setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                            const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) override;
+
+    void setPlayerMatrices(const glm::vec3 &cameraPosition, const glm::mat4 &cameraMatrix, long currentTime) override;
+
+    void switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled, bool depthWriteEnabled, bool scissorEnabled,
+                           bool clearColor, bool clearDepth, CullModes cullMode, std::map<uint32_t, std::shared_ptr<Texture>> &inputs, const std::string &name) override;
+    void switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled, bool depthWriteEnabled, bool scissorEnabled,
+                           bool clearColor, bool clearDepth, CullModes cullMode, const std::map<uint32_t, std::shared_ptr<Texture>> &inputs,
+                           const std::map<std::shared_ptr<Texture>,
+                                   std::pair<FrameBufferAttachPoints, int>> &attachmentLayerMap, const std::string &name) override;
+
+    int getMaxTextureImageUnits() const override {
+        return MAX_TEXTURE_IMAGE_UNITS;
+    }
+
+    void setMaterial(const Material& material) override;
+
+    void setModel(const uint32_t modelID, const glm::mat4 &worldTransform) override;
+
+    void flushModelTransforms() override;
+
+    void setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) override {
+        frameStatistics.bufferBytesUploaded += sizeof(uint32_t) * 4 * modelIndicesList.size();//same std140 padding with the GL backends
+        record(CommandTypes::BUFFER_UPLOAD, modelIndicesList.size());
+    }
+
+    void attachModelIndicesUBO(const uint32_t programID [[gnu::unused]]) override {}
+
+    void renderInstanced(uint32_t program, uint32_t VAO, uint32_t EBO, uint32_t triangleCount,
+                         uint32_t instanceCount) override {
+        renderInstanced(program, VAO, EBO, triangleCount, 0, instanceCount);
+    }
+
+    void renderInstanced(uint32_t program, uint32_t VAO, uint32_t EBO, uint32_t triangleCount, uint32_t startOffset,
+                         uint32_t instanceCount) override;
+
+    void setScissorRect(int32_t x [[gnu::unused]], int32_t y [[gnu::unused]], uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) override {}
+
+    OptionsUtil::Options* getOptions() override {
+        return options;
+    }
+};
+
+
+#endif //LIMONENGINE_HEADLESSGRAPHICS_H
@@ -318,6 +318,28 @@ void OpenGLESGraphics::attachGeneralUBOs(const GLuint program){//Attach the ligh
                           playerUniformSize);
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
+
+    GLuint clusteredLightAttachPoint = 10;
+    int uniformIndex3 = glGetUniformBlockIndex(program, "ClusteredLightBlock");
+    if (uniformIndex3 >= 0) {
+        glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+        glUniformBlockBinding(program, uniformIndex3, clusteredLightAttachPoint);
+        glBindBufferRange(GL_UNIFORM_BUFFER, clusteredLightAttachPoint, clusteredLightUBOLocation, 0,
+                          clusteredLightUniformSize);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    //cluster textures have their own units, like model transforms, so they are attached once
+    GLint lightClustersAttachPoint = glGetUniformLocation(program, "lightClusters");
+    if (lightClustersAttachPoint >= 0) {
+        this->setUniform(program, lightClustersAttachPoint, maxTextureImageUnits-5);
+        state->attachTexture(lightClusterTexture, maxTextureImageUnits-5);
+    }
+    GLint lightClusterIndicesAttachPoint = glGetUniformLocation(program, "lightClusterIndices");
+    if (lightClusterIndicesAttachPoint >= 0) {
+        this->setUniform(program, lightClusterIndicesAttachPoint, maxTextureImageUnits-6);
+        state->attachTexture(lightClusterIndexTexture, maxTextureImageUnits-6);
+    }
 }
 
 
@@ -333,7 +355,8 @@ OpenGLESGraphics::ContextInformation OpenGLESGraphics::getContextInformation() {
     contextInformation.shaderHeader = "#version 310 es\n"
                                       "#extension GL_EXT_shader_io_blocks : enable\n"
                                       "precision mediump float;\n"
-                                      "precision mediump int;";
+                                      "precision mediump int;\n"
+                                      "precision highp usampler2D;";
     return contextInformation;
 }
 
@@ -481,6 +504,29 @@ bool OpenGLESGraphics::createGraphicsBackend() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     state->activateTextureUnit(0);
 
+    //create clustered lights uniform buffer object, and the textures for the lists of clusters
+    glGenBuffers(1, &clusteredLightUBOLocation);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+    std::vector<GLubyte> emptyClusteredLightData(clusteredLightUniformSize, 0);
+    glBufferData(GL_UNIFORM_BUFFER, clusteredLightUniformSize, emptyClusteredLightData.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glGenTextures(1, &lightClusterTexture);
+    state->activateTextureUnit(maxTextureImageUnits-5);
+    glBindTexture(GL_TEXTURE_2D, lightClusterTexture);
+    std::vector<GLuint> emptyClusterData(LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z * 2, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, emptyClusterData.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenTextures(1, &lightClusterIndexTexture);
+    state->activateTextureUnit(maxTextureImageUnits-6);
+    glBindTexture(GL_TEXTURE_2D, lightClusterIndexTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, NR_MAX_LIGHT_CLUSTER_INDICES / LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    state->activateTextureUnit(0);
+
     //create model index uniform buffer object
     glGenBuffers(1, &allModelIndexesUBOLocation);
     glBindBuffer(GL_UNIFORM_BUFFER, allModelIndexesUBOLocation);
@@ -818,6 +864,7 @@ void OpenGLESGraphics::render(const uint32_t program, const uint32_t vao, const
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -837,6 +884,7 @@ void OpenGLESGraphics::renderInstanced(uint32_t program, uint32_t VAO, uint32_t
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -856,6 +904,7 @@ void OpenGLESGraphics::renderInstanced(uint32_t program, uint32_t VAO, uint32_t
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -965,6 +1014,9 @@ OpenGLESGraphics::~OpenGLESGraphics() {
     deleteBuffer(1, lightUBOLocation);
     deleteBuffer(1, playerUBOLocation);
     deleteBuffer(1, allMaterialsUBOLocation);
+    deleteBuffer(1, clusteredLightUBOLocation);
+    glDeleteTextures(1, &lightClusterTexture);
+    glDeleteTextures(1, &lightClusterIndexTexture);
     glDeleteFramebuffers(1, &combineFrameBuffer);
 
     //state->setProgram(0);
@@ -1177,11 +1229,7 @@ void OpenGLESGraphics::attachDrawTextureToFrameBuffer(uint32_t frameBufferID, Te
 
     int32_t attachmentTemp;
     unsigned int drawBufferAttachments[6];
-    if(attachPoint == OpenGLESGraphics::FrameBufferAttachPoints::DEPTH) {
-        if(clear) {
-            glClear(GL_DEPTH_BUFFER_BIT);
-        }
-    } else {
+    if(attachPoint != OpenGLESGraphics::FrameBufferAttachPoints::DEPTH) {
         for (unsigned int i = 0; i < 6; ++i) {
             if (i == index) {
                 drawBufferAttachments[i] = glAttachment;
@@ -1215,7 +1263,11 @@ void OpenGLESGraphics::attachDrawTextureToFrameBuffer(uint32_t frameBufferID, Te
         }
             break;
         case TextureTypes::TCUBE_MAP_ARRAY: {
-            glFramebufferTexture(GL_FRAMEBUFFER, glAttachment, textureID, 0);
+            if(layer == -1 ) {
+                glFramebufferTexture(GL_FRAMEBUFFER, glAttachment, textureID, 0);
+            } else {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, glAttachment, textureID, 0, layer);//layer-face
+            }
         }
             break;
     }
@@ -1402,6 +1454,32 @@ OpenGLESGraphics::loadTextureData(uint32_t textureID, int height, int width, Tex
     checkErrors("loadTextureData");
 }
 
+bool OpenGLESGraphics::loadTextureData2DRegion(uint32_t textureID, int32_t x, int32_t y, uint32_t width, uint32_t height,
+                                     FormatTypes format, DataTypes dataType, const void *data) {
+    GLenum glFormat;
+    switch (format) {
+        case FormatTypes::RED: glFormat = GL_RED; break;
+        case FormatTypes::RGB: glFormat = GL_RGB; break;
+        case FormatTypes::RGBA: glFormat = GL_RGBA; break;
+        case FormatTypes::DEPTH: glFormat = GL_DEPTH_COMPONENT; break;
+    }
+
+    GLenum glDataType;
+    switch (dataType) {
+        case DataTypes::FLOAT: glDataType = GL_FLOAT; break;
+        case DataTypes::UNSIGNED_BYTE: glDataType = GL_UNSIGNED_BYTE; break;
+        case DataTypes::UNSIGNED_SHORT: glDataType = GL_UNSIGNED_SHORT; break;
+        case DataTypes::UNSIGNED_INT: glDataType = GL_UNSIGNED_INT; break;
+        case DataTypes::HALF_FLOAT: glDataType = GL_HALF_FLOAT; break;
+    }
+    state->activateTextureUnit(0);//this is the default working texture
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, glFormat, glDataType, data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    checkErrors("loadTextureData2DRegion");
+    return true;
+}
+
 
 void OpenGLESGraphics::attachTexture(unsigned int textureID, unsigned int attachPoint) {
     state->attachTexture(textureID, attachPoint);
@@ -1515,6 +1593,42 @@ void OpenGLESGraphics::setLight(const int lightIndex,
     checkErrors("setLight");
 }
 
+void OpenGLESGraphics::setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                                          const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) {
+    /*
+    layout (std140) uniform ClusteredLightBlock {
+        vec4 depthParameters;
+        ClusteredLight lights[NR_MAX_CLUSTERED_LIGHTS];//4 vec4 each
+    } clusteredLights;
+    */
+    assert(lights.size() <= NR_MAX_CLUSTERED_LIGHTS * 4);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::vec4), glm::value_ptr(clusterDepthParameters));
+    if(!lights.empty()) {
+        glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::vec4), sizeof(glm::vec4) * lights.size(), lights.data());
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    state->activateTextureUnit(maxTextureImageUnits-5);
+    state->attachTexture(lightClusterTexture, maxTextureImageUnits-5);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, GL_RG_INTEGER, GL_UNSIGNED_INT, clusterRanges.data());
+
+    //only the used rows are uploaded, last row might be partial
+    assert(lightIndices.size() <= NR_MAX_LIGHT_CLUSTER_INDICES);
+    uint32_t fullRowCount = lightIndices.size() / LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH;
+    uint32_t lastRowLength = lightIndices.size() % LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH;
+    state->activateTextureUnit(maxTextureImageUnits-6);
+    state->attachTexture(lightClusterIndexTexture, maxTextureImageUnits-6);
+    if(fullRowCount > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, fullRowCount, GL_RED_INTEGER, GL_UNSIGNED_INT, lightIndices.data());
+    }
+    if(lastRowLength > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRowCount, lastRowLength, 1, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                        lightIndices.data() + fullRowCount * LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH);
+    }
+    checkErrors("setClusteredLights");
+}
+
 void OpenGLESGraphics::setMaterial(const Material& material) {
     /*
      * this buffer has 2 objects, model has mat4 and then the material below:
@@ -1543,15 +1657,24 @@ void OpenGLESGraphics::setMaterial(const Material& material) {
 }
 
 void OpenGLESGraphics::setModel(const uint32_t modelID, const glm::mat4& worldTransform) {
+    if(!modelTransformStaging.set(modelID, worldTransform)) {
+        std::cerr << "Model ID " << modelID << " is over the maximum model count " << NR_MAX_MODELS << ", transform is not set." << std::endl;
+    }
+}
+
+void OpenGLESGraphics::flushModelTransforms() {
+    if(!modelTransformStaging.isDirty()) {
+        return;
+    }
     state->activateTextureUnit(maxTextureImageUnits-4);
     state->attachTexture(allModelTransformsTexture, maxTextureImageUnits-4);
-    glm::mat4 transposeInverse = glm::transpose(glm::inverse(worldTransform));
-    float data[32];
-    memcpy(data, glm::value_ptr(worldTransform), sizeof(float)*16);
-    memcpy((data+16), glm::value_ptr(transposeInverse), sizeof(float)*12);
-    glTexSubImage2D(GL_TEXTURE_2D,0,4*modelID, 0, 4, 2, GL_RGBA, GL_FLOAT, data);
-    //std::cout << "setting for model id " << modelID << std::endl;
-    checkErrors("setModel");
+    //staging keeps both rows with full texture width, so each range uploads world and transpose inverse rows together
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, modelTransformStaging.getRowLengthInTexels());
+    modelTransformStaging.flush([](uint32_t startModelID, uint32_t modelCount, const float* data) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 4 * startModelID, 0, 4 * modelCount, 2, GL_RGBA, GL_FLOAT, data);
+    });
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    checkErrors("flushModelTransforms");
 }
 
 void OpenGLESGraphics::setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) {
@@ -29,6 +29,7 @@
 
 #include "Options.h"
 #include "API/Graphics/GraphicsInterface.h"
+#include "API/Graphics/ModelTransformStaging.h"
 
 class Material;
 
@@ -217,6 +218,12 @@ private:
 
     GLuint allModelTransformsTexture;
 
+    GLuint clusteredLightUBOLocation;
+    GLuint lightClusterTexture;
+    GLuint lightClusterIndexTexture;
+    const uint32_t clusteredLightUniformSize = sizeof(glm::vec4) + NR_MAX_CLUSTERED_LIGHTS * 4 * sizeof(glm::vec4);
+    ModelTransformStaging modelTransformStaging{NR_MAX_MODELS};
+
     glm::mat4 cameraMatrix;
     glm::mat4 perspectiveProjectionMatrix;
     glm::mat4 inverseProjection;
@@ -317,6 +324,8 @@ protected:
 
     void loadTextureData(uint32_t textureID, int height, int width, TextureTypes type, InternalFormatTypes internalFormat, FormatTypes format, DataTypes dataType, uint32_t depth,
                          void *data, void *data2, void *data3, void *data4, void *data5, void *data6) override;
+    bool loadTextureData2DRegion(uint32_t textureID, int32_t x, int32_t y, uint32_t width, uint32_t height,
+                                 FormatTypes format, DataTypes dataType, const void *data) override;
 
     uint32_t createGraphicsProgram(const std::string &vertexShaderContent, const std::string &geometryShaderFileContent, const std::string &fragmentShaderFileContent) override;
 
@@ -452,6 +461,9 @@ public:
         checkErrors("removeLight");
     }
 
+    void setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                            const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) override;
+
     void setPlayerMatrices(const glm::vec3 &cameraPosition, const glm::mat4 &cameraMatrix, long currentTime) override;
 
     void switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled, bool depthWriteEnabled, bool scissorEnabled,
@@ -469,6 +481,8 @@ public:
 
     void setModel(const uint32_t modelID, const glm::mat4 &worldTransform) override;
 
+    void flushModelTransforms() override;
+
     void setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) override;
 
     void attachModelIndicesUBO(const uint32_t programID) override;
@@ -62,6 +62,9 @@ GLuint OpenGLGraphics::createProgram(const std::vector<GLuint> &shaderList) {
     for (size_t iLoop = 0; iLoop < shaderList.size(); iLoop++) {
         glAttachShader(program, shaderList[iLoop]);
     }
+    if(isProgramBinarySupported) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
     glLinkProgram(program);
 
@@ -105,6 +108,47 @@ uint32_t OpenGLGraphics::createGraphicsProgram(const std::string &vertexShaderCo
     return program;
 }
 
+bool OpenGLGraphics::getProgramBinary(uint32_t programID, uint32_t &binaryFormat, std::vector<uint8_t> &binary) {
+    if(!isProgramBinarySupported) {
+        return false;
+    }
+    GLint binaryLength = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if(binaryLength <= 0) {
+        return false;
+    }
+    binary.resize(binaryLength);
+    GLenum format = 0;
+    GLsizei writtenLength = 0;
+    glGetProgramBinary(programID, binaryLength, &writtenLength, &format, binary.data());
+    binary.resize(writtenLength);
+    binaryFormat = format;
+    checkErrors("getProgramBinary");
+    return writtenLength > 0;
+}
+
+uint32_t OpenGLGraphics::createGraphicsProgramFromBinary(uint32_t binaryFormat, const std::vector<uint8_t> &binary) {
+    if(!isProgramBinarySupported || binary.empty()) {
+        return 0;
+    }
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, binaryFormat, binary.data(), (GLsizei)binary.size());
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        //driver update or another binary format, this is expected, no need to log
+        glDeleteProgram(program);
+        checkErrors("createGraphicsProgramFromBinary");
+        return 0;
+    }
+    attachGeneralUBOs(program);
+    checkErrors("createGraphicsProgramFromBinary");
+    return program;
+}
+
+std::string OpenGLGraphics::getProgramBinaryIdentity() {
+    return std::string((const char*)glGetString(GL_VENDOR)) + "|" + (const char*)glGetString(GL_RENDERER) + "|" + (const char*)glGetString(GL_VERSION);
+}
 
 void OpenGLGraphics::initializeProgramAsset(const uint32_t programId,
                                             std::unordered_map<std::string, std::shared_ptr<Uniform>> &uniformMap, std::unordered_map<std::string, uint32_t> &attributesMap,
@@ -318,6 +362,28 @@ void OpenGLGraphics::attachGeneralUBOs(const GLuint program){//Attach the light
                           playerUniformSize);
         glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
+
+    GLuint clusteredLightAttachPoint = 10;
+    int uniformIndex3 = glGetUniformBlockIndex(program, "ClusteredLightBlock");
+    if (uniformIndex3 >= 0) {
+        glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+        glUniformBlockBinding(program, uniformIndex3, clusteredLightAttachPoint);
+        glBindBufferRange(GL_UNIFORM_BUFFER, clusteredLightAttachPoint, clusteredLightUBOLocation, 0,
+                          clusteredLightUniformSize);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    //cluster textures have their own units, like model transforms, so they are attached once
+    GLint lightClustersAttachPoint = glGetUniformLocation(program, "lightClusters");
+    if (lightClustersAttachPoint >= 0) {
+        this->setUniform(program, lightClustersAttachPoint, maxTextureImageUnits-5);
+        state->attachTexture(lightClusterTexture, maxTextureImageUnits-5);
+    }
+    GLint lightClusterIndicesAttachPoint = glGetUniformLocation(program, "lightClusterIndices");
+    if (lightClusterIndicesAttachPoint >= 0) {
+        this->setUniform(program, lightClusterIndicesAttachPoint, maxTextureImageUnits-6);
+        state->attachTexture(lightClusterIndexTexture, maxTextureImageUnits-6);
+    }
 }
 
 
@@ -350,6 +416,12 @@ bool OpenGLGraphics::createGraphicsBackend() {
         std::cout << "GLEW Init: Success!" << std::endl;
     }
     checkErrors("after Context creation");
+    isTimerQuerySupported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        GLint binaryFormatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+        isProgramBinarySupported = binaryFormatCount > 0;
+    }
 
     glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureImageUnits);
 
@@ -478,6 +550,29 @@ bool OpenGLGraphics::createGraphicsBackend() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     state->activateTextureUnit(0);
 
+    //create clustered lights uniform buffer object, and the textures for the lists of clusters
+    glGenBuffers(1, &clusteredLightUBOLocation);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+    std::vector<GLubyte> emptyClusteredLightData(clusteredLightUniformSize, 0);
+    glBufferData(GL_UNIFORM_BUFFER, clusteredLightUniformSize, emptyClusteredLightData.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glGenTextures(1, &lightClusterTexture);
+    state->activateTextureUnit(maxTextureImageUnits-5);
+    glBindTexture(GL_TEXTURE_2D, lightClusterTexture);
+    std::vector<GLuint> emptyClusterData(LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z * 2, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, emptyClusterData.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenTextures(1, &lightClusterIndexTexture);
+    state->activateTextureUnit(maxTextureImageUnits-6);
+    glBindTexture(GL_TEXTURE_2D, lightClusterIndexTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, NR_MAX_LIGHT_CLUSTER_INDICES / LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    state->activateTextureUnit(0);
+
     //create model index uniform buffer object
     glGenBuffers(1, &allModelIndexesUBOLocation);
     glBindBuffer(GL_UNIFORM_BUFFER, allModelIndexesUBOLocation);
@@ -810,6 +905,7 @@ void OpenGLGraphics::render(const uint32_t program, const uint32_t vao, const ui
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -829,6 +925,7 @@ void OpenGLGraphics::renderInstanced(uint32_t program, uint32_t VAO, uint32_t EB
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -848,6 +945,7 @@ void OpenGLGraphics::renderInstanced(uint32_t program, uint32_t VAO, uint32_t EB
         std::cerr << "No program render requested." << std::endl;
         return;
     }
+    flushModelTransforms();
     state->setProgram(program);
 
     // Set up for a glDrawElements call
@@ -957,11 +1055,81 @@ OpenGLGraphics::~OpenGLGraphics() {
     deleteBuffer(1, lightUBOLocation);
     deleteBuffer(1, playerUBOLocation);
     deleteBuffer(1, allMaterialsUBOLocation);
+    deleteBuffer(1, clusteredLightUBOLocation);
+    glDeleteTextures(1, &lightClusterTexture);
+    glDeleteTextures(1, &lightClusterIndexTexture);
     glDeleteFramebuffers(1, &combineFrameBuffer);
+    if(copyFrameBuffer != 0) {
+        glDeleteFramebuffers(1, &copyFrameBuffer);
+    }
+    if(depthCopyFrameBuffers[0] != 0) {
+        glDeleteFramebuffers(2, depthCopyFrameBuffers);
+    }
+    if(!allTimerQueries.empty()) {
+        glDeleteQueries((GLsizei)allTimerQueries.size(), allTimerQueries.data());
+    }
 
     //state->setProgram(0);
 }
 
+bool OpenGLGraphics::beginGPUTimer(const char *name) {
+    if(!isTimerQuerySupported) {
+        return false;
+    }
+    if(freeTimerQueries.size() < 2) {
+        if(allTimerQueries.size() + 2 > MAX_GPU_TIMER_QUERIES) {
+            return false;//results are not collected fast enough, skip instead of waiting
+        }
+        GLuint queries[2];
+        glGenQueries(2, queries);
+        allTimerQueries.push_back(queries[0]);
+        allTimerQueries.push_back(queries[1]);
+        freeTimerQueries.push_back(queries[0]);
+        freeTimerQueries.push_back(queries[1]);
+    }
+    GPUTimer timer;
+    timer.name = name;
+    timer.depth = (uint32_t)openGPUTimers.size();
+    timer.startQuery = freeTimerQueries.back();
+    freeTimerQueries.pop_back();
+    timer.endQuery = freeTimerQueries.back();
+    freeTimerQueries.pop_back();
+    timer.ended = false;
+    glQueryCounter(timer.startQuery, GL_TIMESTAMP);
+    pendingGPUTimers.push_back(timer);
+    openGPUTimers.push_back(&pendingGPUTimers.back());
+    return true;
+}
+
+void OpenGLGraphics::endGPUTimer() {
+    if(openGPUTimers.empty()) {
+        std::cerr << "GPU timer end without begin, ignoring." << std::endl;
+        return;
+    }
+    GPUTimer* timer = openGPUTimers.back();
+    openGPUTimers.pop_back();
+    glQueryCounter(timer->endQuery, GL_TIMESTAMP);
+    timer->ended = true;
+}
+
+void OpenGLGraphics::collectGPUTimers(std::vector<GPUTimerResult> &results) {
+    while (!pendingGPUTimers.empty() && pendingGPUTimers.front().ended) {
+        GPUTimer& timer = pendingGPUTimers.front();
+        GLint available = 0;
+        glGetQueryObjectiv(timer.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available) {
+            break;//later timers can't be ready either
+        }
+        GLuint64 startTime = 0, endTime = 0;
+        glGetQueryObjectui64v(timer.startQuery, GL_QUERY_RESULT, &startTime);
+        glGetQueryObjectui64v(timer.endQuery, GL_QUERY_RESULT, &endTime);
+        results.push_back(GPUTimerResult{timer.name, timer.depth, startTime, endTime});
+        freeTimerQueries.push_back(timer.startQuery);
+        freeTimerQueries.push_back(timer.endQuery);
+        pendingGPUTimers.pop_front();
+    }
+}
+
 void OpenGLGraphics::reshape() {
     //reshape actually checks for changes on options->
     this->screenHeight = options->getScreenHeight();
@@ -1135,6 +1303,64 @@ uint32_t OpenGLGraphics::createFrameBuffer(uint32_t width, uint32_t height) {
     return newFrameBufferLocation;
 }
 
+bool OpenGLGraphics::copyTexture2DRegion(uint32_t sourceTextureID, uint32_t destinationTextureID, int32_t destinationX, int32_t destinationY, uint32_t width, uint32_t height) {
+    if(copyFrameBuffer == 0) {
+        glGenFramebuffers(1, &copyFrameBuffer);
+    }
+    //this might be called while rendering, so only read frame buffer is changed, and it is restored after the copy
+    GLint previousReadFrameBuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFrameBuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, copyFrameBuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sourceTextureID, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    //compressed textures are not color renderable, so they can't be copied this way
+    bool copied = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if(copied) {
+        state->activateTextureUnit(0);//this is the default working texture
+        glBindTexture(GL_TEXTURE_2D, destinationTextureID);
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, destinationX, destinationY, 0, 0, width, height);
+    }
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFrameBuffer);
+    checkErrors("copyTexture2DRegion");
+    return copied;
+}
+
+bool OpenGLGraphics::copyDepthLayers(uint32_t sourceTextureID, uint32_t destinationTextureID, TextureTypes textureType,
+                                     uint32_t firstLayer, uint32_t layerCount, uint32_t width, uint32_t height) {
+    if(textureType != TextureTypes::T2D_ARRAY && textureType != TextureTypes::TCUBE_MAP_ARRAY) {
+        return false;
+    }
+    if(depthCopyFrameBuffers[0] == 0) {
+        glGenFramebuffers(2, depthCopyFrameBuffers);
+    }
+    //called while rendering shadow stages, so bindings are restored after the copy
+    GLint previousReadFrameBuffer, previousDrawFrameBuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFrameBuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFrameBuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, depthCopyFrameBuffers[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depthCopyFrameBuffers[1]);
+    glReadBuffer(GL_NONE);
+    glDrawBuffer(GL_NONE);
+    bool copied = true;
+    for (uint32_t layer = firstLayer; layer < firstLayer + layerCount; ++layer) {
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, sourceTextureID, 0, layer);
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, destinationTextureID, 0, layer);
+        if(glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE ||
+           glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            copied = false;
+            break;
+        }
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    }
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0, 0);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFrameBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousDrawFrameBuffer);
+    checkErrors("copyDepthLayers");
+    return copied;
+}
+
 void OpenGLGraphics::deleteFrameBuffer(uint32_t frameBufferID) {
     glDeleteFramebuffers(1, &frameBufferID);
     checkErrors("deleteFrameBuffer");
@@ -1163,11 +1389,7 @@ void OpenGLGraphics::attachDrawTextureToFrameBuffer(uint32_t frameBufferID, Text
 
     int32_t attachmentTemp;
     unsigned int drawBufferAttachments[6];
-    if(attachPoint == OpenGLGraphics::FrameBufferAttachPoints::DEPTH) {
-        if(clear) {
-            glClear(GL_DEPTH_BUFFER_BIT);
-        }
-    } else {
+    if(attachPoint != OpenGLGraphics::FrameBufferAttachPoints::DEPTH) {
         for (unsigned int i = 0; i < 6; ++i) {
             if (i == index) {
                 drawBufferAttachments[i] = glAttachment;
@@ -1201,7 +1423,11 @@ void OpenGLGraphics::attachDrawTextureToFrameBuffer(uint32_t frameBufferID, Text
         }
             break;
         case TextureTypes::TCUBE_MAP_ARRAY: {
-            glFramebufferTexture(GL_FRAMEBUFFER, glAttachment, textureID, 0);
+            if(layer == -1 ) {
+                glFramebufferTexture(GL_FRAMEBUFFER, glAttachment, textureID, 0);
+            } else {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, glAttachment, textureID, 0, layer);//layer-face
+            }
         }
             break;
     }
@@ -1389,6 +1615,32 @@ OpenGLGraphics::loadTextureData(uint32_t textureID, int height, int width, Textu
     checkErrors("loadTextureData");
 }
 
+bool OpenGLGraphics::loadTextureData2DRegion(uint32_t textureID, int32_t x, int32_t y, uint32_t width, uint32_t height,
+                                     FormatTypes format, DataTypes dataType, const void *data) {
+    GLenum glFormat;
+    switch (format) {
+        case FormatTypes::RED: glFormat = GL_RED; break;
+        case FormatTypes::RGB: glFormat = GL_RGB; break;
+        case FormatTypes::RGBA: glFormat = GL_RGBA; break;
+        case FormatTypes::DEPTH: glFormat = GL_DEPTH_COMPONENT; break;
+    }
+
+    GLenum glDataType;
+    switch (dataType) {
+        case DataTypes::FLOAT: glDataType = GL_FLOAT; break;
+        case DataTypes::UNSIGNED_BYTE: glDataType = GL_UNSIGNED_BYTE; break;
+        case DataTypes::UNSIGNED_SHORT: glDataType = GL_UNSIGNED_SHORT; break;
+        case DataTypes::UNSIGNED_INT: glDataType = GL_UNSIGNED_INT; break;
+        case DataTypes::HALF_FLOAT: glDataType = GL_HALF_FLOAT; break;
+    }
+    state->activateTextureUnit(0);//this is the default working texture
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, glFormat, glDataType, data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    checkErrors("loadTextureData2DRegion");
+    return true;
+}
+
 
 void OpenGLGraphics::attachTexture(unsigned int textureID, unsigned int attachPoint) {
     state->attachTexture(textureID, attachPoint);
@@ -1502,6 +1754,42 @@ void OpenGLGraphics::setLight(const int lightIndex,
     checkErrors("setLight");
 }
 
+void OpenGLGraphics::setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                                        const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) {
+    /*
+    layout (std140) uniform ClusteredLightBlock {
+        vec4 depthParameters;
+        ClusteredLight lights[NR_MAX_CLUSTERED_LIGHTS];//4 vec4 each
+    } clusteredLights;
+    */
+    assert(lights.size() <= NR_MAX_CLUSTERED_LIGHTS * 4);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusteredLightUBOLocation);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::vec4), glm::value_ptr(clusterDepthParameters));
+    if(!lights.empty()) {
+        glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::vec4), sizeof(glm::vec4) * lights.size(), lights.data());
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    state->activateTextureUnit(maxTextureImageUnits-5);
+    state->attachTexture(lightClusterTexture, maxTextureImageUnits-5);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, GL_RG_INTEGER, GL_UNSIGNED_INT, clusterRanges.data());
+
+    //only the used rows are uploaded, last row might be partial
+    assert(lightIndices.size() <= NR_MAX_LIGHT_CLUSTER_INDICES);
+    uint32_t fullRowCount = lightIndices.size() / LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH;
+    uint32_t lastRowLength = lightIndices.size() % LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH;
+    state->activateTextureUnit(maxTextureImageUnits-6);
+    state->attachTexture(lightClusterIndexTexture, maxTextureImageUnits-6);
+    if(fullRowCount > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH, fullRowCount, GL_RED_INTEGER, GL_UNSIGNED_INT, lightIndices.data());
+    }
+    if(lastRowLength > 0) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRowCount, lastRowLength, 1, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                        lightIndices.data() + fullRowCount * LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH);
+    }
+    checkErrors("setClusteredLights");
+}
+
 void OpenGLGraphics::setMaterial(const Material& material) {
     /*
      * this buffer has 2 objects, model has mat4 and then the material below:
@@ -1530,15 +1818,24 @@ void OpenGLGraphics::setMaterial(const Material& material) {
 }
 
 void OpenGLGraphics::setModel(const uint32_t modelID, const glm::mat4& worldTransform) {
+    if(!modelTransformStaging.set(modelID, worldTransform)) {
+        std::cerr << "Model ID " << modelID << " is over the maximum model count " << NR_MAX_MODELS << ", transform is not set." << std::endl;
+    }
+}
+
+void OpenGLGraphics::flushModelTransforms() {
+    if(!modelTransformStaging.isDirty()) {
+        return;
+    }
     state->activateTextureUnit(maxTextureImageUnits-4);
     state->attachTexture(allModelTransformsTexture, maxTextureImageUnits-4);
-    glm::mat4 transposeInverse = glm::transpose(glm::inverse(worldTransform));
-    float data[32];
-    memcpy(data, glm::value_ptr(worldTransform), sizeof(float)*16);
-    memcpy((data+16), glm::value_ptr(transposeInverse), sizeof(float)*12);
-    glTexSubImage2D(GL_TEXTURE_2D,0,4*modelID, 0, 4, 2, GL_RGBA, GL_FLOAT, data);
-    //std::cout << "setting for model id " << modelID << std::endl;
-    checkErrors("setModel");
+    //staging keeps both rows with full texture width, so each range uploads world and transpose inverse rows together
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, modelTransformStaging.getRowLengthInTexels());
+    modelTransformStaging.flush([](uint32_t startModelID, uint32_t modelCount, const float* data) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 4 * startModelID, 0, 4 * modelCount, 2, GL_RGBA, GL_FLOAT, data);
+    });
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    checkErrors("flushModelTransforms");
 }
 
 void OpenGLGraphics::setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) {
@@ -24,12 +24,14 @@
 #include <GL/gl.h>
 #include <memory>
 #include <map>
+#include <deque>
 
 #endif/*__APPLE__*/
 
 
 #include "Options.h"
 #include "API/Graphics/GraphicsInterface.h"
+#include "API/Graphics/ModelTransformStaging.h"
 
 class Material;
 
@@ -208,6 +210,8 @@ private:
     uint32_t activeMaterialIndex;
 
     GLuint combineFrameBuffer;
+    GLuint copyFrameBuffer = 0;//read only frame buffer for texture to texture copies
+    GLuint depthCopyFrameBuffers[2] = {0, 0};//read and draw frame buffers for depth layer copies
 
     OptionsUtil::Options *options;
 
@@ -218,6 +222,12 @@ private:
 
     GLuint allModelTransformsTexture;
 
+    GLuint clusteredLightUBOLocation;
+    GLuint lightClusterTexture;
+    GLuint lightClusterIndexTexture;
+    const uint32_t clusteredLightUniformSize = sizeof(glm::vec4) + NR_MAX_CLUSTERED_LIGHTS * 4 * sizeof(glm::vec4);
+    ModelTransformStaging modelTransformStaging{NR_MAX_MODELS};
+
     glm::mat4 cameraMatrix;
     glm::mat4 perspectiveProjectionMatrix;
     glm::mat4 inverseProjection;
@@ -231,6 +241,21 @@ private:
     bool isProgramInterfaceQuerySupported = false;
     bool isFrameBufferParameterSupported = false;
     bool isDebugOutputSupported = false;
+    bool isTimerQuerySupported = false;
+    bool isProgramBinarySupported = false;
+
+    struct GPUTimer {
+        const char* name;
+        uint32_t depth;
+        GLuint startQuery;
+        GLuint endQuery;
+        bool ended;
+    };
+    static constexpr uint32_t MAX_GPU_TIMER_QUERIES = 1024;
+    std::vector<GLuint> allTimerQueries;
+    std::vector<GLuint> freeTimerQueries;
+    std::deque<GPUTimer> pendingGPUTimers;//begin order, deque keeps references valid on push_back
+    std::vector<GPUTimer*> openGPUTimers;
 
 public:
 
@@ -321,12 +346,21 @@ protected:
 
     uint32_t createGraphicsProgram(const std::string &vertexShaderFile, const std::string &geometryShaderFile, const std::string &fragmentShaderFile) override;
 
+    bool getProgramBinary(uint32_t programID, uint32_t& binaryFormat, std::vector<uint8_t>& binary) override;
+    uint32_t createGraphicsProgramFromBinary(uint32_t binaryFormat, const std::vector<uint8_t>& binary) override;
+
 public:
 
 
     explicit OpenGLGraphics(OptionsUtil::Options *options);
 
     GraphicsInterface::ContextInformation getContextInformation();
+    std::string getProgramBinaryIdentity() override;
+    bool copyTexture2DRegion(uint32_t sourceTextureID, uint32_t destinationTextureID, int32_t destinationX, int32_t destinationY, uint32_t width, uint32_t height) override;
+    bool copyDepthLayers(uint32_t sourceTextureID, uint32_t destinationTextureID, TextureTypes textureType, uint32_t firstLayer,
+                         uint32_t layerCount, uint32_t width, uint32_t height) override;
+    bool loadTextureData2DRegion(uint32_t textureID, int32_t x, int32_t y, uint32_t width, uint32_t height,
+                                 FormatTypes format, DataTypes dataType, const void *data) override;
     bool createGraphicsBackend();
 
     ~OpenGLGraphics();
@@ -451,6 +485,9 @@ public:
         checkErrors("removeLight");
     }
 
+    void setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                            const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) override;
+
     void setPlayerMatrices(const glm::vec3 &cameraPosition, const glm::mat4 &cameraMatrix, long currentTime) override;
 
     void switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled, bool depthWriteEnabled, bool scissorEnabled,
@@ -468,6 +505,12 @@ public:
 
     void setModel(const uint32_t modelID, const glm::mat4 &worldTransform) override;
 
+    void flushModelTransforms() override;
+
+    bool beginGPUTimer(const char* name) override;
+    void endGPUTimer() override;
+    void collectGPUTimers(std::vector<GPUTimerResult>& results) override;
+
     void setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) override;
 
     void attachModelIndicesUBO(const uint32_t programID) override;
@@ -3,101 +3,89 @@
 //
 
 #include <glm/ext.hpp>
+#include <btBulletCollisionCommon.h>
 #include "AIMovementGrid.h"
 
 constexpr float AIMovementGrid::floatingHeight;
 
-//FIXME: this must be the worst way to check for a node in a graph, when you already implemented a*
-std::shared_ptr<AIMovementNode>AIMovementGrid::isAlreadyVisited(const glm::vec3 &position, size_t &indexOf) {
-    if(visited.empty()) {
-        return nullptr;
-    }
-    for (size_t i = visited.size() - 1; i > 0; --i) {
-        if (isPositionCloseEnoughYOnly(position, visited[i]->getPosition())) {
-            indexOf = i;
-            return visited[i];
-        }
-    }
-    //because size_t wraps around, i>=0 is always true. Instead, = 0 case is below
-    if (isPositionCloseEnoughYOnly(position, visited[0]->getPosition())) {
-        indexOf = 0;
-        return visited[0];
-    }
-    return nullptr;
-}
-
-std::shared_ptr<const AIMovementNode>
-AIMovementGrid::aStarPath(std::shared_ptr<const AIMovementNode> start, const glm::vec3 &destination, uint32_t maximumNumberOfNodes,
-                          std::vector<glm::vec3> *route) {
-
-    std::priority_queue<AINodeWithPriority, std::vector<AINodeWithPriority>, std::greater<AINodeWithPriority>> frontier;
-    frontier.push(AINodeWithPriority(start, 0));
-
-    std::map<std::shared_ptr<const AIMovementNode>, std::shared_ptr<const AIMovementNode>> from;
-    std::map<std::shared_ptr<const AIMovementNode> , float> totalCost;
-    std::map<std::shared_ptr<const AIMovementNode> , uint32_t> totalNodes;
-    std::shared_ptr<const AIMovementNode> finalNode = nullptr;
-    from[start] = nullptr;
-    totalCost[start] = 0;
-    totalNodes[start] = 0;
-    while (!frontier.empty()) {
-        AINodeWithPriority nodeWithPriority = frontier.top();
-        //std::cout << "testing with a* " << GLMUtils::vectorToString(nodeWithPriority.node->getPosition()) << std::endl;
-        frontier.pop();
-        if (isPositionCloseEnough(destination, nodeWithPriority.node->getPosition())) {
-            finalNode = nodeWithPriority.node;
-            break;
+struct AIMovementGrid::GenerationContext {
+    /**
+     * Bullet reports touching contacts too, only penetration counts as collision, same as ghost object check.
+     */
+    struct PenetrationCallback : public btCollisionWorld::ContactResultCallback {
+        bool penetrating = false;
+
+        btScalar addSingleResult(btManifoldPoint &contactPoint, const btCollisionObjectWrapper *, int, int,
+                                 const btCollisionObjectWrapper *, int, int) override {
+            if (contactPoint.getDistance() < 0.f) {
+                penetrating = true;
+            }
+            return 0;
         }
-
-        if(maximumNumberOfNodes != 0 && (totalNodes.count(nodeWithPriority.node) != 0 && totalNodes[nodeWithPriority.node] >= maximumNumberOfNodes)) {
-            //we searched for this depth, but couldn't found the player no need to keep searching
-            break;
+    };
+
+    btDefaultCollisionConfiguration collisionConfiguration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    btCollisionWorld collisionWorld;
+    std::vector<btCollisionObject *> proxies;
+    btCollisionObject queryObject;
+    btCollisionWorld::ClosestRayResultCallback rayCallback;
+    uint32_t collisionGroup;
+    uint32_t collisionMask;
+
+    /**
+     * Proxies share shapes with the source objects, shapes are only read during tests.
+     */
+    GenerationContext(btCollisionWorld *sourceWorld, btCollisionShape *queryShape, uint32_t collisionGroup, uint32_t collisionMask) :
+            dispatcher(&collisionConfiguration),
+            collisionWorld(&dispatcher, &broadphase, &collisionConfiguration),
+            rayCallback(btVector3(0, 0, 0), btVector3(0, 0, 0)),
+            collisionGroup(collisionGroup), collisionMask(collisionMask) {
+        const btCollisionObjectArray &sourceObjects = sourceWorld->getCollisionObjectArray();
+        proxies.reserve(sourceObjects.size());
+        for (int i = 0; i < sourceObjects.size(); ++i) {
+            btCollisionObject *sourceObject = sourceObjects[i];
+            btCollisionObject *proxy = new btCollisionObject();
+            proxy->setCollisionShape(sourceObject->getCollisionShape());
+            proxy->setWorldTransform(sourceObject->getWorldTransform());
+            proxy->setCollisionFlags(sourceObject->getCollisionFlags());
+            const btBroadphaseProxy *sourceHandle = sourceObject->getBroadphaseHandle();
+            collisionWorld.addCollisionObject(proxy, sourceHandle->m_collisionFilterGroup, sourceHandle->m_collisionFilterMask);
+            proxies.push_back(proxy);
         }
+        queryObject.setCollisionShape(queryShape);
+    }
 
-        for (int i = 0; i < 9; ++i) {
-            std::shared_ptr<AIMovementNode> currentNode = nodeWithPriority.node->getNeighbour(i);
-            if (currentNode == nullptr) {
-                continue;
-            }
-            if (!currentNode->isIsMovable()) {
-                continue;//if not movable, it means we don't need its child
-            }
-            //make going cross a little harder
-            float movementCost = glm::length(currentNode->getPosition() - nodeWithPriority.node->getPosition());
-            float heuristic = glm::length(destination - currentNode->getPosition());
-            float currentCost = totalCost[nodeWithPriority.node] + movementCost + heuristic;
-            float currentNodeCount = totalNodes[nodeWithPriority.node] + 1;
-            if (!totalCost.count(currentNode) || currentCost < totalCost[currentNode]) {
-                //float currentPriority = currentCost + heuristic;
-//                std::cout << "for node " << GLMUtils::vectorToString(currentNode->getPosition()) << " priority is " << currentCost << " with heuristic " << heuristic << std::endl;
-                frontier.push(AINodeWithPriority(currentNode, currentCost));
-                from[currentNode] = nodeWithPriority.node;
-                totalCost[currentNode] = currentCost;
-                totalNodes[currentNode] = currentNodeCount;
-            }
+    ~GenerationContext() {
+        for (btCollisionObject *proxy : proxies) {
+            collisionWorld.removeCollisionObject(proxy);
+            delete proxy;
         }
-
     }
 
-    if (finalNode == nullptr) {
-        std::cerr << "Path search failed, please check the values: " << GLMUtils::vectorToString(start->getPosition())
-                  << " to " << GLMUtils::vectorToString(destination) << std::endl;
-        return finalNode;
-    } else {
-        if (start == finalNode) {
-            return finalNode;//don't put anything to the route;
-        }
-        route->clear();
-        route->push_back(finalNode->getPosition());
-        //std::cout << GLMUtils::vectorToString(finalNode->getPosition()) << ", " << (finalNode->isIsMovable()? " yes":"no") << std::endl;
-        std::shared_ptr<const AIMovementNode> fromNode = from[finalNode];
-        while (start != fromNode) {
-            route->push_back(fromNode->getPosition());
-            fromNode = from[fromNode];
-            //std::cout << GLMUtils::vectorToString(fromNode->getPosition()) << ", " << (fromNode->isIsMovable()? " yes":"no") << std::endl;
-        }
-        return finalNode;
+    bool isThereCollision(const glm::vec3 &position) {
+        queryObject.setWorldTransform(btTransform(btQuaternion::getIdentity(), GLMConverter::GLMToBlt(position)));
+        PenetrationCallback callback;
+        callback.m_collisionFilterGroup = collisionGroup;
+        callback.m_collisionFilterMask = collisionMask;
+        collisionWorld.contactTest(&queryObject, callback);
+        return callback.penetrating;
     }
+};
+
+void AIMovementGrid::buildNavigationGraph() {
+    std::vector<std::shared_ptr<AIMovementNode>> allNodes;
+    allNodes.reserve(doneNodes.size() + visited.size());
+    allNodes.insert(allNodes.end(), doneNodes.begin(), doneNodes.end());
+    allNodes.insert(allNodes.end(), visited.begin(), visited.end());
+    navigationGraph = std::make_unique<AINavigationGraph>(allNodes);
+}
+
+bool AIMovementGrid::setProperHeight(glm::vec3 *position, float floatingHeight, float checkHeight,
+                                     btDiscreteDynamicsWorld *staticWorld) const {
+    btCollisionWorld::ClosestRayResultCallback rayCallback(btVector3(0, 0, 0), btVector3(0, 0, 0));
+    return setProperHeight(position, floatingHeight, checkHeight, staticWorld, rayCallback);
 }
 
 /**
@@ -109,241 +97,223 @@ AIMovementGrid::aStarPath(std::shared_ptr<const AIMovementNode> start, const glm
  * @param position
  * @param floatingHeight
  * @param checkHeight
- * @param staticWorld
+ * @param world
+ * @param rayCallback
  * @return
  */
-bool AIMovementGrid::setProperHeight(glm::vec3 *position, float floatingHeight, float checkHeight,
-                                     btDiscreteDynamicsWorld *staticWorld) {
-    rayCallback->m_rayFromWorld = GLMConverter::GLMToBlt(*position);
+bool AIMovementGrid::setProperHeight(glm::vec3 *position, float floatingHeight, float checkHeight, btCollisionWorld *world,
+                                     btCollisionWorld::ClosestRayResultCallback &rayCallback) {
+    rayCallback.m_rayFromWorld = GLMConverter::GLMToBlt(*position);
     if (checkHeight == 0.0) {
-        rayCallback->m_rayToWorld = GLMConverter::GLMToBlt(
+        rayCallback.m_rayToWorld = GLMConverter::GLMToBlt(
                 *position - glm::vec3(0, 9999999, 0));//Normally, we expect world aabb min y here, but it is not passed.
     } else {
-        rayCallback->m_rayToWorld = GLMConverter::GLMToBlt(*position - glm::vec3(0, checkHeight, 0));
+        rayCallback.m_rayToWorld = GLMConverter::GLMToBlt(*position - glm::vec3(0, checkHeight, 0));
     }
-    rayCallback->m_closestHitFraction = 1;
-    rayCallback->m_collisionObject = nullptr;
-    staticWorld->rayTest(rayCallback->m_rayFromWorld, rayCallback->m_rayToWorld, *rayCallback);
-    if (rayCallback->hasHit()) {
-        if(rayCallback->m_hitPointWorld.getY() > (*position - glm::vec3(0, 1, 0)).y) {
+    rayCallback.m_closestHitFraction = 1;
+    rayCallback.m_collisionObject = nullptr;
+    world->rayTest(rayCallback.m_rayFromWorld, rayCallback.m_rayToWorld, rayCallback);
+    if (rayCallback.hasHit()) {
+        if(rayCallback.m_hitPointWorld.getY() > (*position - glm::vec3(0, 1, 0)).y) {
             return false;
         }
-        position->y = rayCallback->m_hitPointWorld.getY() + floatingHeight;
+        position->y = rayCallback.m_hitPointWorld.getY() + floatingHeight;
         return true;
     } else {
         return false;
     }
 }
 
+/**
+ * Walks the world breadth first, one level of the frontier at a time:
+ * 1) heights of all neighbour positions are found, in parallel
+ * 2) neighbours are matched to visited nodes, or new nodes are created. This is serial, so IDs don't depend on threads
+ * 3) new nodes are checked for collision, in parallel
+ * 4) movable new nodes become the next frontier
+ */
 std::shared_ptr<AIMovementNode>
 AIMovementGrid::walkMonster(glm::vec3 walkPoint, btDiscreteDynamicsWorld *staticWorld, const glm::vec3 &min,
-                            const glm::vec3 &max, uint32_t collisionGroup, uint32_t collisionMask) {
-    std::queue<std::shared_ptr<AIMovementNode>> frontier;
-    if (!setProperHeight(&walkPoint, floatingHeight, std::fabs(walkPoint.y -1 * min.y), staticWorld)) {
+                            const glm::vec3 &max, uint32_t collisionGroup, uint32_t collisionMask,
+                            SDL2MultiThreading::JobSystem *jobSystem, const ProgressCallback &progressCallback) {
+    struct Candidate {
+        glm::vec3 position;
+        bool needed;
+        bool heightFound;
+    };
+    struct NewNode {
+        std::shared_ptr<AIMovementNode> node;
+        bool isMovable;
+    };
+
+    //contexts are built on this thread, workers never touch the physics world
+    std::vector<std::unique_ptr<GenerationContext>> contexts;
+    uint32_t contextCount = jobSystem == nullptr ? 1 : jobSystem->getWorkerCount() + 1;
+    for (uint32_t i = 0; i < contextCount; ++i) {
+        contexts.push_back(std::make_unique<GenerationContext>(staticWorld, ghostShape, collisionGroup, collisionMask));
+    }
+
+    //each context is used by a single job, so work is split to as many parts as contexts
+    auto runParallel = [&contexts, jobSystem](uint32_t workCount, const std::function<void(GenerationContext &, uint32_t, uint32_t)> &work) {
+        uint32_t partCount = (uint32_t) contexts.size();
+        //first levels are a few nodes, not worth the job overhead
+        if (partCount == 1 || workCount < partCount * 4) {
+            work(*contexts[0], 0, workCount);
+            return;
+        }
+        uint32_t partSize = (workCount + partCount - 1) / partCount;
+        SDL2MultiThreading::JobSystem::Counter counter;
+        jobSystem->parallelFor(partCount, 1, [&contexts, &work, partSize, workCount](uint32_t firstPart, uint32_t lastPart) {
+            for (uint32_t part = firstPart; part < lastPart; ++part) {
+                uint32_t start = std::min(workCount, part * partSize);
+                uint32_t end = std::min(workCount, start + partSize);
+                if (start < end) {
+                    work(*contexts[part], start, end);
+                }
+            }
+        }, &counter);
+        jobSystem->waitFor(&counter);
+    };
+
+    GenerationContext &mainContext = *contexts[0];
+    if (!setProperHeight(&walkPoint, floatingHeight, std::fabs(walkPoint.y -1 * min.y), &mainContext.collisionWorld, mainContext.rayCallback)) {
         std::cerr << "Root node " << glm::to_string(walkPoint)<< " has nothing underneath, grid generation failed. " << std::endl;
         return root;
     }
 
     std::shared_ptr<AIMovementNode>root = std::make_shared<AIMovementNode>(getNextID(), walkPoint);
-    staticWorld->addCollisionObject(sharedGhostObject, collisionGroup, collisionMask);
-    sharedGhostObject->setWorldTransform(
-            btTransform(btQuaternion::getIdentity(), GLMConverter::GLMToBlt(root->getPosition())));
-    btVector3 minO, maxO;
-    sharedGhostObject->getCollisionShape()->getAabb(sharedGhostObject->getWorldTransform(), minO, maxO);
-    bool isMovable = !isThereCollision(staticWorld);
-    staticWorld->removeCollisionObject(sharedGhostObject);
+    isThereCollisionCounter++;
+    bool isMovable = !mainContext.isThereCollision(root->getPosition());
+    std::vector<std::shared_ptr<AIMovementNode>> frontier;
+    VisitedIndex visitedIndex(walkPoint);
     if (isMovable) {
         root->setIsMovable(isMovable);
-        frontier.push(root);
-        visited.push_back(root);
+        frontier.push_back(root);
+        visitedIndex.add(root);
 
         std::cerr << "Root node " << GLMUtils::vectorToString(walkPoint) << "is movable, AI walk grid generation starts." << std::endl;
     } else {
         std::cerr << "Root node " << GLMUtils::vectorToString(walkPoint) << "is not movable, AI walk grid generation failed. Please check map." << std::endl;
         return root;
     }
-    size_t indexOfFoundNode;
-    std::shared_ptr<AIMovementNode> current;
-    while (!frontier.empty()) {
-        current = frontier.front();
-        frontier.pop();
+    this->min = walkPoint;
+    this->max = walkPoint;
 
-        if(doneNodes.size() %10000 == 0) {
-            std::cout << "After "<< SDL_GetTicks() << " current done " << doneNodes.size() << " nodes, partial " << visited.size() << " last node: " << glm::to_string(current->getPosition()) << std::endl;
-        }
-
-        for (int i = -1; i <= 1; ++i) {
-            for (int j = -1; j <= 1; ++j) {
-                if (i == 0 && j == 0) {
-                    continue; //skip the center, it is the self
-                } else {
-                    int neighbourIndex = (i + 1) * 3 + (j + 1);
-                    if(current->getNeighbour(neighbourIndex) != nullptr) {
-                        continue;//already set
-                    }
-                    isMovable = true;
-                    glm::vec3 neighbourPosition = current->getPosition() + glm::vec3(i, 0, j);
-                    if (!setProperHeight(&neighbourPosition, floatingHeight, floatingHeight + 1.0f, staticWorld)) {
-                        isMovable = false;
-                    }
-
-                    if (neighbourPosition.x < min.x || neighbourPosition.y < min.y || neighbourPosition.z < min.z ||
-                        neighbourPosition.x > max.x || neighbourPosition.y > max.y || neighbourPosition.z > max.z) {
-                        //this means this position is out of whole world AABB, skip
-                        continue;
-                    }
-
-                    std::shared_ptr<AIMovementNode> visitedNode = isAlreadyVisited(neighbourPosition, indexOfFoundNode);
-                    if (visitedNode != nullptr) {
-                        //std::cout << "already visited node at " << GLMUtils::vectorToString(neighbourPosition) << std::endl;
-                        //std::cout << "already visited node position is " << GLMUtils::vectorToString(visitedNode->getPosition()) << std::endl;
-                        current->setNeighbour(neighbourIndex, visitedNode);
-                    } else {
-                        //std::cout << "adding new node with position " << GLMUtils::vectorToString(neighbourPosition) << std::endl;
-                        staticWorld->addCollisionObject(sharedGhostObject, collisionGroup, collisionMask);
-                        sharedGhostObject->setWorldTransform(
-                                btTransform(btQuaternion::getIdentity(), GLMConverter::GLMToBlt(neighbourPosition)));
-                        isMovable = isMovable && !isThereCollision(staticWorld);
-                        staticWorld->removeCollisionObject(sharedGhostObject);
-
-
-                        std::shared_ptr<AIMovementNode> neighbour =std::make_shared<AIMovementNode>(getNextID(), neighbourPosition);
-                        neighbour->setIsMovable(isMovable);
-                        current->setNeighbour(neighbourIndex, neighbour);
-                        visited.push_back(neighbour);
-                        if(isMovable) {
-                            frontier.push(neighbour);
+    std::vector<Candidate> candidates;
+    std::vector<NewNode> newNodes;
+    std::vector<std::shared_ptr<AIMovementNode>> nextFrontier;
+    while (!frontier.empty()) {
+        //1) 8 candidates per node, at the neighbour index. Center is kept so indexes match, it is never needed
+        candidates.resize(frontier.size() * 9);
+        runParallel((uint32_t) frontier.size(), [&frontier, &candidates](GenerationContext &context, uint32_t start, uint32_t end) {
+            for (uint32_t nodeIndex = start; nodeIndex < end; ++nodeIndex) {
+                const std::shared_ptr<AIMovementNode> &current = frontier[nodeIndex];
+                for (int i = -1; i <= 1; ++i) {
+                    for (int j = -1; j <= 1; ++j) {
+                        int neighbourIndex = (i + 1) * 3 + (j + 1);
+                        Candidate &candidate = candidates[nodeIndex * 9 + neighbourIndex];
+                        //skip the center, it is the self. Also skip already set ones
+                        candidate.needed = !(i == 0 && j == 0) && current->getNeighbour(neighbourIndex) == nullptr;
+                        if (!candidate.needed) {
+                            continue;
                         }
+                        candidate.position = current->getPosition() + glm::vec3(i, 0, j);
+                        candidate.heightFound = setProperHeight(&candidate.position, floatingHeight, floatingHeight + 1.0f,
+                                                                &context.collisionWorld, context.rayCallback);
                     }
                 }
             }
-        }
-        if(isAlreadyVisited(current->getPosition(), indexOfFoundNode)) {
-            visited.erase(visited.begin() + indexOfFoundNode);
-        }
-
-        doneNodes.push_back(current);
-        if(current->getPosition().x > this->max.x) { this->max.x = current->getPosition().x;}
-        if(current->getPosition().y > this->max.y) { this->max.y = current->getPosition().y;}
-        if(current->getPosition().z > this->max.z) { this->max.z = current->getPosition().z;}
-
-        if(current->getPosition().x < this->min.x) { this->min.x = current->getPosition().x;}
-        if(current->getPosition().y < this->min.y) { this->min.y = current->getPosition().y;}
-        if(current->getPosition().z < this->min.z) { this->min.z = current->getPosition().z;}
-
-    }
-
-    std::cout << "Walk grid creation finished with " << doneNodes.size() << " nodes between " << glm::to_string(this->min) << ", " << glm::to_string(this->max) << std::endl;
-    return root;
-}
+        });
+
+        //2) link or create, in the same order as the single threaded walk
+        newNodes.clear();
+        for (size_t nodeIndex = 0; nodeIndex < frontier.size(); ++nodeIndex) {
+            const std::shared_ptr<AIMovementNode> &current = frontier[nodeIndex];
+            for (int neighbourIndex = 0; neighbourIndex < 9; ++neighbourIndex) {
+                const Candidate &candidate = candidates[nodeIndex * 9 + neighbourIndex];
+                if (!candidate.needed || current->getNeighbour(neighbourIndex) != nullptr) {
+                    continue;
+                }
+                const glm::vec3 &neighbourPosition = candidate.position;
+                if (neighbourPosition.x < min.x || neighbourPosition.y < min.y || neighbourPosition.z < min.z ||
+                    neighbourPosition.x > max.x || neighbourPosition.y > max.y || neighbourPosition.z > max.z) {
+                    //this means this position is out of whole world AABB, skip
+                    continue;
+                }
 
-bool AIMovementGrid::isThereCollision(btDiscreteDynamicsWorld *staticWorld) {
-    isThereCollisionCounter++;
-    staticWorld->updateAabbs();//this should not be needed, but it is. I have no idea why
-    staticWorld->getDispatcher()->dispatchAllCollisionPairs(sharedGhostObject->getOverlappingPairCache(),
-                                                            staticWorld->getDispatchInfo(),
-                                                            staticWorld->getDispatcher());
-    btBroadphasePairArray &pairArray = sharedGhostObject->getOverlappingPairCache()->getOverlappingPairArray();
-    int numPairs = pairArray.size();
-
-    for (int i = 0; i < numPairs; ++i) {
-        const btBroadphasePair &pair = pairArray[i];
-
-        if (pair.m_algorithm) {
-            pair.m_algorithm->getAllContactManifolds(sharedManifoldArray);
+                std::shared_ptr<AIMovementNode> visitedNode = visitedIndex.find(neighbourPosition);
+                if (visitedNode != nullptr) {
+                    current->setNeighbour(neighbourIndex, visitedNode);
+                } else {
+                    std::shared_ptr<AIMovementNode> neighbour = std::make_shared<AIMovementNode>(getNextID(), neighbourPosition);
+                    current->setNeighbour(neighbourIndex, neighbour);
+                    visitedIndex.add(neighbour);
+                    newNodes.push_back(NewNode{neighbour, candidate.heightFound});
+                }
+            }
         }
 
-        for (int j = 0; j < sharedManifoldArray.size(); j++) {
-            btPersistentManifold *manifold = sharedManifoldArray[j];
-            for (int p = 0; p < manifold->getNumContacts(); ++p) {
-                const btManifoldPoint &pt = manifold->getContactPoint(p);
-
-                if (pt.getDistance() < 0.f) {
-                    // There is a collision
-                    return true;
-                }
+        //3) collision check for new nodes that has ground under them
+        runParallel((uint32_t) newNodes.size(), [&newNodes](GenerationContext &context, uint32_t start, uint32_t end) {
+            for (uint32_t i = start; i < end; ++i) {
+                newNodes[i].isMovable = newNodes[i].isMovable && !context.isThereCollision(newNodes[i].node->getPosition());
+            }
+        });
+        isThereCollisionCounter += (int) newNodes.size();
+
+        //4) expanded nodes are done, movable new nodes are expanded next, rest are only kept as edges
+        for (const std::shared_ptr<AIMovementNode> &current : frontier) {
+            doneNodes.push_back(current);
+            this->min = glm::min(this->min, current->getPosition());
+            this->max = glm::max(this->max, current->getPosition());
+        }
+        nextFrontier.clear();
+        for (const NewNode &newNode : newNodes) {
+            newNode.node->setIsMovable(newNode.isMovable);
+            if (newNode.isMovable) {
+                nextFrontier.push_back(newNode.node);
+            } else {
+                visited.push_back(newNode.node);
             }
         }
-        sharedManifoldArray.resize(0);
+        frontier.swap(nextFrontier);
 
+        if (progressCallback) {
+            progressCallback((uint32_t) doneNodes.size(), (uint32_t) frontier.size());
+        }
     }
-    return false;
+
+    std::cout << "Walk grid creation finished with " << doneNodes.size() << " nodes between " << glm::to_string(this->min) << ", " << glm::to_string(this->max) << std::endl;
+    return root;
 }
 
 AIMovementGrid::AIMovementGrid(glm::vec3 startPoint, btDiscreteDynamicsWorld *staticOnlyPhysicsWorld, glm::vec3 min,
-                               glm::vec3 max, uint32_t collisionGroup, uint32_t collisionMask) {
-    //sharedGhostObject->setCollisionShape(new btBoxShape(btVector3(1.0f,1.0f,1.0f)));
-    //sharedGhostObject->setCollisionShape(new btCapsuleShape(1,1));
+                               glm::vec3 max, uint32_t collisionGroup, uint32_t collisionMask,
+                               SDL2MultiThreading::JobSystem *jobSystem, ProgressCallback progressCallback) {
     ghostShape = new btCapsuleShape(capsuleRadius, capsuleHeight);
 
-    sharedGhostObject->setCollisionShape(ghostShape);
-    sharedGhostObject->setCollisionFlags(
-            sharedGhostObject->getCollisionFlags());
-    sharedGhostObject->setWorldTransform(btTransform(btQuaternion::getIdentity(), GLMConverter::GLMToBlt(startPoint)));
     std::cout << "Start generating AI walk grid" << std::endl;
+    long start = SDL_GetTicks();
     doneNodes.push_back(std::make_shared<AIMovementNode>(0, glm::vec3(0,200,0)));//0 index element should be empty
-    root = walkMonster(startPoint, staticOnlyPhysicsWorld, min, max, collisionGroup, collisionMask);
-    std::cout << "Finished generating AI walk grid, created " << visited.size() << " nodes, checked for collision "
-              << isThereCollisionCounter << " times." << std::endl;
-    staticOnlyPhysicsWorld->removeCollisionObject(sharedGhostObject);
+    root = walkMonster(startPoint, staticOnlyPhysicsWorld, min, max, collisionGroup, collisionMask, jobSystem, progressCallback);
+    std::cout << "Finished generating AI walk grid in " << SDL_GetTicks() - start << " ms, created " << nextPossibleIndex - 1
+              << " nodes, checked for collision " << isThereCollisionCounter << " times." << std::endl;
+    buildNavigationGraph();
 }
 
 bool
-AIMovementGrid::coursePath(const glm::vec3 &from, const glm::vec3 &to, uint32_t actorId, uint32_t maximumNumberOfNodes, std::vector<glm::vec3> *route) {
-
-    //first search for from node.
-    std::shared_ptr<const AIMovementNode> fromAINode = nullptr;
-    if (actorLastNodeMap.find(actorId) != actorLastNodeMap.end()) {
-        //if we already processed this actor before, use the last position of that actor we know
-        fromAINode = actorLastNodeMap[actorId];
-    } else {
-        //if we never processed this actor, use root node for search start.
-        fromAINode = root;
-    }
-    if (fromAINode == nullptr) {
-        std::cerr << "Old from node turned out to be NULL. This shouldn't have happened" << std::endl;
-        return false;
-    }
-
-    //search where the actor is
-    fromAINode = aStarPath(fromAINode, from, 0, route);//0 means search whole map
-
-    if (fromAINode == nullptr) {
-        std::cerr << "new from node can't be found, this means snap distance is too small." << std::endl;
-        return false;
-    }
-
-    //save actor position to use on later calls
-    actorLastNodeMap[actorId] = fromAINode;
-
-    std::shared_ptr<const AIMovementNode >finalNode = aStarPath(fromAINode, to, maximumNumberOfNodes, route);
-
-    if (finalNode == nullptr) {
-        std::cerr << "Destination can't be reached, most likely player moved to somewhere AI can't." << std::endl;
-        return false;
-    } else {
-        return true;
-    }
+AIMovementGrid::coursePath(const glm::vec3 &from, const glm::vec3 &to, uint32_t actorId [[gnu::unused]], uint32_t maximumNumberOfNodes, std::vector<glm::vec3> *route) {
+    //actor position used to be cached to shorten the search for from node, spatial lookup doesn't need it
+    return navigationGraph->findRoute(from, to, maximumNumberOfNodes, route);
 }
 
 bool AIMovementGrid::coursePath(const glm::vec3 &from, const glm::vec3 &to, uint32_t maximumNumberOfNodes, std::vector<glm::vec3> *route) {
-    //first start by finding the from point. We should  cache these from values at some point, so we don't a* twice all the time
-    std::shared_ptr<const AIMovementNode> fromAINode;
-
     long start = SDL_GetTicks();
 
-    fromAINode = aStarPath(root, from, 0, route);
-    if (fromAINode == nullptr) {
-        return false;
-    }
-
-    aStarPath(fromAINode, to, maximumNumberOfNodes, route);
+    bool found = navigationGraph->findRoute(from, to, maximumNumberOfNodes, route);
     long end = SDL_GetTicks();
     std::cout << "route set " << end - start << std::endl;
 
-
-
-    return true;
+    return found;
 }
 
 void AIMovementGrid::debugDraw(BulletDebugDrawer *debugDrawer) const {
@@ -604,5 +574,6 @@ AIMovementGrid *AIMovementGrid::deserialize(const std::string &fileName) {
         nodeElement =  nodeElement->NextSiblingElement("Node");
     }
     std::cout << "AI Walk grid read successful" << std::endl;
+    grid->buildNavigationGraph();
     return grid;
 }
@@ -15,6 +15,8 @@
 #include <vector>
 #include <queue>
 #include <unordered_set>
+#include <unordered_map>
+#include <functional>
 #include <map>
 
 #ifdef CEREAL_SUPPORT
@@ -26,69 +28,94 @@
 #endif
 
 #include "AIMovementNode.h"
+#include "AINavigationGraph.h"
 #include "../Utils/GLMConverter.h"
 #include "../Utils/GLMUtils.h"
 #include "../BulletDebugDrawer.h"
+#include "../SDL2MultiThreading.h"
 
 
 
-//bigger than sqrt(3)/2
-//avoiding sqrt
-#define GRID_SNAP_DISTANCE (0.8f * 0.8f)
-
 #define X_Z_DISTANCE 0.1
 #define Y_DISTANCE_SQ 0.25
 
 class AIMovementGrid {
+public:
+    /**
+     * Called after each step of generation with number of finished nodes, and nodes waiting to be expanded.
+     */
+    typedef std::function<void(uint32_t processedNodeCount, uint32_t frontierNodeCount)> ProgressCallback;
 
-    struct AINodeWithPriority {
-        std::shared_ptr<const AIMovementNode> node;
-        float priority;
-
-        AINodeWithPriority(std::shared_ptr<const AIMovementNode> node, float priority) : node(node), priority(priority) {}
-
-        bool operator>(const AINodeWithPriority &aiRight) const {
-            return priority > aiRight.priority;
-        }
-    };
-
-    bool inline isPositionCloseEnoughYOnly(const glm::vec3 &position1, const glm::vec3 &position2) const {
+private:
+    static bool inline isPositionCloseEnoughYOnly(const glm::vec3 &position1, const glm::vec3 &position2) {
         return ((fabs(position1.x - position2.x) < X_Z_DISTANCE) &&
                 (fabs(position1.z - position2.z) < X_Z_DISTANCE) &&
                 (((position1.y - position2.y) * (position1.y - position2.y)) <= Y_DISTANCE_SQ));
     }
 
-    bool inline isPositionCloseEnough(const glm::vec3 &position1, const glm::vec3 &position2) const {
-        return (glm::length2(position1 - position2) < GRID_SNAP_DISTANCE);
-    }
+    /**
+     * Generation state owned by a single thread. Holds a private collision world with proxies of the static world
+     * objects, so ray and contact tests can run in parallel without touching the physics world.
+     */
+    struct GenerationContext;
+
+    /**
+     * Nodes hashed by grid cell, relative to the root. Nodes are placed 1 unit apart on x and z, a cell can have more
+     * than one node only if they are on different heights.
+     */
+    class VisitedIndex {
+        glm::vec3 origin;
+        std::unordered_map<uint64_t, std::vector<std::shared_ptr<AIMovementNode>>> cells;
+
+        uint64_t getCellKey(const glm::vec3 &position) const {
+            int32_t x = (int32_t)std::lround(position.x - origin.x);
+            int32_t z = (int32_t)std::lround(position.z - origin.z);
+            return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+        }
+
+    public:
+        explicit VisitedIndex(const glm::vec3 &origin) : origin(origin) {}
+
+        void add(std::shared_ptr<AIMovementNode> node) {
+            cells[getCellKey(node->getPosition())].push_back(node);
+        }
+
+        std::shared_ptr<AIMovementNode> find(const glm::vec3 &position) const {
+            auto cellIt = cells.find(getCellKey(position));
+            if(cellIt == cells.end()) {
+                return nullptr;
+            }
+            for (const std::shared_ptr<AIMovementNode> &node : cellIt->second) {
+                if(isPositionCloseEnoughYOnly(position, node->getPosition())) {
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+    };
 
     std::shared_ptr<AIMovementNode> root = nullptr;
     btCollisionShape *ghostShape = nullptr;
-    btPairCachingGhostObject *sharedGhostObject = new btPairCachingGhostObject();
-    btCollisionWorld::ClosestRayResultCallback *rayCallback = new btCollisionWorld::ClosestRayResultCallback(
-            btVector3(0, 0, 0), btVector3(0, 0, 0));
-    btManifoldArray sharedManifoldArray;
-    std::map<int, std::shared_ptr<const AIMovementNode>> actorLastNodeMap;
+    std::unique_ptr<AINavigationGraph> navigationGraph;//used for route search, built from nodes after load or generation
     uint32_t nextPossibleIndex = 1;//this is to be used internal and constructor only. Not thread safe
 
     int isThereCollisionCounter = 0;//this is only meaningful for debug
     float capsuleHeight = 1.30f + 0.1f;
     float capsuleRadius = 0.35f;//FIXME these should be configurable
-    bool isThereCollision(btDiscreteDynamicsWorld *staticWorld);
 
     glm::vec3 max,min;
     std::vector<std::shared_ptr<AIMovementNode>> visited;
     std::vector<std::shared_ptr<AIMovementNode>> doneNodes;
 
-    std::shared_ptr<AIMovementNode> isAlreadyVisited(const glm::vec3 &position, size_t &indexOf);
-
     std::shared_ptr<AIMovementNode>
     walkMonster(glm::vec3 walkPoint, btDiscreteDynamicsWorld *staticWorld, const glm::vec3 &min,
-                    const glm::vec3 &max, uint32_t collisionGroup, uint32_t collisionMask);
+                    const glm::vec3 &max, uint32_t collisionGroup, uint32_t collisionMask,
+                    SDL2MultiThreading::JobSystem *jobSystem, const ProgressCallback &progressCallback);
+
+    static bool setProperHeight(glm::vec3 *position, float floatingHeight, float checkHeight, btCollisionWorld *world,
+                                btCollisionWorld::ClosestRayResultCallback &rayCallback);
 
-    std::shared_ptr<const AIMovementNode>
-    aStarPath(std::shared_ptr<const AIMovementNode>start, const glm::vec3 &destination, uint32_t maximumNumberOfNodes,
-                  std::vector<glm::vec3> *route);
+    void buildNavigationGraph();
 
     uint32_t getNextID() {
         return nextPossibleIndex++;
@@ -102,14 +129,16 @@ class AIMovementGrid {
 public:
     static constexpr float floatingHeight = 2.0f;
 
+    /**
+     * Generates the grid by walking from start point. If jobSystem is given, each step of the walk is spread to its
+     * workers, calling thread also works and blocks until generation is finished.
+     */
     AIMovementGrid(glm::vec3 startPoint, btDiscreteDynamicsWorld *staticOnlyPhysicsWorld, glm::vec3 min,
-                       glm::vec3 max, uint32_t collisionGroup, uint32_t collisionMask);
+                       glm::vec3 max, uint32_t collisionGroup, uint32_t collisionMask,
+                       SDL2MultiThreading::JobSystem *jobSystem = nullptr, ProgressCallback progressCallback = nullptr);
 
     ~AIMovementGrid() {
-        delete rayCallback;
-        delete sharedGhostObject;
         delete ghostShape;
-
     }
 
     bool coursePath(const glm::vec3 &from, const glm::vec3 &to, uint32_t actorId, uint32_t maximumNumberOfNodes,
@@ -117,10 +146,17 @@ public:
 
     bool coursePath(const glm::vec3 &from, const glm::vec3 &to, uint32_t maximumNumberOfNodes, std::vector<glm::vec3> *route);
 
+    AINavigationGraph* getNavigationGraph() const {
+        return navigationGraph.get();
+    }
+
     void debugDraw(BulletDebugDrawer *debugDrawer) const;
 
+    /**
+     * Thread safe, as long as physics world is not changed at the same time.
+     */
     bool setProperHeight(glm::vec3 *position, float floatingHeight, float checkHeight,
-                         btDiscreteDynamicsWorld *staticWorld);
+                         btDiscreteDynamicsWorld *staticWorld) const;
 
     bool serializeXML(const std::string& fileName);
 
@@ -204,9 +240,21 @@ public:
         if(doneNodes.size() > 1) {
             root = doneNodes[1];
         }
+        buildNavigationGraph();
 
     }
 
+    bool serializeBinary(const std::string& fileName) const {
+        std::ofstream os(fileName, std::ios::binary);
+        if(os.fail()) {
+            std::cerr << "Binary AI walk grid write to " << fileName << " failed." << std::endl;
+            return false;
+        }
+        cereal::BinaryOutputArchive archive(os);
+        archive(*this);
+        return true;
+    }
+
     static AIMovementGrid* deserializeBinary(const std::string& fileName) {
         std::ifstream is(fileName, std::ios::binary);
         if( is.fail()) {
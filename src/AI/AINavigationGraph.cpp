@@ -0,0 +1,444 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+#include <glm/gtx/norm.hpp>
+#include "AINavigationGraph.h"
+#include "../Utils/GLMUtils.h"
+
+const uint32_t AINavigationGraph::INVALID_INDEX;
+const uint32_t AINavigationGraph::NEIGHBOUR_COUNT;
+const int32_t AINavigationGraph::CLUSTER_SIZE;
+const size_t AINavigationGraph::MAX_CACHED_TARGETS;
+const size_t AINavigationGraph::MAX_CACHED_PATHS_PER_TARGET;
+
+AINavigationGraph::SearchContext::SearchContext(size_t nodeCount, size_t clusterCount) :
+        nodeStamps(nodeCount, 0), nodeClosedStamps(nodeCount, 0), nodeCosts(nodeCount), nodeDepths(nodeCount),
+        nodeParents(nodeCount), clusterStamps(clusterCount, 0), clusterClosedStamps(clusterCount, 0),
+        clusterCosts(clusterCount), clusterParents(clusterCount), corridorStamps(clusterCount, 0) {}
+
+uint32_t AINavigationGraph::SearchContext::nextGeneration() {
+    generation++;
+    if(generation == std::numeric_limits<uint32_t>::max()) {
+        //wrapped, old stamps might collide with new generations
+        std::fill(nodeStamps.begin(), nodeStamps.end(), 0);
+        std::fill(nodeClosedStamps.begin(), nodeClosedStamps.end(), 0);
+        std::fill(clusterStamps.begin(), clusterStamps.end(), 0);
+        std::fill(clusterClosedStamps.begin(), clusterClosedStamps.end(), 0);
+        std::fill(corridorStamps.begin(), corridorStamps.end(), 0);
+        corridorGeneration = 0;
+        generation = 1;
+    }
+    return generation;
+}
+
+AINavigationGraph::AINavigationGraph(const std::vector<std::shared_ptr<AIMovementNode>> &movementNodes) {
+    std::unordered_map<const AIMovementNode*, uint32_t> nodeIndices;
+    for (const auto &movementNode : movementNodes) {
+        if(movementNode == nullptr || !movementNode->isIsMovable() || nodeIndices.count(movementNode.get()) != 0) {
+            continue;
+        }
+        nodeIndices[movementNode.get()] = (uint32_t) positions.size();
+        positions.push_back(movementNode->getPosition());
+    }
+    if(positions.empty()) {
+        std::cerr << "AI walk grid has no movable nodes, routes can't be found." << std::endl;
+        return;
+    }
+    origin = positions[0];
+
+    neighbours.resize(positions.size() * NEIGHBOUR_COUNT, INVALID_INDEX);
+    neighbourCosts.resize(positions.size() * NEIGHBOUR_COUNT, 0.0f);
+    for (const auto &movementNode : movementNodes) {
+        auto nodeIt = movementNode == nullptr ? nodeIndices.end() : nodeIndices.find(movementNode.get());
+        if(nodeIt == nodeIndices.end()) {
+            continue;
+        }
+        uint32_t neighbourSlot = nodeIt->second * NEIGHBOUR_COUNT;
+        for (int i = 0; i < 9; ++i) {
+            if(i == 4) {
+                continue;//4 is self
+            }
+            std::shared_ptr<AIMovementNode> neighbour = movementNode->getNeighbour(i);
+            auto neighbourIt = neighbour == nullptr ? nodeIndices.end() : nodeIndices.find(neighbour.get());
+            if(neighbourIt != nodeIndices.end()) {
+                neighbours[neighbourSlot] = neighbourIt->second;
+                neighbourCosts[neighbourSlot] = glm::length(neighbour->getPosition() - movementNode->getPosition());
+            }
+            neighbourSlot++;
+        }
+    }
+
+    //reverse edges, flow fields are searched from the target
+    incomingOffsets.assign(positions.size() + 1, 0);
+    for (uint32_t neighbour : neighbours) {
+        if(neighbour != INVALID_INDEX) {
+            incomingOffsets[neighbour + 1]++;
+        }
+    }
+    for (size_t i = 1; i < incomingOffsets.size(); ++i) {
+        incomingOffsets[i] += incomingOffsets[i - 1];
+    }
+    incomingSlots.resize(incomingOffsets.back());
+    std::vector<uint32_t> incomingFill(incomingOffsets.begin(), incomingOffsets.end() - 1);
+    for (uint32_t slot = 0; slot < neighbours.size(); ++slot) {
+        if(neighbours[slot] != INVALID_INDEX) {
+            incomingSlots[incomingFill[neighbours[slot]]++] = slot;
+        }
+    }
+
+    //spatial hash, sorted by cell so nodes of a cell (different floors) are next to each other
+    std::vector<std::pair<int32_t, int32_t>> nodeCells(positions.size());
+    std::vector<std::pair<uint64_t, uint32_t>> cellKeys(positions.size());
+    for (uint32_t i = 0; i < positions.size(); ++i) {
+        getCell(positions[i], nodeCells[i].first, nodeCells[i].second);
+        cellKeys[i] = std::make_pair(getCellKey(nodeCells[i].first, nodeCells[i].second), i);
+    }
+    std::sort(cellKeys.begin(), cellKeys.end());
+    cellNodes.resize(cellKeys.size());
+    for (uint32_t i = 0; i < cellKeys.size(); ++i) {
+        cellNodes[i] = cellKeys[i].second;
+        auto rangeIt = cellRanges.find(cellKeys[i].first);
+        if(rangeIt == cellRanges.end()) {
+            cellRanges[cellKeys[i].first] = std::make_pair(i, 1u);
+        } else {
+            rangeIt->second.second++;
+        }
+    }
+
+    buildClusters(nodeCells);
+    std::cout << "AI navigation graph built with " << positions.size() << " nodes in " << clusterCenters.size() << " clusters." << std::endl;
+}
+
+void AINavigationGraph::buildClusters(const std::vector<std::pair<int32_t, int32_t>> &nodeCells) {
+    std::unordered_map<uint64_t, uint32_t> clusterIndices;
+    std::vector<uint32_t> clusterNodeCounts;
+    nodeClusters.resize(positions.size());
+    for (uint32_t i = 0; i < positions.size(); ++i) {
+        uint64_t clusterKey = getCellKey(getClusterCoordinate(nodeCells[i].first), getClusterCoordinate(nodeCells[i].second));
+        auto clusterIt = clusterIndices.find(clusterKey);
+        if(clusterIt == clusterIndices.end()) {
+            clusterIt = clusterIndices.insert(std::make_pair(clusterKey, (uint32_t) clusterCenters.size())).first;
+            clusterCenters.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+            clusterNodeCounts.push_back(0);
+        }
+        nodeClusters[i] = clusterIt->second;
+        clusterCenters[clusterIt->second] += positions[i];
+        clusterNodeCounts[clusterIt->second]++;
+    }
+    for (size_t i = 0; i < clusterCenters.size(); ++i) {
+        clusterCenters[i] /= (float) clusterNodeCounts[i];
+    }
+
+    //clusters are neighbours if any edge crosses between them
+    std::unordered_set<uint64_t> clusterEdges;
+    for (uint32_t i = 0; i < positions.size(); ++i) {
+        for (uint32_t j = 0; j < NEIGHBOUR_COUNT; ++j) {
+            uint32_t neighbour = neighbours[i * NEIGHBOUR_COUNT + j];
+            if(neighbour != INVALID_INDEX && nodeClusters[neighbour] != nodeClusters[i]) {
+                clusterEdges.insert(((uint64_t)nodeClusters[i] << 32) | nodeClusters[neighbour]);
+            }
+        }
+    }
+    std::vector<uint64_t> sortedEdges(clusterEdges.begin(), clusterEdges.end());
+    std::sort(sortedEdges.begin(), sortedEdges.end());
+    clusterNeighbourOffsets.assign(clusterCenters.size() + 1, 0);
+    clusterNeighbours.reserve(sortedEdges.size());
+    for (uint64_t edge : sortedEdges) {
+        clusterNeighbourOffsets[(edge >> 32) + 1]++;
+        clusterNeighbours.push_back((uint32_t) edge);
+    }
+    for (size_t i = 1; i < clusterNeighbourOffsets.size(); ++i) {
+        clusterNeighbourOffsets[i] += clusterNeighbourOffsets[i - 1];
+    }
+}
+
+uint32_t AINavigationGraph::findNode(const glm::vec3 &position) const {
+    if(positions.empty()) {
+        return INVALID_INDEX;
+    }
+    int32_t cellX, cellZ;
+    getCell(position, cellX, cellZ);
+    uint32_t closestNode = INVALID_INDEX;
+    float closestDistance = GRID_SNAP_DISTANCE;
+    //snap distance is less than a cell, but a position close to cell border can still snap to the next cell
+    for (int32_t i = -1; i <= 1; ++i) {
+        for (int32_t j = -1; j <= 1; ++j) {
+            auto rangeIt = cellRanges.find(getCellKey(cellX + i, cellZ + j));
+            if(rangeIt == cellRanges.end()) {
+                continue;
+            }
+            for (uint32_t k = rangeIt->second.first; k < rangeIt->second.first + rangeIt->second.second; ++k) {
+                float distance = glm::length2(positions[cellNodes[k]] - position);
+                if(distance < closestDistance) {
+                    closestDistance = distance;
+                    closestNode = cellNodes[k];
+                }
+            }
+        }
+    }
+    return closestNode;
+}
+
+std::unique_ptr<AINavigationGraph::SearchContext> AINavigationGraph::acquireSearchContext() {
+    {
+        std::lock_guard<std::mutex> lock(searchContextMutex);
+        if(!freeSearchContexts.empty()) {
+            std::unique_ptr<SearchContext> searchContext = std::move(freeSearchContexts.back());
+            freeSearchContexts.pop_back();
+            return searchContext;
+        }
+    }
+    //one per concurrent search, these are reused after
+    return std::make_unique<SearchContext>(positions.size(), clusterCenters.size());
+}
+
+void AINavigationGraph::releaseSearchContext(std::unique_ptr<SearchContext> searchContext) {
+    std::lock_guard<std::mutex> lock(searchContextMutex);
+    freeSearchContexts.push_back(std::move(searchContext));
+}
+
+bool AINavigationGraph::searchClusters(SearchContext &context, uint32_t startCluster, uint32_t targetCluster) const {
+    uint32_t generation = context.nextGeneration();
+    context.open.clear();
+    context.clusterStamps[startCluster] = generation;
+    context.clusterCosts[startCluster] = 0.0f;
+    context.clusterParents[startCluster] = INVALID_INDEX;
+    context.open.push_back(OpenEntry{0.0f, startCluster});
+    const glm::vec3& targetCenter = clusterCenters[targetCluster];
+    bool found = false;
+    while(!context.open.empty()) {
+        std::pop_heap(context.open.begin(), context.open.end(), std::greater<OpenEntry>());
+        uint32_t current = context.open.back().index;
+        context.open.pop_back();
+        if(context.clusterClosedStamps[current] == generation) {
+            continue;//a cheaper entry was already processed
+        }
+        if(current == targetCluster) {
+            found = true;
+            break;
+        }
+        context.clusterClosedStamps[current] = generation;
+        for (uint32_t i = clusterNeighbourOffsets[current]; i < clusterNeighbourOffsets[current + 1]; ++i) {
+            uint32_t neighbour = clusterNeighbours[i];
+            if(context.clusterClosedStamps[neighbour] == generation) {
+                continue;
+            }
+            float cost = context.clusterCosts[current] + glm::length(clusterCenters[neighbour] - clusterCenters[current]);
+            if(context.clusterStamps[neighbour] != generation || cost < context.clusterCosts[neighbour]) {
+                context.clusterStamps[neighbour] = generation;
+                context.clusterCosts[neighbour] = cost;
+                context.clusterParents[neighbour] = current;
+                context.open.push_back(OpenEntry{cost + glm::length(targetCenter - clusterCenters[neighbour]), neighbour});
+                std::push_heap(context.open.begin(), context.open.end(), std::greater<OpenEntry>());
+            }
+        }
+    }
+    if(!found) {
+        return false;
+    }
+    context.corridorGeneration = generation;
+    for (uint32_t cluster = targetCluster; cluster != INVALID_INDEX; cluster = context.clusterParents[cluster]) {
+        context.corridorStamps[cluster] = generation;
+    }
+    return true;
+}
+
+bool AINavigationGraph::searchNodes(SearchContext &context, uint32_t start, uint32_t target, uint32_t maximumNumberOfNodes,
+                                    bool useCorridor) const {
+    uint32_t generation = context.nextGeneration();
+    context.open.clear();
+    context.nodeStamps[start] = generation;
+    context.nodeCosts[start] = 0.0f;
+    context.nodeDepths[start] = 0;
+    context.nodeParents[start] = INVALID_INDEX;
+    context.open.push_back(OpenEntry{0.0f, start});
+    const glm::vec3& targetPosition = positions[target];
+    bool found = false;
+    while(!context.open.empty()) {
+        std::pop_heap(context.open.begin(), context.open.end(), std::greater<OpenEntry>());
+        uint32_t current = context.open.back().index;
+        context.open.pop_back();
+        if(context.nodeClosedStamps[current] == generation) {
+            continue;//a cheaper entry was already processed
+        }
+        if(current == target) {
+            found = true;
+            break;
+        }
+        context.nodeClosedStamps[current] = generation;
+        if(maximumNumberOfNodes != 0 && context.nodeDepths[current] >= maximumNumberOfNodes) {
+            //we searched for this depth, but couldn't found the target no need to keep searching
+            break;
+        }
+        for (uint32_t i = current * NEIGHBOUR_COUNT; i < (current + 1) * NEIGHBOUR_COUNT; ++i) {
+            uint32_t neighbour = neighbours[i];
+            if(neighbour == INVALID_INDEX || context.nodeClosedStamps[neighbour] == generation) {
+                continue;
+            }
+            if(useCorridor && context.corridorStamps[nodeClusters[neighbour]] != context.corridorGeneration) {
+                continue;
+            }
+            float cost = context.nodeCosts[current] + neighbourCosts[i];
+            if(context.nodeStamps[neighbour] != generation || cost < context.nodeCosts[neighbour]) {
+                context.nodeStamps[neighbour] = generation;
+                context.nodeCosts[neighbour] = cost;
+                context.nodeDepths[neighbour] = context.nodeDepths[current] + 1;
+                context.nodeParents[neighbour] = current;
+                context.open.push_back(OpenEntry{cost + glm::length(targetPosition - positions[neighbour]), neighbour});
+                std::push_heap(context.open.begin(), context.open.end(), std::greater<OpenEntry>());
+            }
+        }
+    }
+    if(!found) {
+        return false;
+    }
+    context.path.clear();
+    for (uint32_t node = target; node != INVALID_INDEX; node = context.nodeParents[node]) {
+        context.path.push_back(node);
+    }
+    std::reverse(context.path.begin(), context.path.end());
+    return true;
+}
+
+bool AINavigationGraph::findCachedPath(uint32_t start, uint32_t target, uint32_t maximumNumberOfNodes, std::vector<uint32_t> &path) {
+    std::lock_guard<std::mutex> lock(pathCacheMutex);
+    auto cacheIt = pathCache.find(target);
+    if(cacheIt == pathCache.end()) {
+        return false;
+    }
+    //any actor standing on a cached path to the same target can use the rest of it
+    for (const CachedPath &cachedPath : cacheIt->second) {
+        auto startIt = std::find(cachedPath.nodes.begin(), cachedPath.nodes.end(), start);
+        if(startIt == cachedPath.nodes.end()) {
+            continue;
+        }
+        size_t remainingNodes = cachedPath.nodes.end() - startIt - 1;
+        if(maximumNumberOfNodes != 0 && remainingNodes > maximumNumberOfNodes) {
+            continue;
+        }
+        path.assign(startIt, cachedPath.nodes.end());
+        return true;
+    }
+    return false;
+}
+
+void AINavigationGraph::cachePath(const std::vector<uint32_t> &path) {
+    std::lock_guard<std::mutex> lock(pathCacheMutex);
+    if(pathCache.size() >= MAX_CACHED_TARGETS && pathCache.find(path.back()) == pathCache.end()) {
+        pathCache.clear();//target moves all the time, old targets are not likely to be requested again
+    }
+    std::vector<CachedPath>& targetPaths = pathCache[path.back()];
+    if(targetPaths.size() >= MAX_CACHED_PATHS_PER_TARGET) {
+        targetPaths.erase(targetPaths.begin());
+    }
+    targetPaths.push_back(CachedPath{path});
+}
+
+bool AINavigationGraph::findRoute(const glm::vec3 &from, const glm::vec3 &to, uint32_t maximumNumberOfNodes,
+                                  std::vector<glm::vec3> *route) {
+    uint32_t start = findNode(from);
+    if(start == INVALID_INDEX) {
+        std::cerr << "new from node can't be found, this means snap distance is too small." << std::endl;
+        return false;
+    }
+    uint32_t target = findNode(to);
+    if(target == INVALID_INDEX) {
+        std::cerr << "Destination can't be reached, most likely player moved to somewhere AI can't." << std::endl;
+        return false;
+    }
+    route->clear();
+    if(start == target) {
+        return true;//don't put anything to the route
+    }
+
+    std::unique_ptr<SearchContext> context = acquireSearchContext();
+    bool found = findCachedPath(start, target, maximumNumberOfNodes, context->path);
+    if(!found) {
+        //long routes are searched on clusters first. If the corridor turns out to be blocked inside a cluster, search without it
+        bool useCorridor = nodeClusters[start] != nodeClusters[target] &&
+                           searchClusters(*context, nodeClusters[start], nodeClusters[target]);
+        found = (useCorridor && searchNodes(*context, start, target, maximumNumberOfNodes, true)) ||
+                searchNodes(*context, start, target, maximumNumberOfNodes, false);
+        if(found) {
+            cachePath(context->path);
+        }
+    }
+    if(found) {
+        for (size_t i = context->path.size() - 1; i > 0; --i) {
+            route->push_back(positions[context->path[i]]);
+        }
+    } else {
+        std::cerr << "Path search failed, please check the values: " << GLMUtils::vectorToString(from)
+                  << " to " << GLMUtils::vectorToString(to) << std::endl;
+    }
+    releaseSearchContext(std::move(context));
+    return found;
+}
+
+std::shared_ptr<const AINavigationGraph::FlowField> AINavigationGraph::buildFlowField(uint32_t target, uint32_t maximumDepth) {
+    std::shared_ptr<FlowField> flowField = std::make_shared<FlowField>();
+    flowField->target = target;
+    flowField->maximumDepth = maximumDepth;
+    flowField->nextNodes.assign(positions.size(), INVALID_INDEX);
+    if(target >= positions.size()) {
+        return flowField;
+    }
+
+    //dijkstra over reverse edges, parent of a node is its next node towards the target
+    std::unique_ptr<SearchContext> context = acquireSearchContext();
+    uint32_t generation = context->nextGeneration();
+    context->open.clear();
+    context->nodeStamps[target] = generation;
+    context->nodeCosts[target] = 0.0f;
+    context->nodeDepths[target] = 0;
+    context->open.push_back(OpenEntry{0.0f, target});
+    while(!context->open.empty()) {
+        std::pop_heap(context->open.begin(), context->open.end(), std::greater<OpenEntry>());
+        uint32_t current = context->open.back().index;
+        context->open.pop_back();
+        if(context->nodeClosedStamps[current] == generation) {
+            continue;//a cheaper entry was already processed
+        }
+        context->nodeClosedStamps[current] = generation;
+        if(maximumDepth != 0 && context->nodeDepths[current] >= maximumDepth) {
+            continue;
+        }
+        for (uint32_t i = incomingOffsets[current]; i < incomingOffsets[current + 1]; ++i) {
+            uint32_t slot = incomingSlots[i];
+            uint32_t source = slot / NEIGHBOUR_COUNT;
+            if(context->nodeClosedStamps[source] == generation) {
+                continue;
+            }
+            float cost = context->nodeCosts[current] + neighbourCosts[slot];
+            if(context->nodeStamps[source] != generation || cost < context->nodeCosts[source]) {
+                context->nodeStamps[source] = generation;
+                context->nodeCosts[source] = cost;
+                context->nodeDepths[source] = context->nodeDepths[current] + 1;
+                flowField->nextNodes[source] = current;
+                context->open.push_back(OpenEntry{cost, source});
+                std::push_heap(context->open.begin(), context->open.end(), std::greater<OpenEntry>());
+            }
+        }
+    }
+    releaseSearchContext(std::move(context));
+    return flowField;
+}
+
+bool AINavigationGraph::followFlowField(const FlowField &flowField, uint32_t start, uint32_t maximumNumberOfNodes,
+                                        std::vector<glm::vec3> *route) const {
+    route->clear();
+    uint32_t node = start;
+    while(node != flowField.target) {
+        node = flowField.nextNodes[node];
+        if(node == INVALID_INDEX || (maximumNumberOfNodes != 0 && route->size() >= maximumNumberOfNodes)) {
+            route->clear();
+            return false;
+        }
+        route->push_back(positions[node]);
+    }
+    return true;
+}
@@ -0,0 +1,174 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_AINAVIGATIONGRAPH_H
+#define LIMONENGINE_AINAVIGATIONGRAPH_H
+
+
+#include <vector>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "AIMovementNode.h"
+
+//bigger than sqrt(3)/2
+//avoiding sqrt
+#define GRID_SNAP_DISTANCE (0.8f * 0.8f)
+
+/**
+ * Compact, index based copy of the walk grid, used for route search. AIMovementGrid keeps the linked nodes for
+ * generation and serialization, and builds this once the grid is ready.
+ *
+ * Only movable nodes are kept. Grid nodes are 1 unit apart on x and z, so a position is matched to a node using a
+ * spatial hash of grid cells. Cells are also grouped to clusters, and long routes are searched over clusters first,
+ * then the node search is limited to the clusters on the way.
+ *
+ * findRoute is thread safe, each search uses its own pooled search context.
+ */
+class AINavigationGraph {
+public:
+    static const uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+    static const uint32_t NEIGHBOUR_COUNT = 8;
+    static const int32_t CLUSTER_SIZE = 16;//in grid cells, for both x and z
+    static const size_t MAX_CACHED_TARGETS = 32;
+    static const size_t MAX_CACHED_PATHS_PER_TARGET = 8;
+
+    /**
+     * Result of a reverse search from a target node. Every reached node points to the next node towards the target,
+     * so any number of actors going to the same target can follow it without searching.
+     */
+    struct FlowField {
+        uint32_t target = INVALID_INDEX;
+        uint32_t maximumDepth = 0;//0 means whole graph
+        std::vector<uint32_t> nextNodes;//INVALID_INDEX if not reached
+
+        bool covers(uint32_t maximumNumberOfNodes) const {
+            return maximumDepth == 0 || (maximumNumberOfNodes != 0 && maximumNumberOfNodes <= maximumDepth);
+        }
+    };
+
+private:
+    struct OpenEntry {
+        float priority;
+        uint32_t index;
+
+        bool operator>(const OpenEntry &other) const {
+            return priority > other.priority;
+        }
+    };
+
+    /**
+     * Values of a node are valid only if its stamp is the current generation, so nothing is cleared between searches.
+     */
+    struct SearchContext {
+        uint32_t generation = 0;
+        std::vector<uint32_t> nodeStamps;
+        std::vector<uint32_t> nodeClosedStamps;
+        std::vector<float> nodeCosts;
+        std::vector<uint32_t> nodeDepths;
+        std::vector<uint32_t> nodeParents;
+
+        std::vector<uint32_t> clusterStamps;
+        std::vector<uint32_t> clusterClosedStamps;
+        std::vector<float> clusterCosts;
+        std::vector<uint32_t> clusterParents;
+        std::vector<uint32_t> corridorStamps;
+        uint32_t corridorGeneration = 0;
+
+        std::vector<OpenEntry> open;
+        std::vector<uint32_t> path;
+
+        SearchContext(size_t nodeCount, size_t clusterCount);
+        uint32_t nextGeneration();
+    };
+
+    struct CachedPath {
+        std::vector<uint32_t> nodes;//start to target
+    };
+
+    glm::vec3 origin = glm::vec3(0.0f, 0.0f, 0.0f);
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> neighbours;//NEIGHBOUR_COUNT per node, INVALID_INDEX if not movable
+    std::vector<float> neighbourCosts;
+    std::vector<uint32_t> incomingOffsets;//nodeCount + 1 entries, edges to i are [offsets[i], offsets[i+1])
+    std::vector<uint32_t> incomingSlots;//neighbour slots pointing to the node, source is slot / NEIGHBOUR_COUNT
+    std::vector<uint32_t> nodeClusters;
+
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> cellRanges;//first and count in cellNodes
+    std::vector<uint32_t> cellNodes;
+
+    std::vector<glm::vec3> clusterCenters;
+    std::vector<uint32_t> clusterNeighbourOffsets;//clusterCount + 1 entries, neighbours of i are [offsets[i], offsets[i+1])
+    std::vector<uint32_t> clusterNeighbours;
+
+    std::mutex searchContextMutex;
+    std::vector<std::unique_ptr<SearchContext>> freeSearchContexts;
+
+    std::mutex pathCacheMutex;
+    std::unordered_map<uint32_t, std::vector<CachedPath>> pathCache;//by target node
+
+    static uint64_t getCellKey(int32_t x, int32_t z) {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+    }
+
+    void getCell(const glm::vec3 &position, int32_t &x, int32_t &z) const {
+        x = (int32_t)std::lround(position.x - origin.x);
+        z = (int32_t)std::lround(position.z - origin.z);
+    }
+
+    static int32_t getClusterCoordinate(int32_t cellCoordinate) {
+        return cellCoordinate >= 0 ? cellCoordinate / CLUSTER_SIZE : -((-cellCoordinate + CLUSTER_SIZE - 1) / CLUSTER_SIZE);
+    }
+
+    void buildClusters(const std::vector<std::pair<int32_t, int32_t>> &nodeCells);
+
+    std::unique_ptr<SearchContext> acquireSearchContext();
+    void releaseSearchContext(std::unique_ptr<SearchContext> searchContext);
+
+    bool searchClusters(SearchContext &context, uint32_t startCluster, uint32_t targetCluster) const;
+    bool searchNodes(SearchContext &context, uint32_t start, uint32_t target, uint32_t maximumNumberOfNodes, bool useCorridor) const;
+
+    bool findCachedPath(uint32_t start, uint32_t target, uint32_t maximumNumberOfNodes, std::vector<uint32_t> &path);
+    void cachePath(const std::vector<uint32_t> &path);
+
+public:
+    explicit AINavigationGraph(const std::vector<std::shared_ptr<AIMovementNode>> &movementNodes);
+
+    /**
+     * @return closest movable node in snap distance, or INVALID_INDEX
+     */
+    uint32_t findNode(const glm::vec3 &position) const;
+
+    /**
+     * Fills the route from target to the node after start, same as the order of the previous search.
+     * If maximumNumberOfNodes is not 0, search stops after that many nodes from start.
+     */
+    bool findRoute(const glm::vec3 &from, const glm::vec3 &to, uint32_t maximumNumberOfNodes, std::vector<glm::vec3> *route);
+
+    /**
+     * Searches from target to every node up to maximumDepth nodes away, 0 means no limit. Thread safe.
+     */
+    std::shared_ptr<const FlowField> buildFlowField(uint32_t target, uint32_t maximumDepth);
+
+    /**
+     * Fills the route from the node after start to the target, following the flow field.
+     * Fails if start is not reached by the field, or route is longer than maximumNumberOfNodes.
+     */
+    bool followFlowField(const FlowField &flowField, uint32_t start, uint32_t maximumNumberOfNodes,
+                         std::vector<glm::vec3> *route) const;
+
+    uint32_t getNodeCount() const {
+        return (uint32_t) positions.size();
+    }
+
+    uint32_t getClusterCount() const {
+        return (uint32_t) clusterCenters.size();
+    }
+};
+
+
+#endif //LIMONENGINE_AINAVIGATIONGRAPH_H
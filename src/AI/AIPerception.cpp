@@ -0,0 +1,82 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <btBulletCollisionCommon.h>
+#include <glm/gtx/norm.hpp>
+#include "AIPerception.h"
+#include "../GameObjects/GameObject.h"
+#include "../Utils/GLMConverter.h"
+
+constexpr float AIPerception::MOVEMENT_THRESHOLD;
+const uint64_t AIPerception::MAXIMUM_RESULT_AGE;
+
+/**
+ * Closest hit, skipping the actor itself and triggers. Triggers are ghosts, they should not block sight.
+ */
+class LineOfSightCallback : public btCollisionWorld::ClosestRayResultCallback {
+    const btCollisionObject* self;
+public:
+    LineOfSightCallback(const btVector3 &from, const btVector3 &to, const btCollisionObject *self) :
+            btCollisionWorld::ClosestRayResultCallback(from, to), self(self) {}
+
+    bool needsCollision(btBroadphaseProxy *proxy0) const override {
+        const btCollisionObject* collisionObject = static_cast<const btCollisionObject*>(proxy0->m_clientObject);
+        if(collisionObject == self) {
+            return false;
+        }
+        const GameObject* gameObject = static_cast<const GameObject*>(collisionObject->getUserPointer());
+        if(gameObject != nullptr && gameObject->getTypeID() == GameObject::TRIGGER) {
+            return false;
+        }
+        return btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0);
+    }
+};
+
+void AIPerception::registerActor(uint32_t actorID, const btCollisionObject *self, const glm::vec3 &from,
+                                 uint32_t updateInterval) {
+    VisibilityEntry& entry = entries[actorID];
+    if(entry.self != self) {
+        entry.tested = false;//actor ID is reused
+    }
+    entry.self = self;
+    entry.from = from;
+    entry.updateInterval = updateInterval;
+}
+
+bool AIPerception::isTestNeeded(const VisibilityEntry &entry, const glm::vec3 &playerPosition, uint64_t time) const {
+    if(!entry.tested) {
+        return true;
+    }
+    uint64_t age = time - entry.testTime;
+    if(age < entry.updateInterval) {
+        return false;
+    }
+    if(age >= MAXIMUM_RESULT_AGE) {
+        return true;
+    }
+    return glm::length2(entry.from - entry.testedFrom) > MOVEMENT_THRESHOLD * MOVEMENT_THRESHOLD ||
+           glm::length2(playerPosition - entry.testedTo) > MOVEMENT_THRESHOLD * MOVEMENT_THRESHOLD;
+}
+
+void AIPerception::update(btCollisionWorld *world, const glm::vec3 &playerPosition, uint64_t time) {
+    btVector3 to = GLMConverter::GLMToBlt(playerPosition);
+    for (auto entryIt = entries.begin(); entryIt != entries.end(); ++entryIt) {
+        VisibilityEntry& entry = entryIt->second;
+        if(!isTestNeeded(entry, playerPosition, time)) {
+            continue;
+        }
+        btVector3 from = GLMConverter::GLMToBlt(entry.from);
+        LineOfSightCallback rayCallback(from, to, entry.self);
+        world->rayTest(from, to, rayCallback);
+        entry.visible = false;
+        if(rayCallback.hasHit()) {
+            const GameObject* gameObject = static_cast<const GameObject*>(rayCallback.m_collisionObject->getUserPointer());
+            entry.visible = gameObject != nullptr && gameObject->getTypeID() == GameObject::PLAYER;
+        }
+        entry.testedFrom = entry.from;
+        entry.testedTo = playerPosition;
+        entry.testTime = time;
+        entry.tested = true;
+    }
+}
@@ -0,0 +1,65 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_AIPERCEPTION_H
+#define LIMONENGINE_AIPERCEPTION_H
+
+
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class btCollisionObject;
+class btCollisionWorld;
+
+/**
+ * Keeps the line of sight between actors and player. Actors register each tick, then all rays are tested in one pass.
+ *
+ * A result is kept while neither the actor eye nor the player moved more than MOVEMENT_THRESHOLD, up to
+ * MAXIMUM_RESULT_AGE, since other objects can move in between. Actors can also ask to be tested less often.
+ */
+class AIPerception {
+public:
+    static constexpr float MOVEMENT_THRESHOLD = 0.1f;
+    static const uint64_t MAXIMUM_RESULT_AGE = 250;//in game time
+
+private:
+    struct VisibilityEntry {
+        const btCollisionObject* self = nullptr;
+        glm::vec3 from = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 testedFrom = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 testedTo = glm::vec3(0.0f, 0.0f, 0.0f);
+        uint64_t testTime = 0;
+        uint32_t updateInterval = 0;
+        bool tested = false;
+        bool visible = false;
+    };
+
+    std::unordered_map<uint32_t, VisibilityEntry> entries;//by actor ID
+
+    bool isTestNeeded(const VisibilityEntry &entry, const glm::vec3 &playerPosition, uint64_t time) const;
+
+public:
+    /**
+     * self is skipped by the ray, so the actor doesn't block its own sight. updateInterval 0 means every tick.
+     */
+    void registerActor(uint32_t actorID, const btCollisionObject *self, const glm::vec3 &from, uint32_t updateInterval);
+
+    void removeActor(uint32_t actorID) {
+        entries.erase(actorID);
+    }
+
+    /**
+     * Tests the rays of all registered actors that need it, against the given world.
+     */
+    void update(btCollisionWorld *world, const glm::vec3 &playerPosition, uint64_t time);
+
+    bool canSeePlayer(uint32_t actorID) const {
+        auto entryIt = entries.find(actorID);
+        return entryIt != entries.end() && entryIt->second.visible;
+    }
+};
+
+
+#endif //LIMONENGINE_AIPERCEPTION_H
@@ -0,0 +1,168 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include "AIRouteService.h"
+
+const uint32_t AIRouteService::MAX_CONCURRENT_BUILDS;
+const uint64_t AIRouteService::MAXIMUM_FIELD_AGE;
+const size_t AIRouteService::MAX_CACHED_FIELDS;
+
+static bool depthCovers(uint32_t depth, uint32_t maximumNumberOfNodes) {
+    return depth == 0 || (maximumNumberOfNodes != 0 && maximumNumberOfNodes <= depth);
+}
+
+AIRouteService::~AIRouteService() {
+    for (FieldBuild *build : runningBuilds) {
+        jobSystem->waitFor(&build->counter);
+        delete build;
+    }
+}
+
+const AIRouteService::CachedField *AIRouteService::findUsableField(uint32_t target, uint32_t maximumNumberOfNodes) const {
+    auto fieldIt = cachedFields.find(target);
+    if(fieldIt == cachedFields.end() ||
+       currentTime - fieldIt->second.time > MAXIMUM_FIELD_AGE ||
+       !fieldIt->second.flowField->covers(maximumNumberOfNodes)) {
+        return nullptr;
+    }
+    return &fieldIt->second;
+}
+
+void AIRouteService::answer(uint32_t requesterID, const PendingRequest &request, const CachedField &cachedField) {
+    RouteResult result;
+    result.time = cachedField.time;
+    result.found = graph->followFlowField(*cachedField.flowField, request.start, request.maximumNumberOfNodes, &result.route);
+    results[requesterID] = std::move(result);
+}
+
+void AIRouteService::requestRoute(uint32_t requesterID, const glm::vec3 &from, const glm::vec3 &to,
+                                  uint32_t maximumNumberOfNodes) {
+    uint32_t start = graph->findNode(from);
+    if(start == AINavigationGraph::INVALID_INDEX) {
+        std::cerr << "new from node can't be found, this means snap distance is too small." << std::endl;
+        failRequest(requesterID);
+        return;
+    }
+    uint32_t target = graph->findNode(to);
+    if(target == AINavigationGraph::INVALID_INDEX) {
+        std::cerr << "Destination can't be reached, most likely player moved to somewhere AI can't." << std::endl;
+        failRequest(requesterID);
+        return;
+    }
+
+    PendingRequest request{start, target, maximumNumberOfNodes};
+    const CachedField *cachedField = findUsableField(target, maximumNumberOfNodes);
+    if(cachedField != nullptr) {
+        answer(requesterID, request, *cachedField);
+        return;
+    }
+    pendingRequests[requesterID] = request;
+    queueBuild(target, maximumNumberOfNodes);
+}
+
+void AIRouteService::failRequest(uint32_t requesterID) {
+    pendingRequests.erase(requesterID);
+    RouteResult failedResult;
+    failedResult.time = currentTime;
+    results[requesterID] = failedResult;
+}
+
+std::vector<uint32_t> AIRouteService::getPendingRequesters() const {
+    std::vector<uint32_t> requesters;
+    for (auto requestIt = pendingRequests.begin(); requestIt != pendingRequests.end(); ++requestIt) {
+        requesters.push_back(requestIt->first);
+    }
+    return requesters;
+}
+
+bool AIRouteService::takeResult(uint32_t requesterID, RouteResult &result) {
+    auto resultIt = results.find(requesterID);
+    if(resultIt == results.end()) {
+        return false;
+    }
+    result = std::move(resultIt->second);
+    results.erase(resultIt);
+    return true;
+}
+
+void AIRouteService::queueBuild(uint32_t target, uint32_t maximumNumberOfNodes) {
+    for (const FieldBuild *build : runningBuilds) {
+        if(build->target == target && depthCovers(build->maximumDepth, maximumNumberOfNodes)) {
+            return;
+        }
+    }
+    //same target is searched once, deep enough for all requests
+    for (auto &queuedBuild : queuedBuilds) {
+        if(queuedBuild.first == target) {
+            if(!depthCovers(queuedBuild.second, maximumNumberOfNodes)) {
+                queuedBuild.second = maximumNumberOfNodes;
+            }
+            return;
+        }
+    }
+    queuedBuilds.push_back(std::make_pair(target, maximumNumberOfNodes));
+}
+
+void AIRouteService::collectFinishedBuilds() {
+    for (auto buildIt = runningBuilds.begin(); buildIt != runningBuilds.end();) {
+        FieldBuild *build = *buildIt;
+        if(!build->counter.isDone()) {
+            ++buildIt;
+            continue;
+        }
+        cachedFields[build->target] = CachedField{build->flowField, currentTime};
+        delete build;
+        buildIt = runningBuilds.erase(buildIt);
+    }
+
+    for (auto fieldIt = cachedFields.begin(); fieldIt != cachedFields.end();) {
+        if(currentTime - fieldIt->second.time > MAXIMUM_FIELD_AGE) {
+            fieldIt = cachedFields.erase(fieldIt);
+        } else {
+            ++fieldIt;
+        }
+    }
+    while(cachedFields.size() > MAX_CACHED_FIELDS) {
+        auto oldestIt = cachedFields.begin();
+        for (auto fieldIt = cachedFields.begin(); fieldIt != cachedFields.end(); ++fieldIt) {
+            if(fieldIt->second.time < oldestIt->second.time) {
+                oldestIt = fieldIt;
+            }
+        }
+        cachedFields.erase(oldestIt);
+    }
+}
+
+void AIRouteService::startQueuedBuilds() {
+    while(runningBuilds.size() < MAX_CONCURRENT_BUILDS && !queuedBuilds.empty()) {
+        FieldBuild *build = new FieldBuild();
+        build->target = queuedBuilds.front().first;
+        build->maximumDepth = queuedBuilds.front().second;
+        queuedBuilds.pop_front();
+        AINavigationGraph *graph = this->graph;
+        //search can take multiple frames, so it shouldn't block frame jobs
+        jobSystem->submitBackground([graph, build]() {
+            build->flowField = graph->buildFlowField(build->target, build->maximumDepth);
+        }, &build->counter);
+        runningBuilds.push_back(build);
+    }
+}
+
+void AIRouteService::update(uint64_t time) {
+    currentTime = time;
+    collectFinishedBuilds();
+    for (auto requestIt = pendingRequests.begin(); requestIt != pendingRequests.end();) {
+        const CachedField *cachedField = findUsableField(requestIt->second.target, requestIt->second.maximumNumberOfNodes);
+        if(cachedField != nullptr) {
+            answer(requestIt->first, requestIt->second, *cachedField);
+            requestIt = pendingRequests.erase(requestIt);
+        } else {
+            //field was not deep enough, or expired before request was answered
+            queueBuild(requestIt->second.target, requestIt->second.maximumNumberOfNodes);
+            ++requestIt;
+        }
+    }
+    startQueuedBuilds();
+}
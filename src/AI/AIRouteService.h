@@ -0,0 +1,113 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_AIROUTESERVICE_H
+#define LIMONENGINE_AIROUTESERVICE_H
+
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <glm/glm.hpp>
+#include "AINavigationGraph.h"
+#include "../SDL2MultiThreading.h"
+
+/**
+ * Answers route requests of actors. Requests are grouped by target node, and each group is answered from a single
+ * flow field searched from the target, instead of a search per actor. Flow fields are kept for a while, so requests
+ * to a recent target are answered without searching at all.
+ *
+ * Flow fields are built as background jobs, at most MAX_CONCURRENT_BUILDS at a time, rest wait in a queue.
+ * Everything except the build jobs runs on the main thread.
+ */
+class AIRouteService {
+public:
+    static const uint32_t MAX_CONCURRENT_BUILDS = 2;
+    static const uint64_t MAXIMUM_FIELD_AGE = 500;//in game time, older fields are not used for new requests
+    static const size_t MAX_CACHED_FIELDS = 8;
+
+    struct RouteResult {
+        std::vector<glm::vec3> route;//from the node after start to target
+        bool found = false;
+        uint64_t time = 0;//game time flow field was built
+    };
+
+private:
+    struct FieldBuild {
+        SDL2MultiThreading::JobSystem::Counter counter;
+        uint32_t target;
+        uint32_t maximumDepth;
+        std::shared_ptr<const AINavigationGraph::FlowField> flowField;
+    };
+
+    struct CachedField {
+        std::shared_ptr<const AINavigationGraph::FlowField> flowField;
+        uint64_t time;
+    };
+
+    struct PendingRequest {
+        uint32_t start;
+        uint32_t target;
+        uint32_t maximumNumberOfNodes;
+    };
+
+    AINavigationGraph *graph;
+    SDL2MultiThreading::JobSystem *jobSystem;
+    uint64_t currentTime = 0;
+
+    std::map<uint32_t, PendingRequest> pendingRequests;//by requester
+    std::map<uint32_t, RouteResult> results;//by requester, until it is taken
+    std::unordered_map<uint32_t, CachedField> cachedFields;//by target node
+    std::deque<std::pair<uint32_t, uint32_t>> queuedBuilds;//target and depth
+    std::vector<FieldBuild *> runningBuilds;
+
+    const CachedField *findUsableField(uint32_t target, uint32_t maximumNumberOfNodes) const;
+
+    void answer(uint32_t requesterID, const PendingRequest &request, const CachedField &cachedField);
+
+    void queueBuild(uint32_t target, uint32_t maximumNumberOfNodes);
+
+    void collectFinishedBuilds();
+
+    void startQueuedBuilds();
+
+public:
+    AIRouteService(AINavigationGraph *graph, SDL2MultiThreading::JobSystem *jobSystem) : graph(graph), jobSystem(jobSystem) {}
+
+    /**
+     * Waits for running builds, they use the graph.
+     */
+    ~AIRouteService();
+
+    /**
+     * If a recent flow field to the target exists, result is ready immediately. Else it is ready after a later update.
+     */
+    void requestRoute(uint32_t requesterID, const glm::vec3 &from, const glm::vec3 &to, uint32_t maximumNumberOfNodes);
+
+    /**
+     * Sets an empty, not found result. Used when request can't be made at all.
+     */
+    void failRequest(uint32_t requesterID);
+
+    bool isRequestPending(uint32_t requesterID) const {
+        return pendingRequests.find(requesterID) != pendingRequests.end();
+    }
+
+    std::vector<uint32_t> getPendingRequesters() const;
+
+    /**
+     * Moves the result to the parameter, if it is ready.
+     */
+    bool takeResult(uint32_t requesterID, RouteResult &result);
+
+    /**
+     * Called once per frame, collects finished flow fields, answers waiting requests and starts new builds.
+     */
+    void update(uint64_t time);
+};
+
+
+#endif //LIMONENGINE_AIROUTESERVICE_H
@@ -4,6 +4,7 @@
 
 #include "ALHelper.h"
 #include "Assets/SoundAsset.h"
+#include "Assets/SoundStream.h"
 
 #define DR_WAV_IMPLEMENTATION
 #include "../libs/dr_wav.h"
@@ -33,6 +34,9 @@ ALHelper::ALHelper() {
     }
     SDL_AtomicUnlock(&playRequestLock);
 
+    wakeMutex = SDL_CreateMutex();
+    wakeCondition = SDL_CreateCond();
+
     thread = SDL_CreateThread(&staticSoundManager, "soundManager", this);
 
 }
@@ -54,7 +58,7 @@ int ALHelper::soundManager() {
             paused = false;
             resumed = false;
         } else if(running) {
-            if (playRequests.size() > 0) { //this might miss a request because not locking, but I am ok with 10ms delay at most
+            if (playRequests.size() > 0) { //this might miss a request because not locking, play wakes the thread again anyway
                 SDL_AtomicLock(&playRequestLock);
                 for (size_t i = 0; i < playRequests.size(); ++i) {
                     std::unique_ptr<PlayingSound> &sound = playRequests.at(i);
@@ -70,7 +74,12 @@ int ALHelper::soundManager() {
                 std::unique_ptr<PlayingSound> &temp = (*iterator).second;
                 ALint state;
                 alGetSourcei(temp->source, AL_SOURCE_STATE, &state);
-                if(state == AL_STOPPED && !temp->looped) {
+                if(state == AL_STOPPED && !temp->stopped && temp->sampleCountToPlay > 0) {
+                    //all queued buffers are played before refill, source stops in that case. Refill and continue.
+                    refreshBuffers(temp);
+                    alSourcePlay(temp->source);
+                    ++iterator;
+                } else if(state == AL_STOPPED && !temp->looped) {
                     iterator = playingSounds.erase(iterator);
                 } else if (temp->isFinished()) {
                     if (temp->looped) {
@@ -85,21 +94,8 @@ int ALHelper::soundManager() {
                             std::cerr << "Loop audio buffer data failed!" << alGetString(error) << std::endl;
                         }
 
-                        temp->sampleCountToPlay = temp->asset->getSampleCount();
-                        temp->nextDataToBuffer = temp->asset->getSoundData();
-
-                        for (uint32_t i = 0; i < NUM_BUFFERS; ++i) {
-                            uint32_t currentPlaySize = std::min((uint64_t) temp->sampleCountToPlay,
-                                                                (uint64_t) BUFFER_ELEMENT_COUNT);
-                            temp->sampleCountToPlay = temp->sampleCountToPlay - currentPlaySize;
-                            alBufferData(temp->buffers[i], temp->format, temp->nextDataToBuffer,
-                                         currentPlaySize * sizeof(int16_t), temp->asset->getSampleRate());
-                            temp->nextDataToBuffer = temp->nextDataToBuffer + currentPlaySize;
-                            if ((error = alGetError()) != AL_NO_ERROR) {
-                                std::cerr << "Loop audio buffer data failed!" << alGetString(error) << std::endl;
-                            }
-                        }
-                        alSourceQueueBuffers(temp->source, NUM_BUFFERS, temp->buffers);
+                        rewind(*temp);
+                        queueBuffers(*temp);
                         alSourcePlay(temp->source);
                         iterator++;
                     } else {//non looped finished sound
@@ -114,11 +110,48 @@ int ALHelper::soundManager() {
             }
             removeSoundLock.unlock();
         }
-        SDL_Delay(10);
+        waitForWork();
     }
     return 0;
 }
 
+void ALHelper::wakeSoundManager() {
+    SDL_LockMutex(wakeMutex);
+    wakeRequested = true;
+    SDL_CondSignal(wakeCondition);
+    SDL_UnlockMutex(wakeMutex);
+}
+
+void ALHelper::waitForWork() {
+    uint32_t waitDuration = getWaitDuration();
+    SDL_LockMutex(wakeMutex);
+    if (!wakeRequested) {
+        SDL_CondWaitTimeout(wakeCondition, wakeMutex, waitDuration);
+    }
+    wakeRequested = false;
+    SDL_UnlockMutex(wakeMutex);
+}
+
+uint32_t ALHelper::getWaitDuration() const {
+    uint32_t waitDuration = SOUND_MANAGER_IDLE_WAIT_MS;
+    if (!running) {
+        return waitDuration;
+    }
+    for (auto iterator = playingSounds.begin(); iterator != playingSounds.end(); ++iterator) {
+        const std::unique_ptr<PlayingSound> &sound = iterator->second;
+        if (sound->paused || sound->stopped) {
+            continue;
+        }
+        uint64_t samplesPerSecond = (uint64_t) sound->asset->getChannels() * sound->asset->getSampleRate();
+        if (samplesPerSecond == 0) {
+            continue;
+        }
+        uint32_t bufferDuration = (uint32_t) ((uint64_t) BUFFER_ELEMENT_COUNT * 1000 / samplesPerSecond);
+        waitDuration = std::min(waitDuration, std::max(bufferDuration / 2, (uint32_t) SOUND_MANAGER_MIN_WAIT_MS));
+    }
+    return waitDuration;
+}
+
 bool ALHelper::stop(uint32_t soundID) {
     if(playingSounds.find(soundID) != playingSounds.end()) {
         std::unique_ptr<PlayingSound>& sound = playingSounds[soundID];
@@ -127,6 +160,7 @@ bool ALHelper::stop(uint32_t soundID) {
         alSourceStop(sound->source);
         sound->stopped = true;
         removeSoundLock.unlock();
+        wakeSoundManager();//so the source is released without waiting
         ALenum error;
         if ((error = alGetError()) != AL_NO_ERROR) {
             std::cerr << "Stop source failed! " << alGetString(error) << std::endl;
@@ -214,10 +248,19 @@ uint32_t ALHelper::play(std::shared_ptr<SoundAsset> soundAsset, bool looped, flo
     SDL_AtomicLock(&playRequestLock);
     this->playRequests.push_back(std::move(sound));
     SDL_AtomicUnlock(&playRequestLock);
+    wakeSoundManager();
     return id;
 }
 
 bool ALHelper::startPlay(std::unique_ptr<PlayingSound> &sound) {
+    if (sound->asset->isStreamed()) {
+        //opened here, so disk access is not on the thread that requested the play
+        sound->stream = sound->asset->openStream();
+        if (sound->stream == nullptr) {
+            return false;
+        }
+        sound->streamBuffer.resize(BUFFER_ELEMENT_COUNT);
+    }
 
     alGenBuffers(NUM_BUFFERS, sound->buffers);
     alGenSources(1, &sound->source);
@@ -240,21 +283,8 @@ bool ALHelper::startPlay(std::unique_ptr<PlayingSound> &sound) {
 
     sound->format = to_al_format(sound->asset->getChannels(), 16);
 
-    sound->nextDataToBuffer = sound->asset->getSoundData();
-    sound->sampleCountToPlay = sound->asset->getSampleCount();
-    for (uint32_t i = 0; i < NUM_BUFFERS; ++i) {
-        uint32_t currentPlaySize = std::min((uint64_t)sound->sampleCountToPlay, (uint64_t)BUFFER_ELEMENT_COUNT);
-        sound->sampleCountToPlay = sound->sampleCountToPlay - currentPlaySize;
-
-        alBufferData(sound->buffers[i], sound->format, sound->nextDataToBuffer, currentPlaySize * sizeof(int16_t), sound->asset->getSampleRate());
-        sound->nextDataToBuffer = sound->nextDataToBuffer + currentPlaySize;
-        ALenum error;
-        if ((error = alGetError()) != AL_NO_ERROR) {
-            std::cerr << "Audio buffer data failed with error " << alGetString(error) << std::endl;
-        }
-    }
-
-    alSourceQueueBuffers(sound->source, NUM_BUFFERS, sound->buffers);
+    rewind(*sound);
+    queueBuffers(*sound);
     if(!sound->paused) {
         alSourcePlay(sound->source);
     }
@@ -287,16 +317,7 @@ bool ALHelper::refreshBuffers(std::unique_ptr<ALHelper::PlayingSound> &sound) {
 //            Read the next chunk of decoded data from the stream
 //            Pop the oldest queued buffer from the source, fill it with the new data, then requeue it
             alSourceUnqueueBuffers(sound->source, 1, &buffer);
-            uint32_t currentPlaySize = std::min((uint64_t) sound->sampleCountToPlay, (uint64_t) BUFFER_ELEMENT_COUNT);
-            sound->sampleCountToPlay = sound->sampleCountToPlay - currentPlaySize;
-            if(currentPlaySize > 0) {
-                alBufferData(buffer, sound->format, sound->nextDataToBuffer, currentPlaySize * sizeof(int16_t),
-                             sound->asset->getSampleRate());
-                if ((error = alGetError()) != AL_NO_ERROR) {
-                    std::cerr << "Error buffering alGenBuffers : " << alGetString(error) << std::endl;
-                    return 1;
-                }
-                sound->nextDataToBuffer = sound->nextDataToBuffer + currentPlaySize;
+            if(fillBuffer(*sound, buffer) > 0) {
                 alSourceQueueBuffers(sound->source, 1, &buffer);
                 if ((error = alGetError()) != AL_NO_ERROR) {
                     std::cerr << "Error source buffering : %s" << alGetString(error) << std::endl;
@@ -308,6 +329,63 @@ bool ALHelper::refreshBuffers(std::unique_ptr<ALHelper::PlayingSound> &sound) {
     return true;
 }
 
+void ALHelper::rewind(PlayingSound &sound) {
+    sound.sampleCountToPlay = sound.asset->getSampleCount();
+    if (sound.stream != nullptr) {
+        if (!sound.stream->rewind()) {
+            std::cerr << "Rewinding sound stream " << sound.asset->getName() << " failed, it won't be played again." << std::endl;
+            sound.sampleCountToPlay = 0;
+        }
+    } else {
+        sound.nextDataToBuffer = sound.asset->getSoundData();
+    }
+}
+
+uint32_t ALHelper::fillBuffer(PlayingSound &sound, ALuint buffer) {
+    if (sound.sampleCountToPlay == 0 && sound.looped) {
+        //continue from start while the last buffers are still playing, so there is no gap between loops
+        rewind(sound);
+    }
+    uint32_t currentPlaySize = (uint32_t) std::min((uint64_t) sound.sampleCountToPlay, (uint64_t) BUFFER_ELEMENT_COUNT);
+    if (currentPlaySize == 0) {
+        return 0;
+    }
+    const int16_t *data;
+    if (sound.stream != nullptr) {
+        currentPlaySize = (uint32_t) sound.stream->read(currentPlaySize, sound.streamBuffer.data());
+        if (currentPlaySize == 0) {
+            //file is shorter than its header says
+            sound.sampleCountToPlay = 0;
+            return 0;
+        }
+        data = sound.streamBuffer.data();
+    } else {
+        data = sound.nextDataToBuffer;
+        sound.nextDataToBuffer = sound.nextDataToBuffer + currentPlaySize;
+    }
+    sound.sampleCountToPlay = sound.sampleCountToPlay - currentPlaySize;
+
+    alBufferData(buffer, sound.format, data, currentPlaySize * sizeof(int16_t), sound.asset->getSampleRate());
+    ALenum error;
+    if ((error = alGetError()) != AL_NO_ERROR) {
+        std::cerr << "Audio buffer data failed with error " << alGetString(error) << std::endl;
+        return 0;
+    }
+    return currentPlaySize;
+}
+
+void ALHelper::queueBuffers(PlayingSound &sound) {
+    ALsizei bufferCount = 0;
+    while (bufferCount < NUM_BUFFERS && fillBuffer(sound, sound.buffers[bufferCount]) > 0) {
+        bufferCount++;
+    }
+    if (bufferCount > 0) {
+        alSourceQueueBuffers(sound.source, bufferCount, sound.buffers);
+    }
+}
+
+ALHelper::PlayingSound::PlayingSound(uint32_t id) : soundID(id) {}
+
 bool ALHelper::PlayingSound::isFinished() {
     ALint source_state;
     alGetSourcei(source, AL_SOURCE_STATE, &source_state);
@@ -349,8 +427,11 @@ ALHelper::PlayingSound::~PlayingSound() {
 ALHelper::~ALHelper() {
     this->running = false;
     this->paused = false;
+    wakeSoundManager();
     int threadReturnValue;
     SDL_WaitThread(thread, &threadReturnValue);
+    SDL_DestroyCond(wakeCondition);
+    SDL_DestroyMutex(wakeMutex);
 
     dev = alcGetContextsDevice(ctx);
     alcMakeContextCurrent(NULL);
@@ -18,13 +18,17 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <SDL_atomic.h>
 #include <SDL_thread.h>
+#include <SDL_mutex.h>
 #include "SDL2Helper.h"
 #include "SDL2MultiThreading.h"
 
 class SoundAsset;
+class SoundStream;
 
 #define NUM_BUFFERS 3
 #define BUFFER_ELEMENT_COUNT 8192
+#define SOUND_MANAGER_MIN_WAIT_MS 5
+#define SOUND_MANAGER_IDLE_WAIT_MS 1000
 
 class ALHelper {
     friend class World;
@@ -38,13 +42,15 @@ class ALHelper {
         ALuint buffers[NUM_BUFFERS];
         float gain;
         const int16_t *nextDataToBuffer;
+        std::unique_ptr<SoundStream> stream;//only for streamed assets, nextDataToBuffer is not used for them
+        std::vector<int16_t> streamBuffer;
         bool looped;
         bool paused = false;
         bool stopped = false;
         glm::vec3 position = glm::vec3(0,0,0);
         bool isPositionRelative = true;
         bool isFinished();
-        PlayingSound(uint32_t id): soundID(id) {};
+        explicit PlayingSound(uint32_t id);
 
         ~PlayingSound();
     };
@@ -52,6 +58,9 @@ class ALHelper {
     SDL_SpinLock playRequestLock;
     SDL_Thread *thread = nullptr;
     SDL2MultiThreading::SpinLock removeSoundLock;
+    SDL_mutex *wakeMutex = nullptr;
+    SDL_cond *wakeCondition = nullptr;
+    bool wakeRequested = false;
 
     ALCdevice *dev;
     ALCcontext *ctx;
@@ -89,20 +98,46 @@ class ALHelper {
 
     int soundManager();
 
+    /**
+     * Wakes the sound manager thread before its wait times out, for requests from other threads.
+     */
+    void wakeSoundManager();
+
+    /**
+     * Sound manager waits for half the duration of the shortest buffer that is playing, so a processed buffer is
+     * refilled while there is at least one more queued. If nothing is playing, it waits until woken.
+     */
+    void waitForWork();
+
+    uint32_t getWaitDuration() const;
+
     bool startPlay(std::unique_ptr<PlayingSound> &sound);
 
     bool refreshBuffers(std::unique_ptr<PlayingSound> &sound);//this method updates some of the values of parameter
 
+    void rewind(PlayingSound &sound);
+
+    /**
+     * Fills the buffer with the next samples of the sound, from memory or decoded from the stream.
+     * Looped sounds continue from start when they reach the end.
+     * @return number of samples buffered, 0 means nothing left to play
+     */
+    uint32_t fillBuffer(PlayingSound &sound, ALuint buffer);
+
+    void queueBuffers(PlayingSound &sound);
+
     uint32_t getNextRequestID(){
         return soundRequestID++;
     }
 
     void pausePlay() {
         this->paused = true;
+        wakeSoundManager();
     }
 
     void resumePlay() {
         this->resumed = true;
+        wakeSoundManager();
     }
 
     std::string getErrorString(ALenum error ) {
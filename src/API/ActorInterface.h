@@ -23,6 +23,7 @@ public:
         bool routeToPlayer = false;
         bool routeToCustomPosition = false;
         glm::vec3 customPosition;
+        uint32_t visibilityUpdateInterval = 0;//in game time, player visibility is tested at most this often. 0 means every tick
     };
 
 private:
@@ -54,6 +55,7 @@ public:
         uint32_t maximumRouteDistance = 128;//in node count
         bool routeFound = false;
         bool routeReady = false;
+        uint64_t routeTime = 0;//game time route was calculated, routes of the same target are shared for a while
         bool playerDead = false;
     };
 
@@ -103,6 +105,10 @@ public:
 
     glm::vec3 getFrontVector() const;
 
+    uint32_t getVisibilityUpdateInterval() const {
+        return informationRequest.visibilityUpdateInterval;
+    }
+
     /**
      * Remove requests after this method is called
      *
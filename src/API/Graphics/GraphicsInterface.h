@@ -17,6 +17,13 @@
 #define NR_TOTAL_LIGHTS 4
 #define NR_MAX_MODELS (4096)
 #define NR_MAX_MATERIALS 2000
+//clustered light and cluster sizes are also defined in Engine/Shaders/clusteredLights.glsl, they must match
+#define NR_MAX_CLUSTERED_LIGHTS 192
+#define NR_MAX_LIGHT_CLUSTER_INDICES (64 * 1024)
+#define LIGHT_CLUSTER_X 16
+#define LIGHT_CLUSTER_Y 9
+#define LIGHT_CLUSTER_Z 24
+#define LIGHT_CLUSTER_INDEX_TEXTURE_WIDTH 1024
 
 #include "Options.h"
 #include "Uniform.h"
@@ -61,8 +68,29 @@ protected:
     virtual void loadTextureData(uint32_t textureID, int height, int width, TextureTypes type, InternalFormatTypes internalFormat, FormatTypes format, DataTypes dataType, uint32_t depth,
                          void *data, void *data2, void *data3, void *data4, void *data5, void *data6) = 0;
 
+    /**
+     * Updates a region of a 2D texture without re-specifying it, data is tightly packed width x height texels.
+     * Returns false if backend can't update regions, callers should load the whole texture instead.
+     */
+    virtual bool loadTextureData2DRegion(uint32_t textureID [[gnu::unused]], int32_t x [[gnu::unused]], int32_t y [[gnu::unused]],
+                                         uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]],
+                                         FormatTypes format [[gnu::unused]], DataTypes dataType [[gnu::unused]], const void *data [[gnu::unused]]) {
+        return false;
+    }
+
     //Should be used by GraphicsProgramOnly
     virtual uint32_t createGraphicsProgram(const std::string &vertexShaderContent, const std::string &geometryShaderContent, const std::string &fragmentShaderContent) = 0;
+
+    /**
+     * Program binaries for the shader cache. Backends that can't provide them return false and 0.
+     * createGraphicsProgramFromBinary returns 0 if the driver rejects the binary, then the program should be compiled from sources.
+     */
+    virtual bool getProgramBinary(uint32_t programID [[gnu::unused]], uint32_t& binaryFormat [[gnu::unused]], std::vector<uint8_t>& binary [[gnu::unused]]) {
+        return false;
+    }
+    virtual uint32_t createGraphicsProgramFromBinary(uint32_t binaryFormat [[gnu::unused]], const std::vector<uint8_t>& binary [[gnu::unused]]) {
+        return 0;
+    }
 public:
 
     struct ContextInformation {
@@ -74,9 +102,58 @@ public:
         std::string shaderHeader;
     };
 
+    /**
+     * Calls made to the backend since the last clearFrame. Only recording backends fill it.
+     */
+    struct FrameStatistics {
+        uint32_t drawCalls = 0;
+        uint32_t instancedDrawCalls = 0;
+        uint64_t instances = 0;
+        uint64_t triangles = 0;
+        uint32_t lineDrawCalls = 0;
+        uint64_t lines = 0;
+        uint32_t uniformSets = 0;
+        uint32_t programSwitches = 0;
+        uint32_t textureBinds = 0;
+        uint32_t renderStageSwitches = 0;
+        uint32_t materialSets = 0;
+        uint32_t modelTransformSets = 0;
+        uint32_t modelTransformUploads = 0;
+        uint64_t bufferBytesUploaded = 0;
+        uint64_t textureBytesUploaded = 0;
+        uint64_t commandHash = 0;//hash of call types and counts, same world and frame count should produce the same value
+    };
+
+    struct GPUTimerResult {
+        const char* name;
+        uint32_t depth;
+        uint64_t start;//GPU clock, nanoseconds
+        uint64_t end;
+    };
+
     virtual void getRenderTriangleAndLineCount(uint32_t& triangleCount, uint32_t& lineCount) = 0;
+    virtual bool getFrameStatistics(FrameStatistics& statistics [[gnu::unused]]) const {
+        return false;
+    }
+
+    /**
+     * GPU timers for profiling. Timers can be nested. collectGPUTimers returns finished timers in begin order, and never
+     * waits for the GPU. Backends without timer queries return false from beginGPUTimer, and endGPUTimer must not be called then.
+     */
+    virtual bool beginGPUTimer(const char* name [[gnu::unused]]) {
+        return false;
+    }
+    virtual void endGPUTimer() {}
+    virtual void collectGPUTimers(std::vector<GPUTimerResult>& results [[gnu::unused]]) {}
     explicit GraphicsInterface(OptionsUtil::Options *options [[gnu::unused]]) {};
     virtual ContextInformation getContextInformation() = 0;
+
+    /**
+     * Identifies the driver for the shader cache, cached programs are only used by the same identity. Empty disables the cache.
+     */
+    virtual std::string getProgramBinaryIdentity() {
+        return "";
+    }
     virtual bool createGraphicsBackend() = 0;
     virtual ~GraphicsInterface() {};
 
@@ -124,6 +201,26 @@ public:
                                         FrameBufferAttachPoints attachPoint, int32_t layer = 0 , bool clear = false) = 0;
 
     virtual void attachTexture(unsigned int textureID, unsigned int attachPoint) = 0;
+
+    /**
+     * Copies width x height texels starting from origin of a 2D texture into another 2D texture, at given offset. Used to pack
+     * textures that don't keep their pixels on CPU. Returns false if backend can't copy, callers should use the source as is.
+     */
+    virtual bool copyTexture2DRegion(uint32_t sourceTextureID [[gnu::unused]], uint32_t destinationTextureID [[gnu::unused]],
+                                     int32_t destinationX [[gnu::unused]], int32_t destinationY [[gnu::unused]],
+                                     uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) {
+        return false;
+    }
+
+    /**
+     * Copies layerCount depth layers starting from firstLayer, between two layered textures of same type, size and format.
+     * Cube map array layers are layer-faces. Used to restore cached shadow maps. Returns false if backend can't copy.
+     */
+    virtual bool copyDepthLayers(uint32_t sourceTextureID [[gnu::unused]], uint32_t destinationTextureID [[gnu::unused]],
+                                 TextureTypes textureType [[gnu::unused]], uint32_t firstLayer [[gnu::unused]],
+                                 uint32_t layerCount [[gnu::unused]], uint32_t width [[gnu::unused]], uint32_t height [[gnu::unused]]) {
+        return false;
+    }
     virtual void attach2DArrayTexture(unsigned int textureID, unsigned int attachPoint) = 0;
     virtual void attachCubeMap(unsigned int cubeMapID, unsigned int attachPoint) = 0;
     virtual void attachCubeMapArrayTexture(unsigned int textureID, unsigned int attachPoint) = 0;
@@ -157,6 +254,13 @@ public:
 
     virtual void removeLight(const int i) = 0;
 
+    /**
+     * Point lights that are not in the light slots, culled to view space clusters on CPU. Layouts are explained in LightClusterBuilder.
+     * lights has 4 vec4 per light, clusterRanges has offset and count per cluster, lightIndices are the light indices of all clusters.
+     */
+    virtual void setClusteredLights(const std::vector<glm::vec4> &lights, const std::vector<uint32_t> &clusterRanges,
+                                    const std::vector<uint32_t> &lightIndices, const glm::vec4 &clusterDepthParameters) = 0;
+
     virtual void setPlayerMatrices(const glm::vec3 &cameraPosition, const glm::mat4 &cameraMatrix, long currentTime) = 0;
 
     virtual void switchRenderStage(uint32_t width, uint32_t height, uint32_t frameBufferID, bool blendEnabled, bool depthTestEnabled, bool depthWriteEnabled, bool scissorEnabled,
@@ -169,7 +273,12 @@ public:
     virtual int getMaxTextureImageUnits() const = 0;
 
     virtual void setMaterial(const Material& material) = 0;
+    /**
+     * Transforms set by setModel are staged on CPU side, they reach GPU when flushModelTransforms is called.
+     * Backends flush before each draw too, explicit call is to make the upload happen once per frame.
+     */
     virtual void setModel(const uint32_t modelID, const glm::mat4 &worldTransform) = 0;
+    virtual void flushModelTransforms() = 0;
     virtual void setModelIndexesUBO(const std::vector<uint32_t> &modelIndicesList) = 0;
     virtual void attachModelIndicesUBO(const uint32_t programID) = 0;
 
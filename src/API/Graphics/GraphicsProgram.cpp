@@ -5,13 +5,15 @@
 #include "GraphicsProgram.h"
 #include "Assets/AssetManager.h"
 #include "GraphicsProgramPreprocessor.h"
+#include "GraphicsProgramCache.h"
+
+const std::string GraphicsProgram::SHADER_CACHE_DIRECTORY = "./Engine/ShaderCache/";
 
 GraphicsProgram::GraphicsProgram(AssetManager* assetManager, const std::string& vertexShader, const std::string& fragmentShader, bool isMaterialUsed) :
         assetManager(assetManager), graphicsWrapper(assetManager->getGraphicsWrapper()), materialRequired(isMaterialUsed) {
     graphicsProgramAsset = assetManager->loadAsset<GraphicsProgramAsset>({vertexShader, fragmentShader});
     GraphicsProgramPreprocessor::preprocess(this, assetManager->getGraphicsWrapper()->getContextInformation().shaderHeader, assetManager->getGraphicsWrapper()->getOptions()->getAllOptions());
-    programID = graphicsWrapper->createGraphicsProgram(vertexShaderContent, "", fragmentShaderContent);
-    graphicsProgramAsset->lateInitialize(programID);
+    createProgram();
     if(materialRequired) {
         setSamplersAndUBOs();
     }
@@ -21,15 +23,56 @@ GraphicsProgram::GraphicsProgram(AssetManager* assetManager, const std::string&
         assetManager(assetManager), graphicsWrapper(assetManager->getGraphicsWrapper()), materialRequired(isMaterialUsed) {
     graphicsProgramAsset = assetManager->loadAsset<GraphicsProgramAsset>({vertexShader, geometryShader, fragmentShader});
     GraphicsProgramPreprocessor::preprocess(this, assetManager->getGraphicsWrapper()->getContextInformation().shaderHeader, assetManager->getGraphicsWrapper()->getOptions()->getAllOptions());
-
-    programID = graphicsWrapper->createGraphicsProgram(vertexShaderContent, geometryShaderContent, fragmentShaderContent);
-    graphicsProgramAsset->lateInitialize(programID);
+    createProgram();
     if(materialRequired) {
         setSamplersAndUBOs();
     }
 
 }
 
+void GraphicsProgram::createProgram() {
+    std::string backendIdentity;
+    if(graphicsWrapper->getOptions()->getOption<bool>(HASH("shaderCacheEnabled")).getOrDefault(true)) {
+        backendIdentity = graphicsWrapper->getProgramBinaryIdentity();
+    }
+    if(backendIdentity.empty()) {
+        programID = graphicsWrapper->createGraphicsProgram(vertexShaderContent, geometryShaderContent, fragmentShaderContent);
+        graphicsProgramAsset->lateInitialize(programID);
+        return;
+    }
+
+    //preprocessed sources already have option values in them, so the key changes when options or shader files change
+    uint64_t cacheKey = GraphicsProgramCache::calculateKey(backendIdentity, vertexShaderContent, geometryShaderContent, fragmentShaderContent);
+    GraphicsProgramCache::Entry cacheEntry;
+    if(GraphicsProgramCache::load(SHADER_CACHE_DIRECTORY, cacheKey, backendIdentity, cacheEntry)) {
+        programID = 0;
+        if(!cacheEntry.binary.empty()) {
+            programID = graphicsWrapper->createGraphicsProgramFromBinary(cacheEntry.binaryFormat, cacheEntry.binary);
+        }
+        if(programID != 0 || cacheEntry.binary.empty()) {
+            bool binaryUsed = programID != 0;
+            if(!binaryUsed) {
+                programID = graphicsWrapper->createGraphicsProgram(vertexShaderContent, geometryShaderContent, fragmentShaderContent);
+            }
+            graphicsProgramAsset->initializeFromCache(cacheEntry.uniformMap, cacheEntry.attributesMap, cacheEntry.outputMap);
+            GraphicsProgramCache::countHit(binaryUsed);
+            return;
+        }
+        //driver rejected the binary, locations might be different too, so compile and reflect again
+        GraphicsProgramCache::countBinaryRejected();
+    }
+    GraphicsProgramCache::countMiss();
+    programID = graphicsWrapper->createGraphicsProgram(vertexShaderContent, geometryShaderContent, fragmentShaderContent);
+    graphicsProgramAsset->lateInitialize(programID);
+
+    GraphicsProgramCache::Entry newEntry;
+    newEntry.uniformMap = graphicsProgramAsset->getUniformMap();
+    newEntry.attributesMap = graphicsProgramAsset->getAttributesMap();
+    newEntry.outputMap = graphicsProgramAsset->getOutputMap();
+    graphicsWrapper->getProgramBinary(programID, newEntry.binaryFormat, newEntry.binary);
+    GraphicsProgramCache::save(SHADER_CACHE_DIRECTORY, cacheKey, backendIdentity, newEntry);
+}
+
 GraphicsProgram::~GraphicsProgram() {
     if(graphicsProgramAsset->getGeometryShaderFile().empty()) {
         assetManager->freeAsset({graphicsProgramAsset->getVertexShaderFile(), graphicsProgramAsset->getFragmentShaderFile()});
@@ -9,9 +9,12 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <cstring>
 #include <Assets/GraphicsProgramAsset.h>
 #include "API/Graphics/GraphicsInterface.h"
 #include "API/Graphics/Uniform.h"
+#include "API/Graphics/UniformHandle.h"
+#include <glm/gtc/type_ptr.hpp>
 
 class GraphicsProgramLoader;
 
@@ -25,9 +28,122 @@ class GraphicsProgram {
     uint32_t programID;
     std::string vertexShaderContent, geometryShaderContent, fragmentShaderContent;
 
+    static const std::string SHADER_CACHE_DIRECTORY;
+
     //TODO remove with material editor
     void setSamplersAndUBOs();
 
+    /**
+     * Creates the program from preprocessed sources, using the shader cache if it has the program.
+     */
+    void createProgram();
+
+    struct HandleSlot {
+        const std::string* name = nullptr;//registry name of the handle this slot resolved for
+        const Uniform* uniform = nullptr;
+    };
+    std::vector<HandleSlot> handleSlots;//indexed by handle id
+    std::vector<std::vector<uint8_t>> uniformShadows;//last value uploaded, indexed by Uniform::index. Empty means unknown
+
+    static uint64_t& skippedUniformUploadCounter() {
+        static uint64_t skippedUploadCount = 0;
+        return skippedUploadCount;
+    }
+
+    const Uniform* resolveHandle(const UniformHandleBase &handle) {
+        if(handle.getID() >= handleSlots.size()) {
+            handleSlots.resize(handle.getID() + 1);
+        }
+        HandleSlot& slot = handleSlots[handle.getID()];
+        if(slot.name != handle.getName()) {
+            slot.name = handle.getName();
+            slot.uniform = graphicsProgramAsset->getUniform(*handle.getName());
+        }
+        return slot.uniform;
+    }
+
+    /**
+     * Uploads using upload() only if value is different than the last uploaded value of the uniform.
+     */
+    template<typename Upload>
+    bool uploadIfChanged(const Uniform* uniform, const void* value, size_t size, Upload upload) {
+        if(uniform->index >= uniformShadows.size()) {
+            uniformShadows.resize(uniform->index + 1);
+        }
+        std::vector<uint8_t>& shadow = uniformShadows[uniform->index];
+        if(shadow.size() == size && memcmp(shadow.data(), value, size) == 0) {
+            ++skippedUniformUploadCounter();
+            return true;
+        }
+        if(!upload()) {
+            shadow.clear();
+            return false;
+        }
+        shadow.assign(static_cast<const uint8_t*>(value), static_cast<const uint8_t*>(value) + size);
+        return true;
+    }
+
+    bool setUniformValue(const Uniform* uniform, const glm::mat4 &matrix) {
+        if(uniform == nullptr || uniform->type != Uniform::VariableTypes::FLOAT_MAT4) {
+            return false;
+        }
+        return uploadIfChanged(uniform, glm::value_ptr(matrix), sizeof(glm::mat4), [&]() {
+            return graphicsWrapper->setUniform(programID, uniform->location, matrix);
+        });
+    }
+
+    bool setUniformValue(const Uniform* uniform, const glm::vec3 &vector) {
+        if(uniform == nullptr || uniform->type != Uniform::VariableTypes::FLOAT_VEC3) {
+            return false;
+        }
+        return uploadIfChanged(uniform, glm::value_ptr(vector), sizeof(glm::vec3), [&]() {
+            return graphicsWrapper->setUniform(programID, uniform->location, vector);
+        });
+    }
+
+    bool setUniformValue(const Uniform* uniform, const std::vector<glm::vec3> &vectorArray) {
+        if(uniform == nullptr || uniform->type != Uniform::VariableTypes::FLOAT_VEC3 || vectorArray.empty()) {
+            return false;
+        }
+        return uploadIfChanged(uniform, vectorArray.data(), sizeof(glm::vec3) * vectorArray.size(), [&]() {
+            return graphicsWrapper->setUniform(programID, uniform->location, vectorArray);
+        });
+    }
+
+    bool setUniformValue(const Uniform* uniform, const float value) {
+        if(uniform == nullptr || uniform->type != Uniform::VariableTypes::FLOAT) {
+            return false;
+        }
+        return uploadIfChanged(uniform, &value, sizeof(float), [&]() {
+            return graphicsWrapper->setUniform(programID, uniform->location, value);
+        });
+    }
+
+    bool setUniformValue(const Uniform* uniform, const int value) {
+        if(uniform == nullptr ||
+           (uniform->type != Uniform::VariableTypes::BOOL &&
+            uniform->type != Uniform::VariableTypes::INT &&
+            uniform->type != Uniform::VariableTypes::CUBEMAP &&
+            uniform->type != Uniform::VariableTypes::CUBEMAP_ARRAY &&
+            uniform->type != Uniform::VariableTypes::TEXTURE_2D &&
+            uniform->type != Uniform::VariableTypes::TEXTURE_2D_ARRAY)) {
+            return false;
+        }
+        return uploadIfChanged(uniform, &value, sizeof(int), [&]() {
+            return graphicsWrapper->setUniform(programID, uniform->location, value);
+        });
+    }
+
+    bool setUniformValue(const Uniform* uniform, const std::vector<glm::mat4> &matrixArray) {
+        if(uniform == nullptr || uniform->type != Uniform::VariableTypes::FLOAT_MAT4 || matrixArray.empty()) {
+            return false;
+        }
+        //FIXME this should have a control of some sort
+        return uploadIfChanged(uniform, matrixArray.data(), sizeof(glm::mat4) * matrixArray.size(), [&]() {
+            return graphicsWrapper->setUniformArray(programID, uniform->location, matrixArray);
+        });
+    }
+
 public:
 
     GraphicsProgram(AssetManager* assetManager, const std::string& vertexShader, const std::string& fragmentShader, bool isMaterialUsed);
@@ -50,19 +166,19 @@ public:
     }
 
     bool setUniform(const std::string &uniformName, const glm::mat4 &matrix) {
-        return graphicsProgramAsset->setUniform(this->programID, uniformName, matrix);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformName), matrix);
     }
 
     bool setUniform(const std::string &uniformName, const glm::vec3 &vector) {
-        return graphicsProgramAsset->setUniform(this->programID, uniformName, vector);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformName), vector);
     }
 
     bool setUniform(const std::string &uniformName, const std::vector<glm::vec3> &vectorArray) {
-        return graphicsProgramAsset->setUniform(this->programID, uniformName, vectorArray);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformName), vectorArray);
     }
 
     bool setUniform(const std::string &uniformName, const float value) {
-        return graphicsProgramAsset->setUniform(this->programID, uniformName, value);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformName), value);
     }
 /**
  * This method is used to set samplers, so it can alter int uniforms, and sampler uniforms.
@@ -71,11 +187,27 @@ public:
  * @return
  */
     bool setUniform(const std::string &uniformName, const int value) {
-        return graphicsProgramAsset->setUniform(this->programID, uniformName, value);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformName), value);
     }
 
     bool setUniformArray(const std::string &uniformArrayName, const std::vector<glm::mat4> &matrix) {
-        return graphicsProgramAsset->setUniformArray(this->programID, uniformArrayName, matrix);
+        return setUniformValue(graphicsProgramAsset->getUniform(uniformArrayName), matrix);
+    }
+
+    /**
+     * Same as setting by name, but the name lookup is done once per program and handle.
+     * Value type is not deduced from value, so setUniform(intHandle, true) works like the name version.
+     */
+    template<typename T>
+    bool setUniform(const UniformHandle<T> &handle, const typename UniformHandle<T>::ValueType &value) {
+        return setUniformValue(resolveHandle(handle), value);
+    }
+
+    /**
+     * Uniform uploads skipped because program already had the same value, since start. Only counts the calls of engine.
+     */
+    static uint64_t getSkippedUniformUploadCount() {
+        return skippedUniformUploadCounter();
     }
 
     const std::string &getProgramName() const {
@@ -0,0 +1,166 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "GraphicsProgramCache.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef CEREAL_SUPPORT
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/unordered_map.hpp>
+#endif
+
+namespace {
+    const uint32_t CACHE_FILE_MAGIC = 0x4C475043;//"LGPC"
+    const uint32_t CACHE_FILE_VERSION = 1;
+
+    uint64_t hashFNV1a(uint64_t hash, const std::string &value) {
+        for (unsigned char character : value) {
+            hash ^= character;
+            hash *= 1099511628211ULL;
+        }
+        //separator, so moving text between stages changes the hash
+        hash ^= 0xFF;
+        hash *= 1099511628211ULL;
+        return hash;
+    }
+
+#ifdef CEREAL_SUPPORT
+    /**
+     * Uniform has no default constructor, so it is written field by field.
+     */
+    struct CachedUniform {
+        uint32_t location = 0;
+        std::string name;
+        uint32_t type = 0;
+        uint32_t size = 0;
+
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(location, name, type, size);
+        }
+    };
+
+    struct CachedOutput {
+        uint32_t type = 0;
+        uint32_t attachPoint = 0;
+
+        template<class Archive>
+        void serialize(Archive &archive) {
+            archive(type, attachPoint);
+        }
+    };
+#endif
+}
+
+uint64_t GraphicsProgramCache::calculateKey(const std::string &backendIdentity, const std::string &vertexShaderContent,
+                                            const std::string &geometryShaderContent, const std::string &fragmentShaderContent) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashFNV1a(hash, backendIdentity);
+    hash = hashFNV1a(hash, vertexShaderContent);
+    hash = hashFNV1a(hash, geometryShaderContent);
+    hash = hashFNV1a(hash, fragmentShaderContent);
+    return hash;
+}
+
+std::string GraphicsProgramCache::getFileName(const std::string &cacheDirectory, uint64_t key) {
+    std::stringstream fileName;
+    fileName << cacheDirectory << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return fileName.str();
+}
+
+bool GraphicsProgramCache::load(const std::string &cacheDirectory, uint64_t key, const std::string &backendIdentity, Entry &entry) {
+#ifdef CEREAL_SUPPORT
+    std::ifstream file(getFileName(cacheDirectory, key), std::ios::binary);
+    if(!file.is_open()) {
+        return false;
+    }
+    try {
+        cereal::BinaryInputArchive archive(file);
+        uint32_t magic = 0, version = 0;
+        std::string identity;
+        archive(magic, version);
+        if(magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION) {
+            return false;
+        }
+        archive(identity);
+        if(identity != backendIdentity) {
+            return false;//hash collision between drivers
+        }
+        std::vector<CachedUniform> uniforms;
+        std::unordered_map<std::string, CachedOutput> outputs;
+        archive(uniforms, entry.attributesMap, outputs, entry.binaryFormat, entry.binary);
+        entry.uniformMap.clear();
+        for (const CachedUniform &uniform : uniforms) {
+            entry.uniformMap[uniform.name] = std::make_shared<Uniform>(uniform.location, uniform.name, static_cast<Uniform::VariableTypes>(uniform.type), uniform.size);
+        }
+        entry.outputMap.clear();
+        for (const auto &output : outputs) {
+            entry.outputMap[output.first] = std::make_pair(static_cast<Uniform::VariableTypes>(output.second.type),
+                                                           static_cast<GraphicsInterface::FrameBufferAttachPoints>(output.second.attachPoint));
+        }
+    } catch (cereal::Exception &exception) {
+        std::cerr << "Shader cache file for key " << std::hex << key << std::dec << " is corrupted, ignoring. " << exception.what() << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)cacheDirectory; (void)key; (void)backendIdentity; (void)entry;
+    return false;
+#endif
+}
+
+bool GraphicsProgramCache::save(const std::string &cacheDirectory, uint64_t key, const std::string &backendIdentity, const Entry &entry) {
+#ifdef CEREAL_SUPPORT
+    std::ofstream file(getFileName(cacheDirectory, key), std::ios::binary);
+    if(!file.is_open()) {
+        static bool warned = false;
+        if(!warned) {
+            std::cerr << "Shader cache directory " << cacheDirectory << " is not writable, programs won't be cached." << std::endl;
+            warned = true;
+        }
+        return false;
+    }
+    std::vector<CachedUniform> uniforms;
+    uniforms.reserve(entry.uniformMap.size());
+    for (const auto &uniform : entry.uniformMap) {
+        CachedUniform cachedUniform;
+        cachedUniform.location = uniform.second->location;
+        cachedUniform.name = uniform.second->name;
+        cachedUniform.type = static_cast<uint32_t>(uniform.second->type);
+        cachedUniform.size = uniform.second->size;
+        uniforms.push_back(cachedUniform);
+    }
+    std::unordered_map<std::string, CachedOutput> outputs;
+    for (const auto &output : entry.outputMap) {
+        CachedOutput cachedOutput;
+        cachedOutput.type = static_cast<uint32_t>(output.second.first);
+        cachedOutput.attachPoint = static_cast<uint32_t>(output.second.second);
+        outputs[output.first] = cachedOutput;
+    }
+    cereal::BinaryOutputArchive archive(file);
+    archive(CACHE_FILE_MAGIC, CACHE_FILE_VERSION, backendIdentity);
+    archive(uniforms, entry.attributesMap, outputs, entry.binaryFormat, entry.binary);
+    return true;
+#else
+    (void)cacheDirectory; (void)key; (void)backendIdentity; (void)entry;
+    return false;
+#endif
+}
+
+void GraphicsProgramCache::printReport(const std::string &reason) {
+    Statistics& statistics = getStatistics();
+    if(statistics.hits + statistics.misses == 0) {
+        return;
+    }
+    std::cout << "Shader cache (" << reason << "): " << statistics.hits << " hits (" << statistics.binaryHits << " with binary), "
+              << statistics.misses << " misses, " << statistics.binaryRejected << " binaries rejected by driver." << std::endl;
+    statistics = Statistics();
+}
@@ -0,0 +1,81 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_GRAPHICSPROGRAMCACHE_H
+#define LIMONENGINE_GRAPHICSPROGRAMCACHE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "API/Graphics/Uniform.h"
+#include "API/Graphics/GraphicsInterface.h"
+
+/**
+ * On disk cache of linked graphics programs, one file per program.
+ *
+ * Key is the hash of preprocessed shader sources and backend identity. Option values used by shaders are written to
+ * the sources by the preprocessor, so changing an option, a shader file or the driver creates a new key, old files are
+ * simply not used anymore.
+ *
+ * Reflection results (uniforms, attributes, outputs) are always stored, program binary is stored only if backend supports it.
+ */
+class GraphicsProgramCache {
+public:
+    struct Entry {
+        std::unordered_map<std::string, std::shared_ptr<Uniform>> uniformMap;
+        std::unordered_map<std::string, uint32_t> attributesMap;
+        std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>> outputMap;
+        uint32_t binaryFormat = 0;
+        std::vector<uint8_t> binary;
+    };
+
+    static uint64_t calculateKey(const std::string &backendIdentity, const std::string &vertexShaderContent,
+                                 const std::string &geometryShaderContent, const std::string &fragmentShaderContent);
+
+    /**
+     * Returns false if there is no valid entry for the key. Entries created by another backend identity are rejected too.
+     */
+    static bool load(const std::string &cacheDirectory, uint64_t key, const std::string &backendIdentity, Entry &entry);
+    static bool save(const std::string &cacheDirectory, uint64_t key, const std::string &backendIdentity, const Entry &entry);
+
+    static void countHit(bool binaryUsed) {
+        getStatistics().hits++;
+        if(binaryUsed) {
+            getStatistics().binaryHits++;
+        }
+    }
+
+    static void countMiss() {
+        getStatistics().misses++;
+    }
+
+    static void countBinaryRejected() {
+        getStatistics().binaryRejected++;
+    }
+
+    /**
+     * Prints hits and misses since last report, then resets them.
+     */
+    static void printReport(const std::string &reason);
+
+private:
+    struct Statistics {
+        uint32_t hits = 0;
+        uint32_t binaryHits = 0;
+        uint32_t misses = 0;
+        uint32_t binaryRejected = 0;
+    };
+
+    static Statistics& getStatistics() {
+        static Statistics statistics;
+        return statistics;
+    }
+
+    static std::string getFileName(const std::string &cacheDirectory, uint64_t key);
+};
+
+
+#endif //LIMONENGINE_GRAPHICSPROGRAMCACHE_H
@@ -0,0 +1,139 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_MODELTRANSFORMSTAGING_H
+#define LIMONENGINE_MODELTRANSFORMSTAGING_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+/**
+ * CPU mirror of the all model transforms texture, so backends can upload changed transforms once per frame,
+ * instead of one upload per setModel call.
+ *
+ * Layout is the same as the texture: 2 rows of 4 * maxModels RGBA texels. Row 0 keeps the world transform,
+ * row 1 keeps the transpose inverse of it, only first 3 texels are used. Transpose inverse is calculated
+ * during flush, so a model moved multiple times in a frame pays for it once.
+ *
+ * Dirty models are merged to ranges, small gaps of clean models are uploaded too, since they are cheaper than
+ * another upload call.
+ */
+class ModelTransformStaging {
+public:
+    static constexpr uint32_t FLOATS_PER_MODEL_ROW = 16;//4 RGBA texels
+    static constexpr uint32_t MAX_MERGE_GAP = 16;//models
+
+private:
+    uint32_t maxModels;
+    std::vector<float> data;
+    std::vector<uint64_t> dirtyBits;
+    uint32_t dirtyMin;
+    uint32_t dirtyMax = 0;
+    uint32_t dirtyCount = 0;
+
+    float* row(uint32_t rowIndex, uint32_t modelID) {
+        return &data[((size_t)rowIndex * maxModels + modelID) * FLOATS_PER_MODEL_ROW];
+    }
+
+public:
+    explicit ModelTransformStaging(uint32_t maxModels) :
+            maxModels(maxModels),
+            data((size_t)maxModels * FLOATS_PER_MODEL_ROW * 2, 0.0f),
+            dirtyBits((maxModels + 63) / 64, 0),
+            dirtyMin(maxModels) {}
+
+    /**
+     * Row length of the staging data in texels, backends should set it as unpack row length, so both rows are uploaded by one call.
+     */
+    uint32_t getRowLengthInTexels() const {
+        return maxModels * 4;
+    }
+
+    bool isDirty() const {
+        return dirtyCount > 0;
+    }
+
+    uint32_t getDirtyCount() const {
+        return dirtyCount;
+    }
+
+    bool set(uint32_t modelID, const glm::mat4 &worldTransform) {
+        if(modelID >= maxModels) {
+            return false;
+        }
+        memcpy(row(0, modelID), glm::value_ptr(worldTransform), sizeof(float) * FLOATS_PER_MODEL_ROW);
+        uint64_t bit = 1ull << (modelID % 64);
+        if((dirtyBits[modelID / 64] & bit) == 0) {
+            dirtyBits[modelID / 64] |= bit;
+            ++dirtyCount;
+            dirtyMin = std::min(dirtyMin, modelID);
+            dirtyMax = std::max(dirtyMax, modelID);
+        }
+        return true;
+    }
+
+    /**
+     * Calls upload(startModelID, modelCount, data) for each dirty range, data points to row 0 of the start model.
+     * Returns number of upload calls made.
+     */
+    template<typename Upload>
+    uint32_t flush(Upload upload) {
+        if(dirtyCount == 0) {
+            return 0;
+        }
+        uint32_t uploadCount = 0;
+        uint32_t rangeStart = 0, rangeEnd = 0;//rangeEnd is exclusive
+        bool rangeOpen = false;
+        for (uint32_t word = dirtyMin / 64; word <= dirtyMax / 64; ++word) {
+            uint64_t bits = dirtyBits[word];
+            dirtyBits[word] = 0;
+            while (bits != 0) {
+                uint32_t modelID = word * 64 + countTrailingZeros(bits);
+                bits &= bits - 1;
+                glm::mat4 transposeInverse = glm::transpose(glm::inverse(glm::make_mat4(row(0, modelID))));
+                memcpy(row(1, modelID), glm::value_ptr(transposeInverse), sizeof(float) * 12);
+                if(rangeOpen && modelID - rangeEnd <= MAX_MERGE_GAP) {
+                    rangeEnd = modelID + 1;
+                    continue;
+                }
+                if(rangeOpen) {
+                    upload(rangeStart, rangeEnd - rangeStart, (const float*)row(0, rangeStart));
+                    ++uploadCount;
+                }
+                rangeStart = modelID;
+                rangeEnd = modelID + 1;
+                rangeOpen = true;
+            }
+        }
+        if(rangeOpen) {
+            upload(rangeStart, rangeEnd - rangeStart, (const float*)row(0, rangeStart));
+            ++uploadCount;
+        }
+        dirtyCount = 0;
+        dirtyMin = maxModels;
+        dirtyMax = 0;
+        return uploadCount;
+    }
+
+private:
+    static uint32_t countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return (uint32_t)__builtin_ctzll(value);
+#else
+        uint32_t count = 0;
+        while ((value & 1ull) == 0) {
+            value >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+};
+
+
+#endif //LIMONENGINE_MODELTRANSFORMSTAGING_H
@@ -29,6 +29,7 @@ public:
     std::string name;
     VariableTypes type;
     unsigned int size;
+    unsigned int index = 0;//dense index in the program, set after the program is linked, used to keep per program state
 
     Uniform(unsigned int location, const std::string &name, VariableTypes type, unsigned int size) : location(
             location), name(name), type(type), size(size) {}
@@ -0,0 +1,63 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_UNIFORMHANDLE_H
+#define LIMONENGINE_UNIFORMHANDLE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * Uniform name resolved to a process wide id once, so setting it doesn't hash the name on every call.
+ * Same handle can be used with any program, each program maps the id to its own uniform on first use.
+ *
+ * Handles should be created once, like function local statics, creating them is as costly as setting a uniform by name.
+ */
+class UniformHandleBase {
+    uint32_t id;
+    const std::string* name;
+
+    struct Registry {
+        std::mutex mutex;
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    static Registry& getRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+protected:
+    explicit UniformHandleBase(const std::string &uniformName) {
+        Registry& registry = getRegistry();
+        std::unique_lock<std::mutex> lock(registry.mutex);
+        auto result = registry.ids.emplace(uniformName, (uint32_t)registry.ids.size());
+        id = result.first->second;
+        name = &result.first->first;//map nodes never move
+    }
+
+public:
+    uint32_t getID() const {
+        return id;
+    }
+
+    /**
+     * Pointer is unique per registry, programs use it to detect handles from another registry, like ones created in extension libraries.
+     */
+    const std::string* getName() const {
+        return name;
+    }
+};
+
+template<typename T>
+class UniformHandle : public UniformHandleBase {
+public:
+    typedef T ValueType;
+    explicit UniformHandle(const std::string &uniformName) : UniformHandleBase(uniformName) {}
+};
+
+#endif //LIMONENGINE_UNIFORMHANDLE_H
@@ -198,6 +198,10 @@ std::vector<uint32_t> LimonAPI::getModelChildren(uint32_t modelID) {
     return worldGetModelChildren(modelID);
 }
 
+std::vector<uint32_t> LimonAPI::getObjectsInRadius(const LimonTypes::Vec4& center, float radius) {
+    return worldGetObjectsInRadius(center, radius);
+}
+
 std::string LimonAPI::getModelAnimationName(uint32_t modelID) {
     return worldGetModelAnimationName(modelID);
 }
@@ -218,6 +222,22 @@ bool LimonAPI::setModelAnimationSpeed(uint32_t modelID, float speed) {
     return worldSetModelAnimationSpeed(modelID, speed);
 }
 
+int32_t LimonAPI::addModelAnimationLayer(uint32_t modelID, const std::string& maskRootBoneName, bool isAdditive) {
+    return worldAddModelAnimationLayer(modelID, maskRootBoneName, isAdditive);
+}
+
+bool LimonAPI::setModelAnimationLayerClip(uint32_t modelID, uint32_t layerIndex, const std::string& animationName, float weight, bool isLooped) {
+    return worldSetModelAnimationLayerClip(modelID, layerIndex, animationName, weight, isLooped);
+}
+
+bool LimonAPI::setModelAnimationLayerWeight(uint32_t modelID, uint32_t layerIndex, float weight) {
+    return worldSetModelAnimationLayerWeight(modelID, layerIndex, weight);
+}
+
+bool LimonAPI::removeModelAnimationLayers(uint32_t modelID) {
+    return worldRemoveModelAnimationLayers(modelID);
+}
+
 void LimonAPI::killPlayer() {
     worldKillPlayer();
 }
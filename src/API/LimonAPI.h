@@ -123,8 +123,28 @@ public:
     bool setModelAnimation(uint32_t modelID, const std::string& animationName, bool isLooped = true);
     bool setModelAnimationWithBlend(uint32_t modelID, const std::string& animationName, bool isLooped = true, long blendTime = 100);
     bool setModelAnimationSpeed(uint32_t modelID, float speed);
+
+    /**
+     * Adds an animation layer on top of the model animation. Layer can be limited to a bone and its children,
+     * empty bone name means whole body. Additive layers add the difference of their clips from the first frame.
+     *
+     * @return layer index, -1 if model or bone is not found
+     */
+    int32_t addModelAnimationLayer(uint32_t modelID, const std::string& maskRootBoneName, bool isAdditive = false);
+    /**
+     * Adds animation to the layer, or updates its weight. Clips of a layer are blended by their weights, 0 removes the clip.
+     */
+    bool setModelAnimationLayerClip(uint32_t modelID, uint32_t layerIndex, const std::string& animationName, float weight, bool isLooped = true);
+    bool setModelAnimationLayerWeight(uint32_t modelID, uint32_t layerIndex, float weight);
+    bool removeModelAnimationLayers(uint32_t modelID);
     std::vector<uint32_t> getModelChildren(uint32_t modelID);
 
+    /**
+     * Returns IDs of the models that have any part of their AABB closer than radius to center.
+     * Uses the world spatial tree, so it doesn't iterate all the objects.
+     */
+    std::vector<uint32_t> getObjectsInRadius(const LimonTypes::Vec4& center, float radius);
+
 
     long addTimedEvent(uint64_t waitTime, bool useWallTime, std::function<void(const std::vector<LimonTypes::GenericParameter>&)> methodToCall, std::vector<LimonTypes::GenericParameter> parameters);
     bool cancelTimedEvent(long handleId);
@@ -238,6 +258,7 @@ private:
     std::function<bool (LimonTypes::Vec4)> worldSetPlayerAttachmentOffset;
     std::function<uint32_t ()> worldGetPlayerAttachedModel;
     std::function<std::vector<uint32_t> (uint32_t)> worldGetModelChildren;
+    std::function<std::vector<uint32_t> (const LimonTypes::Vec4&, float)> worldGetObjectsInRadius;
     std::function<void ()> worldKillPlayer;
 
     std::function<std::string(uint32_t)> worldGetModelAnimationName;
@@ -245,6 +266,10 @@ private:
     std::function<bool(uint32_t, const std::string&, bool)> worldSetAnimationOfModel;
     std::function<bool(uint32_t, const std::string&, bool, long)> worldSetAnimationOfModelWithBlend;
     std::function<bool(uint32_t, float)> worldSetModelAnimationSpeed;
+    std::function<int32_t(uint32_t, const std::string&, bool)> worldAddModelAnimationLayer;
+    std::function<bool(uint32_t, uint32_t, const std::string&, float, bool)> worldSetModelAnimationLayerClip;
+    std::function<bool(uint32_t, uint32_t, float)> worldSetModelAnimationLayerWeight;
+    std::function<bool(uint32_t)> worldRemoveModelAnimationLayers;
 
     std::function<bool(const std::string&)> worldChangeRenderPipeline;
 
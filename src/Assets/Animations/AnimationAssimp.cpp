@@ -13,17 +13,16 @@
 //FIXME there must be a better way then is found.
 //FIXME requiring node name should not be a thing
 bool AnimationAssimp::calculateTransform(const std::string& nodeName, float time, Transformation& transformation) const {
-    bool status = false;
-    if (nodes.find(nodeName) == nodes.end()) { //if the bone has no animation, it can happen
-        return status;
+    auto nodeIt = nodes.find(nodeName);
+    if (nodeIt == nodes.end()) { //if the bone has no animation, it can happen
+        return false;
     }
-    status = true;
-    std::shared_ptr<AnimationNode> nodeAnimation = nodes.at(nodeName);
+    const AnimationNode* nodeAnimation = nodeIt->second.get();
 
     transformation.setScale(nodeAnimation->getScalingVector(time));
     transformation.setOrientation(nodeAnimation->getRotationQuat(time));
     transformation.setTranslate(nodeAnimation->getPositionVector(time));
-    return status;
+    return true;
 }
 
 AnimationAssimp::AnimationAssimp(aiAnimation *assimpAnimation) {
@@ -35,6 +35,14 @@ public:
 
     bool calculateTransform(const std::string& nodeName, float time, Transformation& transformation) const;
 
+    const AnimationNode* getChannel(const std::string& nodeName) const {
+        auto nodeIt = nodes.find(nodeName);
+        if(nodeIt == nodes.end()) {
+            return nullptr;
+        }
+        return nodeIt->second.get();
+    }
+
     float getTicksPerSecond() const {
         return ticksPerSecond;
     }
@@ -26,6 +26,14 @@ public:
 
     bool calculateTransform(const std::string& nodeName, float time, Transformation& transformation) const;
 
+    const AnimationNode* getChannel(const std::string& nodeName) const {
+        return baseAnimation->getChannel(nodeName);
+    }
+
+    float getChannelTimeOffset() const {
+        return startTime + baseAnimation->getChannelTimeOffset();
+    }
+
     float getTicksPerSecond() const {
         return baseAnimation->getTicksPerSecond();
     }
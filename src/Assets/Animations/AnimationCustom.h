@@ -45,6 +45,10 @@ public:
 
     bool calculateTransform(const std::string& nodeName __attribute((unused)), float time __attribute((unused)), Transformation& transformation) const;
 
+    const AnimationNode* getChannel(const std::string& nodeName __attribute((unused))) const {
+        return animationNode.get();//same as calculateTransform, node name is not used
+    }
+
     float getTicksPerSecond() const {
         return ticksPerSecond;
     }
@@ -0,0 +1,108 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include <algorithm>
+#include "AnimationGraph.h"
+
+int32_t AnimationGraph::addLayer(LayerMode mode, const std::string &maskRootBoneName) {
+    Layer layer;
+    layer.mode = mode;
+    if(!maskRootBoneName.empty()) {
+        layer.boneMask = modelAsset->buildBoneMask(maskRootBoneName);
+        if(layer.boneMask.empty()) {
+            return -1;
+        }
+    }
+    layers.push_back(layer);
+    return (int32_t)layers.size() - 1;
+}
+
+bool AnimationGraph::setLayerWeight(uint32_t layerIndex, float weight) {
+    if(layerIndex >= layers.size()) {
+        return false;
+    }
+    layers[layerIndex].weight = std::max(0.0f, std::min(1.0f, weight));
+    return true;
+}
+
+bool AnimationGraph::setClip(uint32_t layerIndex, const std::string &animationName, float weight, bool looped) {
+    if(layerIndex >= layers.size()) {
+        return false;
+    }
+    std::vector<Clip>& clips = layers[layerIndex].clips;
+    for (auto clipIt = clips.begin(); clipIt != clips.end(); ++clipIt) {
+        if(clipIt->animationName == animationName) {
+            if(weight <= 0.0f) {
+                clips.erase(clipIt);
+            } else {
+                clipIt->weight = weight;
+                clipIt->looped = looped;
+            }
+            return true;
+        }
+    }
+    if(weight <= 0.0f) {
+        return true;
+    }
+    const ModelAsset::CompiledAnimation* animation = modelAsset->findCompiledAnimation(animationName);
+    if(animation == nullptr) {
+        std::cerr << "Animation layer can't use " << animationName << ", model has no animations." << std::endl;
+        return false;
+    }
+    Clip clip;
+    clip.animationName = animationName;
+    clip.animation = animation;
+    clip.weight = weight;
+    clip.looped = looped;
+    if(layers[layerIndex].mode == LayerMode::ADDITIVE) {
+        ModelAsset::AnimationCursors referenceCursors;
+        modelAsset->samplePose(*animation, 0, false, referenceCursors, clip.additiveReference);
+    }
+    clips.push_back(std::move(clip));
+    return true;
+}
+
+void AnimationGraph::advance(long deltaTime) {
+    for (Layer &layer: layers) {
+        for (Clip &clip: layer.clips) {
+            clip.time += deltaTime;
+        }
+    }
+}
+
+/**
+ * Blends the clips of the layer into layerPose. Each clip is blended with its share of the accumulated weight,
+ * so the result is the weighted average of all clips.
+ * @return false if layer has no clip with weight
+ */
+bool AnimationGraph::sampleLayer(Layer &layer) {
+    float accumulatedWeight = 0.0f;
+    for (Clip &clip: layer.clips) {
+        AnimationPose& targetPose = accumulatedWeight == 0.0f ? layerPose : clipPose;
+        modelAsset->samplePose(*clip.animation, clip.time, clip.looped, clip.cursors, targetPose);
+        if(layer.mode == LayerMode::ADDITIVE) {
+            targetPose.makeAdditive(clip.additiveReference);
+        }
+        accumulatedWeight += clip.weight;
+        if(&targetPose == &clipPose) {
+            layerPose.blend(clipPose, clip.weight / accumulatedWeight);
+        }
+    }
+    return accumulatedWeight > 0.0f;
+}
+
+void AnimationGraph::apply(AnimationPose &pose) {
+    for (Layer &layer: layers) {
+        if(layer.weight <= 0.0f || !sampleLayer(layer)) {
+            continue;
+        }
+        const float* boneWeights = layer.boneMask.empty() ? nullptr : layer.boneMask.data();
+        if(layer.mode == LayerMode::OVERRIDE) {
+            pose.blend(layerPose, layer.weight, boneWeights);
+        } else {
+            pose.addAdditive(layerPose, layer.weight, boneWeights);
+        }
+    }
+}
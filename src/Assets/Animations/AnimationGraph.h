@@ -0,0 +1,87 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_ANIMATIONGRAPH_H
+#define LIMONENGINE_ANIMATIONGRAPH_H
+
+
+#include <vector>
+#include <string>
+#include <memory>
+#include "AnimationPose.h"
+#include "../ModelAsset.h"
+
+/**
+ * Per instance animation layers, applied on top of the base animation of a model.
+ *
+ * Each layer is an N-way blend of clips, weights of the clips are normalized. Override layers blend towards their pose,
+ * additive layers add the difference of their pose from the first frame of the clips. Layers can be limited to a bone
+ * and its children with a mask, so an upper body layer can shoot while base animation walks.
+ *
+ * Names are resolved when clips are set, evaluation only works on flat poses.
+ */
+class AnimationGraph {
+public:
+    enum class LayerMode {OVERRIDE, ADDITIVE};
+
+private:
+    struct Clip {
+        std::string animationName;
+        const ModelAsset::CompiledAnimation* animation;
+        float weight;
+        bool looped;
+        long time = 0;
+        ModelAsset::AnimationCursors cursors;
+        AnimationPose additiveReference;//first frame of the clip, only used by additive layers
+    };
+
+    struct Layer {
+        LayerMode mode;
+        float weight = 1.0f;
+        std::vector<float> boneMask;//empty means all bones
+        std::vector<Clip> clips;
+    };
+
+    std::shared_ptr<const ModelAsset> modelAsset;
+    std::vector<Layer> layers;
+    AnimationPose layerPose;
+    AnimationPose clipPose;
+
+    bool sampleLayer(Layer &layer);
+
+public:
+    explicit AnimationGraph(std::shared_ptr<const ModelAsset> modelAsset) : modelAsset(modelAsset) {}
+
+    /**
+     * @param mode override or additive
+     * @param maskRootBoneName layer only effects this bone and its children. Empty means all bones
+     * @return index of the new layer, -1 if mask bone is not found
+     */
+    int32_t addLayer(LayerMode mode, const std::string &maskRootBoneName);
+
+    bool setLayerWeight(uint32_t layerIndex, float weight);
+
+    /**
+     * Adds the clip to the layer, or updates its weight if it is already in the layer. Weight 0 removes the clip.
+     */
+    bool setClip(uint32_t layerIndex, const std::string &animationName, float weight, bool looped);
+
+    size_t getLayerCount() const {
+        return layers.size();
+    }
+
+    void clear() {
+        layers.clear();
+    }
+
+    void advance(long deltaTime);
+
+    /**
+     * Applies all layers to pose, in order.
+     */
+    void apply(AnimationPose &pose);
+};
+
+
+#endif //LIMONENGINE_ANIMATIONGRAPH_H
@@ -13,10 +13,22 @@
 #include <cereal/archives/xml.hpp>
 #endif
 
+struct AnimationNode;
+
 class AnimationInterface {
 public:
     virtual bool calculateTransform(const std::string& nodeName, float time, Transformation& transformation) const = 0;
 
+    /**
+     * Returns the key frames of the node, nullptr if node is not animated. This allows resolving node names once,
+     * instead of each frame. Key times of the channel are offset by getChannelTimeOffset().
+     */
+    virtual const AnimationNode* getChannel(const std::string& nodeName) const = 0;
+
+    virtual float getChannelTimeOffset() const {
+        return 0;
+    }
+
     virtual float getTicksPerSecond() const = 0;
 
     virtual float getDuration() const = 0;
@@ -2,129 +2,75 @@
 // Created by engin on 18.05.2018.
 //
 
+#include <algorithm>
+#include <cassert>
 #include "AnimationNode.h"
 
-glm::vec3 AnimationNode::getPositionVector(const float timeInTicks) const {
-    glm::vec3 transformVector;
-    if (translates.size() == 1) {
-        transformVector = translates[0];
+/**
+ * Finds the key that is active for the given time, the last key with time smaller or equal to requested time.
+ * Search starts from the cursor, and cursor is updated. Since playback time moves forward, this is mostly 0 or 1 step.
+ * If time moved backwards (loop or a new animation), binary search is used.
+ */
+uint32_t AnimationNode::findKeyIndex(const std::vector<float> &times, const float timeInTicks, uint32_t &cursor) {
+    const uint32_t lastIndex = (uint32_t)times.size() - 1;
+    if(cursor > lastIndex || times[cursor] > timeInTicks) {
+        uint32_t upperIndex = (uint32_t)(std::upper_bound(times.begin(), times.end(), timeInTicks) - times.begin());
+        cursor = upperIndex == 0 ? 0 : upperIndex - 1;
     } else {
-        uint32_t positionIndex = translateTimes.size();
-        for (unsigned int i = 0; i < translates.size(); i++) {
-            if (timeInTicks < translateTimes[i + 1]) {
-                positionIndex = i;
-                break;
-            }
-        }
-
-        if(timeInTicks == translateTimes[translateTimes.size()-1]) {
-            //this is the case were we request last transformation, and it doesn't require interpolation
-            return translates[translateTimes.size()-1];
-        }
-
-        if(timeInTicks < translateTimes[0]) {
-            return translates[0];
-        }
-
-        unsigned int NextPositionIndex = (positionIndex + 1);
-        if(NextPositionIndex >= translates.size()) {
-            transformVector = translates[translates.size()-1];
-        } else {
-            float DeltaTime = (float) (translateTimes[NextPositionIndex] -
-                                       translateTimes[positionIndex]);
-            float Factor = (timeInTicks - (float) translateTimes[positionIndex]) / DeltaTime;
-            assert(Factor >= 0.0f && Factor <= 1.0f);
-            const glm::vec3 &Start = translates[positionIndex];
-            const glm::vec3 &End = translates[NextPositionIndex];
-            glm::vec3 Delta = End - Start;
-            transformVector = Start + Factor * Delta;
+        while (cursor < lastIndex && times[cursor + 1] <= timeInTicks) {
+            ++cursor;
         }
     }
-    return transformVector;
+    return cursor;
 }
 
-glm::vec3 AnimationNode::getScalingVector(const float timeInTicks) const {
-    glm::vec3 scalingTransformVector;
-    if (scales.size() == 1) {
-        scalingTransformVector = scales[0];
-    } else {
-        uint32_t ScalingIndex = scaleTimes.size();
-        assert(scales.size() > 0);
-        for (unsigned int i = 0; i < scales.size(); i++) {
-            if (timeInTicks < scaleTimes[i + 1]) {
-                ScalingIndex = i;
-                break;
-            }
-        }
-
-        if(timeInTicks == scaleTimes[scaleTimes.size()-1]) {
-            //this is the case were we request last transformation, and it doesn't require interpolation
-            return scales[scaleTimes.size()-1];
-        }
-
-        if(timeInTicks < scaleTimes[0]) {
-            return scales[0];
-        }
-
-        unsigned int NextScalingIndex = (ScalingIndex + 1);
-        if(NextScalingIndex >= scales.size()) {//set scale to last element
-            scalingTransformVector = scales[scales.size()-1];
-        } else {//blend scale
-            float DeltaTime = (scaleTimes[NextScalingIndex] -
-                               scaleTimes[ScalingIndex]);
-            float Factor = (timeInTicks - (float) scaleTimes[ScalingIndex]) / DeltaTime;
-            assert(Factor >= 0.0f && Factor <= 1.0f);
-            const glm::vec3 &Start = scales[ScalingIndex];
-            const glm::vec3 &End = scales[NextScalingIndex];
-            glm::vec3 Delta = End - Start;
-            scalingTransformVector = Start + Factor * Delta;
-        }
+template<typename T, typename Interpolator>
+static T sampleKeys(const std::vector<T> &values, const std::vector<float> &times, const float timeInTicks, uint32_t &cursor, Interpolator interpolate) {
+    if (values.size() == 1 || timeInTicks < times[0]) {
+        return values[0];
+    }
+    uint32_t index = AnimationNode::findKeyIndex(times, timeInTicks, cursor);
+    if(index + 1 >= values.size()) {
+        //this is the case were we request last transformation, and it doesn't require interpolation
+        return values[values.size() - 1];
     }
-    return scalingTransformVector;
+    float factor = (timeInTicks - times[index]) / (times[index + 1] - times[index]);
+    assert(factor >= 0.0f && factor <= 1.0f);
+    return interpolate(values[index], values[index + 1], factor);
 }
 
-glm::quat AnimationNode::getRotationQuat(const float timeInTicks) const {
-    glm::quat rotationTransformQuaternion;
-    if (rotations.size() == 1) {
-        rotationTransformQuaternion = rotations[0];
-    } else {
-
-        uint32_t rotationIndex = rotationTimes.size();
-
-        assert(rotations.size() > 0);
+glm::vec3 AnimationNode::getPositionVector(const float timeInTicks, uint32_t &cursor) const {
+    return sampleKeys(translates, translateTimes, timeInTicks, cursor, [](const glm::vec3 &start, const glm::vec3 &end, float factor) {
+        return start + factor * (end - start);
+    });
+}
 
-        for (unsigned int i = 0; i < rotations.size(); i++) {
-            if (timeInTicks < (float) rotationTimes[i + 1]) {
-                rotationIndex = i;
-                break;
-            }
-        }
+glm::vec3 AnimationNode::getScalingVector(const float timeInTicks, uint32_t &cursor) const {
+    return sampleKeys(scales, scaleTimes, timeInTicks, cursor, [](const glm::vec3 &start, const glm::vec3 &end, float factor) {
+        return start + factor * (end - start);
+    });
+}
 
-        if(timeInTicks == rotationTimes[rotationTimes.size()-1]) {
-            //this is the case were we request last transformation, and it doesn't require interpolation
-            return rotations[rotationTimes.size()-1];
-        }
+glm::quat AnimationNode::getRotationQuat(const float timeInTicks, uint32_t &cursor) const {
+    return sampleKeys(rotations, rotationTimes, timeInTicks, cursor, [](const glm::quat &start, const glm::quat &end, float factor) {
+        return glm::normalize(glm::slerp(start, end, factor));
+    });
+}
 
-        if(timeInTicks < rotationTimes[0]) {
-            return rotations[0];
-        }
+glm::vec3 AnimationNode::getPositionVector(const float timeInTicks) const {
+    uint32_t cursor = 0;
+    return getPositionVector(timeInTicks, cursor);
+}
 
-        unsigned int NextRotationIndex = (rotationIndex + 1);
-        if(NextRotationIndex >= rotations.size()) {
-            rotationTransformQuaternion = rotations[rotations.size()-1];
-        } else {
-            float DeltaTime = (rotationTimes[NextRotationIndex] -
-                               rotationTimes[rotationIndex]);
-            float Factor = (timeInTicks - (float) rotationTimes[rotationIndex]) / DeltaTime;
-            assert(Factor >= 0.0f && Factor <= 1.0f);
-            const glm::quat &StartRotationQ = rotations[rotationIndex];
-            const glm::quat &EndRotationQ = rotations[NextRotationIndex];
-            rotationTransformQuaternion = glm::normalize(glm::slerp(StartRotationQ, EndRotationQ, Factor));
-        }
-    }
-    return rotationTransformQuaternion;
+glm::vec3 AnimationNode::getScalingVector(const float timeInTicks) const {
+    uint32_t cursor = 0;
+    return getScalingVector(timeInTicks, cursor);
 }
 
+glm::quat AnimationNode::getRotationQuat(const float timeInTicks) const {
+    uint32_t cursor = 0;
+    return getRotationQuat(timeInTicks, cursor);
+}
 
 void AnimationNode::fillNode(tinyxml2::XMLDocument &document, tinyxml2::XMLElement *nodesNode) const {
     tinyxml2::XMLElement *nodeElement = document.NewElement("Node");
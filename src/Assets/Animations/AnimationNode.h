@@ -11,6 +11,7 @@
 #include <tinyxml2.h>
 #include <glm/gtc/quaternion.hpp>
 #include <string>
+#include <cstdint>
 #ifdef CEREAL_SUPPORT
 #include <cereal/types/vector.hpp>
 #include "../../Utils/GLMCerealConverters.hpp"
@@ -34,6 +35,24 @@ struct AnimationNode {
 
         glm::vec3 getPositionVector(const float timeInTicks) const;
 
+        /**
+         * Key indexes of the last sample for each track. They are kept per instance, and passed back on next sample,
+         * so playback doesn't scan the key times from the start each frame.
+         */
+        struct Cursor {
+            uint32_t translate = 0;
+            uint32_t scale = 0;
+            uint32_t rotation = 0;
+        };
+
+        glm::quat getRotationQuat(const float timeInTicks, uint32_t &cursor) const;
+
+        glm::vec3 getScalingVector(const float timeInTicks, uint32_t &cursor) const;
+
+        glm::vec3 getPositionVector(const float timeInTicks, uint32_t &cursor) const;
+
+        static uint32_t findKeyIndex(const std::vector<float> &times, const float timeInTicks, uint32_t &cursor);
+
     private:
         void fillTranslateAndTimes(tinyxml2::XMLDocument &document, tinyxml2::XMLElement *nodeElement) const;
 
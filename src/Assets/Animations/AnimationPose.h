@@ -0,0 +1,206 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_ANIMATIONPOSE_H
+#define LIMONENGINE_ANIMATIONPOSE_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIMON_ANIMATION_POSE_SSE
+#endif
+
+/**
+ * Local transforms of all skeleton bones, kept as structure of arrays so poses can be blended 4 bones at a time.
+ *
+ * Bone order is the skeleton order of the ModelAsset. Arrays are padded to multiple of 4, padding bones are
+ * identity, so SIMD operations never produce NaN on them. Bone weight arrays passed to the operations must have
+ * the padded size too, ModelAsset::buildBoneMask creates them that way.
+ */
+class AnimationPose {
+public:
+    enum Channel {TRANSLATE_X, TRANSLATE_Y, TRANSLATE_Z,
+                  ORIENTATION_X, ORIENTATION_Y, ORIENTATION_Z, ORIENTATION_W,
+                  SCALE_X, SCALE_Y, SCALE_Z,
+                  CHANNEL_COUNT};
+
+private:
+    uint32_t boneCount = 0;
+    uint32_t paddedCount = 0;
+    std::vector<float> data;//CHANNEL_COUNT arrays of paddedCount elements
+
+public:
+    static uint32_t getPaddedSize(uint32_t count) {
+        return (count + 3u) & ~3u;
+    }
+
+    void resize(uint32_t newBoneCount) {
+        if(newBoneCount == boneCount && !data.empty()) {
+            return;
+        }
+        boneCount = newBoneCount;
+        paddedCount = getPaddedSize(newBoneCount);
+        data.assign((size_t)paddedCount * CHANNEL_COUNT, 0.0f);
+        for (uint32_t i = 0; i < paddedCount; ++i) {
+            channel(ORIENTATION_W)[i] = 1.0f;
+            channel(SCALE_X)[i] = 1.0f;
+            channel(SCALE_Y)[i] = 1.0f;
+            channel(SCALE_Z)[i] = 1.0f;
+        }
+    }
+
+    uint32_t size() const {
+        return boneCount;
+    }
+
+    float* channel(Channel channelIndex) {
+        return &data[(size_t)channelIndex * paddedCount];
+    }
+
+    const float* channel(Channel channelIndex) const {
+        return &data[(size_t)channelIndex * paddedCount];
+    }
+
+    void setBone(uint32_t index, const glm::vec3 &translate, const glm::quat &orientation, const glm::vec3 &scale) {
+        channel(TRANSLATE_X)[index] = translate.x;
+        channel(TRANSLATE_Y)[index] = translate.y;
+        channel(TRANSLATE_Z)[index] = translate.z;
+        channel(ORIENTATION_X)[index] = orientation.x;
+        channel(ORIENTATION_Y)[index] = orientation.y;
+        channel(ORIENTATION_Z)[index] = orientation.z;
+        channel(ORIENTATION_W)[index] = orientation.w;
+        channel(SCALE_X)[index] = scale.x;
+        channel(SCALE_Y)[index] = scale.y;
+        channel(SCALE_Z)[index] = scale.z;
+    }
+
+    glm::vec3 getTranslate(uint32_t index) const {
+        return glm::vec3(channel(TRANSLATE_X)[index], channel(TRANSLATE_Y)[index], channel(TRANSLATE_Z)[index]);
+    }
+
+    glm::quat getOrientation(uint32_t index) const {
+        return glm::quat(channel(ORIENTATION_W)[index], channel(ORIENTATION_X)[index], channel(ORIENTATION_Y)[index], channel(ORIENTATION_Z)[index]);
+    }
+
+    glm::vec3 getScale(uint32_t index) const {
+        return glm::vec3(channel(SCALE_X)[index], channel(SCALE_Y)[index], channel(SCALE_Z)[index]);
+    }
+
+    /**
+     * Moves this pose towards target by weight. Translate and scale are lerped, orientation is nlerped on the shortest path.
+     * If boneWeights is not nullptr, weight of each bone is multiplied with its entry.
+     */
+    void blend(const AnimationPose &target, float weight, const float *boneWeights = nullptr) {
+        uint32_t start = 0;
+#if defined(LIMON_ANIMATION_POSE_SSE)
+        const __m128 weightVector = _mm_set1_ps(weight);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for (; start < paddedCount; start += 4) {
+            __m128 w = boneWeights == nullptr ? weightVector : _mm_mul_ps(weightVector, _mm_loadu_ps(boneWeights + start));
+            for (int c = TRANSLATE_X; c <= TRANSLATE_Z; ++c) {
+                lerp4(channel((Channel)c) + start, target.channel((Channel)c) + start, w);
+            }
+            for (int c = SCALE_X; c <= SCALE_Z; ++c) {
+                lerp4(channel((Channel)c) + start, target.channel((Channel)c) + start, w);
+            }
+            float* q[4] = {channel(ORIENTATION_X) + start, channel(ORIENTATION_Y) + start, channel(ORIENTATION_Z) + start, channel(ORIENTATION_W) + start};
+            const float* t[4] = {target.channel(ORIENTATION_X) + start, target.channel(ORIENTATION_Y) + start, target.channel(ORIENTATION_Z) + start, target.channel(ORIENTATION_W) + start};
+            __m128 a[4], b[4];
+            __m128 dot = _mm_setzero_ps();
+            for (int k = 0; k < 4; ++k) {
+                a[k] = _mm_loadu_ps(q[k]);
+                b[k] = _mm_loadu_ps(t[k]);
+                dot = _mm_add_ps(dot, _mm_mul_ps(a[k], b[k]));
+            }
+            //flip target if it is on the other hemisphere, by moving sign bit of dot to it
+            __m128 dotSign = _mm_and_ps(dot, signMask);
+            __m128 lengthSquare = _mm_setzero_ps();
+            for (int k = 0; k < 4; ++k) {
+                b[k] = _mm_xor_ps(b[k], dotSign);
+                a[k] = _mm_add_ps(a[k], _mm_mul_ps(w, _mm_sub_ps(b[k], a[k])));
+                lengthSquare = _mm_add_ps(lengthSquare, _mm_mul_ps(a[k], a[k]));
+            }
+            __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquare));
+            for (int k = 0; k < 4; ++k) {
+                _mm_storeu_ps(q[k], _mm_mul_ps(a[k], inverseLength));
+            }
+        }
+#endif
+        for (uint32_t i = start; i < paddedCount; ++i) {
+            float w = boneWeights == nullptr ? weight : weight * boneWeights[i];
+            for (int c = TRANSLATE_X; c <= TRANSLATE_Z; ++c) {
+                channel((Channel)c)[i] += w * (target.channel((Channel)c)[i] - channel((Channel)c)[i]);
+            }
+            for (int c = SCALE_X; c <= SCALE_Z; ++c) {
+                channel((Channel)c)[i] += w * (target.channel((Channel)c)[i] - channel((Channel)c)[i]);
+            }
+            float dot = 0;
+            for (int c = ORIENTATION_X; c <= ORIENTATION_W; ++c) {
+                dot += channel((Channel)c)[i] * target.channel((Channel)c)[i];
+            }
+            float sign = dot < 0 ? -1.0f : 1.0f;
+            float lengthSquare = 0;
+            for (int c = ORIENTATION_X; c <= ORIENTATION_W; ++c) {
+                float& value = channel((Channel)c)[i];
+                value += w * (sign * target.channel((Channel)c)[i] - value);
+                lengthSquare += value * value;
+            }
+            float inverseLength = 1.0f / std::sqrt(lengthSquare);
+            for (int c = ORIENTATION_X; c <= ORIENTATION_W; ++c) {
+                channel((Channel)c)[i] *= inverseLength;
+            }
+        }
+    }
+
+    /**
+     * Converts this pose to difference from reference, so it can be added to other poses by addAdditive.
+     */
+    void makeAdditive(const AnimationPose &reference) {
+        for (uint32_t i = 0; i < boneCount; ++i) {
+            glm::vec3 referenceScale = reference.getScale(i);
+            setBone(i, getTranslate(i) - reference.getTranslate(i),
+                    glm::inverse(reference.getOrientation(i)) * getOrientation(i),
+                    glm::vec3(referenceScale.x != 0 ? getScale(i).x / referenceScale.x : 1.0f,
+                              referenceScale.y != 0 ? getScale(i).y / referenceScale.y : 1.0f,
+                              referenceScale.z != 0 ? getScale(i).z / referenceScale.z : 1.0f));
+        }
+    }
+
+    /**
+     * Adds an additive pose created by makeAdditive on top of this pose, scaled by weight. Weight of 1 applies the full difference.
+     */
+    void addAdditive(const AnimationPose &additive, float weight, const float *boneWeights = nullptr) {
+        for (uint32_t i = 0; i < boneCount; ++i) {
+            float w = boneWeights == nullptr ? weight : weight * boneWeights[i];
+            if(w <= 0.0f) {
+                continue;
+            }
+            glm::quat delta = additive.getOrientation(i);
+            if(delta.w < 0) {
+                delta = -delta;
+            }
+            //nlerp from identity
+            delta = glm::normalize(glm::quat(1.0f + w * (delta.w - 1.0f), w * delta.x, w * delta.y, w * delta.z));
+            setBone(i, getTranslate(i) + w * additive.getTranslate(i),
+                    glm::normalize(getOrientation(i) * delta),
+                    getScale(i) * (glm::vec3(1.0f) + w * (additive.getScale(i) - glm::vec3(1.0f))));
+        }
+    }
+
+private:
+#if defined(LIMON_ANIMATION_POSE_SSE)
+    static void lerp4(float *values, const float *targets, __m128 weight) {
+        __m128 a = _mm_loadu_ps(values);
+        _mm_storeu_ps(values, _mm_add_ps(a, _mm_mul_ps(weight, _mm_sub_ps(_mm_loadu_ps(targets), a))));
+    }
+#endif
+};
+
+
+#endif //LIMONENGINE_ANIMATIONPOSE_H
@@ -18,6 +18,7 @@
 
 #include "Asset.h"
 #include "../ALHelper.h"
+#include "../SDL2MultiThreading.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -144,30 +145,32 @@ private:
         }
     };
 
-    AssetLoadQueue assetLoadCpuQueue;
     AssetLoadQueue assetLoadGPUQueue;
 
-    struct AssetLoadThreadState {
-        std::shared_ptr<std::thread> thread;
-        bool running = true;
-    };
-    std::vector<AssetLoadThreadState*> assetLoadThreads;
-
-    void cpuLoadAsset(bool& running) {
-        while(running) {
-            std::pair<std::shared_ptr<Asset>, bool> assetAndLoadNext = assetLoadCpuQueue.popFrontOrBlock();
-            if(assetAndLoadNext.first->getLoadState() != Asset::LoadState::INITIATED) {
-                std::cerr << " asset " << assetAndLoadNext.first->getName() << " tried to start another load??" << std::endl;
-                continue;
-            }
-            assetAndLoadNext.first->setLoadState(Asset::LoadState::CPU_LOAD_STARTED);
-            assetAndLoadNext.first->loadCPUPart();
-            assetAndLoadNext.first->setLoadState(Asset::LoadState::CPU_LOAD_DONE);
-            if(assetAndLoadNext.second){
-                assetLoadGPUQueue.pushBack(assetAndLoadNext);
-            }
-            cpuLoadDoneCondition.notify_all();
+    SDL2MultiThreading::JobSystem* jobSystem;
+    SDL2MultiThreading::JobSystem::Counter cpuLoadCounter;//unfinished cpu loads, destructor waits for them
+
+    void cpuLoadAsset(std::pair<std::shared_ptr<Asset>, bool> assetAndLoadNext) {
+        if(assetAndLoadNext.first->getLoadState() != Asset::LoadState::INITIATED) {
+            std::cerr << " asset " << assetAndLoadNext.first->getName() << " tried to start another load??" << std::endl;
+            return;
+        }
+        assetAndLoadNext.first->setLoadState(Asset::LoadState::CPU_LOAD_STARTED);
+        assetAndLoadNext.first->loadCPUPart();
+        assetAndLoadNext.first->setLoadState(Asset::LoadState::CPU_LOAD_DONE);
+        if(assetAndLoadNext.second){
+            assetLoadGPUQueue.pushBack(assetAndLoadNext);
         }
+        cpuLoadDoneCondition.notify_all();
+    }
+
+    /**
+     * CPU part of the asset loads run as background jobs, so they don't delay frame jobs like culling.
+     */
+    void startCPULoad(std::shared_ptr<Asset> asset, bool pushToGPUQueue) {
+        jobSystem->submitBackground([this, asset, pushToGPUQueue]() {
+            cpuLoadAsset(std::make_pair(asset, pushToGPUQueue));
+        }, &cpuLoadCounter);
     }
 
     const std::string ASSET_EXTENSIONS_FILE = "./Engine/assetExtensions.xml";
@@ -214,15 +217,9 @@ private:
 
 public:
 
-    explicit AssetManager(GraphicsInterface* graphicsWrapper, ALHelper *alHelper) : graphicsWrapper(graphicsWrapper), alHelper(alHelper) {
+    AssetManager(GraphicsInterface* graphicsWrapper, ALHelper *alHelper, SDL2MultiThreading::JobSystem* jobSystem) :
+            jobSystem(jobSystem), graphicsWrapper(graphicsWrapper), alHelper(alHelper) {
         loadAssetList();
-        size_t num_threads = std::thread::hardware_concurrency();
-        for (size_t i = 0; i < num_threads; ++i) {
-            AssetLoadThreadState* state = new AssetLoadThreadState();
-            state->running = true;
-            state->thread = std::make_shared<std::thread>(&AssetManager::cpuLoadAsset, this, std::ref(state->running));
-            assetLoadThreads.push_back(state);
-        }
     }
 
     void loadUsingCereal(const std::vector<std::string> files [[gnu::unused]]);
@@ -254,7 +251,7 @@ public:
                 if(!loaded) {
                     assets[files] = std::make_pair(std::make_shared<T>(this, nextAssetIndexLocal, files), 0);
                     startedAssetIds.insert(nextAssetIndexLocal);
-                    assetLoadCpuQueue.pushBack(assets[files].first, true);
+                    startCPULoad(assets[files].first, true);
                 }
             }
             assets[files].second++;
@@ -310,7 +307,7 @@ public:
             }
             if(!loaded) {
                 assets[files] = std::make_pair(std::make_shared<T>(this, nextAssetIndexLocal, files), 0);
-                assetLoadCpuQueue.pushBack(assets[files].first, false);
+                startCPULoad(assets[files].first, false);
             }
         }
         assets[files].second++;
@@ -440,18 +437,13 @@ public:
         return alHelper;
     }
 
+    SDL2MultiThreading::JobSystem *getJobSystem() const {
+        return jobSystem;
+    }
+
     ~AssetManager() {
-        //Stop the cpu load threads
-        for (auto thread_iterator = assetLoadThreads.begin(); thread_iterator != assetLoadThreads.end(); ++thread_iterator) {
-            (*thread_iterator)->running = false;
-        }
-        for (auto thread_iterator = assetLoadThreads.begin(); thread_iterator != assetLoadThreads.end(); ++thread_iterator) {
-            (*thread_iterator)->thread->join();
-        }
-        //free all the assets
-        for (auto assetLoadIterator = assetLoadThreads.begin(); assetLoadIterator != assetLoadThreads.end(); ++assetLoadIterator) {
-            delete *assetLoadIterator;
-        }
+        //cpu loads reference this object, wait for them to finish
+        jobSystem->waitFor(&cpuLoadCounter);
 
         delete availableAssetsRootNode;
 
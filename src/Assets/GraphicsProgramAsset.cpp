@@ -32,6 +32,26 @@ GraphicsProgramAsset::GraphicsProgramAsset(AssetManager *assetManager, uint32_t
 void GraphicsProgramAsset::lateInitialize(uint32_t programId) {
     if(!initialized) {
         assetManager->getGraphicsWrapper()->initializeProgramAsset(programId, uniformMap, attributesMap, outputMap);
+        assignUniformIndices();
         initialized =true;
     }
 }
+
+void GraphicsProgramAsset::initializeFromCache(const std::unordered_map<std::string, std::shared_ptr<Uniform>> &cachedUniformMap,
+                                               const std::unordered_map<std::string, uint32_t> &cachedAttributesMap,
+                                               const std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>> &cachedOutputMap) {
+    if(!initialized) {
+        uniformMap = cachedUniformMap;
+        attributesMap = cachedAttributesMap;
+        outputMap = cachedOutputMap;
+        assignUniformIndices();
+        initialized = true;
+    }
+}
+
+void GraphicsProgramAsset::assignUniformIndices() {
+    uint32_t uniformIndex = 0;
+    for (auto &uniformEntry: uniformMap) {
+        uniformEntry.second->index = uniformIndex++;
+    }
+}
@@ -28,6 +28,8 @@ class GraphicsProgramAsset : public Asset {
     std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>>outputMap;
     void loadCPUPart() override {} //we don't need to load anything
     void loadGPUPart() override {} //we don't need to load anything
+
+    void assignUniformIndices();
 public:
     GraphicsProgramAsset(AssetManager *assetManager, uint32_t assetID, const std::vector<std::string> &fileList);
 #ifdef CEREAL_SUPPORT
@@ -46,6 +48,17 @@ public:
 
     void lateInitialize(uint32_t programId);
 
+    /**
+     * Same as lateInitialize, but uses maps read from the shader cache instead of asking the backend.
+     */
+    void initializeFromCache(const std::unordered_map<std::string, std::shared_ptr<Uniform>> &cachedUniformMap,
+                             const std::unordered_map<std::string, uint32_t> &cachedAttributesMap,
+                             const std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>> &cachedOutputMap);
+
+    bool isInitialized() const {
+        return initialized;
+    }
+
     uint32_t getAttributeLocation(const std::string& attributeName) {
         if(attributesMap.find(attributeName) != attributesMap.end()) {
             return attributesMap[attributeName];
@@ -57,69 +70,24 @@ public:
         return uniformMap;
     }
 
-    const std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>> &getOutputMap() const {
-        return outputMap;
-    }
-
-
-    bool setUniform(const uint32_t programID, const std::string &uniformName, const glm::mat4 &matrix) {
-        auto uniformIt = uniformMap.find(uniformName);
-        if(uniformIt != uniformMap.end() && uniformIt->second->type == Uniform::VariableTypes::FLOAT_MAT4) {
-            return graphicsInterface->setUniform(programID, uniformIt->second->location, matrix);
-        }
-        return false;
+    const std::unordered_map<std::string, uint32_t> &getAttributesMap() const {
+        return attributesMap;
     }
 
-    bool setUniform(const uint32_t programID, const std::string &uniformName, const glm::vec3 &vector) {
-        auto uniformIt = uniformMap.find(uniformName);
-        if(uniformIt != uniformMap.end() && uniformIt->second->type == Uniform::VariableTypes::FLOAT_VEC3) {
-            return graphicsInterface->setUniform(programID, uniformIt->second->location, vector);
-        }
-        return false;
+    const std::unordered_map<std::string, std::pair<Uniform::VariableTypes, GraphicsInterface::FrameBufferAttachPoints>> &getOutputMap() const {
+        return outputMap;
     }
 
-    bool setUniform(const uint32_t programID, const std::string &uniformName, const std::vector<glm::vec3> &vectorArray) {
-        auto uniformIt = uniformMap.find(uniformName);
-        if(uniformIt != uniformMap.end() && uniformIt->second->type == Uniform::VariableTypes::FLOAT_VEC3) {
-            return graphicsInterface->setUniform(programID, uniformIt->second->location, vectorArray);
-        }
-        return false;
-    }
 
-    bool setUniform(const uint32_t programID, const std::string &uniformName, const float value) {
+    /**
+     * Returns nullptr if the program has no uniform with the given name.
+     */
+    const Uniform* getUniform(const std::string &uniformName) const {
         auto uniformIt = uniformMap.find(uniformName);
-        if(uniformIt != uniformMap.end() && uniformIt->second->type == Uniform::VariableTypes::FLOAT) {
-            return graphicsInterface->setUniform(programID, uniformIt->second->location, value);
-        }
-        return false;
-    }
-/**
- * This method is used to set samplers, so it can alter int uniforms, and sampler uniforms.
- * @param uniformName
- * @param value
- * @return
- */
-    bool setUniform(const uint32_t programID, const std::string &uniformName, const int value) {
-        auto uniformIt = uniformMap.find(uniformName);
-        if(uniformIt != uniformMap.end() &&
-            (uniformIt->second->type == Uniform::VariableTypes::BOOL ||
-             uniformIt->second->type == Uniform::VariableTypes::INT ||
-             uniformIt->second->type == Uniform::VariableTypes::CUBEMAP ||
-             uniformIt->second->type == Uniform::VariableTypes::CUBEMAP_ARRAY ||
-             uniformIt->second->type == Uniform::VariableTypes::TEXTURE_2D ||
-             uniformIt->second->type == Uniform::VariableTypes::TEXTURE_2D_ARRAY))  {
-            return graphicsInterface->setUniform(programID, uniformIt->second->location, value);
-        }
-        return false;
-    }
-
-    bool setUniformArray(const uint32_t programID, const std::string &uniformArrayName, const std::vector<glm::mat4> &matrix) {
-        auto uniformIt = uniformMap.find(uniformArrayName);
-        if(uniformIt != uniformMap.end() && uniformIt->second->type == Uniform::VariableTypes::FLOAT_MAT4) {
-            //FIXME this should have a control of some sort
-            return graphicsInterface->setUniformArray(programID, uniformIt->second->location, matrix);
+        if(uniformIt == uniformMap.end()) {
+            return nullptr;
         }
-        return false;
+        return uniformIt->second.get();
     }
 
     const std::string &getVertexShaderFile() const {
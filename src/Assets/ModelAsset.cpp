@@ -3,6 +3,7 @@
 //
 
 #include <set>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include "ModelAsset.h"
 #include "../Utils/GLMUtils.h"
@@ -129,6 +130,7 @@ void ModelAsset::loadCPUPart() {
     this->deserializeCustomizations();
 
     buildPhysicsMeshes();
+    compileAnimations();
 }
 
 
@@ -389,118 +391,312 @@ bool ModelAsset::findNode(const std::string &nodeName, std::shared_ptr<BoneNode>
 }
 
 /**
- * Blends two animations to generate transform matrix vector
- *
- * @param animationName1
- * @param time1
- * @param looped1
- * @param animationName2
- * @param time2
- * @param looped2
- * @param blendFactor
- * @param transformMatrixVector
- * @return returns true if both of the animations set their last frames. If any were looped, never returns true.
+ * Flattens the node tree to skeleton array, parents first. Bone information is resolved here, so pose calculation
+ * doesn't search by name. Bind pose is calculated once too.
  */
-bool ModelAsset::getTransformBlended(std::string animationNameOld, long timeOld, bool loopedOld,
-                                     std::string animationNameNew, long timeNew, bool loopedNew,
-                                                float blendFactor,
-                                                std::vector<glm::mat4> &transformMatrix) const {
-
-/*
-    for(auto it = animations.begin(); it != animations.end(); it++) {
-        std::cout << "Animations name: " << it->first << " size " << animations.size() <<std::endl;
-    }
-    */
-    if((animationNameOld.empty() || animationNameOld == "") &&
-      (animationNameNew.empty() || animationNameNew == "")) {
-        //if no animation name is provided, we return bind pose by default
-        for(std::unordered_map<std::string, BoneInformation>::const_iterator it = boneInformationMap.begin(); it != boneInformationMap.end(); it++){
-            std::shared_ptr<BoneNode> node;
-            std::string name = it->first;
-            if(findNode(name, node, rootNode)) {
-                transformMatrix[node->boneID] = boneInformationMap.at(node->name).parentOffset;
-                //parent above means parent transform of the mesh node, not the parent of bone.
-            }
+void ModelAsset::buildSkeleton() {
+    skeleton.clear();
+    bindPose.clear();
+    if(rootNode == nullptr) {
+        return;
+    }
+    std::vector<std::pair<const BoneNode*, int32_t>> nodeStack;//node, parent index
+    nodeStack.emplace_back(rootNode.get(), -1);
+    while(!nodeStack.empty()) {
+        const BoneNode* boneNode = nodeStack.back().first;
+        SkeletonBone bone;
+        bone.parentIndex = nodeStack.back().second;
+        nodeStack.pop_back();
+
+        bone.name = boneNode->name;
+        bone.boneID = boneNode->boneID;
+        bone.bindTransform = boneNode->transformation;
+        glm::vec3 skew;//not used
+        glm::vec4 perspective;//not used
+        glm::decompose(bone.bindTransform, bone.bindScale, bone.bindOrientation, bone.bindTranslate, skew, perspective);
+        auto boneInformationIt = boneInformationMap.find(boneNode->name);
+        bone.hasBoneInformation = boneInformationIt != boneInformationMap.end();
+        if(bone.hasBoneInformation) {
+            //parent above means parent transform of the mesh node, not the parent of bone.
+            bone.meshTransform = boneInformationIt->second.globalMeshInverse * boneInformationIt->second.parentOffset;
+            bone.offset = boneInformationIt->second.offset;
+            bindPose.emplace_back(boneNode->boneID, boneInformationIt->second.parentOffset);
+        }
+        int32_t boneIndex = (int32_t)skeleton.size();
+        skeleton.push_back(bone);
+        //pushed in reverse, so children are added in order
+        for (auto child = boneNode->children.rbegin(); child != boneNode->children.rend(); ++child) {
+            nodeStack.emplace_back(child->get(), boneIndex);
         }
-        //std::cout << "bind pose returned. for animation name [" << animationNameOld << "]"<< std::endl;
-        return true;
     }
+}
 
-    std::shared_ptr<const AnimationInterface> currentAnimationOld = nullptr;
-    float animationTimeOld = 0.0f;
-    bool isFinishedOld = false;
-    if(!(animationNameOld.empty() ||animationNameOld == "")) {
-        if (animations.find(animationNameOld) != animations.end()) {
-            currentAnimationOld = animations.at(animationNameOld);
+void ModelAsset::compileAnimation(const std::string &animationName) {
+    auto animationIt = animations.find(animationName);
+    if(animationIt == animations.end()) {
+        return;
+    }
+    CompiledAnimation& compiledAnimation = compiledAnimations[animationName];
+    compiledAnimation.animation = animationIt->second;
+    compiledAnimation.channelTimeOffset = animationIt->second->getChannelTimeOffset();
+    compiledAnimation.channels.resize(skeleton.size());
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        compiledAnimation.channels[i] = animationIt->second->getChannel(skeleton[i].name);
+    }
+}
+
+void ModelAsset::compileAnimations() {
+    buildSkeleton();
+    compiledAnimations.clear();
+    for (auto animationIt = animations.begin(); animationIt != animations.end(); ++animationIt) {
+        compileAnimation(animationIt->first);
+    }
+}
+
+const ModelAsset::CompiledAnimation* ModelAsset::findCompiledAnimation(const std::string &animationName) const {
+    auto animationIt = compiledAnimations.find(animationName);
+    if(animationIt != compiledAnimations.end()) {
+        return &animationIt->second;
+    }
+    if(compiledAnimations.empty()) {
+        return nullptr;
+    }
+    //std::cerr << "Animation " << animationName << " not found, playing first animation. " << std::endl;
+    return &compiledAnimations.begin()->second;
+}
+
+/**
+ * Converts time in milliseconds to animation ticks. If animation is not looped and time is after the last frame,
+ * sets isFinished.
+ */
+float ModelAsset::calculateAnimationTime(const AnimationInterface &animation, long time, bool looped, bool &isFinished) {
+    float ticksPerSecond;
+    if (animation.getTicksPerSecond() != 0) {
+        ticksPerSecond = animation.getTicksPerSecond();
+    } else {
+        ticksPerSecond = 60.0f;
+    }
+
+    float requestedTime = (time / 1000.0f) * ticksPerSecond;
+    if(requestedTime < animation.getDuration()) {
+        return requestedTime;
+    }
+    if (looped) {
+        return fmod(requestedTime, animation.getDuration());
+    }
+    isFinished = true;
+    return animation.getDuration();
+}
+
+bool ModelAsset::sampleChannel(const AnimationNode *channel, float timeInTicks, AnimationNode::Cursor &cursor,
+                               glm::vec3 &translate, glm::quat &orientation, glm::vec3 &scale) {
+    if(channel == nullptr) {
+        return false;
+    }
+    translate = channel->getPositionVector(timeInTicks, cursor.translate);
+    orientation = channel->getRotationQuat(timeInTicks, cursor.rotation);
+    scale = channel->getScalingVector(timeInTicks, cursor.scale);
+    return true;
+}
+
+static glm::mat4 composeTransform(const glm::vec3 &translate, const glm::quat &orientation, const glm::vec3 &scale) {
+    //same as Transformation::getWorldTransform
+    return glm::translate(glm::mat4(1.0f), translate) * glm::mat4_cast(glm::normalize(orientation)) *
+           glm::scale(glm::mat4(1.0f), scale);
+}
+
+void ModelAsset::setBoneTransform(size_t boneIndex, const glm::mat4 &localTransform, std::vector<glm::mat4> &nodeTransforms,
+                                  std::vector<glm::mat4> &transforms) const {
+    const SkeletonBone& bone = skeleton[boneIndex];
+    if(bone.parentIndex < 0) {
+        nodeTransforms[boneIndex] = localTransform;
+    } else {
+        //parent is always before the child, so it is already set
+        nodeTransforms[boneIndex] = nodeTransforms[bone.parentIndex] * localTransform;
+    }
+    if(bone.hasBoneInformation) {
+        transforms[bone.boneID] = bone.meshTransform * nodeTransforms[boneIndex] * bone.offset;
+    }
+}
+
+/**
+ * Global transforms of the nodes are only needed while calculating a pose. Each thread has its own, so poses of
+ * different models can be calculated in parallel.
+ */
+static std::vector<glm::mat4>& getNodeTransformBuffer(size_t boneCount) {
+    static thread_local std::vector<glm::mat4> nodeTransforms;
+    nodeTransforms.resize(boneCount);
+    return nodeTransforms;
+}
+
+void ModelAsset::calculatePose(const CompiledAnimation &animation, float timeInTicks, AnimationCursors &cursors,
+                               std::vector<glm::mat4> &transforms) const {
+    std::vector<glm::mat4>& nodeTransforms = getNodeTransformBuffer(skeleton.size());
+    cursors.resize(skeleton.size());
+
+    const float channelTime = timeInTicks + animation.channelTimeOffset;
+    glm::vec3 translate, scale;
+    glm::quat orientation;
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        if(sampleChannel(animation.channels[i], channelTime, cursors[i], translate, orientation, scale)) {
+            setBoneTransform(i, composeTransform(translate, orientation, scale), nodeTransforms, transforms);
         } else {
-            //std::cerr << "Animation " << animationNameOld << " not found, playing first animation. " << std::endl;
-            currentAnimationOld = animations.begin()->second;
+            //Children are calculated even if parent does not have animation attached.
+            setBoneTransform(i, skeleton[i].bindTransform, nodeTransforms, transforms);
         }
+    }
+}
 
-        float ticksPerSecond;
-        if (currentAnimationOld->getTicksPerSecond() != 0) {
-            ticksPerSecond = currentAnimationOld->getTicksPerSecond();
+void ModelAsset::calculatePoseBlended(const CompiledAnimation &animationOld, float timeInTicksOld, AnimationCursors &cursorsOld,
+                                      const CompiledAnimation &animationNew, float timeInTicksNew, AnimationCursors &cursorsNew,
+                                      float blendFactor, std::vector<glm::mat4> &transforms) const {
+    std::vector<glm::mat4>& nodeTransforms = getNodeTransformBuffer(skeleton.size());
+    cursorsOld.resize(skeleton.size());
+    cursorsNew.resize(skeleton.size());
+
+    const float channelTimeOld = timeInTicksOld + animationOld.channelTimeOffset;
+    const float channelTimeNew = timeInTicksNew + animationNew.channelTimeOffset;
+    glm::vec3 translateOld, scaleOld, translateNew, scaleNew;
+    glm::quat orientationOld, orientationNew;
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        bool status = sampleChannel(animationOld.channels[i], channelTimeOld, cursorsOld[i], translateOld, orientationOld, scaleOld);
+        bool status2 = sampleChannel(animationNew.channels[i], channelTimeNew, cursorsNew[i], translateNew, orientationNew, scaleNew);
+        if(!status && !status2) {
+            setBoneTransform(i, skeleton[i].bindTransform, nodeTransforms, transforms);//if both failed
+        } else if(!status) {
+            setBoneTransform(i, composeTransform(translateNew, orientationNew, scaleNew), nodeTransforms, transforms);//if only first failed
+        } else if(!status2) {
+            setBoneTransform(i, composeTransform(translateOld, orientationOld, scaleOld), nodeTransforms, transforms);//if only second failed
         } else {
-            ticksPerSecond = 60.0f;
+            setBoneTransform(i, composeTransform(translateOld + blendFactor * (translateNew - translateOld),
+                                                 glm::slerp(glm::normalize(orientationOld), glm::normalize(orientationNew), blendFactor),
+                                                 scaleOld + blendFactor * (scaleNew - scaleOld)),
+                             nodeTransforms, transforms);
         }
+    }
+}
 
-        float requestedTime = (timeOld / 1000.0f) * ticksPerSecond;
-        if (requestedTime < currentAnimationOld->getDuration()) {
-            animationTimeOld = requestedTime;
+void ModelAsset::fillBindPose(AnimationPose &pose) const {
+    pose.resize(skeleton.size());
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        pose.setBone(i, skeleton[i].bindTranslate, skeleton[i].bindOrientation, skeleton[i].bindScale);
+    }
+}
+
+bool ModelAsset::samplePose(const CompiledAnimation &animation, long time, bool looped, AnimationCursors &cursors, AnimationPose &pose) const {
+    bool isFinished = false;
+    const float channelTime = calculateAnimationTime(*animation.animation, time, looped, isFinished) + animation.channelTimeOffset;
+    pose.resize(skeleton.size());
+    cursors.resize(skeleton.size());
+    glm::vec3 translate, scale;
+    glm::quat orientation;
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        if(sampleChannel(animation.channels[i], channelTime, cursors[i], translate, orientation, scale)) {
+            pose.setBone(i, translate, glm::normalize(orientation), scale);
         } else {
-            if (loopedOld) {
-                animationTimeOld = fmod(requestedTime, currentAnimationOld->getDuration());
-            } else {
-                animationTimeOld = currentAnimationOld->getDuration();
-                isFinishedOld = true;
-            }
+            pose.setBone(i, skeleton[i].bindTranslate, skeleton[i].bindOrientation, skeleton[i].bindScale);
         }
     }
+    return isFinished;
+}
 
-    std::shared_ptr<const AnimationInterface> currentAnimationNew = nullptr;
-    float animationTimeNew = 0.0f;
-    bool isFinishedNew = false;
-    if(!(animationNameNew.empty() ||animationNameNew == "")) {
-        if (animations.find(animationNameNew) != animations.end()) {
-            currentAnimationNew = animations.at(animationNameNew);
-        } else {
-            //std::cerr << "Animation " << animationNameNew << " not found, playing first animation. " << std::endl;
-            currentAnimationNew = animations.begin()->second;
+bool ModelAsset::samplePose(const std::string &animationName, long time, bool looped, AnimationCursors &cursors, AnimationPose &pose) const {
+    const CompiledAnimation* animation = nullptr;
+    if(!animationName.empty()) {
+        animation = findCompiledAnimation(animationName);
+    }
+    if(animation == nullptr) {
+        fillBindPose(pose);
+        return true;
+    }
+    return samplePose(*animation, time, looped, cursors, pose);
+}
+
+void ModelAsset::calculateTransforms(const AnimationPose &pose, std::vector<glm::mat4> &transforms) const {
+    std::vector<glm::mat4>& nodeTransforms = getNodeTransformBuffer(skeleton.size());
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        setBoneTransform(i, composeTransform(pose.getTranslate(i), pose.getOrientation(i), pose.getScale(i)), nodeTransforms, transforms);
+    }
+}
+
+std::vector<float> ModelAsset::buildBoneMask(const std::string &rootBoneName) const {
+    std::vector<float> mask(AnimationPose::getPaddedSize(skeleton.size()), 0.0f);
+    if(rootBoneName.empty()) {
+        std::fill(mask.begin(), mask.begin() + skeleton.size(), 1.0f);
+        return mask;
+    }
+    bool found = false;
+    for (size_t i = 0; i < skeleton.size(); ++i) {
+        //parents are before children, so parent mask is already set
+        if(skeleton[i].name == rootBoneName || (skeleton[i].parentIndex >= 0 && mask[skeleton[i].parentIndex] != 0.0f)) {
+            mask[i] = 1.0f;
+            found = true;
         }
+    }
+    if(!found) {
+        std::cerr << "Bone " << rootBoneName << " not found in model " << name << ", mask can't be built." << std::endl;
+        mask.clear();
+    }
+    return mask;
+}
 
-        float ticksPerSecond;
-        if (currentAnimationNew->getTicksPerSecond() != 0) {
-            ticksPerSecond = currentAnimationNew->getTicksPerSecond();
-        } else {
-            ticksPerSecond = 60.0f;
+/**
+ * Blends two animations to generate transform matrix vector
+ *
+ * @param animationNameOld
+ * @param timeOld
+ * @param loopedOld
+ * @param cursorsOld key frame cursors of the instance for old animation
+ * @param animationNameNew
+ * @param timeNew
+ * @param loopedNew
+ * @param cursorsNew key frame cursors of the instance for new animation
+ * @param blendFactor
+ * @param transformMatrix
+ * @return returns true if both of the animations set their last frames. If any were looped, never returns true.
+ */
+bool ModelAsset::getTransformBlended(const std::string &animationNameOld, long timeOld, bool loopedOld, AnimationCursors &cursorsOld,
+                                     const std::string &animationNameNew, long timeNew, bool loopedNew, AnimationCursors &cursorsNew,
+                                     float blendFactor, std::vector<glm::mat4> &transformMatrix) const {
+    const CompiledAnimation* currentAnimationOld = nullptr;
+    float animationTimeOld = 0.0f;
+    bool isFinishedOld = false;
+    if(!animationNameOld.empty()) {
+        currentAnimationOld = findCompiledAnimation(animationNameOld);
+        if(currentAnimationOld != nullptr) {
+            animationTimeOld = calculateAnimationTime(*currentAnimationOld->animation, timeOld, loopedOld, isFinishedOld);
         }
+    }
 
-        float requestedTime = (timeNew / 1000.0f) * ticksPerSecond;
-        if (requestedTime < currentAnimationNew->getDuration()) {
-            animationTimeNew = requestedTime;
-        } else {
-            if (loopedNew) {
-                animationTimeNew = fmod(requestedTime, currentAnimationNew->getDuration());
-            } else {
-                animationTimeNew = currentAnimationNew->getDuration();
-                isFinishedNew = true;
-            }
+    const CompiledAnimation* currentAnimationNew = nullptr;
+    float animationTimeNew = 0.0f;
+    bool isFinishedNew = false;
+    if(!animationNameNew.empty()) {
+        currentAnimationNew = findCompiledAnimation(animationNameNew);
+        if(currentAnimationNew != nullptr) {
+            animationTimeNew = calculateAnimationTime(*currentAnimationNew->animation, timeNew, loopedNew, isFinishedNew);
         }
     }
 
+    if(currentAnimationOld == nullptr && currentAnimationNew == nullptr) {
+        //if no animation name is provided, we return bind pose by default
+        for (const auto &boneBindPose: bindPose) {
+            transformMatrix[boneBindPose.first] = boneBindPose.second;
+        }
+        return true;
+    }
+
     //at this point, it is possible one of the animations doesn't exists, if both didn't we would have returned bind pose.
     //if one of them is not found, return single animation, and log the issue
-    glm::mat4 parentTransform(1.0f);
-
     if(currentAnimationOld == nullptr) {
         std::cerr << "Animation blend fail, old animation "<< animationNameOld <<" not found" << std::endl;
-        traverseAndSetTransform(rootNode, parentTransform, currentAnimationNew, animationTimeNew, transformMatrix);
+        calculatePose(*currentAnimationNew, animationTimeNew, cursorsNew, transformMatrix);
     } else if(currentAnimationNew == nullptr) {
         std::cerr << "Animation blend fail, new animation "<< animationNameNew <<" not found" << std::endl;
-        traverseAndSetTransform(rootNode, parentTransform, currentAnimationOld, animationTimeOld, transformMatrix);
+        calculatePose(*currentAnimationOld, animationTimeOld, cursorsOld, transformMatrix);
     } else {
-        traverseAndSetTransformBlended(rootNode, parentTransform, currentAnimationOld, animationTimeOld,
-                                       currentAnimationNew, animationTimeNew, blendFactor, transformMatrix);
+        calculatePoseBlended(*currentAnimationOld, animationTimeOld, cursorsOld,
+                             *currentAnimationNew, animationTimeNew, cursorsNew, blendFactor, transformMatrix);
     }
     return isFinishedOld && isFinishedNew;
 }
@@ -513,143 +709,30 @@ bool ModelAsset::getTransformBlended(std::string animationNameOld, long timeOld,
  * @param time Requested animation time in miliseconds.
  * @param looped if animation should loop or not. Effects return.
  * @param animationName name of animation to seek.
+ * @param cursors key frame cursors of the instance, reused between calls.
  * @param transformMatrix transform matrix list for bones
  *
  * @return if last frame of animation is played for not looped animation. Always false for looped ones.
  */
-bool ModelAsset::getTransform(long time, bool looped, std::string animationName, std::vector<glm::mat4> &transformMatrix) const {
-/*
-    for(auto it = animations.begin(); it != animations.end(); it++) {
-        std::cout << "Animations name: " << it->first << " size " << animations.size() <<std::endl;
-    }
-    */
-    if(animationName.empty() || animationName == "") {
-        //this means return to bind pose
-        //FIXME calculating bind pose for each frame is wrong, but I am assuming this part will be removed, and idle pose
-        //will be used instead. If bind pose requirement arises, it should set once, and reused.
-        for(std::unordered_map<std::string, BoneInformation>::const_iterator it = boneInformationMap.begin(); it != boneInformationMap.end(); it++){
-            std::shared_ptr<BoneNode> node;
-            std::string name = it->first;
-            if(findNode(name, node, rootNode)) {
-                transformMatrix[node->boneID] = boneInformationMap.at(node->name).parentOffset;
-                //parent above means parent transform of the mesh node, not the parent of bone.
-            }
+bool ModelAsset::getTransform(long time, bool looped, const std::string &animationName, AnimationCursors &cursors, std::vector<glm::mat4> &transformMatrix) const {
+    const CompiledAnimation* currentAnimation = nullptr;
+    if(!animationName.empty()) {
+        currentAnimation = findCompiledAnimation(animationName);
+    }
+    if(currentAnimation == nullptr) {
+        //this means return to bind pose, it is calculated once on load
+        for (const auto &boneBindPose: bindPose) {
+            transformMatrix[boneBindPose.first] = boneBindPose.second;
         }
-        //std::cout << "bind pose returned. for animation name [" << animationName << "]"<< std::endl;
         return true;
     }
 
-    std::shared_ptr<const AnimationInterface> currentAnimation;
-    if(animations.find(animationName) != animations.end()) {
-        currentAnimation = animations.at(animationName);
-    } else {
-        //std::cerr << "Animation " << animationName << " not found, playing first animation. " << std::endl;
-        currentAnimation = animations.begin()->second;
-    }
-
-    float animationTime;
-    float ticksPerSecond;
-    if (currentAnimation->getTicksPerSecond() != 0) {
-        ticksPerSecond = currentAnimation->getTicksPerSecond();
-    } else {
-        ticksPerSecond = 60.0f;
-    }
-
     bool result = false;
-    float requestedTime = (time / 1000.0f) * ticksPerSecond;
-    if(requestedTime < currentAnimation->getDuration()) {
-        animationTime = requestedTime;
-    } else {
-        if (looped) {
-            animationTime = fmod(requestedTime, currentAnimation->getDuration());
-        } else {
-            animationTime = currentAnimation->getDuration();
-            result = true;
-        }
-    }
-
-    glm::mat4 parentTransform(1.0f);
-    traverseAndSetTransform(rootNode, parentTransform, currentAnimation, animationTime, transformMatrix);
+    float animationTime = calculateAnimationTime(*currentAnimation->animation, time, looped, result);
+    calculatePose(*currentAnimation, animationTime, cursors, transformMatrix);
     return result;
 }
 
-void ModelAsset::traverseAndSetTransformBlended(std::shared_ptr<const BoneNode> boneNode, const glm::mat4 &parentTransform,
-                                                std::shared_ptr<const AnimationInterface> animationOld,
-                                                float timeInTicksOld,
-                                                std::shared_ptr<const AnimationInterface> animationNew,
-                                                float timeInTicksNew,
-                                                float blendFactor,
-                                                std::vector<glm::mat4> &transforms) const {
-
-    glm::mat4 nodeTransform;
-    Transformation tf1, tf2;
-    bool status = animationOld->calculateTransform(boneNode->name, timeInTicksOld, tf1);
-    bool status2 = animationNew->calculateTransform(boneNode->name, timeInTicksNew, tf2);
-
-    if(!status && !status2) {
-        nodeTransform = boneNode->transformation;//if both failed
-    } else if(!status) {
-        nodeTransform = tf2.getWorldTransform();//if only first failed(only by else)
-    } else if(!status2) {
-        nodeTransform = tf1.getWorldTransform();//if only second failed(only by else)
-    } else {//if both succeed
-        //now blend tf1 and tf2
-        Transformation blended;
-
-        glm::vec3 scaleDelta = tf2.getScale() - tf1.getScale();
-        blended.setScale(tf1.getScale() + blendFactor * scaleDelta);
-
-        glm::vec3 translateDelta = tf2.getTranslate() - tf1.getTranslate();
-        blended.setTranslate(tf1.getTranslate() + blendFactor * translateDelta);
-
-        blended.setOrientation(glm::normalize(slerp(tf1.getOrientation(), tf2.getOrientation(), blendFactor)));
-
-        nodeTransform = blended.getWorldTransform();
-    }
-
-    nodeTransform = parentTransform * nodeTransform;
-
-    if(boneInformationMap.find(boneNode->name) != boneInformationMap.end()) {
-        transforms[boneNode->boneID] =
-                boneInformationMap.at(boneNode->name).globalMeshInverse * boneInformationMap.at(boneNode->name).parentOffset * nodeTransform * boneInformationMap.at(boneNode->name).offset;
-        //parent above means parent transform of the mesh node, not the parent of bone.
-    }
-
-    //Call children even if parent does not have animation attached.
-    for (unsigned int i = 0; i < boneNode->children.size(); ++i) {
-        traverseAndSetTransformBlended(boneNode->children[i], nodeTransform, animationOld, timeInTicksOld, animationNew,
-                timeInTicksNew, blendFactor, transforms);
-    }
-}
-
-void ModelAsset::traverseAndSetTransform( std::shared_ptr<const BoneNode> boneNode, const glm::mat4 &parentTransform,
-                                          std::shared_ptr<const AnimationInterface> animation,
-                                    float timeInTicks,
-                                    std::vector<glm::mat4> &transforms) const {
-
-    glm::mat4 nodeTransform;
-    Transformation tf;
-    bool status = animation->calculateTransform(boneNode->name, timeInTicks, tf);
-    nodeTransform = tf.getWorldTransform();
-
-    if(!status) {
-        nodeTransform = boneNode->transformation;
-    }
-
-    nodeTransform = parentTransform * nodeTransform;
-
-    if(boneInformationMap.find(boneNode->name) != boneInformationMap.end()) {
-        transforms[boneNode->boneID] =
-                boneInformationMap.at(boneNode->name).globalMeshInverse * boneInformationMap.at(boneNode->name).parentOffset * nodeTransform * boneInformationMap.at(boneNode->name).offset;
-        //parent above means parent transform of the mesh node, not the parent of bone.
-    }
-
-    //Call children even if parent does not have animation attached.
-    for (unsigned int i = 0; i < boneNode->children.size(); ++i) {
-        traverseAndSetTransform(boneNode->children[i], nodeTransform, animation, timeInTicks, transforms);
-    }
-}
-
 bool ModelAsset::isAnimated() const {
     return hasAnimation;
 }
@@ -678,6 +761,7 @@ bool ModelAsset::addAnimationAsSubSequence(const std::string &baseAnimationName,
     std::shared_ptr<AnimationAssimpSection> animation = std::make_shared<AnimationAssimpSection>(animationAssimp, startTime, endTime);
 
     this->animations[newAnimationName] = animation;
+    compileAnimation(newAnimationName);
 
     this->animationSections.push_back(AnimationSection(baseAnimationName, newAnimationName, startTime, endTime));
     std::cout << "animation created and added to sections" << std::endl;
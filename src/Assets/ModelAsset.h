@@ -26,10 +26,28 @@
 #include "../Utils/GLMConverter.h"
 #include "BoneNode.h"
 #include "Animations/AnimationInterface.h"
+#include "Animations/AnimationNode.h"
+#include "Animations/AnimationPose.h"
 
 class AnimationAssimp;
 
 class ModelAsset : public Asset {
+public:
+    /**
+     * Per instance key frame cursors, one for each skeleton bone. Models keep one for each animation they play.
+     */
+    typedef std::vector<AnimationNode::Cursor> AnimationCursors;
+
+    /**
+     * Animation with its channels resolved to skeleton indexes, so evaluation doesn't search by name.
+     */
+    struct CompiledAnimation {
+        std::shared_ptr<const AnimationInterface> animation;
+        float channelTimeOffset = 0;
+        std::vector<const AnimationNode*> channels;//per skeleton bone, nullptr if bone is not animated
+    };
+
+private:
     void loadCPUPart() override;
     void loadGPUPart() override;
 
@@ -61,8 +79,27 @@ class ModelAsset : public Asset {
         }
     };
 
+    /**
+     * Node tree flattened to an array. Parents always come before their children, so pose can be calculated
+     * with a single loop instead of recursion.
+     */
+    struct SkeletonBone {
+        std::string name;
+        int32_t parentIndex;//-1 for root
+        uint32_t boneID;
+        bool hasBoneInformation;
+        glm::mat4 bindTransform;//used if animation doesn't have the bone
+        glm::vec3 bindTranslate, bindScale;//bindTransform decomposed, for pose blending
+        glm::quat bindOrientation;
+        glm::mat4 meshTransform;//globalMeshInverse * parentOffset
+        glm::mat4 offset;
+    };
+
     std::string name;
     std::map<std::string, std::shared_ptr<AnimationInterface>> animations;//shared for animation sections
+    std::map<std::string, CompiledAnimation> compiledAnimations;//same keys as animations
+    std::vector<SkeletonBone> skeleton;
+    std::vector<std::pair<uint32_t, glm::mat4>> bindPose;//boneID, transform
     std::shared_ptr<BoneNode> rootNode = nullptr;//bones are shared with meshes
     int_fast32_t boneIDCounter, boneIDCounterPerMesh;
 
@@ -101,17 +138,24 @@ class ModelAsset : public Asset {
 
     bool findNode(const std::string &nodeName, std::shared_ptr<BoneNode>& foundNode, std::shared_ptr<BoneNode> searchRoot) const;
 
-    void traverseAndSetTransform(std::shared_ptr<const BoneNode> boneNode, const glm::mat4 &parentTransform, std::shared_ptr<const AnimationInterface> animation,
-                                 float timeInTicks,
-                                 std::vector<glm::mat4> &transforms) const;
+    void buildSkeleton();
+
+    void compileAnimation(const std::string &animationName);
+
+    void compileAnimations();
+
+    static bool sampleChannel(const AnimationNode *channel, float timeInTicks, AnimationNode::Cursor &cursor,
+                              glm::vec3 &translate, glm::quat &orientation, glm::vec3 &scale);
+
+    void setBoneTransform(size_t boneIndex, const glm::mat4 &localTransform, std::vector<glm::mat4> &nodeTransforms,
+                          std::vector<glm::mat4> &transforms) const;
+
+    void calculatePose(const CompiledAnimation &animation, float timeInTicks, AnimationCursors &cursors,
+                       std::vector<glm::mat4> &transforms) const;
 
-    void traverseAndSetTransformBlended(std::shared_ptr<const BoneNode> boneNode, const glm::mat4 &parentTransform,
-                                        std::shared_ptr<const AnimationInterface> animationOld,
-                                        float timeInTicksOld,
-                                        std::shared_ptr<const AnimationInterface> animationNew,
-                                        float timeInTicksNew,
-                                        float blendFactor,
-                                        std::vector<glm::mat4> &transforms) const;
+    void calculatePoseBlended(const CompiledAnimation &animationOld, float timeInTicksOld, AnimationCursors &cursorsOld,
+                              const CompiledAnimation &animationNew, float timeInTicksNew, AnimationCursors &cursorsNew,
+                              float blendFactor, std::vector<glm::mat4> &transforms) const;
 
     const aiNodeAnim *findNodeAnimation(aiAnimation *pAnimation, std::string basic_string) const;
 
@@ -149,15 +193,50 @@ public:
      * @param time Requested animation time in miliseconds.
      * @param looped if animation should loop or not. Effects return.
      * @param animationName name of animation to seek.
+     * @param cursors key frame cursors of the instance, reused between calls.
      * @param transformMatrix transform matrix list for bones
      *
      * @return if last frame of animation is played for not looped animation. Always true for looped ones.
      */
-    bool getTransform(long time, bool looped, std::string animationName, std::vector<glm::mat4> &transformMatrix) const; //this method takes vector to avoid copying it
+    bool getTransform(long time, bool looped, const std::string &animationName, AnimationCursors &cursors, std::vector<glm::mat4> &transformMatrix) const; //this method takes vector to avoid copying it
 
-    bool getTransformBlended(std::string animationName1, long time1, bool looped1,
-                                         std::string animationName2, long time2, bool looped2,
-                                         float blendFactor, std::vector<glm::mat4> &transformMatrixVector) const;
+    bool getTransformBlended(const std::string &animationName1, long time1, bool looped1, AnimationCursors &cursors1,
+                             const std::string &animationName2, long time2, bool looped2, AnimationCursors &cursors2,
+                             float blendFactor, std::vector<glm::mat4> &transformMatrixVector) const;
+
+    /************ Flat pose API, bones are in skeleton order. Used for layered animations ************/
+    uint32_t getSkeletonBoneCount() const {
+        return (uint32_t)skeleton.size();
+    }
+
+    /**
+     * Returns the compiled animation with the name. If not found, returns the first animation, like getTransform.
+     * Returns nullptr only if the model has no animations.
+     */
+    const CompiledAnimation* findCompiledAnimation(const std::string &animationName) const;
+
+    static float calculateAnimationTime(const AnimationInterface &animation, long time, bool looped, bool &isFinished);
+
+    void fillBindPose(AnimationPose &pose) const;
+
+    /**
+     * Samples the animation at time in milliseconds to the pose.
+     * @return true if the animation is not looped, and time is after its last frame.
+     */
+    bool samplePose(const CompiledAnimation &animation, long time, bool looped, AnimationCursors &cursors, AnimationPose &pose) const;
+
+    /**
+     * Same as above, but finds the animation by name. Fills bind pose if name is empty, like getTransform.
+     */
+    bool samplePose(const std::string &animationName, long time, bool looped, AnimationCursors &cursors, AnimationPose &pose) const;
+
+    void calculateTransforms(const AnimationPose &pose, std::vector<glm::mat4> &transforms) const;
+
+    /**
+     * Creates per bone weights, 1 for the bone with the name and its children, 0 for others. Empty name selects all bones.
+     * Returned vector has the padded size of AnimationPose. Empty vector is returned if bone is not found.
+     */
+    std::vector<float> buildBoneMask(const std::string &rootBoneName) const;
 
     const glm::vec3 &getBoundingBoxMin() const { return boundingBoxMin; }
 
@@ -225,6 +304,7 @@ public:
         ar(assetID, boneIDCounter, boneIDCounterPerMesh, *temporaryEmbeddedTextures, hasAnimation, rootNode, boundingBoxMax, boundingBoxMin, centerOffset, boneInformationMap, simplifiedMeshes, meshes, animations, animationSections, customizationAfterSave, materialMap, transparentMaterialUsed);
         //now update embedded textures to assetManager
         buildPhysicsMeshes();
+        compileAnimations();
     }
 #endif
 
@@ -3,11 +3,14 @@
 //
 
 #include "SoundAsset.h"
+#include "SoundStream.h"
 #include "../../libs/dr_wav.h"
 
 #include <iostream>
 #include <vector>
 
+const uint32_t SoundAsset::STREAMING_THRESHOLD_SECONDS = 10;
+
 SoundAsset::SoundAsset(AssetManager *assetManager, uint32_t assetID, const std::vector<std::string> &fileList) : Asset(
         assetManager, assetID, fileList) {
 
@@ -22,12 +25,36 @@ SoundAsset::SoundAsset(AssetManager *assetManager, uint32_t assetID, const std::
 }
 
 void SoundAsset::loadCPUPart() {
-    soundData = drwav_open_and_read_file_s16(name.c_str(), &channels, &sampleRate, &sampleCount);
-    if (soundData == nullptr) {
+    drwav wav;
+    if (!drwav_init_file(&wav, name.c_str()) || wav.channels == 0 || wav.sampleRate == 0) {
         // Error opening and reading WAV file.
         std::cerr << "failed to read wav file " << name << " , this case is not handled. Exiting" << std::endl;
         exit(-1);
     }
+    channels = wav.channels;
+    sampleRate = wav.sampleRate;
+    sampleCount = wav.totalSampleCount;
+
+    // only the header is read until now, long sounds stay on disk
+    streamed = sampleCount / channels >= (uint64_t)STREAMING_THRESHOLD_SECONDS * sampleRate;
+    if (!streamed) {
+        soundData = (int16_t *) malloc((size_t) sampleCount * sizeof(int16_t));
+        if (soundData == nullptr) {
+            std::cerr << "failed to allocate memory for wav file " << name << " , this case is not handled. Exiting" << std::endl;
+            exit(-1);
+        }
+        sampleCount = drwav_read_s16(&wav, sampleCount, soundData);
+    }
+    drwav_uninit(&wav);
+}
+
+std::unique_ptr<SoundStream> SoundAsset::openStream() const {
+    std::unique_ptr<SoundStream> stream = std::unique_ptr<SoundStream>(new SoundStream(name));
+    if (!stream->isValid()) {
+        std::cerr << "failed to open wav file " << name << " for streaming." << std::endl;
+        return nullptr;
+    }
+    return stream;
 }
 
 SoundAsset::~SoundAsset() {
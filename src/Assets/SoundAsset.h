@@ -8,12 +8,23 @@
 
 #include "Asset.h"
 #include <cassert>
+#include <memory>
 
+class SoundStream;
+
+/**
+ * Short sounds are decoded once on load, and all plays of the asset share the decoded data.
+ * Sounds longer than STREAMING_THRESHOLD_SECONDS are not decoded on load, each play decodes them from disk
+ * using its own stream.
+ */
 class SoundAsset : public Asset {
+    static const uint32_t STREAMING_THRESHOLD_SECONDS;
+
     unsigned int channels;
     uint32_t sampleRate;
     uint64_t sampleCount;
-    int16_t* soundData = nullptr; //PCM 16bit, prefer single channel
+    int16_t* soundData = nullptr; //PCM 16bit, prefer single channel. nullptr if streamed
+    bool streamed = false;
     std::string name;
     void loadCPUPart() override;
     void loadGPUPart() override {
@@ -46,6 +57,15 @@ public:
         return soundData;
     }
 
+    bool isStreamed() const {
+        return streamed;
+    }
+
+    /**
+     * Opens a new decoder for the asset, only for streamed assets.
+     */
+    std::unique_ptr<SoundStream> openStream() const;
+
     const std::string& getName() const {
         return name;
     }
@@ -0,0 +1,58 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_SOUNDSTREAM_H
+#define LIMONENGINE_SOUNDSTREAM_H
+
+
+#include <string>
+#include <cstdint>
+#include "../../libs/dr_wav.h"
+
+/**
+ * Incremental decoder for long sounds. Keeps the file open and decodes only the requested samples, so the whole
+ * track is never in memory. Each playing sound owns its own, since decoders have a read position.
+ *
+ * Not thread safe, it is used only by the sound manager thread.
+ */
+class SoundStream {
+    drwav decoder;
+    bool valid;
+
+public:
+    explicit SoundStream(const std::string &fileName) {
+        valid = drwav_init_file(&decoder, fileName.c_str());
+    }
+
+    SoundStream(const SoundStream&) = delete;
+    SoundStream& operator=(const SoundStream&) = delete;
+
+    ~SoundStream() {
+        if(valid) {
+            drwav_uninit(&decoder);
+        }
+    }
+
+    bool isValid() const {
+        return valid;
+    }
+
+    /**
+     * Decodes next samples as PCM 16bit. Samples are interleaved, so count should be a multiple of channel count.
+     * @return number of samples decoded, less than requested means end of file or read error
+     */
+    uint64_t read(uint64_t sampleCount, int16_t *buffer) {
+        if(!valid) {
+            return 0;
+        }
+        return drwav_read_s16(&decoder, sampleCount, buffer);
+    }
+
+    bool rewind() {
+        return valid && drwav_seek_to_sample(&decoder, 0);
+    }
+};
+
+
+#endif //LIMONENGINE_SOUNDSTREAM_H
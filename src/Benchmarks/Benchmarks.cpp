@@ -0,0 +1,38 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include <algorithm>
+#include "Benchmarks.h"
+
+bool Benchmarks::run(const std::string &name, std::shared_ptr<AssetManager> assetManager) {
+    if(name == "culling") {
+        return runCulling();
+    }
+    if(name == "lightClusters") {
+        return runLightClusters();
+    }
+    if(name == "particles") {
+        return runParticles(assetManager);
+    }
+    std::cerr << "Unknown benchmark " << name << ". Available benchmarks are: culling, lightClusters, particles" << std::endl;
+    return false;
+}
+
+void Benchmarks::printTimings(const std::string &name, std::vector<double> &timingsMs, uint64_t elementCount) {
+    if(timingsMs.empty()) {
+        return;
+    }
+    double total = 0;
+    for (double timing : timingsMs) {
+        total += timing;
+    }
+    std::sort(timingsMs.begin(), timingsMs.end());
+    double median = timingsMs[timingsMs.size() / 2];
+    std::cout << "    " << name << ": average " << total / timingsMs.size() << "ms, "
+              << "min " << timingsMs.front() << "ms, "
+              << "median " << median << "ms, "
+              << "max " << timingsMs.back() << "ms, "
+              << (uint64_t)(elementCount / median) << " per ms" << std::endl;
+}
@@ -0,0 +1,38 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_BENCHMARKS_H
+#define LIMONENGINE_BENCHMARKS_H
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+class AssetManager;
+
+/**
+ * Micro benchmarks of engine systems, run with --benchmark name. They use the headless backend and don't load a world,
+ * so results are reproducible and don't need a GPU. Inputs are generated with fixed seeds.
+ */
+class Benchmarks {
+    static bool runCulling();
+    static bool runLightClusters();
+    static bool runParticles(std::shared_ptr<AssetManager> assetManager);
+
+public:
+    /**
+     * @return false if the benchmark is unknown, or its results are wrong
+     */
+    static bool run(const std::string &name, std::shared_ptr<AssetManager> assetManager);
+
+    /**
+     * Prints timings of the iterations, and the elements processed per ms for the median.
+     */
+    static void printTimings(const std::string &name, std::vector<double> &timingsMs, uint64_t elementCount);
+};
+
+
+#endif //LIMONENGINE_BENCHMARKS_H
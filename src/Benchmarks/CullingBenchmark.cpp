@@ -0,0 +1,90 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmarks.h"
+#include "Camera/AABBArray.h"
+#include "Utils/FastRandom.h"
+#include "Utils/Profiler.h"
+
+/**
+ * Culls 100k boxes against the 6 planes of a perspective frustum. Batched culling of AABBArray is compared with the
+ * per object test the cameras use, and the results must match.
+ */
+bool Benchmarks::runCulling() {
+    const uint32_t boxCount = 100000;
+    const uint32_t iterationCount = 100;
+
+    //planes of projection * view, same convention as the cameras, inside is positive
+    glm::mat4 clip = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) *
+                     glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(1, 0, -1), glm::vec3(0, 1, 0));
+    glm::mat4 rows = glm::transpose(clip);
+    glm::vec4 planes[6] = {rows[3] - rows[0], rows[3] + rows[0],
+                           rows[3] - rows[1], rows[3] + rows[1],
+                           rows[3] - rows[2], rows[3] + rows[2]};
+    for (glm::vec4 &plane : planes) {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
+
+    FastRandom random(1);
+    AABBArray aabbs;
+    aabbs.resize(boxCount);
+    std::vector<glm::vec3> aabbMins(boxCount), aabbMaxs(boxCount);
+    for (uint32_t i = 0; i < boxCount; ++i) {
+        glm::vec3 center(random.nextSigned() * 500.0f, random.nextSigned() * 500.0f, random.nextSigned() * 500.0f);
+        glm::vec3 halfExtent = glm::vec3(3.0f) + glm::vec3(random.nextSigned(), random.nextSigned(), random.nextSigned()) * 2.5f;
+        aabbMins[i] = center - halfExtent;
+        aabbMaxs[i] = center + halfExtent;
+        aabbs.set(i, aabbMins[i], aabbMaxs[i]);
+    }
+
+    std::vector<uint32_t> scalarMask(AABBArray::getMaskWordCount(boxCount));
+    std::vector<uint32_t> batchedMask(AABBArray::getMaskWordCount(boxCount));
+    std::vector<double> scalarTimings, batchedTimings;
+    for (uint32_t iteration = 0; iteration < iterationCount; ++iteration) {
+        uint64_t startTime = Profiler::now();
+        std::fill(scalarMask.begin(), scalarMask.end(), 0);
+        for (uint32_t i = 0; i < boxCount; ++i) {
+            bool inside = true;
+            for (int plane = 0; plane < 6; plane++) {
+                //summed in the same order as the SIMD path, so boxes touching a plane give the same result
+                float d =   (std::fmax(aabbMins[i].x * planes[plane].x, aabbMaxs[i].x * planes[plane].x)
+                             + std::fmax(aabbMins[i].y * planes[plane].y, aabbMaxs[i].y * planes[plane].y))
+                            + (std::fmax(aabbMins[i].z * planes[plane].z, aabbMaxs[i].z * planes[plane].z)
+                             + planes[plane].w);
+                inside &= d > 0;
+            }
+            scalarMask[i / 32] |= (inside ? 1u : 0u) << (i % 32);
+        }
+        scalarTimings.push_back((Profiler::now() - startTime) / 1000000.0);
+
+        startTime = Profiler::now();
+        aabbs.cullAgainstPlanes(planes, 6, 0, boxCount, batchedMask.data());
+        batchedTimings.push_back((Profiler::now() - startTime) / 1000000.0);
+    }
+
+    uint32_t visibleCount = 0;
+    for (uint32_t i = 0; i < boxCount; ++i) {
+        if(AABBArray::isVisible(scalarMask.data(), i) != AABBArray::isVisible(batchedMask.data(), i)) {
+            std::cerr << "Culling benchmark failed, box " << i << " has different results for scalar and batched culling" << std::endl;
+            return false;
+        }
+        visibleCount += AABBArray::isVisible(batchedMask.data(), i);
+    }
+
+#if defined(LIMON_AABB_CULL_AVX)
+    const std::string batchType = "AVX";
+#elif defined(LIMON_AABB_CULL_SSE)
+    const std::string batchType = "SSE";
+#else
+    const std::string batchType = "scalar fallback";
+#endif
+    std::cout << "Culling " << boxCount << " boxes against 6 planes, " << visibleCount << " visible, "
+              << iterationCount << " iterations, batched with " << batchType << std::endl;
+    printTimings("per object", scalarTimings, boxCount);
+    printTimings("batched", batchedTimings, boxCount);
+    return true;
+}
@@ -0,0 +1,68 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmarks.h"
+#include "Graphics/LightClusterBuilder.h"
+#include "Utils/FastRandom.h"
+#include "Utils/Profiler.h"
+
+/**
+ * Assigns NR_MAX_CLUSTERED_LIGHTS point lights, spread in the view frustum, to the clusters on a single thread. Each light
+ * must be in the cluster its center falls in.
+ */
+bool Benchmarks::runLightClusters() {
+    const uint32_t iterationCount = 100;
+    const float maximumDistance = 150.0f;//World default
+    const float fieldOfView = glm::radians(60.0f);
+    const float aspect = 16.0f / 9.0f;
+
+    //camera at origin looking at -z, so view space is the same as world space
+    glm::mat4 projection = glm::perspective(fieldOfView, aspect, 0.1f, 500.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+
+    FastRandom random(1);
+    std::vector<glm::vec3> positions(NR_MAX_CLUSTERED_LIGHTS);
+    std::vector<float> radii(NR_MAX_CLUSTERED_LIGHTS);
+    const float tanHalfFov = std::tan(fieldOfView / 2.0f);
+    for (uint32_t i = 0; i < NR_MAX_CLUSTERED_LIGHTS; ++i) {
+        float depth = 1.0f + (random.nextSigned() * 0.5f + 0.5f) * (maximumDistance - 1.0f);
+        positions[i] = glm::vec3(random.nextSigned() * 0.95f * tanHalfFov * aspect * depth,
+                                 random.nextSigned() * 0.95f * tanHalfFov * depth,
+                                 -depth);
+        radii[i] = 6.0f + random.nextSigned() * 4.0f;
+    }
+
+    LightClusterBuilder builder;
+    std::vector<double> timings;
+    for (uint32_t iteration = 0; iteration < iterationCount; ++iteration) {
+        builder.beginFrame(projection, view, maximumDistance);
+        for (uint32_t i = 0; i < NR_MAX_CLUSTERED_LIGHTS; ++i) {
+            builder.addLight(positions[i], radii[i], glm::vec3(1.0f), glm::vec3(1.0f, 0.1f, 0.01f), glm::vec3(0.1f));
+        }
+        uint64_t startTime = Profiler::now();
+        builder.build();
+        timings.push_back((Profiler::now() - startTime) / 1000000.0);
+    }
+
+    const std::vector<uint32_t> &clusterRanges = builder.getClusterRanges();
+    const std::vector<uint32_t> &lightIndices = builder.getLightIndices();
+    for (uint32_t i = 0; i < NR_MAX_CLUSTERED_LIGHTS; ++i) {
+        uint32_t cluster = builder.getClusterIndex(positions[i]);
+        uint32_t offset = clusterRanges[2 * cluster];
+        uint32_t count = clusterRanges[2 * cluster + 1];
+        if(std::find(lightIndices.begin() + offset, lightIndices.begin() + offset + count, i) == lightIndices.begin() + offset + count) {
+            std::cerr << "Light cluster benchmark failed, light " << i << " is not in cluster " << cluster << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "Clustering " << NR_MAX_CLUSTERED_LIGHTS << " point lights to " << LightClusterBuilder::CLUSTER_COUNT
+              << " clusters, " << lightIndices.size() << " light indices, " << iterationCount << " iterations, single thread" << std::endl;
+    printTimings("build", timings, NR_MAX_CLUSTERED_LIGHTS);
+    return true;
+}
@@ -0,0 +1,50 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include "Benchmarks.h"
+#include "Graphics/Particles/Emitter.h"
+#include "Utils/Profiler.h"
+
+/**
+ * Simulates a single emitter of 100k particles on a single thread, so particles per ms is per core. Emitter is filled
+ * before timing, then continuous emit keeps it full while the oldest particles expire.
+ */
+bool Benchmarks::runParticles(std::shared_ptr<AssetManager> assetManager) {
+    const long particleCount = 100000;
+    const long lifeTime = 2000;
+    const long tickDuration = 1000 / TICK_PER_SECOND;
+    const uint32_t iterationCount = 300;
+
+    Emitter emitter(1, "benchmarkEmitter", assetManager, "./Engine/Textures/ssaoNoiseTexture.png",
+                    glm::vec3(0, 0, 0), glm::vec3(10, 10, 10), glm::vec2(0.1f, 0.1f), particleCount, lifeTime);
+    emitter.setGravity(glm::vec3(0, -9.8f, 0));
+    emitter.setSpeedMultiplier(glm::vec3(0.1f, 0.1f, 0.1f));
+    emitter.setSpeedOffset(glm::vec3(0, 0.2f, 0));
+    emitter.setRandomSeed(1);
+
+    long time = tickDuration;//0 means not simulated yet
+    for (; time <= lifeTime + tickDuration; time += tickDuration) {
+        emitter.simulate(time);
+    }
+    if(emitter.getCurrentCount() < particleCount * 9 / 10) {
+        std::cerr << "Particle benchmark failed, emitter has " << emitter.getCurrentCount() << " particles after its life time, expected "
+                  << particleCount << std::endl;
+        return false;
+    }
+
+    std::vector<double> timings;
+    uint64_t simulatedParticleCount = 0;
+    for (uint32_t iteration = 0; iteration < iterationCount; ++iteration, time += tickDuration) {
+        uint64_t startTime = Profiler::now();
+        emitter.simulate(time);
+        timings.push_back((Profiler::now() - startTime) / 1000000.0);
+        simulatedParticleCount += emitter.getCurrentCount();
+    }
+
+    std::cout << "Simulating " << particleCount << " particles, " << simulatedParticleCount / iterationCount
+              << " alive on average, " << iterationCount << " ticks, single thread" << std::endl;
+    printTimings("simulate", timings, simulatedParticleCount / iterationCount);
+    return true;
+}
@@ -0,0 +1,192 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_AABBARRAY_H
+#define LIMONENGINE_AABBARRAY_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <glm/glm.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LIMON_AABB_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIMON_AABB_CULL_SSE
+#endif
+
+/**
+ * World space AABBs kept as structure of arrays, so they can be culled 4 (SSE) or 8 (AVX) at a time.
+ *
+ * Culling results are written as a bitmask, bit i is set if box i is visible. Culling can be split to ranges,
+ * each range writes only its own words, so the range start must be multiple of 32, and the end must be either
+ * multiple of 32 or the size of the array.
+ *
+ * Arrays are padded to multiple of 8 elements, so SIMD loads never read out of bounds.
+ */
+class AABBArray {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+    uint32_t count = 0;
+
+    static uint32_t getPaddedSize(uint32_t elementCount) {
+        return (elementCount + 7u) & ~7u;
+    }
+
+    /**
+     * Runs test for each 32 element block in [start, end), test returns the visibility bits of the boxes starting at given index.
+     */
+    template<typename BlockTest>
+    void forEachBlock(uint32_t start, uint32_t end, uint32_t* outBitmask, uint32_t boxesPerTest, BlockTest test) const {
+        assert(start % 32 == 0);
+        assert(end % 32 == 0 || end == count);
+        for (uint32_t blockStart = start; blockStart < end; blockStart += 32) {
+            uint32_t blockEnd = std::min(blockStart + 32, end);
+            uint32_t word = 0;
+            for (uint32_t index = blockStart; index < blockEnd; index += boxesPerTest) {
+                word |= test(index) << (index - blockStart);
+            }
+            if(blockEnd - blockStart < 32) {
+                word &= (1u << (blockEnd - blockStart)) - 1;//padding is not part of the range
+            }
+            outBitmask[blockStart / 32] = word;
+        }
+    }
+
+public:
+    static uint32_t getMaskWordCount(uint32_t elementCount) {
+        return (elementCount + 31) / 32;
+    }
+
+    static bool isVisible(const uint32_t* bitmask, uint32_t index) {
+        return (bitmask[index / 32] >> (index % 32)) & 1u;
+    }
+
+    void resize(uint32_t newCount) {
+        count = newCount;
+        uint32_t paddedSize = getPaddedSize(newCount);
+        minX.resize(paddedSize, 0.0f);
+        minY.resize(paddedSize, 0.0f);
+        minZ.resize(paddedSize, 0.0f);
+        maxX.resize(paddedSize, 0.0f);
+        maxY.resize(paddedSize, 0.0f);
+        maxZ.resize(paddedSize, 0.0f);
+    }
+
+    uint32_t size() const {
+        return count;
+    }
+
+    void set(uint32_t index, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        minX[index] = aabbMin.x;
+        minY[index] = aabbMin.y;
+        minZ[index] = aabbMin.z;
+        maxX[index] = aabbMax.x;
+        maxY[index] = aabbMax.y;
+        maxZ[index] = aabbMax.z;
+    }
+
+    glm::vec3 getMin(uint32_t index) const {
+        return glm::vec3(minX[index], minY[index], minZ[index]);
+    }
+
+    glm::vec3 getMax(uint32_t index) const {
+        return glm::vec3(maxX[index], maxY[index], maxZ[index]);
+    }
+
+    /**
+     * Box is visible if it is not completely behind any of the planes. Same test as the single object isVisible of the cameras.
+     */
+    void cullAgainstPlanes(const glm::vec4* planes, uint32_t planeCount, uint32_t start, uint32_t end, uint32_t* outBitmask) const {
+#if defined(LIMON_AABB_CULL_AVX)
+        forEachBlock(start, end, outBitmask, 8, [&](uint32_t index) -> uint32_t {
+            __m256 bMinX = _mm256_loadu_ps(&minX[index]), bMaxX = _mm256_loadu_ps(&maxX[index]);
+            __m256 bMinY = _mm256_loadu_ps(&minY[index]), bMaxY = _mm256_loadu_ps(&maxY[index]);
+            __m256 bMinZ = _mm256_loadu_ps(&minZ[index]), bMaxZ = _mm256_loadu_ps(&maxZ[index]);
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (uint32_t i = 0; i < planeCount; ++i) {
+                __m256 planeX = _mm256_set1_ps(planes[i].x), planeY = _mm256_set1_ps(planes[i].y), planeZ = _mm256_set1_ps(planes[i].z);
+                __m256 distance = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_max_ps(_mm256_mul_ps(bMinX, planeX), _mm256_mul_ps(bMaxX, planeX)),
+                                      _mm256_max_ps(_mm256_mul_ps(bMinY, planeY), _mm256_mul_ps(bMaxY, planeY))),
+                        _mm256_add_ps(_mm256_max_ps(_mm256_mul_ps(bMinZ, planeZ), _mm256_mul_ps(bMaxZ, planeZ)),
+                                      _mm256_set1_ps(planes[i].w)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GT_OQ));
+            }
+            return (uint32_t)_mm256_movemask_ps(inside);
+        });
+#elif defined(LIMON_AABB_CULL_SSE)
+        forEachBlock(start, end, outBitmask, 4, [&](uint32_t index) -> uint32_t {
+            __m128 bMinX = _mm_loadu_ps(&minX[index]), bMaxX = _mm_loadu_ps(&maxX[index]);
+            __m128 bMinY = _mm_loadu_ps(&minY[index]), bMaxY = _mm_loadu_ps(&maxY[index]);
+            __m128 bMinZ = _mm_loadu_ps(&minZ[index]), bMaxZ = _mm_loadu_ps(&maxZ[index]);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (uint32_t i = 0; i < planeCount; ++i) {
+                __m128 planeX = _mm_set1_ps(planes[i].x), planeY = _mm_set1_ps(planes[i].y), planeZ = _mm_set1_ps(planes[i].z);
+                __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_max_ps(_mm_mul_ps(bMinX, planeX), _mm_mul_ps(bMaxX, planeX)),
+                                   _mm_max_ps(_mm_mul_ps(bMinY, planeY), _mm_mul_ps(bMaxY, planeY))),
+                        _mm_add_ps(_mm_max_ps(_mm_mul_ps(bMinZ, planeZ), _mm_mul_ps(bMaxZ, planeZ)),
+                                   _mm_set1_ps(planes[i].w)));
+                inside = _mm_and_ps(inside, _mm_cmpgt_ps(distance, _mm_setzero_ps()));
+            }
+            return (uint32_t)_mm_movemask_ps(inside);
+        });
+#else
+        forEachBlock(start, end, outBitmask, 1, [&](uint32_t index) -> uint32_t {
+            bool inside = true;
+            for (uint32_t i = 0; i < planeCount; ++i) {
+                float d =   std::fmax(minX[index] * planes[i].x, maxX[index] * planes[i].x)
+                            + std::fmax(minY[index] * planes[i].y, maxY[index] * planes[i].y)
+                            + std::fmax(minZ[index] * planes[i].z, maxZ[index] * planes[i].z)
+                            + planes[i].w;
+                inside &= d > 0;
+            }
+            return inside ? 1u : 0u;
+        });
+#endif
+    }
+
+    /**
+     * Box is visible if its closest point to center is closer than radius.
+     */
+    void cullAgainstSphere(const glm::vec3& center, float radius, uint32_t start, uint32_t end, uint32_t* outBitmask) const {
+        const float radiusSquare = radius * radius;
+#if defined(LIMON_AABB_CULL_AVX)
+        forEachBlock(start, end, outBitmask, 8, [&](uint32_t index) -> uint32_t {
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 centerX = _mm256_set1_ps(center.x), centerY = _mm256_set1_ps(center.y), centerZ = _mm256_set1_ps(center.z);
+            __m256 dx = _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(&minX[index]), centerX), _mm256_max_ps(zero, _mm256_sub_ps(centerX, _mm256_loadu_ps(&maxX[index]))));
+            __m256 dy = _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(&minY[index]), centerY), _mm256_max_ps(zero, _mm256_sub_ps(centerY, _mm256_loadu_ps(&maxY[index]))));
+            __m256 dz = _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(&minZ[index]), centerZ), _mm256_max_ps(zero, _mm256_sub_ps(centerZ, _mm256_loadu_ps(&maxZ[index]))));
+            __m256 distanceSquare = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(distanceSquare, _mm256_set1_ps(radiusSquare), _CMP_LT_OQ));
+        });
+#elif defined(LIMON_AABB_CULL_SSE)
+        forEachBlock(start, end, outBitmask, 4, [&](uint32_t index) -> uint32_t {
+            const __m128 zero = _mm_setzero_ps();
+            __m128 centerX = _mm_set1_ps(center.x), centerY = _mm_set1_ps(center.y), centerZ = _mm_set1_ps(center.z);
+            __m128 dx = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minX[index]), centerX), _mm_max_ps(zero, _mm_sub_ps(centerX, _mm_loadu_ps(&maxX[index]))));
+            __m128 dy = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minY[index]), centerY), _mm_max_ps(zero, _mm_sub_ps(centerY, _mm_loadu_ps(&maxY[index]))));
+            __m128 dz = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minZ[index]), centerZ), _mm_max_ps(zero, _mm_sub_ps(centerZ, _mm_loadu_ps(&maxZ[index]))));
+            __m128 distanceSquare = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(distanceSquare, _mm_set1_ps(radiusSquare)));
+        });
+#else
+        forEachBlock(start, end, outBitmask, 1, [&](uint32_t index) -> uint32_t {
+            float dx = std::max(minX[index] - center.x, std::max(0.0f, center.x - maxX[index]));
+            float dy = std::max(minY[index] - center.y, std::max(0.0f, center.y - maxY[index]));
+            float dz = std::max(minZ[index] - center.z, std::max(0.0f, center.z - maxZ[index]));
+            return (dx * dx + dy * dy + dz * dz) < radiusSquare ? 1u : 0u;
+        });
+#endif
+    }
+};
+
+
+#endif //LIMONENGINE_AABBARRAY_H
@@ -0,0 +1,435 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_AABBTREE_H
+#define LIMONENGINE_AABBTREE_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <glm/glm.hpp>
+
+/**
+ * Dynamic bounding volume hierarchy of object AABBs.
+ *
+ * Leaves keep a fattened copy of the object AABB, so small movements don't change the tree. When an object leaves
+ * its fat AABB, it is removed and inserted again. Tree is kept balanced with rotations, so queries are O(log n) to
+ * reach a leaf, and whole subtrees are rejected with a single test.
+ *
+ * Queries collect object IDs, they don't check anything other than the AABBs. Queries don't modify the tree, so
+ * multiple threads can query at the same time, as long as nothing updates it.
+ */
+class AABBTree {
+    static constexpr int32_t NULL_NODE = -1;
+
+    struct Node {
+        glm::vec3 aabbMin;
+        glm::vec3 aabbMax;
+        int32_t parent = NULL_NODE;//also used as next pointer in free list
+        int32_t left = NULL_NODE;
+        int32_t right = NULL_NODE;
+        int32_t height = 0;//leaf is 0, free node is -1
+        uint32_t objectID = 0;
+
+        bool isLeaf() const {
+            return left == NULL_NODE;
+        }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    float margin;
+    std::vector<int32_t> leafOfObject;//objectID -> leaf node
+
+    static float getSurfaceArea(const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        glm::vec3 size = aabbMax - aabbMin;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static bool contains(const Node& node, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        return node.aabbMin.x <= aabbMin.x && node.aabbMin.y <= aabbMin.y && node.aabbMin.z <= aabbMin.z &&
+               aabbMax.x <= node.aabbMax.x && aabbMax.y <= node.aabbMax.y && aabbMax.z <= node.aabbMax.z;
+    }
+
+    static float getDistanceSquare(const Node& node, const glm::vec3& point) {
+        float dx = std::max(node.aabbMin.x - point.x, std::max(0.0f, point.x - node.aabbMax.x));
+        float dy = std::max(node.aabbMin.y - point.y, std::max(0.0f, point.y - node.aabbMax.y));
+        float dz = std::max(node.aabbMin.z - point.z, std::max(0.0f, point.z - node.aabbMax.z));
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    static float getFarthestDistanceSquare(const Node& node, const glm::vec3& point) {
+        float dx = std::max(std::abs(point.x - node.aabbMin.x), std::abs(point.x - node.aabbMax.x));
+        float dy = std::max(std::abs(point.y - node.aabbMin.y), std::abs(point.y - node.aabbMax.y));
+        float dz = std::max(std::abs(point.z - node.aabbMin.z), std::abs(point.z - node.aabbMax.z));
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    void collectLeaves(int32_t subtreeRoot, std::vector<int32_t>& stack, std::vector<uint32_t>& objectIDs) const {
+        //stack is in use by the caller, its elements below the current size are preserved
+        size_t stackBase = stack.size();
+        stack.push_back(subtreeRoot);
+        while(stack.size() > stackBase) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if(node.isLeaf()) {
+                objectIDs.push_back(node.objectID);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    int32_t allocateNode() {
+        if(freeList == NULL_NODE) {
+            nodes.emplace_back();
+            return (int32_t)nodes.size() - 1;
+        }
+        int32_t nodeIndex = freeList;
+        freeList = nodes[nodeIndex].parent;
+        nodes[nodeIndex] = Node();
+        return nodeIndex;
+    }
+
+    void freeNode(int32_t nodeIndex) {
+        nodes[nodeIndex].parent = freeList;
+        nodes[nodeIndex].height = -1;
+        freeList = nodeIndex;
+    }
+
+    void fitToChildren(int32_t nodeIndex) {
+        Node& node = nodes[nodeIndex];
+        const Node& left = nodes[node.left];
+        const Node& right = nodes[node.right];
+        node.aabbMin = glm::min(left.aabbMin, right.aabbMin);
+        node.aabbMax = glm::max(left.aabbMax, right.aabbMax);
+        node.height = 1 + std::max(left.height, right.height);
+    }
+
+    void insertLeaf(int32_t leaf) {
+        if(root == NULL_NODE) {
+            root = leaf;
+            nodes[root].parent = NULL_NODE;
+            return;
+        }
+        //find the best sibling, by going down the child that grows less
+        const glm::vec3 leafMin = nodes[leaf].aabbMin;
+        const glm::vec3 leafMax = nodes[leaf].aabbMax;
+        int32_t index = root;
+        while(!nodes[index].isLeaf()) {
+            const Node& node = nodes[index];
+            float area = getSurfaceArea(node.aabbMin, node.aabbMax);
+            float combinedArea = getSurfaceArea(glm::min(node.aabbMin, leafMin), glm::max(node.aabbMax, leafMax));
+            //cost of making a new parent for this node and the leaf
+            float cost = 2.0f * combinedArea;
+            //minimum cost of pushing the leaf further down
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float childCosts[2];
+            int32_t children[2] = {node.left, node.right};
+            for (int i = 0; i < 2; ++i) {
+                const Node& child = nodes[children[i]];
+                float childCombinedArea = getSurfaceArea(glm::min(child.aabbMin, leafMin), glm::max(child.aabbMax, leafMax));
+                if(child.isLeaf()) {
+                    childCosts[i] = childCombinedArea + inheritanceCost;
+                } else {
+                    childCosts[i] = childCombinedArea - getSurfaceArea(child.aabbMin, child.aabbMax) + inheritanceCost;
+                }
+            }
+            if(cost < childCosts[0] && cost < childCosts[1]) {
+                break;
+            }
+            index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+        }
+
+        int32_t sibling = index;
+        int32_t oldParent = nodes[sibling].parent;
+        int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].left = sibling;
+        nodes[newParent].right = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+        fitToChildren(newParent);
+        if(oldParent == NULL_NODE) {
+            root = newParent;
+        } else if(nodes[oldParent].left == sibling) {
+            nodes[oldParent].left = newParent;
+        } else {
+            nodes[oldParent].right = newParent;
+        }
+        refitUpwards(nodes[leaf].parent);
+    }
+
+    void removeLeaf(int32_t leaf) {
+        if(leaf == root) {
+            root = NULL_NODE;
+            return;
+        }
+        int32_t parent = nodes[leaf].parent;
+        int32_t grandParent = nodes[parent].parent;
+        int32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+        if(grandParent == NULL_NODE) {
+            root = sibling;
+            nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+            return;
+        }
+        if(nodes[grandParent].left == parent) {
+            nodes[grandParent].left = sibling;
+        } else {
+            nodes[grandParent].right = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitUpwards(grandParent);
+    }
+
+    void refitUpwards(int32_t index) {
+        while(index != NULL_NODE) {
+            index = balance(index);
+            fitToChildren(index);
+            index = nodes[index].parent;
+        }
+    }
+
+    /**
+     * If one child is 2 levels higher than the other, rotates it up. Returns the node that took the place of the given node.
+     */
+    int32_t balance(int32_t aIndex) {
+        Node& a = nodes[aIndex];
+        if(a.isLeaf() || a.height < 2) {
+            return aIndex;
+        }
+        int32_t bIndex = a.left;
+        int32_t cIndex = a.right;
+        int32_t heightDifference = nodes[cIndex].height - nodes[bIndex].height;
+        if(heightDifference > 1) {
+            return rotateUp(aIndex, cIndex, bIndex);
+        }
+        if(heightDifference < -1) {
+            return rotateUp(aIndex, bIndex, cIndex);
+        }
+        return aIndex;
+    }
+
+    /**
+     * high child of a takes the place of a, and a takes the place of one of the high child's children.
+     */
+    int32_t rotateUp(int32_t aIndex, int32_t highIndex, int32_t lowIndex) {
+        Node& a = nodes[aIndex];
+        Node& high = nodes[highIndex];
+        int32_t fIndex = high.left;
+        int32_t gIndex = high.right;
+
+        high.parent = a.parent;
+        a.parent = highIndex;
+        if(high.parent == NULL_NODE) {
+            root = highIndex;
+        } else if(nodes[high.parent].left == aIndex) {
+            nodes[high.parent].left = highIndex;
+        } else {
+            nodes[high.parent].right = highIndex;
+        }
+        //the taller grandchild stays with high, the other one goes to a
+        int32_t keptIndex = nodes[fIndex].height > nodes[gIndex].height ? fIndex : gIndex;
+        int32_t movedIndex = keptIndex == fIndex ? gIndex : fIndex;
+        high.left = aIndex;
+        high.right = keptIndex;
+        a.left = lowIndex;
+        a.right = movedIndex;
+        nodes[movedIndex].parent = aIndex;
+        nodes[lowIndex].parent = aIndex;
+        fitToChildren(aIndex);
+        fitToChildren(highIndex);
+        return highIndex;
+    }
+
+public:
+    static constexpr float NO_DISTANCE_LIMIT = std::numeric_limits<float>::max();
+
+    explicit AABBTree(float margin = 0.1f) : margin(margin) {}
+
+    bool contains(uint32_t objectID) const {
+        return objectID < leafOfObject.size() && leafOfObject[objectID] != NULL_NODE;
+    }
+
+    void insert(uint32_t objectID, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        if(contains(objectID)) {
+            update(objectID, aabbMin, aabbMax);
+            return;
+        }
+        int32_t leaf = allocateNode();
+        nodes[leaf].aabbMin = aabbMin - glm::vec3(margin);
+        nodes[leaf].aabbMax = aabbMax + glm::vec3(margin);
+        nodes[leaf].objectID = objectID;
+        nodes[leaf].height = 0;
+        if(leafOfObject.size() <= objectID) {
+            leafOfObject.resize(objectID + 1, static_cast<int32_t>(NULL_NODE));
+        }
+        leafOfObject[objectID] = leaf;
+        insertLeaf(leaf);
+    }
+
+    void remove(uint32_t objectID) {
+        if(!contains(objectID)) {
+            return;
+        }
+        int32_t leaf = leafOfObject[objectID];
+        removeLeaf(leaf);
+        freeNode(leaf);
+        leafOfObject[objectID] = NULL_NODE;
+    }
+
+    /**
+     * @return true if the tree changed, false if the new AABB is still inside the fat AABB of the leaf
+     */
+    bool update(uint32_t objectID, const glm::vec3& aabbMin, const glm::vec3& aabbMax) {
+        if(!contains(objectID)) {
+            insert(objectID, aabbMin, aabbMax);
+            return true;
+        }
+        int32_t leaf = leafOfObject[objectID];
+        if(contains(nodes[leaf], aabbMin, aabbMax)) {
+            return false;
+        }
+        removeLeaf(leaf);
+        nodes[leaf].aabbMin = aabbMin - glm::vec3(margin);
+        nodes[leaf].aabbMax = aabbMax + glm::vec3(margin);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    void clear() {
+        nodes.clear();
+        leafOfObject.clear();
+        root = NULL_NODE;
+        freeList = NULL_NODE;
+    }
+
+    /**
+     * Collects objects that are not completely behind any of the planes, and closer than maxDistance to distanceCenter.
+     * If a node is completely inside all planes and the distance, its subtree is collected without further tests.
+     */
+    void queryPlanes(const glm::vec4* planes, uint32_t planeCount, const glm::vec3& distanceCenter, float maxDistance,
+                     std::vector<uint32_t>& objectIDs) const {
+        if(root == NULL_NODE) {
+            return;
+        }
+        const float maxDistanceSquare = maxDistance * maxDistance;
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(root);
+        while(!stack.empty()) {
+            int32_t index = stack.back();
+            stack.pop_back();
+            const Node& node = nodes[index];
+            if(getDistanceSquare(node, distanceCenter) > maxDistanceSquare) {
+                continue;
+            }
+            bool outside = false;
+            bool fullyInside = true;
+            for (uint32_t i = 0; i < planeCount; ++i) {
+                const glm::vec4& plane = planes[i];
+                float farthest = std::max(node.aabbMin.x * plane.x, node.aabbMax.x * plane.x)
+                                 + std::max(node.aabbMin.y * plane.y, node.aabbMax.y * plane.y)
+                                 + std::max(node.aabbMin.z * plane.z, node.aabbMax.z * plane.z)
+                                 + plane.w;
+                if(farthest <= 0) {
+                    outside = true;
+                    break;
+                }
+                float closest = std::min(node.aabbMin.x * plane.x, node.aabbMax.x * plane.x)
+                                + std::min(node.aabbMin.y * plane.y, node.aabbMax.y * plane.y)
+                                + std::min(node.aabbMin.z * plane.z, node.aabbMax.z * plane.z)
+                                + plane.w;
+                fullyInside &= closest > 0;
+            }
+            if(outside) {
+                continue;
+            }
+            if(node.isLeaf()) {
+                objectIDs.push_back(node.objectID);
+            } else if(fullyInside && getFarthestDistanceSquare(node, distanceCenter) <= maxDistanceSquare) {
+                collectLeaves(index, stack, objectIDs);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    /**
+     * Collects objects with AABBs that have any point closer than radius to center.
+     */
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objectIDs) const {
+        if(root == NULL_NODE) {
+            return;
+        }
+        const float radiusSquare = radius * radius;
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(root);
+        while(!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if(getDistanceSquare(node, center) > radiusSquare) {
+                continue;
+            }
+            if(node.isLeaf()) {
+                objectIDs.push_back(node.objectID);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    /**
+     * Collects objects with AABBs that are hit by the segment from-to.
+     */
+    void queryRay(const glm::vec3& from, const glm::vec3& to, std::vector<uint32_t>& objectIDs) const {
+        if(root == NULL_NODE) {
+            return;
+        }
+        glm::vec3 direction = to - from;
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(root);
+        while(!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            //slab test
+            float entry = 0.0f, exit = 1.0f;
+            bool hit = true;
+            for (int axis = 0; axis < 3 && hit; ++axis) {
+                if(direction[axis] == 0.0f) {
+                    hit = from[axis] >= node.aabbMin[axis] && from[axis] <= node.aabbMax[axis];
+                    continue;
+                }
+                float t1 = (node.aabbMin[axis] - from[axis]) / direction[axis];
+                float t2 = (node.aabbMax[axis] - from[axis]) / direction[axis];
+                entry = std::max(entry, std::min(t1, t2));
+                exit = std::min(exit, std::max(t1, t2));
+                hit = entry <= exit;
+            }
+            if(!hit) {
+                continue;
+            }
+            if(node.isLeaf()) {
+                objectIDs.push_back(node.objectID);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+};
+
+
+#endif //LIMONENGINE_AABBTREE_H
@@ -6,14 +6,18 @@
 #define LIMONENGINE_CAMERA_H
 
 #include "Renderable.h"
+#include "AABBArray.h"
+#include "AABBTree.h"
 #include "vector"
 #include "Utils/HashUtil.h"
+#include "Utils/TagRegistry.h"
 #include "iostream"
 
 class Camera {
     std::vector<HashUtil::HashedString> renderTags;
     std::vector<HashUtil::HashedString> selfTags;
-
+    TagRegistry::TagMask renderTagMask;
+    TagRegistry::TagMask selfTagMask;
 
 protected:
     std::string name;
@@ -123,6 +127,17 @@ public:
 
     virtual bool isVisible(const PhysicalRenderable& renderable) const = 0;
 
+    /**
+     * Batched version of isVisible, sets bits of outBitmask for visible boxes in [start, end). See AABBArray for range rules.
+     */
+    virtual void cullAABBs(const AABBArray& aabbs, uint32_t start, uint32_t end, uint32_t* outBitmask) const = 0;
+
+    /**
+     * Hierarchical version of isVisible. Collects objects of the tree that might be visible and closer than maxDistance
+     * to distanceCenter. Tree uses fattened AABBs, so results should still be checked with isVisible.
+     */
+    virtual void queryVisible(const AABBTree& tree, const glm::vec3& distanceCenter, float maxDistance, std::vector<uint32_t>& objectIDs) const = 0;
+
     virtual bool isResultVisibleOnOtherCamera(const PhysicalRenderable& renderable, const Camera* otherCamera) const = 0;
 
     virtual const glm::mat4& getCameraMatrix() = 0;
@@ -135,10 +150,19 @@ public:
         HashUtil::HashedString tag(text);
         if(!hasRenderTag(tag.hash)) {
             renderTags.emplace_back(tag);
+            uint32_t tagIndex = TagRegistry::registerTag(tag);
+            if(tagIndex != TagRegistry::INVALID_INDEX) {
+                renderTagMask.set(tagIndex);
+            }
         }
     }
 
     bool hasRenderTag(uint64_t hash) const {
+        uint32_t tagIndex = TagRegistry::findIndex(hash);
+        if(tagIndex != TagRegistry::INVALID_INDEX) {
+            return renderTagMask.test(tagIndex);
+        }
+        //registry might be full, so tags without index are still checked by hash
         for (const HashUtil::HashedString& hashedString:renderTags) {
             if(hashedString.hash == hash) {
                 return true;
@@ -151,15 +175,29 @@ public:
         return renderTags;
     }
 
+    /**
+     * Culling matches objects with this, instead of checking each tag
+     */
+    const TagRegistry::TagMask& getRenderTagMask() const {
+        return renderTagMask;
+    }
+
     void addTag(const std::string& text) {
         HashUtil::HashedString tag(text);
         if(!hasTag(tag.hash)) {
             selfTags.emplace_back(tag);
+            uint32_t tagIndex = TagRegistry::registerTag(tag);
+            if(tagIndex != TagRegistry::INVALID_INDEX) {
+                selfTagMask.set(tagIndex);
+            }
         }
     }
 
-    //FIXME this is slower than it needs to be
-    bool hasTag(uint64_t hash) {
+    bool hasTag(uint64_t hash) const {
+        uint32_t tagIndex = TagRegistry::findIndex(hash);
+        if(tagIndex != TagRegistry::INVALID_INDEX) {
+            return selfTagMask.test(tagIndex);
+        }
         for (const HashUtil::HashedString& hashedString:selfTags) {
             if(hashedString.hash == hash) {
                 return true;
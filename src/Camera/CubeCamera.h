@@ -49,8 +49,26 @@ public:
         this->dirty = false;
     }
 
+    /**
+     * Uses the closest point of the box instead of the object position, so big objects are not culled while still in range.
+     * Same calculation as AABBArray::cullAgainstSphere, tree and range culling must agree.
+     */
     bool isVisible(const PhysicalRenderable& renderable) const override {
-        return glm::distance2(renderable.getTransformation()->getTranslate(), this->position) < activeDistance * activeDistance;
+        const glm::vec3 &aabbMin = renderable.getAabbMin();
+        const glm::vec3 &aabbMax = renderable.getAabbMax();
+        float dx = std::max(aabbMin.x - position.x, std::max(0.0f, position.x - aabbMax.x));
+        float dy = std::max(aabbMin.y - position.y, std::max(0.0f, position.y - aabbMax.y));
+        float dz = std::max(aabbMin.z - position.z, std::max(0.0f, position.z - aabbMax.z));
+        return (dx * dx + dy * dy + dz * dz) < activeDistance * activeDistance;
+    }
+
+    void cullAABBs(const AABBArray& aabbs, uint32_t start, uint32_t end, uint32_t* outBitmask) const override {
+        aabbs.cullAgainstSphere(position, activeDistance, start, end, outBitmask);
+    }
+
+    void queryVisible(const AABBTree& tree, const glm::vec3& distanceCenter [[gnu::unused]], float maxDistance [[gnu::unused]], std::vector<uint32_t>& objectIDs) const override {
+        //lod distance is not from the light, so it is checked per object
+        tree.querySphere(position, activeDistance, objectIDs);
     }
 
     bool isResultVisibleOnOtherCamera(const PhysicalRenderable& renderable[[gnu::unused]], const Camera* otherCamera[[gnu::unused]]) const override {
@@ -49,7 +49,8 @@ public:
     };
 
     bool isDirty() const override {
-        return this->dirty || cameraAttachment->isDirty();
+        //light marks the cascades it recalculates through getCameraMatrix, rest keep their culling results
+        return this->dirty;
     };
 
     void clearDirty() override {
@@ -74,6 +75,14 @@ public:
         return inside;
     };
 
+    void cullAABBs(const AABBArray& aabbs, uint32_t start, uint32_t end, uint32_t* outBitmask) const override {
+        aabbs.cullAgainstPlanes(frustumPlanes.data(), frustumPlanes.size(), start, end, outBitmask);
+    }
+
+    void queryVisible(const AABBTree& tree, const glm::vec3& distanceCenter, float maxDistance, std::vector<uint32_t>& objectIDs) const override {
+        tree.queryPlanes(frustumPlanes.data(), frustumPlanes.size(), distanceCenter, maxDistance, objectIDs);
+    }
+
     bool isResultVisibleOnOtherCamera(const PhysicalRenderable& renderable[[gnu::unused]], const Camera* otherCamera[[gnu::unused]]) const override {
         return true;
     }
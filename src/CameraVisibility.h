@@ -0,0 +1,294 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_CAMERAVISIBILITY_H
+#define LIMONENGINE_CAMERAVISIBILITY_H
+
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "Utils/TagRegistry.h"
+
+/**
+ * Culling results of a single camera.
+ *
+ * Tag sets come from the render pipeline, and they are resolved to indices once, when the pipeline changes. Tags are
+ * also mapped by their registry index, so culling can match an object with a mask and, and find the set by bit.
+ * For each tag set, visible objects are kept grouped by asset in contiguous arrays, so they can be passed directly
+ * to instanced rendering. Each object remembers its position in the asset array, so insert and remove are O(1).
+ *
+ * There are 2 copies of the results. Culling writes to the write buffer, publish() copies it to the read buffer.
+ * Render and setup code only reads the read buffer, so it never sees a half written state. Write buffer tracks the
+ * assets that changed since the last publish, and only those are copied.
+ */
+class CameraVisibility {
+public:
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t NO_LOD = std::numeric_limits<uint32_t>::max();
+
+    struct AssetVisibility {
+        uint32_t assetID;
+        uint32_t lod = NO_LOD;//minimum lod of the visible objects
+        std::vector<uint32_t> objectIDs;
+
+        explicit AssetVisibility(uint32_t assetID) : assetID(assetID) {}
+    };
+
+    class TagSetVisibility {
+        std::vector<AssetVisibility> assets;
+        std::unordered_map<uint32_t, uint32_t> assetIndices;//assetID -> index in assets
+        std::vector<uint32_t> objectSlots;//objectID -> index in the objectIDs of its asset
+        std::vector<uint8_t> assetChanged;//per index in assets, since last publish
+        std::vector<uint32_t> changedAssets;
+
+        void markChanged(uint32_t assetIndex) {
+            if(!assetChanged[assetIndex]) {
+                assetChanged[assetIndex] = 1;
+                changedAssets.emplace_back(assetIndex);
+            }
+        }
+
+    public:
+        void insert(uint32_t assetID, uint32_t objectID, uint32_t lod) {
+            auto assetIndexIt = assetIndices.find(assetID);
+            if(assetIndexIt == assetIndices.end()) {
+                assetIndexIt = assetIndices.insert(std::make_pair(assetID, (uint32_t)assets.size())).first;
+                assets.emplace_back(assetID);
+                assetChanged.emplace_back(0);
+            }
+            AssetVisibility& assetVisibility = assets[assetIndexIt->second];
+            if(lod < assetVisibility.lod) {
+                assetVisibility.lod = lod;
+                markChanged(assetIndexIt->second);
+            }
+            if(objectSlots.size() <= objectID) {
+                objectSlots.resize(objectID + 1, static_cast<uint32_t>(INVALID_INDEX));
+            }
+            if(objectSlots[objectID] != INVALID_INDEX) {
+                return;//already in the list
+            }
+            objectSlots[objectID] = (uint32_t)assetVisibility.objectIDs.size();
+            assetVisibility.objectIDs.emplace_back(objectID);
+            markChanged(assetIndexIt->second);
+        }
+
+        void remove(uint32_t assetID, uint32_t objectID) {
+            if(objectSlots.size() <= objectID || objectSlots[objectID] == INVALID_INDEX) {
+                return;
+            }
+            auto assetIndexIt = assetIndices.find(assetID);
+            if(assetIndexIt == assetIndices.end()) {
+                return;
+            }
+            AssetVisibility& assetVisibility = assets[assetIndexIt->second];
+            markChanged(assetIndexIt->second);
+            uint32_t slot = objectSlots[objectID];
+            //swap with the last element, so removal doesn't shift the array
+            uint32_t lastObjectID = assetVisibility.objectIDs.back();
+            assetVisibility.objectIDs[slot] = lastObjectID;
+            objectSlots[lastObjectID] = slot;
+            assetVisibility.objectIDs.pop_back();
+            objectSlots[objectID] = INVALID_INDEX;
+            if(assetVisibility.objectIDs.empty()) {
+                //asset entry is kept, so its index stays valid. Empty entries are skipped by the readers
+                assetVisibility.lod = NO_LOD;
+            }
+        }
+
+        bool contains(uint32_t objectID) const {
+            return objectID < objectSlots.size() && objectSlots[objectID] != INVALID_INDEX;
+        }
+
+        const AssetVisibility* findAsset(uint32_t assetID) const {
+            auto assetIndexIt = assetIndices.find(assetID);
+            if(assetIndexIt == assetIndices.end()) {
+                return nullptr;
+            }
+            return &assets[assetIndexIt->second];
+        }
+
+        const std::vector<AssetVisibility>& getAssets() const {
+            return assets;
+        }
+
+        void clear() {
+            for (uint32_t assetIndex = 0; assetIndex < assets.size(); ++assetIndex) {
+                AssetVisibility &assetVisibility = assets[assetIndex];
+                if(assetVisibility.objectIDs.empty() && assetVisibility.lod == NO_LOD) {
+                    continue;
+                }
+                for (uint32_t objectID: assetVisibility.objectIDs) {
+                    objectSlots[objectID] = INVALID_INDEX;
+                }
+                assetVisibility.objectIDs.clear();
+                assetVisibility.lod = NO_LOD;
+                markChanged(assetIndex);
+            }
+        }
+
+        /**
+         * Copies the assets that changed since the last call to target. Target must only be changed by this method,
+         * or by the same removes, so its assets are in the same order.
+         */
+        void publishChangesTo(TagSetVisibility &target) {
+            for (uint32_t assetIndex: changedAssets) {
+                assetChanged[assetIndex] = 0;
+                while(target.assets.size() <= assetIndex) {
+                    uint32_t assetID = assets[target.assets.size()].assetID;
+                    target.assetIndices.insert(std::make_pair(assetID, (uint32_t)target.assets.size()));
+                    target.assets.emplace_back(assetID);
+                    target.assetChanged.emplace_back(0);
+                }
+                const AssetVisibility &source = assets[assetIndex];
+                AssetVisibility &destination = target.assets[assetIndex];
+                for (uint32_t objectID: destination.objectIDs) {
+                    target.objectSlots[objectID] = INVALID_INDEX;
+                }
+                destination.objectIDs = source.objectIDs;//reuses the capacity
+                destination.lod = source.lod;
+                if(target.objectSlots.size() < objectSlots.size()) {
+                    target.objectSlots.resize(objectSlots.size(), static_cast<uint32_t>(INVALID_INDEX));
+                }
+                for (uint32_t slot = 0; slot < destination.objectIDs.size(); ++slot) {
+                    target.objectSlots[destination.objectIDs[slot]] = slot;
+                }
+            }
+            changedAssets.clear();
+        }
+    };
+
+private:
+    std::vector<std::vector<uint64_t>> tagSetHashes;
+    std::unordered_map<uint64_t, uint32_t> tagToSetIndex;
+    std::array<uint32_t, TagRegistry::MAX_TAG_COUNT> tagIndexToSetIndex;
+    TagRegistry::TagMask tagSetMask;//tags that are in any set
+    std::vector<TagSetVisibility> writeBuffer;
+    std::vector<TagSetVisibility> readBuffer;
+    bool refillRequired = true;
+
+public:
+    CameraVisibility() {
+        tagIndexToSetIndex.fill(static_cast<uint32_t>(INVALID_INDEX));
+    }
+
+    /**
+     * Replaces the tag sets with the ones from the render pipeline. Any tag from a set is enough for a match,
+     * if a tag is in multiple sets, first one is used.
+     */
+    void setTagSets(const std::vector<std::vector<uint64_t>>& newTagSets) {
+        clear();
+        tagSetHashes = newTagSets;
+        for (size_t setIndex = 0; setIndex < tagSetHashes.size(); ++setIndex) {
+            for (uint64_t hash: tagSetHashes[setIndex]) {
+                tagToSetIndex.insert(std::make_pair(hash, (uint32_t)setIndex));
+                uint32_t tagIndex = TagRegistry::findIndex(hash);
+                if(tagIndex != TagRegistry::INVALID_INDEX && !tagSetMask.test(tagIndex)) {
+                    tagSetMask.set(tagIndex);
+                    tagIndexToSetIndex[tagIndex] = (uint32_t)setIndex;
+                }
+            }
+        }
+        writeBuffer.resize(tagSetHashes.size());
+        readBuffer.resize(tagSetHashes.size());
+    }
+
+    void clear() {
+        tagSetHashes.clear();
+        tagToSetIndex.clear();
+        tagIndexToSetIndex.fill(static_cast<uint32_t>(INVALID_INDEX));
+        tagSetMask.reset();
+        writeBuffer.clear();
+        readBuffer.clear();
+        refillRequired = true;
+    }
+
+    uint32_t findTagSetIndex(uint64_t hash) const {
+        auto it = tagToSetIndex.find(hash);
+        if(it == tagToSetIndex.end()) {
+            return INVALID_INDEX;
+        }
+        return it->second;
+    }
+
+    /**
+     * Tag must be in getTagSetMask(), so the index is valid.
+     */
+    uint32_t findTagSetIndexByTag(uint32_t tagIndex) const {
+        return tagIndexToSetIndex[tagIndex];
+    }
+
+    const TagRegistry::TagMask& getTagSetMask() const {
+        return tagSetMask;
+    }
+
+    const std::vector<uint64_t>& getTagSetHashes(uint32_t setIndex) const {
+        return tagSetHashes[setIndex];
+    }
+
+    /************ Writer side, only culling should use these ************/
+    TagSetVisibility& getWritableTagSet(uint32_t setIndex) {
+        return writeBuffer[setIndex];
+    }
+
+    /**
+     * Drops every visible object, but keeps the tag sets. Used when the camera is dirty, so everything is recalculated.
+     */
+    void clearWritable() {
+        for (TagSetVisibility &tagSetVisibility: writeBuffer) {
+            tagSetVisibility.clear();
+        }
+    }
+
+    /**
+     * Removes object from both buffers. Only safe when culling is not running.
+     */
+    void removeObject(uint32_t assetID, uint32_t objectID) {
+        for (TagSetVisibility &tagSetVisibility: writeBuffer) {
+            tagSetVisibility.remove(assetID, objectID);
+        }
+        for (TagSetVisibility &tagSetVisibility: readBuffer) {
+            tagSetVisibility.remove(assetID, objectID);
+        }
+    }
+
+    /**
+     * True after tag sets change, meaning all objects should be culled again even if nothing is dirty
+     */
+    bool isRefillRequired() const {
+        return refillRequired;
+    }
+
+    /**
+     * Makes the culling results visible to readers. Write buffer keeps its content, so next culling can be incremental.
+     */
+    void publish() {
+        for (size_t setIndex = 0; setIndex < writeBuffer.size(); ++setIndex) {
+            writeBuffer[setIndex].publishChangesTo(readBuffer[setIndex]);
+        }
+        refillRequired = false;
+    }
+
+    /************ Reader side ************/
+    const std::vector<TagSetVisibility>& getVisibleTagSets() const {
+        return readBuffer;
+    }
+
+    /**
+     * True if the object is in any of the published tag sets.
+     */
+    bool isVisible(uint32_t objectID) const {
+        for (const TagSetVisibility &tagSetVisibility: readBuffer) {
+            if(tagSetVisibility.contains(objectID)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+#endif //LIMONENGINE_CAMERAVISIBILITY_H
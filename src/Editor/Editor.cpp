@@ -612,13 +612,14 @@ void Editor::renderEditor() {
         if(ImGui::Button("Save AI walk Grid Binary")) {
             if(world->grid != nullptr) {
                 std::string AIWalkName = world->name.substr(0, world->name.find_last_of(".")) + ".aiwalkb";
-                std::ofstream os(AIWalkName, std::ios::binary);
-                cereal::BinaryOutputArchive archive( os );
-
-                archive(*(world->grid));
+                world->grid->serializeBinary(AIWalkName);
             }
         }
 #endif
+        if(ImGui::Button("Regenerate AI walk Grid")) {
+            //blocks until done, progress is logged
+            world->createGridFrom(world->aiGridStartPoint, true);
+        }
         if(ImGui::Button("Convert models to binary")) {
             std::set<std::vector<std::string>> convertedAssets;
             for (auto objectIt = world->objects.begin(); objectIt != world->objects.end(); ++objectIt) {
@@ -636,6 +637,10 @@ void Editor::renderEditor() {
         if(ImGui::Button("Change Render Pipeline")) {
             world->showNodeGraph = true;
         }
+        ImGui::SameLine();
+        if(ImGui::Button("Show Profiler")) {
+            showProfiler = true;
+        }
         if (ImGui::CollapsingHeader("Render Debugging")) {
             static int listbox_item_current = -1;//not static because I don't want user to select a item.
             static ImGuiImageWrapper wrapper;//keeps selected texture and layer;
@@ -719,9 +724,10 @@ void Editor::renderEditor() {
             Model *pickedModel = dynamic_cast<Model *>(world->pickedObject);
             if (pickedModel != nullptr) {
                 for(const auto& cameraResult :world->cullingResults) {
-                    for(const auto& tagResult : *cameraResult.second) {
-                        if (tagResult.second.find(pickedModel->getAssetID()) != tagResult.second.end()) {
-                            lod = std::min(tagResult.second.find(pickedModel->getAssetID())->second.second, lod);
+                    for(const auto& tagResult : cameraResult.second->getVisibleTagSets()) {
+                        const CameraVisibility::AssetVisibility* assetVisibility = tagResult.findAsset(pickedModel->getAssetID());
+                        if (assetVisibility != nullptr) {
+                            lod = std::min(assetVisibility->lod, lod);
                         }
                     }
                 }
@@ -878,21 +884,15 @@ void Editor::renderEditor() {
                             if((*iterator)->getWorldObjectID() == world->pickedObject->getWorldObjectID()) {
                                 world->unusedIDs.push(world->pickedObject->getWorldObjectID());
                                 const std::vector<Camera*>& cameras = (*iterator)->getCameras();
+                                //culling jobs are done when frame ends, so requests and results can be removed directly
                                 for (auto camera:cameras) {
-                                    world->cullingResults.erase(camera);
-                                }
-                                //we need to find where the visibility thread is
-                                for (auto entry:world->visibilityThreadPool) {
-                                    for (auto camera:cameras) {
-                                        if (entry.first->camera == camera) {
-                                            entry.first->running = false;
-                                            VisibilityRequest::condition.signalWaiting();
-                                            SDL_WaitThread(entry.second, nullptr);
-                                            auto visRequest = entry.first;
-                                            world->visibilityThreadPool.erase(visRequest);
-                                            delete visRequest;
-                                        }
+                                    auto requestIt = world->visibilityRequests.find(camera);
+                                    if (requestIt != world->visibilityRequests.end()) {
+                                        delete requestIt->second;
+                                        world->visibilityRequests.erase(requestIt);
                                     }
+                                    delete world->cullingResults[camera];
+                                    world->cullingResults.erase(camera);
                                 }
                                 world->lights.erase(iterator);
                                 break;
@@ -916,11 +916,103 @@ void Editor::renderEditor() {
 
         ImGui::End();
     }
+    if(showProfiler) {
+        renderProfiler();
+    }
 
     /* window definitions */
     world->imgGuiHelper->RenderDrawLists();
 }
 
+void Editor::renderProfiler() {
+    ImGui::Begin("Profiler", &showProfiler);
+    bool recording = Profiler::isEnabled();
+    if(ImGui::Checkbox("Record##Profiler", &recording)) {
+        Profiler::setEnabled(recording);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause##Profiler", &profilerPaused);
+    ImGui::SameLine();
+    if(ImGui::Button("Export Chrome trace##Profiler")) {
+        Profiler::exportChromeTrace("./profile_trace.json");
+    }
+    if(ImGui::CollapsingHeader("Shadow updates##Profiler")) {
+        const ShadowUpdateScheduler &scheduler = world->shadowUpdateScheduler;
+        for (uint32_t slot = 0; slot < scheduler.getSlotCount() && slot < world->activeLights.size(); ++slot) {
+            ImGui::Text("%s", world->activeLights[slot]->getName().c_str());
+            for (uint32_t layer = 0; layer < scheduler.getLayerCount(slot); ++layer) {
+                const ShadowUpdateScheduler::LayerStatistics &statistics = scheduler.getStatistics(slot, layer);
+                ImGui::Text("    Layer %u: %llu updates, %llu static%s", layer, (unsigned long long)statistics.updateCount,
+                            (unsigned long long)statistics.staticUpdateCount, statistics.updatedThisFrame ? ", updated" : "");
+            }
+        }
+    }
+    if(!profilerPaused) {
+        uint64_t frameStart, frameEnd;
+        if(Profiler::getLastFrame(frameStart, frameEnd)) {
+            profilerFrameStart = frameStart;
+            profilerFrameEnd = frameEnd;
+            Profiler::collect(frameStart, frameEnd, profilerEvents);
+        }
+    }
+    if(profilerFrameEnd <= profilerFrameStart) {
+        ImGui::Text("No frame is recorded yet.");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("Frame time: %.3f ms", (profilerFrameEnd - profilerFrameStart) / 1000000.0);
+
+    const float labelWidth = 120.0f;
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    float timelineWidth = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 100.0f);
+    double pixelsPerNanosecond = timelineWidth / (double)(profilerFrameEnd - profilerFrameStart);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    for (const Profiler::ThreadEvents &thread: profilerEvents) {
+        if(thread.events.empty()) {
+            continue;
+        }
+        uint32_t maxDepth = 0;
+        for (const Profiler::Event &event: thread.events) {
+            maxDepth = std::max(maxDepth, event.depth);
+        }
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float trackHeight = (maxDepth + 1) * rowHeight;
+        ImGui::Text("%s", thread.threadName.c_str());
+        ImGui::SetCursorScreenPos(origin);
+        ImGui::Dummy(ImVec2(labelWidth + timelineWidth, trackHeight));
+        ImVec2 trackMin(origin.x + labelWidth, origin.y);
+        ImVec2 trackMax(trackMin.x + timelineWidth, origin.y + trackHeight);
+        drawList->AddRectFilled(trackMin, trackMax, IM_COL32(40, 40, 40, 255));
+        drawList->PushClipRect(trackMin, trackMax, true);
+        for (const Profiler::Event &event: thread.events) {
+            ImVec2 zoneMin(trackMin.x + (float)(((double)event.start - (double)profilerFrameStart) * pixelsPerNanosecond),
+                           trackMin.y + event.depth * rowHeight);
+            ImVec2 zoneMax(trackMin.x + (float)(((double)event.end - (double)profilerFrameStart) * pixelsPerNanosecond),
+                           zoneMin.y + rowHeight - 1.0f);
+            zoneMax.x = std::max(zoneMax.x, zoneMin.x + 1.0f);//keep very short zones visible
+            //color by name, so same zone has same color on every frame
+            uint32_t nameHash = 2166136261u;
+            for (const char* character = event.name; *character != '\0'; ++character) {
+                nameHash = (nameHash ^ (uint8_t)*character) * 16777619u;
+            }
+            drawList->AddRectFilled(zoneMin, zoneMax, ImColor::HSV((nameHash % 360) / 360.0f, 0.5f, 0.8f));
+            if(zoneMax.x - zoneMin.x > 20.0f) {
+                ImVec4 textClip(zoneMin.x, zoneMin.y, zoneMax.x, zoneMax.y);
+                drawList->AddText(ImGui::GetFont(), ImGui::GetFontSize(), ImVec2(zoneMin.x + 2.0f, zoneMin.y + 2.0f),
+                                  IM_COL32_BLACK, event.name, nullptr, 0.0f, &textClip);
+            }
+            if(ImGui::IsMouseHoveringRect(zoneMin, zoneMax)) {
+                ImGui::BeginTooltip();
+                ImGui::Text("%s", event.name);
+                ImGui::Text("%.3f ms", (event.end - event.start) / 1000000.0);
+                ImGui::EndTooltip();
+            }
+        }
+        drawList->PopClipRect();
+    }
+    ImGui::End();
+}
+
 void Editor::setTransformToModel(Model *model, const glm::vec3 &newObjectPosition) {
     //First reset the model transform
     model->getTransformation()->setTranslate(glm::vec3(0.0f, 0.0f, 0.0f));
@@ -7,6 +7,7 @@
 
 #include "ImGui/imgui.h"
 #include <set>
+#include "Utils/Profiler.h"
 #define MAX_PRELOAD_MODEL_COUNT_EDITOR 10
 class World;
 class PhysicalRenderable;
@@ -29,6 +30,12 @@ class Editor {
     Model* getModelAndMoveToEnd(const std::string& modelFilePath);
     Model *createRenderAndAddModelToLRU(const std::string &modelFileName, const glm::vec3 &newObjectPosition);
     ImGuiImageWrapper* wrapper = nullptr;
+
+    bool showProfiler = false;
+    bool profilerPaused = false;
+    std::vector<Profiler::ThreadEvents> profilerEvents;
+    uint64_t profilerFrameStart = 0;
+    uint64_t profilerFrameEnd = 0;
 public:
     Editor(World* world);
     void renderEditor();
@@ -46,6 +53,11 @@ private:
     void renderSelectedObject(Model* model);
 
     void setTransformToModel(Model *model, const glm::vec3 &newObjectPosition);
+
+    /**
+     * Timeline of the last frame, one track per thread and one for GPU. Pausing keeps the shown frame.
+     */
+    void renderProfiler();
 };
 
 
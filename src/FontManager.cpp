@@ -27,28 +27,13 @@ Face *FontManager::getFont(const std::string &fontPath, const uint32_t size) {
             FT_New_Face(ft, DEFAULT_FONT_PATH.c_str(), 0, &face);
         }
 
-        fonts[fontDescription] = new Face(graphicsWrapper, fontPath, size, face);
-        FT_Set_Pixel_Sizes(face, 0, size);
-        //now we should calculate what we have
-
-
-        unsigned int w = 0;
-        unsigned int h = 0;
-
-        for (unsigned int i = 0; i < 256; i++) {
-            if (FT_Load_Char(face, i, FT_LOAD_RENDER)) {
-                fprintf(stderr, "Loading character %c failed!\n", i);
-                continue;
-            }
-
-            w = std::max(w, face->glyph->bitmap.width);
-            h = std::max(h, face->glyph->bitmap.rows);
-
+        Face* newFace = new Face(graphicsWrapper, fontPath, size, face);
+        fonts[fontDescription] = newFace;
+        //pack printable ascii up front, others are added to atlas when used
+        for (char character = 32; character < 127; character++) {
+            newFace->getGlyph(character);
         }
-
-        std::cout << "atlas h: " << h << ", w " << w << std::endl;
-
-        //now we have maximum size of the textures
+        std::cout << "Font atlas for " << fontPath << " size " << size << " is " << newFace->getAtlasWidth() << "x" << newFace->getAtlasHeight() << std::endl;
     }
 
     return fonts[fontDescription];
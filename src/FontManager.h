@@ -11,52 +11,56 @@
 #include <memory>
 #include <freetype2/ft2build.h>
 #include <set>
+#include <vector>
+#include <cstring>
+#include <algorithm>
 
 #include FT_FREETYPE_H
 #include "API/Graphics/GraphicsInterface.h"
 #include "Graphics/Texture.h"
 
 class Glyph {
-    std::unique_ptr<Texture> texture;
     glm::mediump_ivec2 size;
     glm::mediump_ivec2 bearing;
+    glm::mediump_ivec2 atlasPosition;//top left pixel in face atlas
     uint32_t advance;
 public:
-    Glyph(GraphicsInterface* graphicsWrapper, FT_Face face, const int size, const char character) :
-            size(glm::mediump_vec2(0)), bearing(glm::mediump_vec2(0)), advance(0) {
+    /**
+     * Renders the glyph to the glyph slot of the face, Face copies the bitmap to its atlas right after.
+     */
+    Glyph(FT_Face face, const int size, const char character) :
+            size(glm::mediump_vec2(0)), bearing(glm::mediump_vec2(0)), atlasPosition(glm::mediump_vec2(0)), advance(0) {
         //FIXME this is not correct, there is a better function in API
         FT_Set_Pixel_Sizes(face, 0, size);
         if (FT_Load_Char(face, character, FT_LOAD_RENDER)) {
             std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
         } else {
-            texture = std::make_unique<Texture>(graphicsWrapper, GraphicsInterface::TextureTypes::T2D,
-                                                GraphicsInterface::InternalFormatTypes::RED, GraphicsInterface::FormatTypes::RED, GraphicsInterface::DataTypes::UNSIGNED_BYTE,
-                                                face->glyph->bitmap.width, face->glyph->bitmap.rows);
-            texture->loadData(face->glyph->bitmap.buffer);
             this->size = glm::mediump_ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows);
             bearing = glm::mediump_ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
             advance = face->glyph->advance.x;
-            /**
-            std::cout << "Glyph load success. Information:" << std::endl
-            << "char: " << character << std::endl
-            << "size: " << this->size.x << "," << this->size.y << std::endl
-            << "bearing: " << bearing.x << "," << bearing.y << std::endl
-            << "advance: " << advance << " (" << advance / 64 << ")" << std::endl;
-             */
         }
-
     }
 
-    uint32_t getTextureID() const { return texture->getTextureID(); }
-
     const glm::mediump_ivec2 &getSize() const { return size; }
 
     const glm::mediump_ivec2 &getBearing() const { return bearing; }
 
+    const glm::mediump_ivec2 &getAtlasPosition() const { return atlasPosition; }
+
+    void setAtlasPosition(const glm::mediump_ivec2 &atlasPosition) { this->atlasPosition = atlasPosition; }
+
     uint32_t getAdvance() const { return advance; }
 };
 
+/**
+ * Glyphs of a face are packed to a single texture using shelves, so a text can be rendered with one draw.
+ * Atlas width is fixed, height doubles when it is full. Since the rows don't move, only the texture coordinates change,
+ * users should rebuild their texture coordinates when getAtlasGeneration changes.
+ */
 class Face {
+    static const uint32_t ATLAS_PADDING = 1;//empty pixels between glyphs, so linear filtering doesn't bleed
+    static const uint32_t MAX_ATLAS_HEIGHT = 8192;
+
     GraphicsInterface* graphicsWrapper;
     std::string path;
     unsigned int size;
@@ -64,18 +68,116 @@ class Face {
     int lineHeight;
     int maxCharWidth;
     std::map<const char, Glyph *> glyphs;
+
+    std::unique_ptr<Texture> atlasTexture;
+    std::vector<uint8_t> atlasPixels;
+    uint32_t atlasWidth;
+    uint32_t atlasHeight;
+    uint32_t shelfX = ATLAS_PADDING;
+    uint32_t shelfY = ATLAS_PADDING;
+    uint32_t shelfHeight = 0;
+    uint32_t atlasGeneration = 0;
+    bool atlasDirty = false;
+
+    void addToAtlas(Glyph *glyph, const FT_Bitmap &bitmap) {
+        uint32_t glyphWidth = bitmap.width;
+        uint32_t glyphHeight = bitmap.rows;
+        if(glyphWidth == 0 || glyphHeight == 0) {
+            return;//space etc.
+        }
+        if(glyphWidth + 2 * ATLAS_PADDING > atlasWidth) {
+            std::cerr << "Glyph is wider than font atlas for " << path << ", it won't be rendered." << std::endl;
+            return;
+        }
+        if(shelfX + glyphWidth + ATLAS_PADDING > atlasWidth) {
+            //next shelf
+            shelfY += shelfHeight + ATLAS_PADDING;
+            shelfX = ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        while(shelfY + glyphHeight + ATLAS_PADDING > atlasHeight) {
+            if(atlasHeight * 2 > MAX_ATLAS_HEIGHT) {
+                std::cerr << "Font atlas for " << path << " is full, glyph won't be rendered." << std::endl;
+                return;
+            }
+            atlasHeight *= 2;
+            atlasPixels.resize(atlasWidth * atlasHeight, 0);//width is same, so existing rows stay where they are
+            atlasTexture.reset();
+            atlasGeneration++;
+        }
+        int pitch = bitmap.pitch < 0 ? -bitmap.pitch : bitmap.pitch;
+        for (uint32_t row = 0; row < glyphHeight; ++row) {
+            std::memcpy(&atlasPixels[(shelfY + row) * atlasWidth + shelfX], bitmap.buffer + row * pitch, glyphWidth);
+        }
+        glyph->setAtlasPosition(glm::mediump_ivec2(shelfX, shelfY));
+        shelfX += glyphWidth + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, glyphHeight);
+        atlasDirty = true;
+    }
+
 public:
     Face(GraphicsInterface* graphicsWrapper, std::string path, int size, FT_Face face) : graphicsWrapper(graphicsWrapper), path(path), size(size),
                                                                                   face(face) {
         lineHeight = face->height;
         maxCharWidth = face->max_advance_width;
+        //16 glyphs per row for ascii is enough, but keep it at least 256 for small fonts
+        atlasWidth = 256;
+        while(atlasWidth < (uint32_t)size * 16 && atlasWidth < 4096) {
+            atlasWidth *= 2;
+        }
+        atlasHeight = atlasWidth / 4;
+        atlasPixels.resize(atlasWidth * atlasHeight, 0);
     }
 
     const Glyph *getGlyph(const char character) {
-        if (glyphs.count(character) == 0) {
-            glyphs[character] = new Glyph(graphicsWrapper, face, size, character);
+        auto glyphIt = glyphs.find(character);
+        if (glyphIt != glyphs.end()) {
+            return glyphIt->second;
+        }
+        Glyph* glyph = new Glyph(face, size, character);
+        addToAtlas(glyph, face->glyph->bitmap);
+        glyphs[character] = glyph;
+        return glyph;
+    }
+
+    /**
+     * Uploads the atlas if there are new glyphs, so it should be called after getGlyph calls of the frame.
+     */
+    uint32_t getAtlasTextureID() {
+        if(atlasTexture == nullptr) {
+            atlasTexture = std::make_unique<Texture>(graphicsWrapper, GraphicsInterface::TextureTypes::T2D,
+                                                     GraphicsInterface::InternalFormatTypes::RED, GraphicsInterface::FormatTypes::RED, GraphicsInterface::DataTypes::UNSIGNED_BYTE,
+                                                     atlasWidth, atlasHeight);
+            atlasTexture->setFilterMode(GraphicsInterface::FilterModes::LINEAR);
+            atlasDirty = true;
         }
-        return glyphs[character];
+        if(atlasDirty) {
+            atlasTexture->loadData(atlasPixels.data());
+            atlasDirty = false;
+        }
+        return atlasTexture->getTextureID();
+    }
+
+    uint32_t getAtlasGeneration() const {
+        return atlasGeneration;
+    }
+
+    /**
+     * Bitmap rows are top to bottom, so bottom left of the quad uses the larger v.
+     */
+    void getTextureCoordinates(const Glyph *glyph, glm::vec2 &bottomLeft, glm::vec2 &topRight) const {
+        bottomLeft = glm::vec2((float) glyph->getAtlasPosition().x / atlasWidth,
+                               (float) (glyph->getAtlasPosition().y + glyph->getSize().y) / atlasHeight);
+        topRight = glm::vec2((float) (glyph->getAtlasPosition().x + glyph->getSize().x) / atlasWidth,
+                             (float) glyph->getAtlasPosition().y / atlasHeight);
+    }
+
+    uint32_t getAtlasWidth() const {
+        return atlasWidth;
+    }
+
+    uint32_t getAtlasHeight() const {
+        return atlasHeight;
     }
 
     int getLineHeight() const {
@@ -9,3 +9,9 @@ void GUICursor::renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram
         GUIImageBase::renderWithProgram(renderProgram, lodLevel);
     }
 }
+
+void GUICursor::appendToBatch(GUISpriteBatch &batch) {
+    if(!this->hidden) {
+        GUIImageBase::appendToBatch(batch);
+    }
+}
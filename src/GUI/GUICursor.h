@@ -19,6 +19,8 @@ public:
 
     void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel) override;
 
+    void appendToBatch(GUISpriteBatch &batch) override;
+
     bool isHidden() {
         return hidden;
     }
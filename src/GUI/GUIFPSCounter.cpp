@@ -15,7 +15,7 @@ void GUIFPSCounter::updateFPS() {
 
     int normalizedFrameRate = (unsigned int) (1000.0f / (lastFrameTime / (float)PREVIOUS_FRAME_COUNT));
     if(currentTime - lastUpdateTime > 1000) {//1 update per second max
-        text = std::to_string(normalizedFrameRate);
+        updateText(std::to_string(normalizedFrameRate));
         lastUpdateTime = currentTime;
     }
 }
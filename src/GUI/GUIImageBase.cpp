@@ -5,6 +5,11 @@
 #include "GUIImageBase.h"
 #include "../Assets/AssetManager.h"
 #include "../Assets/TextureAsset.h"
+#include "GUISpriteBatch.h"
+
+static const UniformHandle<glm::mat4> ORTHOGONAL_PROJECTION_UNIFORM("orthogonalProjectionMatrix");
+static const UniformHandle<glm::mat4> WORLD_TRANSFORM_UNIFORM("worldTransformMatrix");
+static const UniformHandle<int> GUI_SAMPLER_UNIFORM("GUISampler");
 
 std::shared_ptr<GraphicsProgram> GUIImageBase::imageRenderProgram = nullptr;
 
@@ -21,19 +26,23 @@ GUIImageBase::~GUIImageBase() {
 
 void GUIImageBase::renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel[[gnu::unused]]) {
 
-    renderProgram->setUniform("orthogonalProjectionMatrix", graphicsWrapper->getGUIOrthogonalProjectionMatrix());
+    renderProgram->setUniform(ORTHOGONAL_PROJECTION_UNIFORM, graphicsWrapper->getGUIOrthogonalProjectionMatrix());
 
-    if (!renderProgram->setUniform("worldTransformMatrix", this->getTransformation()->getWorldTransform())) {//translate.z is alpha channel, we are sending it too!
+    if (!renderProgram->setUniform(WORLD_TRANSFORM_UNIFORM, this->getTransformation()->getWorldTransform())) {//translate.z is alpha channel, we are sending it too!
         std::cerr << "failed to set uniform \"worldTransformMatrix\"" << std::endl;
     }
 
-    if (!renderProgram->setUniform("GUISampler", imageAttachPoint)) {
+    if (!renderProgram->setUniform(GUI_SAMPLER_UNIFORM, imageAttachPoint)) {
         std::cerr << "failed to set uniform \"GUISampler\"" << std::endl;
     }
     graphicsWrapper->attachTexture(image->getID(), imageAttachPoint);
     graphicsWrapper->render(renderProgram->getID(), vao, ebo, (uint32_t) (faces.size() * 3));
 }
 
+void GUIImageBase::appendToBatch(GUISpriteBatch &batch) {
+    batch.add(image->getTexture(), this->getTransformation()->getWorldTransform());
+}
+
 void GUIImageBase::getAABB(glm::vec2 &aabbMin, glm::vec2 &aabbMax) const {
     Transformation temp = transformation;
     glm::vec4 upRight   = (temp.getWorldTransform() * glm::vec4( 1.0f,  1.0f, 0.0f, 1.0f));
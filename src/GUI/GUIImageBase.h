@@ -10,6 +10,7 @@
 
 class AssetManager;
 class TextureAsset;
+class GUISpriteBatch;
 
 class GUIImageBase : public GUIRenderable {
     int imageAttachPoint = 1;
@@ -25,6 +26,12 @@ public:
 
     virtual void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel) override;
 
+    /**
+     * Adds current image to the batch instead of rendering it. Elements that switch between images should make sure
+     * all of them are packed together, so switching doesn't change the texture the batch uses.
+     */
+    virtual void appendToBatch(GUISpriteBatch &batch);
+
     void getAABB(glm::vec2 &aabbMin, glm::vec2 &aabbMax) const override;
 
 
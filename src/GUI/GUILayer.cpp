@@ -4,6 +4,7 @@
 
 #include "GUILayer.h"
 #include "GUIRenderable.h"
+#include "GUITextBatch.h"
 #include "../GameObjects/GUIText.h"
 #include "../GameObjects/GUIImage.h"
 #include "../GameObjects/GUIButton.h"
@@ -12,10 +13,10 @@
 
 class Options;
 
-void GUILayer::renderImageWithProgram(std::shared_ptr<GraphicsProgram> renderProgram){
+void GUILayer::addImagesToBatch(GUISpriteBatch &batch){
     for (auto it = guiElements.begin(); it != guiElements.end(); ++it) {
         if(it->second == RenderTypes::IMAGE) {
-            it->first->renderWithProgram(renderProgram, 0);
+            static_cast<GUIImageBase*>(it->first)->appendToBatch(batch);
         }
     }
     if (isDebug) {
@@ -27,12 +28,25 @@ void GUILayer::renderImageWithProgram(std::shared_ptr<GraphicsProgram> renderPro
     }
 }
 
+GUILayer::~GUILayer() = default;
+
 void GUILayer::renderTextWithProgram(std::shared_ptr<GraphicsProgram> renderProgram){
+    for (auto batchIt = textBatches.begin(); batchIt != textBatches.end(); ++batchIt) {
+        batchIt->second->clear();
+    }
     for (auto it = guiElements.begin(); it != guiElements.end(); ++it) {
         if(it->second == RenderTypes::TEXT) {
-            it->first->renderWithProgram(renderProgram, 0);
+            GUITextBase* text = static_cast<GUIText*>(it->first);
+            std::unique_ptr<GUITextBatch>& batch = textBatches[text->getFace()];
+            if(batch == nullptr) {
+                batch = std::make_unique<GUITextBatch>(graphicsWrapper, text->getFace());
+            }
+            batch->add(text);
         }
     }
+    for (auto batchIt = textBatches.begin(); batchIt != textBatches.end(); ++batchIt) {
+        batchIt->second->render(renderProgram);
+    }
     if (isDebug) {
         for (auto it = guiElements.begin(); it != guiElements.end(); ++it) {
             if(it->second == RenderTypes::TEXT) {
@@ -6,11 +6,16 @@
 #define LIMONENGINE_GUILAYER_H
 
 #include <tinyxml2.h>
+#include <memory>
+#include <unordered_map>
 #include "API/Graphics/GraphicsInterface.h"
 
 class BulletDebugDrawer;
 class GUIRenderable;
 class GameObject;
+class GUITextBatch;
+class GUISpriteBatch;
+class Face;
 
 class GUILayer {
     GraphicsInterface* graphicsWrapper;
@@ -19,10 +24,13 @@ class GUILayer {
     bool isDebug;
     enum class RenderTypes {TEXT, IMAGE };
     std::vector<std::pair<GUIRenderable *, RenderTypes>> guiElements;
+    std::unordered_map<Face*, std::unique_ptr<GUITextBatch>> textBatches;//texts with same face are rendered with one draw
 
 public:
     GUILayer(GraphicsInterface* graphicsWrapper, BulletDebugDrawer* debugDrawer, uint32_t level) : graphicsWrapper(graphicsWrapper), debugDrawer(debugDrawer), level(level), isDebug(false) { };
 
+    ~GUILayer();
+
     uint32_t getLevel() { return level; }
 
     bool getDebug() const {
@@ -40,7 +48,10 @@ public:
     std::vector<GameObject*> getGuiElements();
 
     void renderTextWithProgram(std::shared_ptr<GraphicsProgram> renderProgram);
-    void renderImageWithProgram(std::shared_ptr<GraphicsProgram> renderProgram);
+    /**
+     * Images are not rendered by layer, they are added to a batch shared by all layers, in layer order.
+     */
+    void addImagesToBatch(GUISpriteBatch &batch);
 
     void setupForTime(long time);
 
@@ -0,0 +1,138 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "GUISpriteAtlas.h"
+#include "Graphics/Texture.h"
+
+const uint32_t GUISpriteAtlas::PAGE_SIZE;
+const uint32_t GUISpriteAtlas::MAX_PACKED_SIZE;
+const uint32_t GUISpriteAtlas::MAX_PAGE_COUNT;
+const uint32_t GUISpriteAtlas::PADDING;
+
+GUISpriteAtlas::~GUISpriteAtlas() = default;
+
+bool GUISpriteAtlas::createPage() {
+    if(pages.size() >= MAX_PAGE_COUNT) {
+        full = true;
+        return false;
+    }
+    std::unique_ptr<Texture> page = std::make_unique<Texture>(graphicsWrapper, GraphicsInterface::TextureTypes::T2D,
+                                                              GraphicsInterface::InternalFormatTypes::RGBA, GraphicsInterface::FormatTypes::RGBA,
+                                                              GraphicsInterface::DataTypes::UNSIGNED_BYTE, PAGE_SIZE, PAGE_SIZE);
+    //padding between images must be transparent, created texture content is undefined
+    std::vector<uint8_t> emptyPixels(PAGE_SIZE * PAGE_SIZE * 4, 0);
+    page->loadData(emptyPixels.data());
+    page->setFilterMode(GraphicsInterface::FilterModes::LINEAR);
+    pages.push_back(std::move(page));
+    shelfX = 0;
+    shelfY = 0;
+    shelfHeight = 0;
+    return true;
+}
+
+bool GUISpriteAtlas::findSpace(uint32_t width, uint32_t height, uint32_t &x, uint32_t &y) const {
+    if(pages.empty()) {
+        return false;
+    }
+    x = shelfX;
+    y = shelfY;
+    if(x + width > PAGE_SIZE) {
+        //start a new shelf
+        x = 0;
+        y = shelfY + shelfHeight;
+    }
+    return y + height <= PAGE_SIZE;
+}
+
+GUISpriteAtlas::Region GUISpriteAtlas::pack(const std::shared_ptr<Texture> &texture) {
+    Region region;
+    region.textureID = texture->getTextureID();
+    uint32_t width = texture->getWidth();
+    uint32_t height = texture->getHeight();
+    if(width > MAX_PACKED_SIZE || height > MAX_PACKED_SIZE || texture->getType() != GraphicsInterface::TextureTypes::T2D) {
+        return region;
+    }
+
+    uint32_t x, y;
+    if(!findSpace(width + PADDING, height + PADDING, x, y)) {
+        if(!createPage() || !findSpace(width + PADDING, height + PADDING, x, y)) {
+            return region;
+        }
+    }
+    Texture* page = pages.back().get();
+    if(!graphicsWrapper->copyTexture2DRegion(texture->getTextureID(), page->getTextureID(), x, y, width, height)) {
+        return region;
+    }
+    if(x == 0 && y != shelfY) {
+        shelfY = y;
+        shelfHeight = 0;
+    }
+    shelfX = x + width + PADDING;
+    shelfHeight = std::max(shelfHeight, height + PADDING);
+
+    //half texel inset, so linear filtering doesn't blend with the padding
+    region.textureID = page->getTextureID();
+    region.textureCoordinateMin = glm::vec2((x + 0.5f) / PAGE_SIZE, (y + 0.5f) / PAGE_SIZE);
+    region.textureCoordinateMax = glm::vec2((x + width - 0.5f) / PAGE_SIZE, (y + height - 0.5f) / PAGE_SIZE);
+    return region;
+}
+
+const GUISpriteAtlas::Region &GUISpriteAtlas::getRegion(const std::shared_ptr<Texture> &texture) {
+    auto packedIt = packedImages.find(texture.get());
+    if(packedIt != packedImages.end() && packedIt->second.texture.lock() == texture) {
+        return packedIt->second.region;
+    }
+    PackedImage& packedImage = packedImages[texture.get()];
+    packedImage.texture = texture;
+    packedImage.region = pack(texture);
+    return packedImage.region;
+}
+
+void GUISpriteAtlas::packTogether(const std::vector<std::shared_ptr<Texture>> &textures) {
+    //simulate shelf packing on the current page, and start a new one if the group doesn't fit
+    bool needsPacking = false;
+    bool fits = !pages.empty();
+    uint32_t x = shelfX, y = shelfY, currentShelfHeight = shelfHeight;
+    for (const auto &texture : textures) {
+        auto packedIt = packedImages.find(texture.get());
+        if(packedIt != packedImages.end() && packedIt->second.texture.lock() == texture) {
+            continue;
+        }
+        if(texture->getWidth() > MAX_PACKED_SIZE || texture->getHeight() > MAX_PACKED_SIZE) {
+            continue;
+        }
+        needsPacking = true;
+        uint32_t width = texture->getWidth() + PADDING;
+        uint32_t height = texture->getHeight() + PADDING;
+        if(x + width > PAGE_SIZE) {
+            x = 0;
+            y = y + currentShelfHeight;
+            currentShelfHeight = 0;
+        }
+        if(y + height > PAGE_SIZE) {
+            fits = false;
+        }
+        x = x + width;
+        currentShelfHeight = std::max(currentShelfHeight, height);
+    }
+    if(!needsPacking) {
+        return;
+    }
+    if(!fits) {
+        createPage();
+    }
+    for (const auto &texture : textures) {
+        getRegion(texture);
+    }
+}
+
+void GUISpriteAtlas::repackIfFull() {
+    if(!full) {
+        return;
+    }
+    std::cout << "GUI sprite atlas is full, repacking." << std::endl;
+    packedImages.clear();
+    pages.clear();
+    full = false;
+}
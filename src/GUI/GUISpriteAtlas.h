@@ -0,0 +1,79 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_GUISPRITEATLAS_H
+#define LIMONENGINE_GUISPRITEATLAS_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "API/Graphics/GraphicsInterface.h"
+
+class Texture;
+
+/**
+ * Packs GUI images into a few big RGBA pages, so images sharing a page can be drawn together.
+ * Texture assets don't keep their pixels on CPU, so images are copied on GPU. If the backend can't copy an image,
+ * or it is too big to share a page, the image is used as its own page, with full texture coordinates.
+ */
+class GUISpriteAtlas {
+public:
+    struct Region {
+        uint32_t textureID = 0;
+        glm::vec2 textureCoordinateMin = glm::vec2(0.0f, 0.0f);
+        glm::vec2 textureCoordinateMax = glm::vec2(1.0f, 1.0f);
+    };
+
+private:
+    static const uint32_t PAGE_SIZE = 2048;
+    static const uint32_t MAX_PACKED_SIZE = 512;
+    static const uint32_t MAX_PAGE_COUNT = 4;
+    static const uint32_t PADDING = 2;
+
+    struct PackedImage {
+        std::weak_ptr<Texture> texture;//to detect a freed texture, whose address is reused
+        Region region;
+    };
+
+    GraphicsInterface* graphicsWrapper;
+    std::vector<std::unique_ptr<Texture>> pages;
+    std::unordered_map<const Texture*, PackedImage> packedImages;
+
+    //shelf packing state of the last page
+    uint32_t shelfX = 0, shelfY = 0, shelfHeight = 0;
+    bool full = false;
+
+    bool createPage();
+    bool findSpace(uint32_t width, uint32_t height, uint32_t &x, uint32_t &y) const;
+    Region pack(const std::shared_ptr<Texture> &texture);
+
+public:
+    explicit GUISpriteAtlas(GraphicsInterface* graphicsWrapper) : graphicsWrapper(graphicsWrapper) {}
+
+    ~GUISpriteAtlas();
+
+    /**
+     * Packs the texture on first request. Texture coordinates are in the same orientation as the source texture.
+     */
+    const Region& getRegion(const std::shared_ptr<Texture> &texture);
+
+    /**
+     * Packs all given textures now, starting a new page if they don't fit the current one, so frames of an
+     * animation or states of a button end up on the same page.
+     */
+    void packTogether(const std::vector<std::shared_ptr<Texture>> &textures);
+
+    /**
+     * If pages run out, images are drawn from their own textures until this is called. It drops all pages, so it
+     * should only be called when no region is in use, like the start of a frame.
+     */
+    void repackIfFull();
+
+    uint32_t getPageCount() const {
+        return (uint32_t) pages.size();
+    }
+};
+
+
+#endif //LIMONENGINE_GUISPRITEATLAS_H
@@ -0,0 +1,89 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "GUISpriteBatch.h"
+#include "API/Graphics/GraphicsProgram.h"
+#include "Graphics/Texture.h"
+
+static const UniformHandle<glm::mat4> ORTHOGONAL_PROJECTION_UNIFORM("orthogonalProjectionMatrix");
+static const UniformHandle<glm::mat4> WORLD_TRANSFORM_UNIFORM("worldTransformMatrix");
+static const UniformHandle<int> GUI_SAMPLER_UNIFORM("GUISampler");
+
+GUISpriteBatch::~GUISpriteBatch() {
+    if(vao != 0) {
+        graphicsWrapper->freeBuffer(vertexVBO);
+        graphicsWrapper->freeBuffer(textureCoordinateVBO);
+        graphicsWrapper->freeBuffer(colorVBO);
+        graphicsWrapper->freeBuffer(ebo);
+        graphicsWrapper->freeVAO(vao);
+    }
+}
+
+void GUISpriteBatch::clear() {
+    vertices.clear();
+    textureCoordinates.clear();
+    colors.clear();
+    faces.clear();
+    drawRanges.clear();
+    //nothing references atlas pages between frames, so this is the safe point
+    atlas.repackIfFull();
+}
+
+void GUISpriteBatch::add(const std::shared_ptr<Texture> &texture, const glm::mat4 &worldTransform) {
+    const GUISpriteAtlas::Region& region = atlas.getRegion(texture);
+
+    uint32_t firstVertex = (uint32_t) vertices.size();
+    vertices.push_back(glm::vec3(worldTransform * glm::vec4(-1.0f, -1.0f, 0.0f, 1.0f)));
+    vertices.push_back(glm::vec3(worldTransform * glm::vec4( 1.0f, -1.0f, 0.0f, 1.0f)));
+    vertices.push_back(glm::vec3(worldTransform * glm::vec4( 1.0f,  1.0f, 0.0f, 1.0f)));
+    vertices.push_back(glm::vec3(worldTransform * glm::vec4(-1.0f,  1.0f, 0.0f, 1.0f)));
+
+    //same orientation as GUIRenderable quad, bottom of the quad samples the end of the texture
+    textureCoordinates.push_back(glm::vec2(region.textureCoordinateMin.x, region.textureCoordinateMax.y));
+    textureCoordinates.push_back(glm::vec2(region.textureCoordinateMax.x, region.textureCoordinateMax.y));
+    textureCoordinates.push_back(glm::vec2(region.textureCoordinateMax.x, region.textureCoordinateMin.y));
+    textureCoordinates.push_back(glm::vec2(region.textureCoordinateMin.x, region.textureCoordinateMin.y));
+
+    glm::vec4 color(1.0f, 1.0f, 1.0f, 1.0f - worldTransform[3][2]);//translate.z is alpha
+    colors.insert(colors.end(), 4, color);
+
+    faces.push_back(glm::mediump_uvec3(firstVertex, firstVertex + 1, firstVertex + 2));
+    faces.push_back(glm::mediump_uvec3(firstVertex, firstVertex + 2, firstVertex + 3));
+
+    if(drawRanges.empty() || drawRanges.back().textureID != region.textureID) {
+        drawRanges.push_back(DrawRange{region.textureID, 0});
+    }
+    drawRanges.back().quadCount++;
+}
+
+void GUISpriteBatch::upload() {
+    if(vao == 0) {
+        graphicsWrapper->bufferVertexData(vertices, faces, vao, vertexVBO, 2, ebo);
+        graphicsWrapper->bufferVertexTextureCoordinates(textureCoordinates, vao, textureCoordinateVBO, 3);
+        graphicsWrapper->bufferExtraVertexData(colors, vao, colorVBO, 4);
+    } else {
+        graphicsWrapper->updateVertexData(vertices, faces, vertexVBO, ebo);
+        graphicsWrapper->updateVertexTextureCoordinates(textureCoordinates, textureCoordinateVBO);
+        graphicsWrapper->updateExtraVertexData(colors, colorVBO);
+    }
+}
+
+void GUISpriteBatch::render(const std::shared_ptr<GraphicsProgram> &renderProgram) {
+    if(faces.empty()) {
+        return;
+    }
+    upload();
+
+    renderProgram->setUniform(ORTHOGONAL_PROJECTION_UNIFORM, graphicsWrapper->getGUIOrthogonalProjectionMatrix());
+    //images are already transformed, and alpha is in vertex color
+    renderProgram->setUniform(WORLD_TRANSFORM_UNIFORM, glm::mat4(1.0f));
+    renderProgram->setUniform(GUI_SAMPLER_UNIFORM, imageAttachPoint);
+    uint32_t firstIndex = 0;
+    for (const DrawRange &drawRange : drawRanges) {
+        graphicsWrapper->attachTexture(drawRange.textureID, imageAttachPoint);
+        graphicsWrapper->render(renderProgram->getID(), vao, ebo, drawRange.quadCount * 6,
+                                (const uint32_t *) (firstIndex * sizeof(uint32_t)));
+        firstIndex += drawRange.quadCount * 6;
+    }
+}
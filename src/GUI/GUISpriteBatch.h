@@ -0,0 +1,67 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_GUISPRITEBATCH_H
+#define LIMONENGINE_GUISPRITEBATCH_H
+
+#include <vector>
+#include <memory>
+#include "API/Graphics/GraphicsInterface.h"
+#include "GUISpriteAtlas.h"
+
+class GraphicsProgram;
+class Texture;
+
+/**
+ * Collects all GUI images of a frame into one dynamic buffer. Images are transformed on CPU, and consecutive images
+ * on the same atlas page are drawn with one call. Insertion order is kept, so overlapping images are drawn the same
+ * as rendering them one by one.
+ */
+class GUISpriteBatch {
+    struct DrawRange {
+        uint32_t textureID;
+        uint32_t quadCount;
+    };
+
+    GraphicsInterface* graphicsWrapper;
+    GUISpriteAtlas atlas;
+    int imageAttachPoint = 1;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec2> textureCoordinates;
+    std::vector<glm::vec4> colors;
+    std::vector<glm::mediump_uvec3> faces;
+    std::vector<DrawRange> drawRanges;
+
+    uint32_t vao = 0, ebo = 0;
+    uint32_t vertexVBO = 0, textureCoordinateVBO = 0, colorVBO = 0;
+
+    void upload();
+
+public:
+    explicit GUISpriteBatch(GraphicsInterface* graphicsWrapper) : graphicsWrapper(graphicsWrapper), atlas(graphicsWrapper) {}
+
+    ~GUISpriteBatch();
+
+    void clear();
+
+    /**
+     * Adds the unit quad of GUI renderables (-1 to 1), transformed with worldTransform. Translate z is alpha, as in
+     * single image rendering.
+     */
+    void add(const std::shared_ptr<Texture> &texture, const glm::mat4 &worldTransform);
+
+    GUISpriteAtlas& getAtlas() {
+        return atlas;
+    }
+
+    uint32_t getDrawCallCount() const {
+        return (uint32_t) drawRanges.size();
+    }
+
+    void render(const std::shared_ptr<GraphicsProgram> &renderProgram);
+};
+
+
+#endif //LIMONENGINE_GUISPRITEBATCH_H
@@ -4,6 +4,10 @@
 
 #include "GUITextBase.h"
 
+static const UniformHandle<glm::mat4> ORTHOGONAL_PROJECTION_UNIFORM("orthogonalProjectionMatrix");
+static const UniformHandle<glm::mat4> WORLD_TRANSFORM_UNIFORM("worldTransformMatrix");
+static const UniformHandle<int> GUI_SAMPLER_UNIFORM("GUISampler");
+
 
 std::shared_ptr<GraphicsProgram> GUITextBase::textRenderProgram = nullptr;
 
@@ -44,71 +48,130 @@ GUITextBase::GUITextBase(GraphicsInterface* graphicsWrapper, Face *face, const s
     calculateSizes();
 }
 
-void GUITextBase::renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel[[gnu::unused]]) {
-
-    float totalAdvance = 0.0f;
-
-    renderProgram->setUniform("inColor", color);
-
-    renderProgram->setUniform("orthogonalProjectionMatrix", graphicsWrapper->getGUIOrthogonalProjectionMatrix());
-
-    glm::mat4 currentTransform;
+GUITextBase::~GUITextBase() {
+    //delete renderProgram;// since the program is shared, don't remove
+    if(textVAO != 0) {
+        graphicsWrapper->freeBuffer(textVertexVBO);
+        graphicsWrapper->freeBuffer(textTextureCoordinateVBO);
+        graphicsWrapper->freeBuffer(textColorVBO);
+        graphicsWrapper->freeBuffer(textEBO);
+        graphicsWrapper->freeVAO(textVAO);
+    }
+}
 
-    this->transformation.getWorldTransform();//this is called incase part of animation, if not it returns value from cache, so no performance hit.
+void GUITextBase::addGlyphQuad(const Glyph *glyph, float left, float baseline) {
+    if(glyph->getSize().x == 0 || glyph->getSize().y == 0) {
+        return;
+    }
+    left += glyph->getBearing().x;
+    float top = baseline + glyph->getBearing().y;
+    float right = left + glyph->getSize().x;
+    float bottom = top - glyph->getSize().y;
+
+    glm::vec2 bottomLeftUV, topRightUV;
+    face->getTextureCoordinates(glyph, bottomLeftUV, topRightUV);
+
+    uint32_t firstVertex = (uint32_t) textVertices.size();
+    //same order with GUIRenderable quad
+    textVertices.emplace_back(left, bottom, 0.0f);
+    textVertices.emplace_back(right, bottom, 0.0f);
+    textVertices.emplace_back(right, top, 0.0f);
+    textVertices.emplace_back(left, top, 0.0f);
+
+    textTextureCoordinates.emplace_back(bottomLeftUV.x, bottomLeftUV.y);
+    textTextureCoordinates.emplace_back(topRightUV.x, bottomLeftUV.y);
+    textTextureCoordinates.emplace_back(topRightUV.x, topRightUV.y);
+    textTextureCoordinates.emplace_back(bottomLeftUV.x, topRightUV.y);
+
+    textFaces.emplace_back(firstVertex, firstVertex + 1, firstVertex + 2);
+    textFaces.emplace_back(firstVertex, firstVertex + 2, firstVertex + 3);
+}
 
-    //Setup position
-    float quadPositionX, quadPositionY, quadSizeX, quadSizeY;
-    const Glyph *glyph;
+void GUITextBase::buildGeometry() {
+    //origin is the center of the text, baseline is at the bottom
+    float totalAdvance = -width / 2.0f;
+    float baseline = -height / 2.0f;
     for (unsigned int i = 0; i < text.length(); ++i) {
-        glyph = face->getGlyph(text.at(i));
-        quadSizeX = glyph->getSize().x / 2.0f;
-        quadSizeY = glyph->getSize().y / 2.0f;
-
-        quadPositionX = totalAdvance + glyph->getBearing().x + quadSizeX; //origin is left side
-        quadPositionY = glyph->getBearing().y - quadSizeY; // origin is the bottom line
+        const Glyph *glyph = face->getGlyph(text.at(i));
+        addGlyphQuad(glyph, totalAdvance, baseline);
+        totalAdvance += glyph->getAdvance() / 64.0f;
+    }
+}
 
+bool GUITextBase::updateGeometry() {
+    if(geometryDirty || builtAtlasGeneration != face->getAtlasGeneration()) {
+        //new glyphs might grow the atlas while building, then the earlier texture coordinates are wrong, so build again
+        do {
+            builtAtlasGeneration = face->getAtlasGeneration();
+            textVertices.clear();
+            textTextureCoordinates.clear();
+            textFaces.clear();
+            buildGeometry();
+        } while(builtAtlasGeneration != face->getAtlasGeneration());
+        geometryDirty = false;
+        buffersDirty = true;
+    }
+    return !textVertices.empty();
+}
 
-        /**
-         * the scale, translate and rotate functions apply the transition to first element, so the below code is
-         * scale to quadSizeX/Y * this->scale first,
-         * than translate to quadPositionX/Y - width/height* scale/2,
-         * than rotate using orientation,
-         * than translate to this->translate
-         *
-         * The double translate is because we want to rotate from center of the text.
-         */
-        if (transformation.isRotated()) {
-            currentTransform = glm::scale(
-                    glm::translate(
-                            (glm::translate(glm::mat4(1.0f), transformation.getTranslate()) * glm::mat4_cast(transformation.getOrientation())),
-                            glm::vec3(quadPositionX, quadPositionY, 0) -
-                            glm::vec3(width * transformation.getScale().x / 2.0f, height * transformation.getScale().y / 2.0f, 0.0f)),
-                    this->transformation.getScale() * glm::vec3(quadSizeX, quadSizeY, 1.0f)
-            );
-        } else {
-            //this branch removes quaternion cast, so double translate is not necessary.
-            currentTransform = glm::scale(
-                    glm::translate(glm::mat4(1.0f), transformation.getTranslate() +
-                                                    glm::vec3(quadPositionX, quadPositionY, 0) -
-                                                    glm::vec3(width * transformation.getScale().x / 2.0f, height * transformation.getScale().y / 2.0f,
-                                                              0.0f)),
-                    this->transformation.getScale() * glm::vec3(quadSizeX, quadSizeY, 1.0f)
-            );
-        }
-        currentTransform[3][2] = this->getTransformation()->getTranslate().z;//alpha is set on translate z, since it is not used
-        if (!renderProgram->setUniform("worldTransformMatrix", currentTransform)) {
-            std::cerr << "failed to set uniform \"worldTransformMatrix\"" << std::endl;
+void GUITextBase::uploadGeometry() {
+    if(!buffersDirty && color == builtColor) {
+        return;
+    }
+    std::vector<glm::vec4> colors(textVertices.size(), glm::vec4(color, 1.0f));
+    if(textVAO == 0) {
+        graphicsWrapper->bufferVertexData(textVertices, textFaces, textVAO, textVertexVBO, 2, textEBO);
+        graphicsWrapper->bufferVertexTextureCoordinates(textTextureCoordinates, textVAO, textTextureCoordinateVBO, 3);
+        graphicsWrapper->bufferExtraVertexData(colors, textVAO, textColorVBO, 4);
+    } else {
+        if(buffersDirty) {
+            graphicsWrapper->updateVertexData(textVertices, textFaces, textVertexVBO, textEBO);
+            graphicsWrapper->updateVertexTextureCoordinates(textTextureCoordinates, textTextureCoordinateVBO);
         }
+        graphicsWrapper->updateExtraVertexData(colors, textColorVBO);
+    }
+    builtColor = color;
+    buffersDirty = false;
+}
 
-        if (!renderProgram->setUniform("GUISampler", glyphAttachPoint)) {
-            std::cerr << "failed to set uniform \"GUISampler\"" << std::endl;
-        }
-        graphicsWrapper->attachTexture(glyph->getTextureID(), glyphAttachPoint);
-        graphicsWrapper->render(renderProgram->getID(), vao, ebo, (uint32_t) (faces.size() * 3));
+void GUITextBase::renderGeometry(std::shared_ptr<GraphicsProgram> renderProgram) {
+    if(!updateGeometry()) {
+        return;
+    }
+    uint32_t atlasTextureID = face->getAtlasTextureID();//after the update, so new glyphs are uploaded
+    uploadGeometry();
 
-        totalAdvance += (glyph->getAdvance() / 64.0f) * this->getScale().x;
+    renderProgram->setUniform(ORTHOGONAL_PROJECTION_UNIFORM, graphicsWrapper->getGUIOrthogonalProjectionMatrix());
+    //alpha is set on translate z, since it is not used
+    if (!renderProgram->setUniform(WORLD_TRANSFORM_UNIFORM, transformation.getWorldTransform())) {
+        std::cerr << "failed to set uniform \"worldTransformMatrix\"" << std::endl;
+    }
+    if (!renderProgram->setUniform(GUI_SAMPLER_UNIFORM, glyphAttachPoint)) {
+        std::cerr << "failed to set uniform \"GUISampler\"" << std::endl;
     }
+    graphicsWrapper->attachTexture(atlasTextureID, glyphAttachPoint);
+    graphicsWrapper->render(renderProgram->getID(), textVAO, textEBO, (uint32_t) (textFaces.size() * 3));
+}
 
+void GUITextBase::renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel[[gnu::unused]]) {
+    renderGeometry(renderProgram);
+}
+
+void GUITextBase::appendToBatch(std::vector<glm::vec3> &vertices, std::vector<glm::vec2> &textureCoordinates,
+                                std::vector<glm::vec4> &colors, std::vector<glm::mediump_uvec3> &batchFaces) {
+    if(!updateGeometry()) {
+        return;
+    }
+    const glm::mat4 &worldTransform = transformation.getWorldTransform();
+    uint32_t firstVertex = (uint32_t) vertices.size();
+    for (const glm::vec3 &vertex : textVertices) {
+        vertices.emplace_back(worldTransform * glm::vec4(vertex, 1.0f));
+    }
+    textureCoordinates.insert(textureCoordinates.end(), textTextureCoordinates.begin(), textTextureCoordinates.end());
+    colors.insert(colors.end(), textVertices.size(), glm::vec4(color, 1.0f - worldTransform[3][2]));
+    for (const glm::mediump_uvec3 &textFace : textFaces) {
+        batchFaces.push_back(textFace + glm::mediump_uvec3(firstVertex));
+    }
 }
 
 void GUITextBase::renderDebug(BulletDebugDrawer *debugDrawer) {
@@ -16,6 +16,14 @@
 class GUITextBase : public GUIRenderable {
     void calculateSizes();
 
+    uint32_t textVAO = 0, textEBO = 0;
+    uint32_t textVertexVBO = 0, textTextureCoordinateVBO = 0, textColorVBO = 0;
+    uint32_t builtAtlasGeneration = 0;
+    glm::vec3 builtColor = glm::vec3(-1.0f);
+    bool buffersDirty = true;
+
+    void uploadGeometry();
+
 protected:
     std::string text;
     glm::vec3 color;
@@ -24,6 +32,15 @@ protected:
     int height, width;
     int bearingUp;
 
+    /**
+     * Glyph quads of the text in local space, rebuilt only when the text or atlas changes. Both the text itself and
+     * GUILayer batches use these.
+     */
+    std::vector<glm::vec3> textVertices;
+    std::vector<glm::vec2> textTextureCoordinates;
+    std::vector<glm::mediump_uvec3> textFaces;
+    bool geometryDirty = true;
+
     static std::shared_ptr<GraphicsProgram> textRenderProgram;
 
     //Don't allow constructing of this object itself
@@ -31,10 +48,28 @@ protected:
     GUITextBase(GraphicsInterface* graphicsWrapper, Face *font, const glm::vec3 color) : GUITextBase(graphicsWrapper, font, "",
                                                                                               color) {};
 
+    /**
+     * Adds quad of the glyph, left is the pen position, baseline is y of the line.
+     */
+    void addGlyphQuad(const Glyph *glyph, float left, float baseline);
+
+    /**
+     * Fills textVertices, textTextureCoordinates and textFaces.
+     */
+    virtual void buildGeometry();
+
+    /**
+     * Rebuilds the geometry if it is dirty, returns false if there is nothing to render.
+     */
+    bool updateGeometry();
+
+    /**
+     * Renders textVertices with world transform, using one draw call.
+     */
+    void renderGeometry(std::shared_ptr<GraphicsProgram> renderProgram);
+
 public:
-    virtual ~GUITextBase(){
-        //delete renderProgram;// since the program is shared, don't remove
-    };
+    virtual ~GUITextBase();
 
 
     virtual void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel) override;
@@ -42,10 +77,24 @@ public:
     virtual void renderDebug(BulletDebugDrawer *debugDrawer);
 
     void updateText(const std::string& text) {
+        if(this->text == text) {
+            return;
+        }
         this->text = text;
         calculateSizes();
+        geometryDirty = true;
     }
 
+    Face *getFace() const {
+        return face;
+    }
+
+    /**
+     * Appends the text to a batch, transformed to GUI space. Alpha is written to color, since batches don't have a world transform.
+     */
+    void appendToBatch(std::vector<glm::vec3> &vertices, std::vector<glm::vec2> &textureCoordinates,
+                       std::vector<glm::vec4> &colors, std::vector<glm::mediump_uvec3> &batchFaces);
+
     void getAABB(glm::vec2 &aabbMin, glm::vec2 &aabbMax) const override;
 
 };
@@ -0,0 +1,61 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "GUITextBatch.h"
+#include "GUITextBase.h"
+
+static const UniformHandle<glm::mat4> ORTHOGONAL_PROJECTION_UNIFORM("orthogonalProjectionMatrix");
+static const UniformHandle<glm::mat4> WORLD_TRANSFORM_UNIFORM("worldTransformMatrix");
+static const UniformHandle<int> GUI_SAMPLER_UNIFORM("GUISampler");
+
+GUITextBatch::~GUITextBatch() {
+    if(vao != 0) {
+        graphicsWrapper->freeBuffer(vertexVBO);
+        graphicsWrapper->freeBuffer(textureCoordinateVBO);
+        graphicsWrapper->freeBuffer(colorVBO);
+        graphicsWrapper->freeBuffer(ebo);
+        graphicsWrapper->freeVAO(vao);
+    }
+}
+
+void GUITextBatch::add(GUITextBase *text) {
+    text->appendToBatch(vertices, textureCoordinates, colors, faces);
+}
+
+void GUITextBatch::upload() {
+    if(vao == 0) {
+        graphicsWrapper->bufferVertexData(vertices, faces, vao, vertexVBO, 2, ebo);
+        graphicsWrapper->bufferVertexTextureCoordinates(textureCoordinates, vao, textureCoordinateVBO, 3);
+        graphicsWrapper->bufferExtraVertexData(colors, vao, colorVBO, 4);
+    } else {
+        if(vertices != uploadedVertices) {
+            //faces only depend on quad count, so they change only with vertices
+            graphicsWrapper->updateVertexData(vertices, faces, vertexVBO, ebo);
+        }
+        if(textureCoordinates != uploadedTextureCoordinates) {
+            graphicsWrapper->updateVertexTextureCoordinates(textureCoordinates, textureCoordinateVBO);
+        }
+        if(colors != uploadedColors) {
+            graphicsWrapper->updateExtraVertexData(colors, colorVBO);
+        }
+    }
+    uploadedVertices = vertices;
+    uploadedTextureCoordinates = textureCoordinates;
+    uploadedColors = colors;
+}
+
+void GUITextBatch::render(const std::shared_ptr<GraphicsProgram> &renderProgram) {
+    if(faces.empty()) {
+        return;
+    }
+    uint32_t atlasTextureID = face->getAtlasTextureID();
+    upload();
+
+    renderProgram->setUniform(ORTHOGONAL_PROJECTION_UNIFORM, graphicsWrapper->getGUIOrthogonalProjectionMatrix());
+    //texts are already transformed, and alpha is in vertex color
+    renderProgram->setUniform(WORLD_TRANSFORM_UNIFORM, glm::mat4(1.0f));
+    renderProgram->setUniform(GUI_SAMPLER_UNIFORM, glyphAttachPoint);
+    graphicsWrapper->attachTexture(atlasTextureID, glyphAttachPoint);
+    graphicsWrapper->render(renderProgram->getID(), vao, ebo, (uint32_t) (faces.size() * 3));
+}
@@ -0,0 +1,58 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_GUITEXTBATCH_H
+#define LIMONENGINE_GUITEXTBATCH_H
+
+#include <vector>
+#include <memory>
+#include "API/Graphics/GraphicsInterface.h"
+
+class GUITextBase;
+class GraphicsProgram;
+class Face;
+
+/**
+ * All texts of a GUILayer that use the same face, rendered with a single draw call.
+ * Texts are transformed on CPU, buffers are only uploaded if the result is different from last frame.
+ */
+class GUITextBatch {
+    GraphicsInterface* graphicsWrapper;
+    Face* face;
+    int glyphAttachPoint = 1;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec2> textureCoordinates;
+    std::vector<glm::vec4> colors;
+    std::vector<glm::mediump_uvec3> faces;
+
+    //last uploaded, to skip uploads when nothing changes
+    std::vector<glm::vec3> uploadedVertices;
+    std::vector<glm::vec2> uploadedTextureCoordinates;
+    std::vector<glm::vec4> uploadedColors;
+
+    uint32_t vao = 0, ebo = 0;
+    uint32_t vertexVBO = 0, textureCoordinateVBO = 0, colorVBO = 0;
+
+    void upload();
+
+public:
+    GUITextBatch(GraphicsInterface* graphicsWrapper, Face* face) : graphicsWrapper(graphicsWrapper), face(face) {}
+
+    ~GUITextBatch();
+
+    void clear() {
+        vertices.clear();
+        textureCoordinates.clear();
+        colors.clear();
+        faces.clear();
+    }
+
+    void add(GUITextBase* text);
+
+    void render(const std::shared_ptr<GraphicsProgram> &renderProgram);
+};
+
+
+#endif //LIMONENGINE_GUITEXTBATCH_H
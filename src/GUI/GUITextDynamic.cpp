@@ -5,7 +5,6 @@
 #include <SDL_timer.h>
 #include "GUITextDynamic.h"
 
-
 void GUITextDynamic::renderWithProgram(std::shared_ptr<GraphicsProgram> program, uint32_t lodLevel[[gnu::unused]]) {
     //first move all logs to our list
     Logger::LogLine* logLine = source->getLog();
@@ -13,104 +12,57 @@ void GUITextDynamic::renderWithProgram(std::shared_ptr<GraphicsProgram> program,
         this->textList.push_back(TextLine(logLine,logLineCount++));
         delete logLine;
         logLine = source->getLog();
+        geometryDirty = true;
     }
-    float totalAdvance = 0.0f;
-
-    program->setUniform("inColor", color);
-
-    program->setUniform("orthogonalProjectionMatrix", graphicsWrapper->getGUIOrthogonalProjectionMatrix());
-
-    glm::mat4 currentTransform;
-
-    //Setup position
-    float quadPositionX, quadPositionY, quadSizeX, quadSizeY;
-    const Glyph *glyph;
     if(textList.empty()) {
         return;
     }
-    int lineCount=1;//the line 0 would be out of the box
 
     int MaxLineCount = (height)/(lineHeight);
     int removeLineCount = textList.size() + totalExtraLines - MaxLineCount;
     if(removeLineCount > 0) {
         std::list<TextLine>::iterator it = textList.begin();
-        std::advance(it,removeLineCount);
+        std::advance(it, std::min((size_t)removeLineCount, textList.size()));
         for(std::list<TextLine>::iterator lineIt = textList.begin(); lineIt != it; lineIt++) {
             totalExtraLines = totalExtraLines - lineIt->extraLines;
         }
         textList.erase(textList.begin(),it);
+        geometryDirty = true;
     }
 
-    for(std::list<TextLine>::iterator lineIt = textList.begin(); lineIt != textList.end(); lineIt++, lineCount++) {
-        if(renderSetupTime - lineIt->time > duration) {//this is done here, because this way we don't iterate the list twice
-            std::list<TextLine>::iterator test = lineIt;
-            lineIt++;
-            totalExtraLines = totalExtraLines - test->extraLines;
-            textList.erase(test);
+    for(std::list<TextLine>::iterator lineIt = textList.begin(); lineIt != textList.end();) {
+        if(renderSetupTime - lineIt->time > duration) {
+            totalExtraLines = totalExtraLines - lineIt->extraLines;
+            lineIt = textList.erase(lineIt);
+            geometryDirty = true;
         } else {
-            for (unsigned int character = 0; character < lineIt->text.length(); ++character) {
-                glm::vec3 lineTranslate = transformation.getTranslate() + glm::vec3(0, height - (lineCount * lineHeight), 0);
-
-                glyph = face->getGlyph(lineIt->text.at(character));
-                quadSizeX = glyph->getSize().x / 2.0f;
-                quadSizeY = glyph->getSize().y / 2.0f;
-
-                quadPositionX = totalAdvance + glyph->getBearing().x + quadSizeX; //origin is left side
-                quadPositionY = glyph->getBearing().y - quadSizeY; // origin is the bottom line
-
-
-                /**
-                 * the scale, translate and rotate functions apply the transition to first element, so the below code is
-                 * scale to quadSizeX/Y * this->scale first,
-                 * than translate to quadPositionX/Y - width/height* scale/2,
-                 * than rotate using orientation,
-                 * than translate to this->translate
-                 *
-                 * The double translate is because we want to rotate from center of the text.
-                 */
-                if (transformation.isRotated()) {
-                    currentTransform = glm::scale(
-                            glm::translate(
-                                    (glm::translate(glm::mat4(1.0f), lineTranslate) * glm::mat4_cast(transformation.getOrientation())),
-                                    glm::vec3(quadPositionX, quadPositionY, 0) -
-                                    glm::vec3(width * transformation.getScale().x / 2.0f, height * transformation.getScale().y / 2.0f, 0.0f)),
-                            this->transformation.getScale() * glm::vec3(quadSizeX, quadSizeY, 1.0f)
-                    );
-                } else {
-                    //this branch removes quaternion cast, so double translate is not necessary.
-                    currentTransform = glm::scale(
-                            glm::translate(glm::mat4(1.0f), lineTranslate +
-                                                            glm::vec3(quadPositionX, quadPositionY, 0) -
-                                                            glm::vec3(width * transformation.getScale().x / 2.0f, height * transformation.getScale().y / 2.0f,
-                                                                      0.0f)),
-                            this->transformation.getScale() * glm::vec3(quadSizeX, quadSizeY, 1.0f)
-                    );
-                }
-
-                if (!program->setUniform("worldTransformMatrix", currentTransform)) {
-                    std::cerr << "failed to set uniform \"worldTransformMatrix\"" << std::endl;
-                }
+            lineIt++;
+        }
+    }
 
-                if (!program->setUniform("GUISampler", glyphAttachPoint)) {
-                    std::cerr << "failed to set uniform \"GUISampler\"" << std::endl;
-                }
-                graphicsWrapper->attachTexture(glyph->getTextureID(), glyphAttachPoint);
-                graphicsWrapper->render(program->getID(), vao, ebo, (uint32_t) (faces.size() * 3));
+    //geometry is only rebuilt if a line is added or removed
+    renderGeometry(program);
+}
 
-                totalAdvance += glyph->getAdvance() / 64;
-                if(totalAdvance + maxCharWidth >= width) {
-                    lineCount++;
-                    totalAdvance = 0;
-                    if(!lineIt->renderedBefore) {
-                        lineIt->extraLines++;
-                        totalExtraLines++;
-                    }
-                }
+void GUITextDynamic::buildGeometry() {
+    //positions are relative to center, same as GUITextBase
+    int lineCount=1;//the line 0 would be out of the box
+    float totalAdvance = 0.0f;
+    totalExtraLines = 0;
+    for(std::list<TextLine>::iterator lineIt = textList.begin(); lineIt != textList.end(); lineIt++, lineCount++) {
+        lineIt->extraLines = 0;
+        for (unsigned int character = 0; character < lineIt->text.length(); ++character) {
+            const Glyph *glyph = face->getGlyph(lineIt->text.at(character));
+            addGlyphQuad(glyph, totalAdvance - width / 2.0f, height / 2.0f - lineCount * lineHeight);
+
+            totalAdvance += glyph->getAdvance() / 64;
+            if(totalAdvance + maxCharWidth >= width) {
+                lineCount++;
+                totalAdvance = 0;
+                lineIt->extraLines++;
+                totalExtraLines++;
             }
-            lineIt->renderedBefore = true;
-            totalAdvance = 0;
         }
-
+        totalAdvance = 0;
     }
-
-}
\ No newline at end of file
+}
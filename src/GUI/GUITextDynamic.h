@@ -15,7 +15,6 @@ struct TextLine {
     std::string text;
     long time;
     int extraLines = 0;
-    bool renderedBefore = false;
 
     TextLine(Logger::LogLine *logLine, long logLineCount) : time(logLine->time) {
         this->text = std::to_string(logLineCount)+ ": " + std::to_string(logLine->level) + ": " + logLine->text;
@@ -61,6 +60,9 @@ public:
 
     void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel) override;
 
+protected:
+    void buildGeometry() override;
+
 };
 
 
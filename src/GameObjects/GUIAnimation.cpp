@@ -8,6 +8,7 @@
 #include "../../libs/ImGuizmo/ImGuizmo.h"
 #include "../Assets/AssetManager.h"
 #include "../Assets/TextureAsset.h"
+#include "../GUI/GUISpriteBatch.h"
 
 
 GUIAnimation::GUIAnimation(uint32_t worldID,  std::shared_ptr<AssetManager> assetManager, const std::string name,
@@ -39,6 +40,18 @@ std::string GUIAnimation::getName() const {
     return this->name;
 }
 
+void GUIAnimation::appendToBatch(GUISpriteBatch &batch) {
+    //all frames share an atlas page, so switching is only a texture coordinate change
+    std::vector<std::shared_ptr<Texture>> textures;
+    for (size_t i = 0; i < images.size(); ++i) {
+        if(images[i] != nullptr) {
+            textures.push_back(images[i]->getTexture());
+        }
+    }
+    batch.getAtlas().packTogether(textures);
+    GUIImageBase::appendToBatch(batch);
+}
+
 void GUIAnimation::addedToLayer(GUILayer *layer) {
     parentLayers.push_back(layer);
 }
@@ -39,6 +39,8 @@ public:
 
     void addedToLayer(GUILayer* layer);
 
+    void appendToBatch(GUISpriteBatch &batch) override;
+
     bool serialize(tinyxml2::XMLDocument &document, tinyxml2::XMLElement *parentNode, OptionsUtil::Options *options);
 
     static GUIAnimation *
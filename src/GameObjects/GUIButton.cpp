@@ -8,6 +8,7 @@
 #include "../../libs/ImGuizmo/ImGuizmo.h"
 #include "../Assets/AssetManager.h"
 #include "../Assets/TextureAsset.h"
+#include "../GUI/GUISpriteBatch.h"
 #include "TriggerObject.h"
 #include "GamePlay/APISerializer.h"
 
@@ -45,6 +46,18 @@ std::string GUIButton::getName() const {
     return this->name;
 }
 
+void GUIButton::appendToBatch(GUISpriteBatch &batch) {
+    //all states share an atlas page, so switching is only a texture coordinate change
+    std::vector<std::shared_ptr<Texture>> textures;
+    for (size_t i = 0; i < images.size(); ++i) {
+        if(images[i] != nullptr) {
+            textures.push_back(images[i]->getTexture());
+        }
+    }
+    batch.getAtlas().packTogether(textures);
+    GUIImageBase::appendToBatch(batch);
+}
+
 void GUIButton::addedToLayer(GUILayer *layer) {
     parentLayers.push_back(layer);
 }
@@ -67,6 +67,8 @@ public:
 
     void addedToLayer(GUILayer* layer);
 
+    void appendToBatch(GUISpriteBatch &batch) override;
+
     bool serialize(tinyxml2::XMLDocument &document, tinyxml2::XMLElement *parentNode, OptionsUtil::Options *options);
 
     static GUIButton *deserialize(tinyxml2::XMLElement *GUIRenderableNode, std::shared_ptr<AssetManager> assetManager, OptionsUtil::Options *options,
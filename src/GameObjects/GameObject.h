@@ -12,6 +12,7 @@
 #include "Editor/ImGuiRequest.h"
 #include "Editor/ImGuiResult.h"
 #include "Utils/HashUtil.h"
+#include "Utils/TagRegistry.h"
 
 /**
  * This class is used to provide a polymorphic way of determining type and name of the object.
@@ -47,10 +48,19 @@ public:
         }
         if(!found) {
             tags.emplace_back(tag);
+            uint32_t tagIndex = TagRegistry::registerTag(tag);
+            if(tagIndex != TagRegistry::INVALID_INDEX) {
+                tagMask.set(tagIndex);
+            }
         }
     }
 
-    bool hasTag(uint64_t hash) {
+    bool hasTag(uint64_t hash) const {
+        uint32_t tagIndex = TagRegistry::findIndex(hash);
+        if(tagIndex != TagRegistry::INVALID_INDEX) {
+            return tagMask.test(tagIndex);
+        }
+        //registry might be full, so tags without index are still checked by hash
         for (const HashUtil::HashedString& hashedString:tags) {
             if(hashedString.hash == hash) {
                 return true;
@@ -59,10 +69,17 @@ public:
         return false;
     }
 
+    /**
+     * Tags as strings, for serialization and editor. Matching should use getTagMask()
+     */
     const std::list<HashUtil::HashedString>& getTags() const {
         return tags;
     }
 
+    const TagRegistry::TagMask& getTagMask() const {
+        return tagMask;
+    }
+
     void removeTag(const std::string& text) {
         HashUtil::HashedString tag(text);
         bool found = false;
@@ -71,6 +88,10 @@ public:
                 //found case
                 found = true;
                 tags.erase(it);
+                uint32_t tagIndex = TagRegistry::findIndex(tag.hash);
+                if(tagIndex != TagRegistry::INVALID_INDEX) {
+                    tagMask.reset(tagIndex);
+                }
                 break;
             }
         }
@@ -80,6 +101,7 @@ public:
     }
 private:
     std::list<HashUtil::HashedString> tags;
+    TagRegistry::TagMask tagMask;
 
 };
 
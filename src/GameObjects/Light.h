@@ -38,11 +38,20 @@ private:
     LightTypes lightType;
     bool frustumChanged = true;
 
-    void updateLightView(const PerspectiveCamera* playerCamera) {
+    /**
+     * Only the cascades in the mask are recalculated, and only they are marked dirty for culling.
+     */
+    void updateLightView(const PerspectiveCamera* playerCamera, uint32_t cascadeMask = 0xFFFFFFFF) {
+        if(cascadeMask == 0) {
+            return;
+        }
         frustumChanged = true;
-        for(Camera *directionalCamera : directionalCameras) {
-            static_cast<OrthographicCamera*>(directionalCamera)->getCameraMatrix();
-            static_cast<OrthographicCamera*>(directionalCamera)->recalculateView(playerCamera);
+        for (size_t i = 0; i < directionalCameras.size(); ++i) {
+            if(i < 32 && (cascadeMask & (1u << i)) == 0) {
+                continue;
+            }
+            static_cast<OrthographicCamera*>(directionalCameras[i])->getCameraMatrix();
+            static_cast<OrthographicCamera*>(directionalCameras[i])->recalculateView(playerCamera);
         }
         this->clearDirty();
         frustumChanged = true;
@@ -114,9 +123,12 @@ public:
 
     void setPosition(glm::vec3 position, const PerspectiveCamera* playerCamera);
 
-    void step(long time [[gnu::unused]], PerspectiveCamera* playerCamera) {
+    /**
+     * @param cascadeMask cascades of directional light to recalculate, ignored by point lights
+     */
+    void step(long time [[gnu::unused]], PerspectiveCamera* playerCamera, uint32_t cascadeMask = 0xFFFFFFFF) {
         if(lightType == LightTypes::DIRECTIONAL) {
-            updateLightView(playerCamera);
+            updateLightView(playerCamera, cascadeMask);
         }
     }
 
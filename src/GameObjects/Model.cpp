@@ -12,13 +12,15 @@
 #ifdef CEREAL_SUPPORT
 #include <cereal/archives/binary.hpp>
 #endif
+
+static const UniformHandle<std::vector<glm::mat4>> BONE_TRANSFORM_ARRAY_UNIFORM("boneTransformArray[0]");
+static const UniformHandle<int> IS_ANIMATED_UNIFORM("isAnimated");
+
 Model::Model(uint32_t objectID,  std::shared_ptr<AssetManager> assetManager, const float mass, const std::string &modelFile,
              bool disconnected = false) :
         PhysicalRenderable(assetManager->getGraphicsWrapper(), mass, disconnected), objectID(objectID), assetManager(assetManager),
         name(modelFile) {
 
-    transformation.setUpdateCallback(std::bind(&Model::transformChangeCallback, this));
-
     //this is required because the shader has fixed size arrays
     boneTransforms.resize(128);
     modelAsset = assetManager->loadAsset<ModelAsset>({modelFile});
@@ -28,6 +30,8 @@ Model::Model(uint32_t objectID,  std::shared_ptr<AssetManager> assetManager, con
     this->ebo = 0;//these are not per Model, but per Mesh, and comes from ModelAsset->MeshAsset, shared between instances
     this->centerOffset = modelAsset->getCenterOffset();
     this->centerOffsetMatrix = glm::translate(glm::mat4(1.0f), centerOffset);
+    //physics is centered, the mesh is moved back by the offset
+    this->transformation.setPivotOffset(centerOffset);
 
     compoundShape = new btCompoundShape();
     btTransform baseTransform;
@@ -90,27 +94,78 @@ Model::Model(uint32_t objectID,  std::shared_ptr<AssetManager> assetManager, con
 }
 
 void Model::setupForTime(long time) {
-    if(animated && !animationLastFramePlayed) {
-        //check if we need to blend
-        if(animationBlend) {
-            //we need 2 animation times, and a factor
-            animationTime = animationTime + (time - lastSetupTime) * animationTimeScale;
+    applyPose(evaluatePose(time, 0));
+}
 
-            animationTimeOld = animationTimeOld + (time - lastSetupTime) * animationTimeScale;
+/**
+ * Calculates bone transforms for the given time. It only writes to this model and reads the shared asset, so it is safe
+ * to run for different models in parallel. Physics is not touched, applyPose should be called after.
+ *
+ * @param time game time
+ * @param updateInterval minimum time between 2 pose calculations, used for animation lod. Time is not lost when skipped,
+ *        next calculation advances the animation for the whole duration.
+ * @return true if bone transforms are recalculated
+ */
+bool Model::evaluatePose(long time, long updateInterval) {
+    bool layered = animationGraph != nullptr && animationGraph->getLayerCount() > 0;
+    if(!animated || (animationLastFramePlayed && !layered)) {
+        lastSetupTime = time;
+        return false;
+    }
+    if(time - lastSetupTime < updateInterval) {
+        return false;
+    }
+    long deltaTime = (time - lastSetupTime) * animationTimeScale;
+    animationTime = animationTime + deltaTime;
+    //check if we need to blend
+    bool blending = animationBlend;
+    float blendFactor = 1.0f;
+    if(blending) {
+        //we need 2 animation times, and a factor
+        animationTimeOld = animationTimeOld + deltaTime;
+
+        blendFactor = std::min(1.0f, (float)animationTime / (float)animationBlendTime);//don't blend after 1.0
+
+        if(blendFactor == 1) {
+            animationBlend = false; // no need to blend anymore.
+        }
+    }
+    if(layered) {
+        animationLastFramePlayed = evaluateLayeredPose(blending, blendFactor, deltaTime);
+    } else if(blending) {
+        animationLastFramePlayed = modelAsset->getTransformBlended(animationNameOld, animationTimeOld, animationLoopedOld, animationCursorsOld,
+                                                                   animationName, animationTime, animationLooped, animationCursors,
+                                                                   blendFactor, boneTransforms);
+        //std::cout << "blend " << animationNameOld << " with " << animationName << " for " << blendFactor << " factor" << std::endl;
+    } else {
+        animationLastFramePlayed = modelAsset->getTransform(animationTime, animationLooped, animationName, animationCursors, boneTransforms);
+    }
+    lastSetupTime = time;
+    return true;
+}
 
-            float blendFactor = std::min(1.0f, (float)animationTime / (float)animationBlendTime);//don't blend after 1.0
+/**
+ * Base animation is calculated as a flat pose, then animation layers are applied on it before generating bone transforms.
+ */
+bool Model::evaluateLayeredPose(bool blending, float blendFactor, long deltaTime) {
+    bool isFinished = modelAsset->samplePose(animationName, animationTime, animationLooped, animationCursors, basePose);
+    if(blending) {
+        bool isFinishedOld = modelAsset->samplePose(animationNameOld, animationTimeOld, animationLoopedOld, animationCursorsOld, basePoseOld);
+        basePoseOld.blend(basePose, blendFactor);
+        std::swap(basePose, basePoseOld);
+        isFinished = isFinished && isFinishedOld;
+    }
+    animationGraph->advance(deltaTime);
+    animationGraph->apply(basePose);
+    modelAsset->calculateTransforms(basePose, boneTransforms);
+    return isFinished;
+}
 
-            if(blendFactor == 1) {
-                animationBlend = false; // no need to blend anymore.
-            }
-            animationLastFramePlayed = modelAsset->getTransformBlended(animationNameOld, animationTimeOld, animationLoopedOld,
-                                                                       animationName, animationTime, animationLooped,
-                                                                       blendFactor, boneTransforms);
-            //std::cout << "blend " << animationNameOld << " with " << animationName << " for " << blendFactor << " factor" << std::endl;
-        } else {
-            animationTime = animationTime + (time - lastSetupTime) * animationTimeScale;
-            animationLastFramePlayed = modelAsset->getTransform(animationTime, animationLooped, animationName, boneTransforms);
-        }
+/**
+ * Applies the pose calculated by evaluatePose to physics, and updates the exposed bones. Must run on the main thread.
+ */
+void Model::applyPose(bool poseUpdated) {
+    if(poseUpdated) {
         if(disconnected) {
             for (unsigned int i = 0; i < boneTransforms.size(); ++i) {
                 if (boneIdCompoundChildMap.find(i) != boneIdCompoundChildMap.end()) {
@@ -151,8 +206,6 @@ void Model::setupForTime(long time) {
         exposedBoneTransforms[boneIterator->first]->setScale(scale);
         exposedBoneTransforms[boneIterator->first]->setOrientation(orientation);
     }
-
-    lastSetupTime = time;
 }
 
 void Model::activateTexturesOnly(std::shared_ptr<const Material>material) {
@@ -178,15 +231,14 @@ void Model::activateTexturesOnly(std::shared_ptr<const Material>material) {
 
 void Model::renderWithProgram(std::shared_ptr<GraphicsProgram> program, uint32_t lodLevel) {
     graphicsWrapper->attachModelUBO(program->getID());
+    //bones are per model, not per mesh
+    if (animated) {
+        program->setUniform(BONE_TRANSFORM_ARRAY_UNIFORM, boneTransforms);
+        program->setUniform(IS_ANIMATED_UNIFORM, true);
+    } else {
+        program->setUniform(IS_ANIMATED_UNIFORM, false);
+    }
     for (auto iter = meshMetaData.begin(); iter != meshMetaData.end(); ++iter) {
-
-        if (animated) {
-            //set all of the bones to unitTransform for testing
-            program->setUniformArray("boneTransformArray[0]", boneTransforms);
-            program->setUniform("isAnimated", true);
-        } else {
-            program->setUniform("isAnimated", false);
-        }
         if(program->IsMaterialRequired()) {
             graphicsWrapper->attachMaterialUBO(program->getID(), (*iter)->mesh->getMaterial()->getMaterialIndex());
         }
@@ -200,14 +252,13 @@ void Model::renderWithProgramInstanced(const std::vector<uint32_t> &modelIndices
     graphicsWrapper->attachModelUBO(program.getID());
     graphicsWrapper->attachModelIndicesUBO(program.getID());
 
+    if (animated) {
+        program.setUniform(BONE_TRANSFORM_ARRAY_UNIFORM, boneTransforms);
+        program.setUniform(IS_ANIMATED_UNIFORM, true);
+    } else {
+        program.setUniform(IS_ANIMATED_UNIFORM, false);
+    }
     for (auto iter = meshMetaData.begin(); iter != meshMetaData.end(); ++iter) {
-        if (animated) {
-            //set all of the bones to unitTransform for testing
-            program.setUniformArray("boneTransformArray[0]", boneTransforms);
-            program.setUniform("isAnimated", true);
-        } else {
-            program.setUniform("isAnimated", false);
-        }
         if(program.IsMaterialRequired()) {
             graphicsWrapper->attachMaterialUBO(program.getID(), (*iter)->mesh->getMaterial()->getMaterialIndex());
             this->activateTexturesOnly((*iter)->mesh->getMaterial());
@@ -459,7 +510,6 @@ Model::Model(const Model &otherModel, uint32_t objectID) :
             otherModel.transformation.getScale()
             );
     this->updateAABB();
-    transformation.setUpdateCallback(std::bind(&Model::transformChangeCallback, this));
 
     this->animationName = otherModel.animationName;
     this->animationTimeScale = otherModel.animationTimeScale;
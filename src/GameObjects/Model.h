@@ -15,6 +15,7 @@
 #include "../Assets/TextureAsset.h"
 #include "../Material.h"
 #include "../Assets/ModelAsset.h"
+#include "../Assets/Animations/AnimationGraph.h"
 #include "../../libs/ImGui/imgui.h"
 #include "GameObject.h"
 
@@ -42,6 +43,12 @@ class Model : public PhysicalRenderable, public GameObject {
     bool animationBlend = false;
     long animationBlendTime = 1000;
 
+    ModelAsset::AnimationCursors animationCursors;
+    ModelAsset::AnimationCursors animationCursorsOld;
+    std::unique_ptr<AnimationGraph> animationGraph;//created when first layer is added
+    AnimationPose basePose;
+    AnimationPose basePoseOld;
+
     bool animationLastFramePlayed = false;
     long lastSetupTime = 0;
     float animationTimeScale = 1.0f;
@@ -84,7 +91,7 @@ public:
 
     Model(const Model& otherModel, uint32_t objectID); //kind of copy constructor, except ID
 
-    void transformChangeCallback() {
+    void transformChanged() override {
         PhysicalRenderable::updatePhysicsFromTransform();
         graphicsWrapper->setModel(this->getWorldObjectID(), this->transformation.getWorldTransform());
     }
@@ -100,6 +107,12 @@ public:
 
     void setupForTime(long time) override;
 
+    bool evaluatePose(long time, long updateInterval);
+
+    bool evaluateLayeredPose(bool blending, float blendFactor, long deltaTime);
+
+    void applyPose(bool poseUpdated);
+
     void renderWithProgram(std::shared_ptr<GraphicsProgram> program, uint32_t lodLevel) override;
 
 
@@ -121,6 +134,7 @@ public:
         this->animationNameOld = this->animationName;
         this->animationTimeOld = this->animationTime;
         this->animationLoopedOld = this->animationLooped;
+        this->animationCursorsOld.swap(this->animationCursors);//cursors are only hints, stale ones are still valid
 
         this->animationName = animationName;
         this->animationTime = 0;
@@ -140,6 +154,20 @@ public:
         return animationLastFramePlayed;
     }
 
+    /**
+     * Layers are applied on top of the animation set by setAnimation. Graph is created on first call.
+     */
+    AnimationGraph* getAnimationGraph() {
+        if(animationGraph == nullptr) {
+            animationGraph = std::make_unique<AnimationGraph>(modelAsset);
+        }
+        return animationGraph.get();
+    }
+
+    void removeAnimationLayers() {
+        animationGraph.reset();
+    }
+
     float getAnimationTimeScale() const {
         return animationTimeScale;
     }
@@ -17,7 +17,7 @@ public:
 
     ModelGroup(GraphicsInterface* graphicsWrapper, uint32_t worldObjectID, const std::string& name)
     : PhysicalRenderable(graphicsWrapper, 0, true), worldObjectID(worldObjectID), name(name) {
-        transformation.setUpdateCallback(nullptr);
+        transformation.setUpdateListener(nullptr);
     }
 
     GameObject::ObjectTypes getTypeID() const override {
@@ -4,6 +4,8 @@
 
 #include "SkyBox.h"
 
+static const UniformHandle<int> CUBE_SAMPLER_UNIFORM("cubeSampler");
+static const UniformHandle<glm::mat4> CAMERA_TRANSFORM_UNIFORM("cameraTransformMatrix");
 
 SkyBox::SkyBox(uint32_t objectID, std::shared_ptr<AssetManager> assetManager, std::string path, std::string right, std::string left,
                std::string top, std::string down, std::string back, std::string front) :
@@ -56,8 +58,8 @@ void SkyBox::renderWithProgram(std::shared_ptr<GraphicsProgram> program, uint32_
 
     graphicsWrapper->attachCubeMap(cubeMap->getID(), texturePoint);
     //this is because we want to remove translate component from cameraMatrix.
-    if (program->setUniform("cubeSampler", texturePoint)) {
-        if (program->setUniform("cameraTransformMatrix", viewMatrix)) {
+    if (program->setUniform(CUBE_SAMPLER_UNIFORM, texturePoint)) {
+        if (program->setUniform(CAMERA_TRANSFORM_UNIFORM, viewMatrix)) {
             graphicsWrapper->render(program->getID(), vao, ebo, faces.size() * 3);
         } else {
             std::cerr << "Uniform \"cameraTransformMatrix\" could not be set, passing rendering." << std::endl;
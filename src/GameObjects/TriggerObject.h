@@ -15,7 +15,7 @@
 #include "API/TriggerInterface.h"
 #include "../BulletDebugDrawer.h"
 
-class TriggerObject : public GameObject {
+class TriggerObject : public GameObject, public Transformation::UpdateListener {
     std::string name;
     Transformation transformation;
     std::vector<LimonTypes::GenericParameter> firstEnterParameters;
@@ -62,7 +62,11 @@ public:
         ghostObject->setUserPointer(static_cast<GameObject *>(this));
         name  = "TRIGGER-" + std::to_string(objectID);
 
-        transformation.setUpdateCallback(std::bind(&TriggerObject::updatePhysicsFromTransform, this));
+        transformation.setUpdateListener(this);
+    }
+
+    void transformChanged() override {
+        updatePhysicsFromTransform();
     }
 
     ~TriggerObject() override {
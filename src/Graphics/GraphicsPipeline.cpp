@@ -291,11 +291,14 @@ GraphicsPipeline::StageInfo::deserialize(tinyxml2::XMLElement *stageInfoElement,
             method.setRenderTags(hashedRenderTags);
             method.setCameraName(StringUtils::join(newStageInfo.cameraTags, ","));
             newStageInfo.addRenderMethod(method);
+            newStageInfo.clear = false;//shadow methods clear the layers they update, rest are kept
         } else if(methodName == "All point shadows") {
-            RenderMethods::RenderMethod method = pipeline->getRenderMethods().getRenderMethodAllPointLights(graphicsProgram);
+            std::shared_ptr<Texture> depthMap = newStageInfo.stage->getOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH);
+            RenderMethods::RenderMethod method = pipeline->getRenderMethods().getRenderMethodAllPointLights(newStageInfo.stage, depthMap, graphicsProgram);
             method.setRenderTags(hashedRenderTags);
             method.setCameraName(StringUtils::join(newStageInfo.cameraTags, ","));
             newStageInfo.addRenderMethod(method);
+            newStageInfo.clear = false;
         } else {
             RenderMethods::RenderMethod method = pipeline->getRenderMethods().getRenderMethod(assetManager->getGraphicsWrapper(), methodName,
                                                                                                      graphicsProgram,
@@ -31,6 +31,7 @@ public:
         std::unordered_map<std::string, RenderMethodInterface*> externalRenderMethods;
         std::vector<std::string> cameraTags;
         std::vector<std::string> renderTags;
+        const char* profileName = nullptr;//stage name is only known after outputs are attached, so set on first render
 
         void addRenderMethod(RenderMethods::RenderMethod method) {
             for (auto iterator = renderMethods.begin(); iterator != renderMethods.end();++iterator) {
@@ -133,6 +134,11 @@ public:
 
     inline void render() {
         for(auto& stageInfo:pipelineStages) {
+            if(stageInfo.profileName == nullptr) {
+                stageInfo.profileName = Profiler::internName("Stage " + stageInfo.stage->getName());
+            }
+            LIMON_PROFILE_ZONE(stageInfo.profileName);
+            LIMON_PROFILE_GPU_ZONE(stageInfo.stage->getGraphicsWrapper(), stageInfo.profileName);
             lastStageInfo = &stageInfo;
             stageInfo.stage->activate(stageInfo.clear);
             for(auto& renderMethod:stageInfo.renderMethods) {
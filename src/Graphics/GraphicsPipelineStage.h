@@ -87,6 +87,14 @@ public:
         }
     }
 
+    const std::string &getName() const {
+        return foundName;
+    }
+
+    GraphicsInterface* getGraphicsWrapper() const {
+        return graphicsWrapper;
+    }
+
     GraphicsInterface::CullModes getCullMode() const {
         return cullMode;
     }
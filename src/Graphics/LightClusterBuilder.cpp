@@ -0,0 +1,189 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include "LightClusterBuilder.h"
+
+const uint32_t LightClusterBuilder::CLUSTER_COUNT;
+const uint32_t LightClusterBuilder::SLICES_PER_RANGE;
+const uint32_t LightClusterBuilder::RANGE_COUNT;
+const uint32_t LightClusterBuilder::CLUSTERS_PER_RANGE;
+const uint32_t LightClusterBuilder::VEC4_PER_LIGHT;
+constexpr float LightClusterBuilder::MINIMUM_CLUSTER_NEAR;
+
+static_assert(LIGHT_CLUSTER_Z % LightClusterBuilder::SLICES_PER_RANGE == 0, "Depth slices must be divisible to ranges");
+static_assert(LightClusterBuilder::CLUSTERS_PER_RANGE % 32 == 0, "AABBArray ranges must start at multiple of 32");
+
+static const uint32_t WORDS_PER_RANGE = LightClusterBuilder::CLUSTERS_PER_RANGE / 32;
+
+LightClusterBuilder::LightClusterBuilder() {
+    clusterBounds.resize(CLUSTER_COUNT);
+    clusterRanges.resize(CLUSTER_COUNT * 2, 0);
+    for (RangeResult &rangeResult : rangeResults) {
+        rangeResult.counts.resize(CLUSTERS_PER_RANGE);
+        rangeResult.offsets.resize(CLUSTERS_PER_RANGE);
+        rangeResult.writePositions.resize(CLUSTERS_PER_RANGE);
+        rangeResult.cullScratch.resize(AABBArray::getMaskWordCount(CLUSTER_COUNT));
+    }
+    for (float &sliceDepth : sliceDepths) {
+        sliceDepth = 0.0f;
+    }
+}
+
+void LightClusterBuilder::calculateClusterBounds(const glm::mat4 &projection, float maximumDistance) {
+    //works for the symmetric perspective projections, glm::perspective
+    float nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    float farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    float clusterNear = std::max(nearPlane, MINIMUM_CLUSTER_NEAR);
+    float clusterFar = std::max(std::min(farPlane, maximumDistance), clusterNear * 2.0f);
+
+    float logDepthRatio = std::log(clusterFar / clusterNear);
+    for (uint32_t slice = 0; slice <= LIGHT_CLUSTER_Z; ++slice) {
+        sliceDepths[slice] = clusterNear * std::exp(logDepthRatio * (float)slice / (float)LIGHT_CLUSTER_Z);
+    }
+    //fragments outside of the sliced range are clamped to first and last slices, so they should cover them
+    sliceDepths[0] = std::min(nearPlane, clusterNear);
+    sliceDepths[LIGHT_CLUSTER_Z] = std::max(farPlane, clusterFar);
+
+    float scale = (float)LIGHT_CLUSTER_Z / logDepthRatio;
+    depthParameters = glm::vec4(scale, -std::log(clusterNear) * scale, clusterNear, clusterFar);
+
+    for (uint32_t z = 0; z < LIGHT_CLUSTER_Z; ++z) {
+        float nearDepth = sliceDepths[z];
+        float farDepth = sliceDepths[z + 1];
+        for (uint32_t y = 0; y < LIGHT_CLUSTER_Y; ++y) {
+            float ndcY0 = -1.0f + 2.0f * (float)y / (float)LIGHT_CLUSTER_Y;
+            float ndcY1 = -1.0f + 2.0f * (float)(y + 1) / (float)LIGHT_CLUSTER_Y;
+            for (uint32_t x = 0; x < LIGHT_CLUSTER_X; ++x) {
+                float ndcX0 = -1.0f + 2.0f * (float)x / (float)LIGHT_CLUSTER_X;
+                float ndcX1 = -1.0f + 2.0f * (float)(x + 1) / (float)LIGHT_CLUSTER_X;
+                //view space x = ndc x * depth / projection[0][0], extremes are on near or far depth
+                glm::vec3 clusterMin(std::min(ndcX0 * nearDepth, ndcX0 * farDepth) / projection[0][0],
+                                     std::min(ndcY0 * nearDepth, ndcY0 * farDepth) / projection[1][1],
+                                     -farDepth);
+                glm::vec3 clusterMax(std::max(ndcX1 * nearDepth, ndcX1 * farDepth) / projection[0][0],
+                                     std::max(ndcY1 * nearDepth, ndcY1 * farDepth) / projection[1][1],
+                                     -nearDepth);
+                clusterBounds.set(x + y * LIGHT_CLUSTER_X + z * LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, clusterMin, clusterMax);
+            }
+        }
+    }
+    boundsProjection = projection;
+    boundsMaximumDistance = maximumDistance;
+}
+
+void LightClusterBuilder::beginFrame(const glm::mat4 &projection, const glm::mat4 &view, float maximumDistance) {
+    boundsChanged = false;
+    if(projection != boundsProjection || maximumDistance != boundsMaximumDistance) {
+        calculateClusterBounds(projection, maximumDistance);
+        boundsChanged = true;
+    }
+    this->view = view;
+    viewSpacePositions.clear();
+    radii.clear();
+    lightData.clear();
+}
+
+bool LightClusterBuilder::addLight(const glm::vec3 &position, float radius, const glm::vec3 &color,
+                                   const glm::vec3 &attenuation, const glm::vec3 &ambient) {
+    if(radii.size() >= NR_MAX_CLUSTERED_LIGHTS) {
+        return false;
+    }
+    viewSpacePositions.emplace_back(view * glm::vec4(position, 1.0f));
+    radii.push_back(radius);
+    lightData.emplace_back(position, radius);
+    lightData.emplace_back(color, 0.0f);
+    lightData.emplace_back(attenuation, 0.0f);
+    lightData.emplace_back(ambient, 0.0f);
+    return true;
+}
+
+void LightClusterBuilder::buildRange(uint32_t rangeIndex) {
+    RangeResult &result = rangeResults[rangeIndex];
+    const uint32_t lightCount = (uint32_t)radii.size();
+    const uint32_t rangeStart = rangeIndex * CLUSTERS_PER_RANGE;
+    const float rangeNearDepth = sliceDepths[rangeIndex * SLICES_PER_RANGE];
+    const float rangeFarDepth = sliceDepths[(rangeIndex + 1) * SLICES_PER_RANGE];
+
+    result.masks.assign(lightCount * WORDS_PER_RANGE, 0);
+    std::fill(result.counts.begin(), result.counts.end(), 0);
+    for (uint32_t light = 0; light < lightCount; ++light) {
+        float lightDepth = -viewSpacePositions[light].z;
+        if(lightDepth + radii[light] < rangeNearDepth || lightDepth - radii[light] > rangeFarDepth) {
+            continue;//can't touch any slice of the range
+        }
+        clusterBounds.cullAgainstSphere(viewSpacePositions[light], radii[light], rangeStart, rangeStart + CLUSTERS_PER_RANGE, result.cullScratch.data());
+        uint32_t* lightMask = &result.masks[light * WORDS_PER_RANGE];
+        for (uint32_t word = 0; word < WORDS_PER_RANGE; ++word) {
+            uint32_t bits = result.cullScratch[rangeStart / 32 + word];
+            lightMask[word] = bits;
+            while(bits != 0) {
+                result.counts[word * 32 + __builtin_ctz(bits)]++;
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    uint32_t indexCount = 0;
+    for (uint32_t cluster = 0; cluster < CLUSTERS_PER_RANGE; ++cluster) {
+        result.offsets[cluster] = indexCount;
+        indexCount += result.counts[cluster];
+    }
+    result.indices.resize(indexCount);
+    //lights are iterated in order, so each cluster list is sorted by light index
+    std::copy(result.offsets.begin(), result.offsets.end(), result.writePositions.begin());
+    for (uint32_t light = 0; light < lightCount; ++light) {
+        const uint32_t* lightMask = &result.masks[light * WORDS_PER_RANGE];
+        for (uint32_t word = 0; word < WORDS_PER_RANGE; ++word) {
+            uint32_t bits = lightMask[word];
+            while(bits != 0) {
+                result.indices[result.writePositions[word * 32 + __builtin_ctz(bits)]++] = light;
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+void LightClusterBuilder::finish() {
+    lightIndices.clear();
+    bool truncated = false;
+    for (uint32_t rangeIndex = 0; rangeIndex < RANGE_COUNT; ++rangeIndex) {
+        const RangeResult &result = rangeResults[rangeIndex];
+        for (uint32_t cluster = 0; cluster < CLUSTERS_PER_RANGE; ++cluster) {
+            uint32_t count = result.counts[cluster];
+            if(lightIndices.size() + count > NR_MAX_LIGHT_CLUSTER_INDICES) {
+                count = NR_MAX_LIGHT_CLUSTER_INDICES - (uint32_t)lightIndices.size();
+                truncated = true;
+            }
+            uint32_t globalCluster = rangeIndex * CLUSTERS_PER_RANGE + cluster;
+            clusterRanges[2 * globalCluster] = (uint32_t)lightIndices.size();
+            clusterRanges[2 * globalCluster + 1] = count;
+            lightIndices.insert(lightIndices.end(), result.indices.begin() + result.offsets[cluster],
+                                result.indices.begin() + result.offsets[cluster] + count);
+        }
+    }
+    if(truncated && !indicesTruncated) {
+        std::cerr << "Light cluster indices are over the maximum " << NR_MAX_LIGHT_CLUSTER_INDICES << ", some lights will not be rendered." << std::endl;
+    }
+    indicesTruncated = truncated;
+
+    built = true;
+    boundsChanged = false;
+    builtView = view;
+    builtLightData = lightData;
+}
+
+uint32_t LightClusterBuilder::getClusterIndex(const glm::vec3 &viewSpacePosition) const {
+    glm::vec4 clipSpacePosition = boundsProjection * glm::vec4(viewSpacePosition, 1.0f);
+    glm::vec2 ndc = glm::vec2(clipSpacePosition) / clipSpacePosition.w;
+    int x = (int)std::floor((ndc.x * 0.5f + 0.5f) * LIGHT_CLUSTER_X);
+    int y = (int)std::floor((ndc.y * 0.5f + 0.5f) * LIGHT_CLUSTER_Y);
+    int z = (int)std::floor(std::log(-viewSpacePosition.z) * depthParameters.x + depthParameters.y);
+    x = std::min(std::max(x, 0), LIGHT_CLUSTER_X - 1);
+    y = std::min(std::max(y, 0), LIGHT_CLUSTER_Y - 1);
+    z = std::min(std::max(z, 0), LIGHT_CLUSTER_Z - 1);
+    return x + y * LIGHT_CLUSTER_X + z * LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y;
+}
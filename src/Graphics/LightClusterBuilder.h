@@ -0,0 +1,137 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_LIGHTCLUSTERBUILDER_H
+#define LIMONENGINE_LIGHTCLUSTERBUILDER_H
+
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "API/Graphics/GraphicsInterface.h"
+#include "../Camera/AABBArray.h"
+
+/**
+ * Assigns point lights to clusters of the camera frustum, so each fragment only processes the lights that can reach it.
+ *
+ * Frustum is split to LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y tiles in screen, and LIGHT_CLUSTER_Z exponential depth slices.
+ * Cluster bounds are kept in view space, and only recalculated when projection changes. Lights are tested against
+ * clusters as spheres, using the SIMD sphere test of AABBArray.
+ *
+ * Building is split to ranges of depth slices, each range writes only its own data, so ranges can be built in parallel.
+ * finish() merges them to the GPU layout:
+ *  - light data: 4 vec4 per light, position and radius, color, attenuation, ambient. Positions are in world space.
+ *  - cluster ranges: offset and count in light indices, per cluster. Cluster index is x + y * X + z * X * Y.
+ *  - light indices: light data indices, ordered by cluster.
+ *  - depth parameters: slice = log(viewDepth) * x + y, z and w are the near and far of the slices.
+ *
+ * Doesn't use any graphics calls, so it can be tested and benchmarked without a GPU.
+ */
+class LightClusterBuilder {
+public:
+    static const uint32_t CLUSTER_COUNT = LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z;
+    static const uint32_t SLICES_PER_RANGE = 4;
+    static const uint32_t RANGE_COUNT = LIGHT_CLUSTER_Z / SLICES_PER_RANGE;
+    static const uint32_t CLUSTERS_PER_RANGE = LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * SLICES_PER_RANGE;
+    static const uint32_t VEC4_PER_LIGHT = 4;
+    static constexpr float MINIMUM_CLUSTER_NEAR = 0.1f;//first slices get too thin with smaller values
+
+private:
+    struct RangeResult {
+        std::vector<uint32_t> masks;//per light, only the words of the range
+        std::vector<uint32_t> counts;//per cluster of the range
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> writePositions;
+        std::vector<uint32_t> indices;
+        std::vector<uint32_t> cullScratch;//whole cluster mask, AABBArray writes by global word index
+    };
+
+    AABBArray clusterBounds;//view space
+    glm::mat4 boundsProjection = glm::mat4(0.0f);
+    float boundsMaximumDistance = 0.0f;
+    float sliceDepths[LIGHT_CLUSTER_Z + 1];
+    glm::vec4 depthParameters = glm::vec4(0.0f);
+
+    glm::mat4 view = glm::mat4(1.0f);
+    std::vector<glm::vec3> viewSpacePositions;
+    std::vector<float> radii;
+    std::vector<glm::vec4> lightData;
+
+    RangeResult rangeResults[RANGE_COUNT];
+
+    std::vector<uint32_t> clusterRanges;
+    std::vector<uint32_t> lightIndices;
+    bool built = false;
+    bool boundsChanged = false;
+    glm::mat4 builtView = glm::mat4(1.0f);
+    std::vector<glm::vec4> builtLightData;
+    bool indicesTruncated = false;
+
+    void calculateClusterBounds(const glm::mat4 &projection, float maximumDistance);
+
+public:
+    LightClusterBuilder();
+
+    /**
+     * Clears the lights of last frame. maximumDistance limits the depth of the slices, anything further uses the last slice.
+     */
+    void beginFrame(const glm::mat4 &projection, const glm::mat4 &view, float maximumDistance);
+
+    /**
+     * returns false if NR_MAX_CLUSTERED_LIGHTS lights are already added, the light is ignored.
+     */
+    bool addLight(const glm::vec3 &position, float radius, const glm::vec3 &color, const glm::vec3 &attenuation, const glm::vec3 &ambient);
+
+    /**
+     * false if camera, lights and projection are the same with the last build, so the last result can be used as is.
+     */
+    bool needsBuild() const {
+        return !built || boundsChanged || view != builtView || lightData != builtLightData;
+    }
+
+    /**
+     * Thread safe for different range indexes, beginFrame and addLight must not be called before finish.
+     */
+    void buildRange(uint32_t rangeIndex);
+
+    void finish();
+
+    /**
+     * Builds all ranges on calling thread.
+     */
+    void build() {
+        for (uint32_t rangeIndex = 0; rangeIndex < RANGE_COUNT; ++rangeIndex) {
+            buildRange(rangeIndex);
+        }
+        finish();
+    }
+
+    uint32_t getLightCount() const {
+        return (uint32_t)radii.size();
+    }
+
+    const std::vector<glm::vec4> &getLightData() const {
+        return lightData;
+    }
+
+    const std::vector<uint32_t> &getClusterRanges() const {
+        return clusterRanges;
+    }
+
+    const std::vector<uint32_t> &getLightIndices() const {
+        return lightIndices;
+    }
+
+    const glm::vec4 &getDepthParameters() const {
+        return depthParameters;
+    }
+
+    /**
+     * For debugging, returns the cluster given view space position falls in. Same calculation as the shaders.
+     */
+    uint32_t getClusterIndex(const glm::vec3 &viewSpacePosition) const;
+};
+
+
+#endif //LIMONENGINE_LIGHTCLUSTERBUILDER_H
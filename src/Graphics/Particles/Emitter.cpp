@@ -5,8 +5,11 @@
 #include <Assets/TextureAsset.h>
 
 #include <utility>
+#include <random>
+#include <algorithm>
 #include "ImGui/imgui.h"
 #include "Emitter.h"
+#include "Utils/Profiler.h"
 
 Emitter::Emitter(long worldObjectId, std::string name, std::shared_ptr<AssetManager> assetManager,
                  const std::string &textureFile, glm::vec3 startPosition, glm::vec3 maxStartDistances, glm::vec2 size, long count,
@@ -19,9 +22,7 @@ Emitter::Emitter(long worldObjectId, std::string name, std::shared_ptr<AssetMana
         maxCount(count),
         lifeTime(lifeTime),
         maxStartDistances(maxStartDistances),
-        randomFloatGenerator(randomDevice()),
-        randomStartingPoints(-1.0f, 1.0f),
-        randomSpeedDistribution(-1.0f, 1.0f)
+        randomSeed(((uint64_t)std::random_device()() << 32) | (uint32_t)worldObjectId)
         {
     this->transformation.setTranslate(startPosition);
     textureAsset = assetManager->loadAsset<TextureAsset>({textureFile});
@@ -35,6 +36,9 @@ Emitter::Emitter(long worldObjectId, std::string name, std::shared_ptr<AssetMana
                                                     GraphicsInterface::FormatTypes::RGBA,
                                                     GraphicsInterface::DataTypes::FLOAT,
                                                     maxCount, 1);
+    //only level 0 is uploaded, mipmapped filtering would make the texture incomplete
+    particleDataTexture->setFilterMode(GraphicsInterface::FilterModes::NEAREST);
+    resetParticles();
     if(particlePerMs > 0) {
         this->perMsParticleCount = particlePerMs;
     } else {
@@ -42,10 +46,156 @@ Emitter::Emitter(long worldObjectId, std::string name, std::shared_ptr<AssetMana
     }
 }
 
-void Emitter::addRandomParticle(const glm::vec3 &startPosition, const glm::vec3 &maxStartDistances, long time) {
-    float x = randomStartingPoints(randomFloatGenerator) * maxStartDistances.x;
-    float y = randomStartingPoints(randomFloatGenerator) * maxStartDistances.y;
-    float z = randomStartingPoints(randomFloatGenerator) * maxStartDistances.z;
+void Emitter::resetParticles() {
+    positions.assign(maxCount, glm::vec4(0, 0, 0, 1));
+    speeds.assign(maxCount, glm::vec4(0, 0, 0, 0));
+    creationTime.assign(maxCount, 0);
+    oldestParticle = 0;
+    currentCount = 0;
+}
+
+void Emitter::setupForTime(long time) {
+    uint64_t startTime = Profiler::now();
+    simulate(time);
+    statistics.lastUpdateNanoseconds = Profiler::now() - startTime;
+    statistics.simulatedTickCount = 1;
+    uploadParticleData();
+}
+
+void Emitter::catchUp(long time, long tickDuration) {
+    uint64_t startTime = Profiler::now();
+    statistics.simulatedTickCount = 0;
+    if(lastSetupTime != 0 && tickDuration > 0) {
+        long nextTick = lastSetupTime + tickDuration;
+        //particles created before this are expired at time, so ticks before it don't change the result
+        long firstUsefulTick = time - lifeTime;
+        if(nextTick < firstUsefulTick) {
+            nextTick += ((firstUsefulTick - nextTick) / tickDuration) * tickDuration;
+            skipUntil(nextTick - tickDuration);
+        }
+        for (; nextTick < time; nextTick += tickDuration) {
+            simulate(nextTick);
+            statistics.simulatedTickCount++;
+        }
+    }
+    simulate(time);
+    statistics.simulatedTickCount++;
+    statistics.lastUpdateNanoseconds = Profiler::now() - startTime;
+}
+
+void Emitter::skipUntil(long time) {
+    if(enabled && !continuousEmit) {
+        //skipped particles still count for the emitters that stop
+        long skippedCreationCount = (time - lastCreationTime) * perMsParticleCount;
+        totalCreatedCount = std::min(maxCount, totalCreatedCount + skippedCreationCount);
+    }
+    resetParticles();
+    lastSetupTime = time;
+    lastCreationTime = time;
+}
+
+void Emitter::getBounds(long tickDuration, glm::vec3 &aabbMin, glm::vec3 &aabbMax) const {
+    //speeds are per tick, so the furthest a particle can go is its life time in ticks
+    float tickCount = (float)lifeTime / (float)std::max(tickDuration, 1L) + 1.0f;
+    glm::vec3 travel = (glm::abs(speedOffset) + glm::abs(speedMultiplier)) * tickCount +
+                       glm::abs(gravity / 60.0f) * (tickCount * (tickCount + 1.0f) / 2.0f);
+    glm::vec3 extent = maxStartDistances + travel + glm::vec3(std::max(size.x, size.y));
+    aabbMin = transformation.getTranslate() - extent;
+    aabbMax = transformation.getTranslate() + extent;
+}
+
+void Emitter::simulate(long time) {
+    LIMON_PROFILE_ZONE("Emitter");
+    //random values are seeded per tick, so particles of a tick are the same no matter which ticks are skipped
+    FastRandom random(randomSeed ^ ((uint64_t)time * 0x9E3779B97F4A7C15ULL));
+    if(lastSetupTime == 0) {
+        lastSetupTime = time;//don't try to create massive amounts in first setup.
+        lastCreationTime = time;
+    }
+    //oldest particles are at the start of the ring, so expired ones are removed by advancing it
+    while(currentCount > 0 && (time - creationTime[oldestParticle]) > lifeTime) {
+        oldestParticle = getRingIndex(1);
+        currentCount--;
+    }
+    if(currentCount == 0) {
+        oldestParticle = 0;//keeps the live range in one piece as long as possible
+    }
+
+    if(enabled && (
+                (continuousEmit && currentCount < maxCount) ||
+                (!continuousEmit && totalCreatedCount < maxCount)
+                )
+        ) {
+        long creationParticleCount = (time - lastCreationTime) * perMsParticleCount;
+        if(creationParticleCount > 0) {
+            lastCreationTime = time;
+        }
+        if(currentCount + creationParticleCount > maxCount) {
+            creationParticleCount = maxCount - currentCount;
+        }
+        for (int i = 0; i < creationParticleCount; ++i) {
+            addRandomParticle(random, this->transformation.getTranslate(), maxStartDistances, time);
+        }
+        totalCreatedCount += creationParticleCount;
+    }
+
+    //live range is at most 2 pieces, one until the end of ring and one from its start
+    glm::vec4 speedChange = glm::vec4(gravity / 60.0f, 0.0f);
+    uint32_t firstPieceEnd = std::min((uint32_t)(oldestParticle + currentCount), (uint32_t)maxCount);
+    integrate(oldestParticle, firstPieceEnd, speedChange);
+    integrate(0, (uint32_t)(oldestParticle + currentCount) - firstPieceEnd, speedChange);
+
+    //color only depends on age, and particles created at the same time are next to each other
+    long colorShiftCreationTime = -1;
+    float colorShift = 0;
+    for (uint32_t i = 0; i < (uint32_t)currentCount; ++i) {
+        uint32_t index = getRingIndex(i);
+        if(creationTime[index] != colorShiftCreationTime) {
+            colorShiftCreationTime = creationTime[index];
+            colorShift = calculateTimedColorShift(time, colorShiftCreationTime);
+        }
+        positions[index].w = colorShift;
+    }
+    lastSetupTime = time;
+}
+
+void Emitter::integrate(uint32_t start, uint32_t end, const glm::vec4 &speedChange) {
+    uint32_t i = start;
+#if defined(LIMON_PARTICLE_SSE)
+    //color multiplier in w is written after, so it is not touched by the float additions
+    const __m128 speedChangeVector = _mm_loadu_ps(&speedChange.x);
+    for (; i < end; ++i) {
+        __m128 speed = _mm_loadu_ps(&speeds[i].x);
+        _mm_storeu_ps(&positions[i].x, _mm_add_ps(_mm_loadu_ps(&positions[i].x), speed));
+        _mm_storeu_ps(&speeds[i].x, _mm_add_ps(speed, speedChangeVector));
+    }
+#endif
+    for (; i < end; ++i) {
+        positions[i] += speeds[i];
+        speeds[i] += speedChange;
+    }
+}
+
+void Emitter::uploadParticleData() {
+    statistics.uploadedParticleCount = (uint32_t)currentCount;
+    if(currentCount == 0) {
+        return;//nothing is rendered
+    }
+    uint32_t firstPieceEnd = std::min((uint32_t)(oldestParticle + currentCount), (uint32_t)maxCount);
+    uint32_t secondPieceEnd = (uint32_t)(oldestParticle + currentCount) - firstPieceEnd;
+    if(particleDataTexture->loadDataRegion(&positions[oldestParticle], oldestParticle, 0, firstPieceEnd - oldestParticle, 1) &&
+       (secondPieceEnd == 0 || particleDataTexture->loadDataRegion(&positions[0], 0, 0, secondPieceEnd, 1))) {
+        return;
+    }
+    //backend can't update regions, whole ring is uploaded
+    statistics.uploadedParticleCount = (uint32_t)maxCount;
+    particleDataTexture->loadData(positions.data());
+}
+
+void Emitter::addRandomParticle(FastRandom &random, const glm::vec3 &startPosition, const glm::vec3 &maxStartDistances, long time) {
+    float x = random.nextSigned() * maxStartDistances.x;
+    float y = random.nextSigned() * maxStartDistances.y;
+    float z = random.nextSigned() * maxStartDistances.z;
     /* Leaving here if I want to add a toggle for sphere
     if(x*x + y*y + z*z > startSphereR * startSphereR) {
         if(x > y && x > z) {
@@ -57,14 +207,16 @@ void Emitter::addRandomParticle(const glm::vec3 &startPosition, const glm::vec3
         }
     }
     */
-    glm::vec4 position = glm::vec4(startPosition, 0) +
-                         glm::vec4(x, y, z, 1);
-    positions.emplace_back(position);
-    glm::vec3 speed = glm::vec3(randomSpeedDistribution(randomFloatGenerator) * speedMultiplier.x + speedOffset.x,
-                                randomSpeedDistribution(randomFloatGenerator) * speedMultiplier.y + speedOffset.y,
-                                randomSpeedDistribution(randomFloatGenerator) * speedMultiplier.z + speedOffset.z);
-    speeds.emplace_back(speed);
-    creationTime.emplace_back(time);
+    //caller makes sure there is room in the ring
+    uint32_t index = getRingIndex(currentCount);
+    positions[index] = glm::vec4(startPosition, 0) +
+                       glm::vec4(x, y, z, 1);
+    speeds[index] = glm::vec4(random.nextSigned() * speedMultiplier.x + speedOffset.x,
+                              random.nextSigned() * speedMultiplier.y + speedOffset.y,
+                              random.nextSigned() * speedMultiplier.z + speedOffset.z,
+                              0.0f);
+    creationTime[index] = time;
+    currentCount++;
     //std::cout << "Add particle with position " << position.x << ", " <<position.y << ", " <<position.z << std::endl;
 }
 
@@ -126,20 +278,17 @@ ImGuiResult Emitter::addImGuiEditorElements(const ImGuiRequest &request) {
     }
 
     uint32_t maxCountTemp = maxCount;
-    if(ImGui::InputScalar("Maximum particle count##ParticleEmitter", ImGuiDataType_U32, &maxCountTemp)) {
+    if(ImGui::InputScalar("Maximum particle count##ParticleEmitter", ImGuiDataType_U32, &maxCountTemp) && maxCountTemp > 0) {
+        maxCount = maxCountTemp;
         particleDataTexture = std::make_shared<Texture>(this->graphicsWrapper,
                                                         GraphicsInterface::TextureTypes::T2D,
                                                         GraphicsInterface::InternalFormatTypes::RGBA32F,
-                                                        GraphicsInterface::FormatTypes::RGB,
+                                                        GraphicsInterface::FormatTypes::RGBA,
                                                         GraphicsInterface::DataTypes::FLOAT,
                                                         maxCount, 1);
-
-        maxCount = maxCountTemp;
+        particleDataTexture->setFilterMode(GraphicsInterface::FilterModes::NEAREST);
         perMsParticleCount = (float) maxCount / lifeTime;
-        currentCount = 0;
-        positions.clear();
-        speeds.clear();
-        creationTime.clear();
+        resetParticles();
     }
 
     uint32_t lifeTimeTemp = lifeTime;
@@ -256,6 +405,12 @@ ImGuiResult Emitter::addImGuiEditorElements(const ImGuiRequest &request) {
         }
     }
 
+    ImGui::Text("Particles: %ld, update: %.3f ms for %u ticks", currentCount, statistics.lastUpdateNanoseconds / 1000000.0, statistics.simulatedTickCount);
+    if(statistics.lastUpdateNanoseconds > 0) {
+        ImGui::Text("%.0f particles/ms, uploaded %u", currentCount * statistics.simulatedTickCount * 1000000.0 / statistics.lastUpdateNanoseconds,
+                    statistics.uploadedParticleCount);
+    }
+
     ImGuiResult imGuiResult;
     if(ImGui::Button("Remove##ParticleEmitter")) {
         imGuiResult.remove = true;
@@ -8,26 +8,43 @@
 
 #include <Graphics/Texture.h>
 #include <API/Graphics/GraphicsProgram.h>
-#include <random>
 #include <utility>
 #include <Renderable.h>
 #include "../../Assets/TextureAsset.h"
-
+#include "../../Utils/FastRandom.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIMON_PARTICLE_SSE
+#endif
+
+/**
+ * CPU simulated particles. Particles are kept in a ring buffer with the same layout as the particle data texture.
+ * They are created in time order and all have the same life time, so the oldest ones expire first, and removal
+ * is advancing the oldest index. Only the live range of the ring is uploaded.
+ */
 class Emitter : public Renderable, public GameObject {
 public:
     struct TimedColorMultiplier {
         glm::uvec4 colorMultiplier = glm::uvec4(255,255,255,255);
         long time;
     };
+
+    struct SimulationStatistics {
+        uint64_t lastUpdateNanoseconds = 0;//simulation of all ticks in last update
+        uint32_t simulatedTickCount = 0;
+        uint32_t uploadedParticleCount = 0;
+    };
     ~Emitter() {
         particleDataTexture.reset();
         assetManager->freeAsset(textureAsset->getName());
     }
 private:
     std::shared_ptr<AssetManager> assetManager;
-    std::vector<glm::vec4> positions;
-    std::vector<glm::vec3> speeds;
+    std::vector<glm::vec4> positions;//ring buffer, w is the packed color multiplier
+    std::vector<glm::vec4> speeds;//w is always 0, so 4 floats can be added at once
     std::vector<long> creationTime;
+    uint32_t oldestParticle = 0;
 
     long worldObjectID;
     std::string name;
@@ -50,15 +67,24 @@ private:
     long lastCreationTime = 0;
     std::shared_ptr<Texture> particleDataTexture;
 
-    std::random_device randomDevice;
-    std::default_random_engine randomFloatGenerator;
-    std::uniform_real_distribution<float> randomStartingPoints;
-    std::uniform_real_distribution<float> randomSpeedDistribution;
+    uint64_t randomSeed;
     long totalCreatedCount = 0;
+    SimulationStatistics statistics;
 
     void setupVAO();
 
-    void addRandomParticle(const glm::vec3 &startPosition, const glm::vec3 &maxStartDistances, long time);
+    void resetParticles();
+
+    uint32_t getRingIndex(uint32_t order) const {
+        uint32_t index = oldestParticle + order;
+        return index >= (uint32_t)maxCount ? index - (uint32_t)maxCount : index;
+    }
+
+    void addRandomParticle(FastRandom &random, const glm::vec3 &startPosition, const glm::vec3 &maxStartDistances, long time);
+
+    void integrate(uint32_t start, uint32_t end, const glm::vec4 &speedChange);
+
+    void skipUntil(long time);
 
     float calculateTimedColorShift(const long time, const long particleCreateTime);
 
@@ -69,71 +95,46 @@ public:
             const std::string &textureFile, glm::vec3 startPosition, glm::vec3 maxStartDistances, glm::vec2 size, long count,
             long lifeTime, float particlePerMs = -1);
 
-    void setupForTime(long time) override {
-        if(lastSetupTime == 0) {
-            lastSetupTime = time;//don't try to create massive amounts in first setup.
-            lastCreationTime = time;
-        }
-        if(enabled && (
-                    (continuousEmit && currentCount < maxCount) ||
-                    (!continuousEmit && totalCreatedCount < maxCount)
-                    )
-            ) {
-            long creationParticleCount = (time - lastCreationTime) * perMsParticleCount;
-            if(creationParticleCount > 0) {
-                lastCreationTime = time;
-            }
-            if(currentCount + creationParticleCount > maxCount) {
-                creationParticleCount = maxCount - currentCount;
-            }
-            for (int i = 0; i < creationParticleCount; ++i) {
-                addRandomParticle(this->transformation.getTranslate(), maxStartDistances, time);
-            }
-            currentCount += creationParticleCount;
-            totalCreatedCount += creationParticleCount;
-        }
+    void setupForTime(long time) override;
 
-        size_t removalStart, removalEnd = 0;
-        bool removalSet = false;
-        for (int i = 0; i < currentCount; ++i) {
-            float colorShift = calculateTimedColorShift(time, creationTime[i]);
-            positions[i].w = colorShift;
-            positions[i] = positions[i] + glm::vec4(speeds[i], 0);
-            speeds[i] +=(gravity/60.0);
-            if(!removalSet && ((time - this->creationTime[i]) > lifeTime )) {
-                removalStart = i;
-                removalSet = true;
-            }
-            if(removalSet && ((time - this->creationTime[i]) > lifeTime )) {
-                removalEnd = i+1;
-            }
-        }
-        if(removalSet) {
-            if(removalEnd == 0 || removalEnd > (size_t)currentCount) {
-                removalEnd = currentCount;
-            }
-            //now remove
-            positions.erase(positions.begin() + removalStart, positions.begin() + removalEnd);
-            speeds.erase(speeds.begin() + removalStart, speeds.begin() + removalEnd);
-            creationTime.erase(creationTime.begin() + removalStart, creationTime.begin() + removalEnd);
-
-            currentCount = currentCount - (removalEnd - removalStart);
-        }
-        std::vector<glm::vec4> temp;
-        temp.insert(temp.end(), positions.rbegin(), positions.rend());
-        for (int i = temp.size(); i < maxCount; ++i) {
-            temp.emplace_back(glm::vec4(0,0,0, 1));
-        }
-        particleDataTexture->loadData(temp.data());
-        lastSetupTime = time;
-    }
+    /**
+     * Simulates a single tick. Doesn't make any graphics calls, so different emitters can be simulated in parallel.
+     */
+    void simulate(long time);
+
+    /**
+     * Simulates the ticks missed since the last simulation until time, for emitters that are not simulated while
+     * they are not visible. Ticks that can't affect living particles are skipped.
+     */
+    void catchUp(long time, long tickDuration);
+
+    /**
+     * Uploads the living particles, must be called from the thread that owns graphics.
+     */
+    void uploadParticleData();
+
+    /**
+     * Conservative bounds of all particles, using the start distances, speeds and gravity through the life time.
+     */
+    void getBounds(long tickDuration, glm::vec3 &aabbMin, glm::vec3 &aabbMax) const;
 
     void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel[[gnu::unused]]) override {
-        renderProgram->setUniform("sprite", 6);
+        static const UniformHandle<int> spriteUniform("sprite");
+        static const UniformHandle<int> positionsUniform("positions");
+        static const UniformHandle<float> sizeUniform("size");
+        static const UniformHandle<int> newestParticleUniform("newestParticle");
+        static const UniformHandle<int> particleCapacityUniform("particleCapacity");
+        if(currentCount == 0) {
+            return;
+        }
+        renderProgram->setUniform(spriteUniform, 6);
         graphicsWrapper->attachTexture((int) texture->getTextureID(), 6);
-        renderProgram->setUniform("positions", 7);
+        renderProgram->setUniform(positionsUniform, 7);
         graphicsWrapper->attachTexture((int) particleDataTexture->getTextureID(), 7);
-        renderProgram->setUniform("size", size.x);
+        renderProgram->setUniform(sizeUniform, size.x);
+        //newest particles are rendered first, as they used to be
+        renderProgram->setUniform(newestParticleUniform, (int) getRingIndex(currentCount - 1));
+        renderProgram->setUniform(particleCapacityUniform, (int) maxCount);
         graphicsWrapper->renderInstanced(renderProgram->getID(), vao, ebo, 3 * 2, currentCount);
     }
 
@@ -161,6 +162,18 @@ public:
         return maxCount;
     }
 
+    long getLastSimulationTime() const {
+        return lastSetupTime;
+    }
+
+    long getCurrentCount() const {
+        return currentCount;
+    }
+
+    const SimulationStatistics &getStatistics() const {
+        return statistics;
+    }
+
     long getLifeTime() const {
         return lifeTime;
     }
@@ -209,6 +222,13 @@ public:
         Emitter::continuousEmit = continuousEmit;
     }
 
+    /**
+     * Seed is random by default, a fixed one makes simulation reproducible.
+     */
+    void setRandomSeed(uint64_t randomSeed) {
+        this->randomSeed = randomSeed;
+    }
+
     bool isEnabled() const {
         return enabled;
     }
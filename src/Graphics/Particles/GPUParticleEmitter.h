@@ -119,14 +119,20 @@ public:
     }
 
     void renderWithProgram(std::shared_ptr<GraphicsProgram> renderProgram, uint32_t lodLevel[[gnu::unused]]) override {
-        renderProgram->setUniform("sprite", 6);
+        static const UniformHandle<int> spriteUniform("sprite");
+        static const UniformHandle<int> positionsUniform("positions");
+        static const UniformHandle<float> sizeUniform("size");
+        static const UniformHandle<glm::vec3> gravityUniform("gravity");
+        static const UniformHandle<int> continuousEmitUniform("continuousEmit");
+        static const UniformHandle<float> lifeTimeUniform("lifeTime");
+        renderProgram->setUniform(spriteUniform, 6);
         graphicsWrapper->attachTexture((int) texture->getTextureID(), 6);
-        renderProgram->setUniform("positions", 7);
+        renderProgram->setUniform(positionsUniform, 7);
         graphicsWrapper->attachTexture((int) particleDataTexture->getTextureID(), 7);
-        renderProgram->setUniform("size", size.x);
-        renderProgram->setUniform("gravity", gravity);
-        renderProgram->setUniform("continuousEmit", continuousEmit);
-        renderProgram->setUniform("lifeTime", (float) lifeTime);
+        renderProgram->setUniform(sizeUniform, size.x);
+        renderProgram->setUniform(gravityUniform, gravity);
+        renderProgram->setUniform(continuousEmitUniform, continuousEmit);
+        renderProgram->setUniform(lifeTimeUniform, (float) lifeTime);
         graphicsWrapper->renderInstanced(renderProgram->getID(), vao, ebo, 3 * 2, maxCount);
     }
 
@@ -13,6 +13,9 @@
 #include <API/Graphics/RenderMethodInterface.h>
 #include "../GameObjects/Light.h"
 #include "GraphicsPipelineStage.h"
+#include "ShadowMapCache.h"
+#include "ShadowUpdateScheduler.h"
+#include "Utils/Profiler.h"
 
 
 class RenderMethods {
@@ -20,6 +23,7 @@ class RenderMethods {
 public:
     class RenderMethod {
         std::string name;
+        const char* profileName;
         std::string cameraName;//FIXME I am not sure if we want multiple tags in single call or single, needs decision.
         std::vector<HashUtil::HashedString> renderTags;
         std::function<void(const std::shared_ptr<GraphicsProgram>&, const std::vector<LimonTypes::GenericParameter>&)> initializer;
@@ -36,7 +40,7 @@ public:
                      std::function<void(const std::shared_ptr<GraphicsProgram> &, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]])> method,
                      std::function<void(const std::shared_ptr<GraphicsProgram> &, const std::vector<LimonTypes::GenericParameter> &)> finalizer,
                      std::shared_ptr<GraphicsProgram> glslProgram) :
-                     name(std::move(name)), initializer(std::move(initializer)), method(std::move(method)), finalizer(std::move(finalizer)),
+                     name(std::move(name)), profileName(Profiler::internName(this->name)), initializer(std::move(initializer)), method(std::move(method)), finalizer(std::move(finalizer)),
                      glslProgram(std::move(glslProgram)), priority(priority) {
             if(!this->initializer) {
                 isInitialized = true;
@@ -55,6 +59,7 @@ public:
                 }
             }
 #endif
+            LIMON_PROFILE_ZONE(profileName);
             method(glslProgram, cameraName, renderTags);
         }
 
@@ -124,7 +129,8 @@ private:
     //These methods are not exposed to the interface
     //They are also not possible to add to render pipeline, so a method should be created and assigned.
     std::function<std::vector<size_t>(Light::LightTypes)> getLightsByType;
-    std::function<void(unsigned int, unsigned int, std::shared_ptr<GraphicsProgram>)> renderLight;
+    std::function<void(unsigned int, unsigned int, ShadowUpdateScheduler::ShadowCasters, std::shared_ptr<GraphicsProgram>)> renderLight;
+    std::function<bool(unsigned int, unsigned int, uint64_t&)> isShadowLayerScheduled;
 
     /**
      * Always returns a method, even if not found. If not found, the parameter is set to false.
@@ -174,10 +180,40 @@ private:
         return getLightsByType(lightType);
     }
 
-    std::function<void(unsigned int, unsigned int, std::shared_ptr<GraphicsProgram>)>& getRenderLightMethod() {
+    std::function<void(unsigned int, unsigned int, ShadowUpdateScheduler::ShadowCasters, std::shared_ptr<GraphicsProgram>)>& getRenderLightMethod() {
         return renderLight;
     }
 
+    static std::shared_ptr<ShadowMapCache> createShadowMapCache(GraphicsInterface* graphicsWrapper, const std::shared_ptr<Texture> &shadowMap, uint32_t layersPerGroup) {
+        if(shadowMap == nullptr) {
+            return nullptr;
+        }
+        bool cacheEnabled = graphicsWrapper->getOptions()->getOption<bool>(HASH("shadowStaticCache")).getOrDefault(true);
+        return std::make_shared<ShadowMapCache>(graphicsWrapper, shadowMap, layersPerGroup, cacheEnabled);
+    }
+
+    /**
+     * Renders a layer of a light if it is scheduled, or it was never rendered to this map. Static casters are copied
+     * from the cache if they didn't change since they are cached, otherwise they are rendered and cached again.
+     */
+    void renderShadowLayer(GraphicsPipelineStage &stage, ShadowMapCache &shadowMapCache, size_t lightIndex, uint32_t lightLayer,
+                           uint32_t group, const std::shared_ptr<GraphicsProgram> &renderProgram) const {
+        uint64_t staticVersion;
+        bool scheduled = isShadowLayerScheduled(lightIndex, lightLayer, staticVersion);
+        if(!scheduled && shadowMapCache.isRendered(group)) {
+            return;
+        }
+        if(shadowMapCache.restore(group, staticVersion)) {
+            shadowMapCache.attachForRender(stage, group);
+            renderLight(lightIndex, lightLayer, ShadowUpdateScheduler::ShadowCasters::DYNAMIC, renderProgram);
+            return;
+        }
+        shadowMapCache.clearForRender(stage, group);
+        renderLight(lightIndex, lightLayer, ShadowUpdateScheduler::ShadowCasters::STATIC, renderProgram);
+        shadowMapCache.store(group, staticVersion);
+        renderLight(lightIndex, lightLayer, ShadowUpdateScheduler::ShadowCasters::DYNAMIC, renderProgram);
+    }
+
     RenderMethod getBuiltInRenderMethod(const std::string& methodName, const std::shared_ptr<GraphicsProgram>& glslProgram, bool& isFound) const {
         uint32_t priority = 0;
         std::function<void(const std::shared_ptr<GraphicsProgram>&, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]])> method = getRenderMethodByName(methodName, isFound, priority);
@@ -225,11 +261,15 @@ public:
         return getBuiltInRenderMethod(methodName, glslProgram, isFound);
     }
 
+    /**
+     * Only the layers that are scheduled are cleared and rendered, rest keep the last render. Stage should not clear.
+     */
     RenderMethod getRenderMethodAllDirectionalLights(std::shared_ptr<GraphicsPipelineStage> &stage, std::shared_ptr<Texture> &layeredDepthMap,
                                                      const std::shared_ptr<GraphicsProgram> &glslProgram,
                                                      OptionsUtil::Options *options) const {
 
         OptionsUtil::Options::Option<long> optionNewSet = options->getOption<long>(HASH("CascadeCount"));
+        std::shared_ptr<ShadowMapCache> shadowMapCache = createShadowMapCache(stage->getGraphicsWrapper(), layeredDepthMap, 1);
         return RenderMethod("All directional shadows",
                             1,
                             nullptr,
@@ -240,16 +280,12 @@ public:
                                 if(lights.size() > 1) {
                                     std::cerr << "only one directional light is supported since CSM, this will not work correctly" << std::endl;
                                 }
-                                if(lights.empty() ) {
+                                if(lights.empty() || shadowMapCache == nullptr) {
                                     return;
                                 }
-                                for (int i = 0; i < cascadeCount; ++i) {
-                                        stage->setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, layeredDepthMap, true, i);
-                                }
                                 size_t lightId = lights[0];
-                                for (int i = 0; i < cascadeCount; ++i) {
-                                    stage->setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, layeredDepthMap, false, i);
-                                    renderLight(lightId, i, renderProgram);
+                                for (int i = 0; i < cascadeCount && (uint32_t)i < shadowMapCache->getGroupCount(); ++i) {
+                                    renderShadowLayer(*stage, *shadowMapCache, lightId, i, i, renderProgram);
                                 }
 
                             },
@@ -258,21 +294,29 @@ public:
         );
     }
 
-    RenderMethod getRenderMethodAllPointLights(const std::shared_ptr<GraphicsProgram>& glslProgram) const {
+    /**
+     * Point light shadows are layered renders of 6 faces, light index selects the faces in the cube map array.
+     * Only the lights that are scheduled are cleared and rendered, rest keep the last render. Stage should not clear.
+     */
+    RenderMethod getRenderMethodAllPointLights(std::shared_ptr<GraphicsPipelineStage> &stage, std::shared_ptr<Texture> &cubeDepthMap,
+                                               const std::shared_ptr<GraphicsProgram>& glslProgram) const {
+        std::shared_ptr<ShadowMapCache> shadowMapCache = createShadowMapCache(stage->getGraphicsWrapper(), cubeDepthMap, 6);
         return RenderMethod("All point shadows",
                             1,
                             nullptr,
-                            [&] (const std::shared_ptr<GraphicsProgram> &renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) {
+                            [=] (const std::shared_ptr<GraphicsProgram> &renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) {
+                                if(shadowMapCache == nullptr) {
+                                    return;
+                                }
                                 std::vector<size_t> lights = getLightIndexes(Light::LightTypes::POINT);
                                 for (size_t light:lights) {
-                                    renderLight(light, 0, renderProgram);
+                                    renderShadowLayer(*stage, *shadowMapCache, light, 0, light, renderProgram);
                                 }
                             },
                             nullptr,
                             glslProgram);
     }
 
-
 };
 
 #endif //LIMONENGINE_RENDERMETHODS_H
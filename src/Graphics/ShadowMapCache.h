@@ -0,0 +1,118 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_SHADOWMAPCACHE_H
+#define LIMONENGINE_SHADOWMAPCACHE_H
+
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Texture.h"
+#include "GraphicsPipelineStage.h"
+#include "ShadowUpdateScheduler.h"
+
+/**
+ * Keeps a copy of a shadow map with only static casters, so static casters are not re-rendered every time a dynamic
+ * caster moves. Shadow map layers are grouped per render, 1 layer per cascade, 6 layer-faces per point light.
+ *
+ * Cached groups are tagged with the static version of the scheduler. If backend can't copy depth layers, or caching
+ * is disabled, nothing is cached and static casters are rendered with the dynamic ones.
+ */
+class ShadowMapCache {
+    GraphicsInterface* graphicsWrapper;
+    std::shared_ptr<Texture> shadowMap;
+    std::shared_ptr<Texture> staticCache;//created on first store
+    uint32_t layersPerGroup;
+    std::vector<uint64_t> cachedVersions;
+    std::vector<bool> renderedGroups;//shadow map has a render for the group, so it can be skipped
+    bool cacheEnabled;
+
+    bool copyGroup(const std::shared_ptr<Texture> &source, const std::shared_ptr<Texture> &destination, uint32_t group) {
+        return graphicsWrapper->copyDepthLayers(source->getTextureID(), destination->getTextureID(), shadowMap->getType(),
+                                                group * layersPerGroup, layersPerGroup,
+                                                shadowMap->getCurrentWidth(), shadowMap->getCurrentHeight());
+    }
+
+public:
+    ShadowMapCache(GraphicsInterface *graphicsWrapper, const std::shared_ptr<Texture> &shadowMap, uint32_t layersPerGroup, bool cacheEnabled) :
+            graphicsWrapper(graphicsWrapper), shadowMap(shadowMap), layersPerGroup(layersPerGroup), cacheEnabled(cacheEnabled) {
+        uint32_t groupCount = shadowMap->getTextureInfo().depth / layersPerGroup;
+        cachedVersions.resize(groupCount, ShadowUpdateScheduler::EMPTY_VERSION);
+        renderedGroups.resize(groupCount, false);
+    }
+
+    uint32_t getGroupCount() const {
+        return (uint32_t)renderedGroups.size();
+    }
+
+    bool isRendered(uint32_t group) const {
+        return group < renderedGroups.size() && renderedGroups[group];
+    }
+
+    /**
+     * Clears the layers of the group and attaches them for rendering.
+     */
+    void clearForRender(GraphicsPipelineStage &stage, uint32_t group) {
+        if(layersPerGroup == 1) {
+            stage.setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, shadowMap, true, group);
+            return;
+        }
+        for (uint32_t layer = group * layersPerGroup; layer < (group + 1) * layersPerGroup; ++layer) {
+            stage.setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, shadowMap, true, layer);
+        }
+        attachForRender(stage, group);
+    }
+
+    void attachForRender(GraphicsPipelineStage &stage, uint32_t group) {
+        if(layersPerGroup == 1) {
+            stage.setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, shadowMap, false, group);
+        } else {
+            //groups with multiple layers are rendered with layered rendering, so all layers are attached
+            stage.setOutput(GraphicsInterface::FrameBufferAttachPoints::DEPTH, shadowMap, false);
+        }
+    }
+
+    /**
+     * Copies the static casters of the group to the shadow map, if the cache has the given version.
+     */
+    bool restore(uint32_t group, uint64_t staticVersion) {
+        if(group >= cachedVersions.size() || staticVersion == ShadowUpdateScheduler::EMPTY_VERSION ||
+           cachedVersions[group] != staticVersion) {
+            return false;
+        }
+        if(!copyGroup(staticCache, shadowMap, group)) {
+            cachedVersions[group] = ShadowUpdateScheduler::EMPTY_VERSION;
+            return false;
+        }
+        renderedGroups[group] = true;
+        return true;
+    }
+
+    /**
+     * Called when the shadow map of the group has only the static casters rendered.
+     */
+    void store(uint32_t group, uint64_t staticVersion) {
+        if(group >= renderedGroups.size()) {
+            return;
+        }
+        renderedGroups[group] = true;
+        if(!cacheEnabled) {
+            return;
+        }
+        if(staticCache == nullptr) {
+            staticCache = std::make_shared<Texture>(graphicsWrapper, shadowMap->getTextureInfo());
+        }
+        if(copyGroup(shadowMap, staticCache, group)) {
+            cachedVersions[group] = staticVersion;
+        } else {
+            std::cerr << "Shadow map " << shadowMap->getName() << " can't be cached, static casters will be rendered on each update." << std::endl;
+            cacheEnabled = false;
+            staticCache = nullptr;
+        }
+    }
+};
+
+
+#endif //LIMONENGINE_SHADOWMAPCACHE_H
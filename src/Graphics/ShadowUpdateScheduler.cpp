@@ -0,0 +1,168 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <algorithm>
+#include "ShadowUpdateScheduler.h"
+
+const uint64_t ShadowUpdateScheduler::EMPTY_VERSION;
+
+ShadowUpdateScheduler::LayerState &ShadowUpdateScheduler::getState(uint32_t slot, uint32_t layer) {
+    if(slots.size() <= slot) {
+        slots.resize(slot + 1);
+    }
+    if(slots[slot].size() <= layer) {
+        slots[slot].resize(layer + 1);
+    }
+    return slots[slot][layer];
+}
+
+uint32_t ShadowUpdateScheduler::selectCascadesToRecalculate(uint32_t cascadeCount, bool playerCameraChanged) {
+    uint32_t allCascades = cascadeCount >= 32 ? 0xFFFFFFFFu : (1u << cascadeCount) - 1;
+    if(cascadeLastRecalculation.size() != cascadeCount) {
+        cascadeLastRecalculation.assign(cascadeCount, frame);
+        return allCascades;
+    }
+    if(!playerCameraChanged || cascadeCount == 0) {
+        return 0;
+    }
+    if(farUpdateInterval <= 1) {
+        std::fill(cascadeLastRecalculation.begin(), cascadeLastRecalculation.end(), frame);
+        return allCascades;
+    }
+    uint32_t cascadeMask = 1;
+    cascadeLastRecalculation[0] = frame;
+    uint32_t oldestCascade = 0;
+    for (uint32_t cascade = 1; cascade < cascadeCount; ++cascade) {
+        if(frame - cascadeLastRecalculation[cascade] < farUpdateInterval) {
+            continue;
+        }
+        if(oldestCascade == 0 || cascadeLastRecalculation[cascade] < cascadeLastRecalculation[oldestCascade]) {
+            oldestCascade = cascade;
+        }
+    }
+    if(oldestCascade != 0) {
+        cascadeMask |= 1u << oldestCascade;
+        cascadeLastRecalculation[oldestCascade] = frame;
+    }
+    return cascadeMask;
+}
+
+void ShadowUpdateScheduler::beginFrame(const std::vector<uint32_t> &movingCasterIDs, bool staticCastersChanged) {
+    frame++;
+    this->movingCasterIDs = movingCasterIDs;
+    std::sort(this->movingCasterIDs.begin(), this->movingCasterIDs.end());
+    this->staticCastersChanged = staticCastersChanged;
+    for (std::vector<LayerState> &slot : slots) {
+        for (LayerState &state : slot) {
+            state.seen = false;
+            state.scheduled = false;
+            state.statistics.updatedThisFrame = false;
+        }
+    }
+}
+
+void ShadowUpdateScheduler::addLayer(uint32_t slot, uint32_t layer, const Light *light, const glm::mat4 &shadowMatrix,
+                                     bool near, const std::vector<uint32_t> &visibleMovingCasters) {
+    LayerState &state = getState(slot, layer);
+    state.seen = true;
+    state.near = near;
+    state.urgent = false;
+    if(state.light != light) {
+        //map has the shadow of another light
+        state.light = light;
+        state.statistics = LayerStatistics();
+        state.renderedDynamicCasters.clear();
+        state.staticPending = true;
+        state.urgent = true;
+    }
+    if(state.shadowMatrix != shadowMatrix) {
+        //light moved, or cascade is recalculated. Shader already uses the new matrix
+        state.shadowMatrix = shadowMatrix;
+        state.staticPending = true;
+        state.urgent = true;
+    }
+    if(staticCastersChanged) {
+        state.staticPending = true;
+    }
+    if(!visibleMovingCasters.empty()) {
+        state.dynamicPending = true;
+    } else {
+        //casters that moved out of range should be removed from the map too
+        for (uint32_t casterID : movingCasterIDs) {
+            if(std::binary_search(state.renderedDynamicCasters.begin(), state.renderedDynamicCasters.end(), casterID)) {
+                state.dynamicPending = true;
+                break;
+            }
+        }
+    }
+}
+
+void ShadowUpdateScheduler::schedule() {
+    candidates.clear();
+    uint32_t usedBudget = 0;
+    for (std::vector<LayerState> &slot : slots) {
+        for (LayerState &state : slot) {
+            if(!state.seen) {
+                //slot is not used this frame, whatever light is assigned to it next should be rendered
+                state.light = nullptr;
+                continue;
+            }
+            if(!state.staticPending && !state.dynamicPending) {
+                continue;
+            }
+            if(state.urgent) {
+                state.scheduled = true;
+                usedBudget++;
+            } else if(isDue(state)) {
+                candidates.push_back(&state);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const LayerState* first, const LayerState* second) {
+        if(first->near != second->near) {
+            return first->near;
+        }
+        return first->lastUpdateFrame < second->lastUpdateFrame;
+    });
+    for (LayerState *candidate : candidates) {
+        if(budget != 0 && usedBudget >= budget) {
+            break;
+        }
+        candidate->scheduled = true;
+        usedBudget++;
+    }
+
+    for (std::vector<LayerState> &slot : slots) {
+        for (LayerState &state : slot) {
+            if(!state.scheduled) {
+                continue;
+            }
+            if(state.staticPending) {
+                state.staticVersion = nextStaticVersion++;
+                state.statistics.staticUpdateCount++;
+            }
+            state.statistics.updateCount++;
+            state.statistics.updatedThisFrame = true;
+            state.lastUpdateFrame = frame;
+            state.staticPending = false;
+            state.dynamicPending = false;
+        }
+    }
+}
+
+void ShadowUpdateScheduler::setRenderedDynamicCasters(uint32_t slot, uint32_t layer, const std::vector<uint32_t> &casterIDs) {
+    if(slot >= slots.size() || layer >= slots[slot].size()) {
+        return;
+    }
+    slots[slot][layer].renderedDynamicCasters = casterIDs;
+}
+
+bool ShadowUpdateScheduler::isScheduled(uint32_t slot, uint32_t layer, uint64_t &staticVersion) const {
+    if(slot >= slots.size() || layer >= slots[slot].size()) {
+        staticVersion = EMPTY_VERSION;
+        return false;
+    }
+    staticVersion = slots[slot][layer].staticVersion;
+    return slots[slot][layer].scheduled;
+}
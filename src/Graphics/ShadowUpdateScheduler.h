@@ -0,0 +1,136 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_SHADOWUPDATESCHEDULER_H
+#define LIMONENGINE_SHADOWUPDATESCHEDULER_H
+
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Light;
+
+/**
+ * Decides which shadow map layers are rendered each frame. A layer is a cascade for directional lights, and the whole
+ * cube for point lights, since all 6 faces are rendered in one pass.
+ *
+ * Casters are split in two:
+ *  - static: models without mass that are not animated. They are rendered once to a cache, and only re-rendered when
+ *    the static version of the layer changes. Light moving, cascade recalculation, or any static model moving changes it.
+ *  - dynamic: everything else. They are rendered on top of the cache when any of them moves in range of the layer.
+ *
+ * Layers that need update are rendered immediately if the shadow would be wrong otherwise (light of the slot changed,
+ * or its matrix changed). Rest are limited by budget, near ones first, then the far ones that waited at least the far
+ * interval. Each group is sorted by last update, so layers left over are round robined on the following frames.
+ *
+ * Doesn't use any graphics calls, World feeds the lights and moved casters each frame.
+ */
+class ShadowUpdateScheduler {
+public:
+    enum class ShadowCasters { ALL, STATIC, DYNAMIC };
+    static const uint64_t EMPTY_VERSION = 0;//no static version is ever this, so empty caches never match
+
+    struct LayerStatistics {
+        uint64_t updateCount = 0;
+        uint64_t staticUpdateCount = 0;
+        bool updatedThisFrame = false;
+    };
+
+private:
+    struct LayerState {
+        const Light* light = nullptr;
+        glm::mat4 shadowMatrix = glm::mat4(0.0f);
+        uint64_t staticVersion = EMPTY_VERSION;
+        uint64_t lastUpdateFrame = 0;
+        std::vector<uint32_t> renderedDynamicCasters;//dynamic casters in the map, from the last update. Sorted
+        LayerStatistics statistics;
+        bool staticPending = true;
+        bool dynamicPending = false;
+        bool urgent = false;
+        bool near = false;
+        bool seen = false;//added this frame
+        bool scheduled = false;
+    };
+
+    std::vector<std::vector<LayerState>> slots;//per active light index, per layer
+    std::vector<uint32_t> movingCasterIDs;//sorted
+    std::vector<uint32_t> cascadeLastRecalculation;
+    std::vector<LayerState*> candidates;
+    uint64_t frame = 0;
+    uint64_t nextStaticVersion = EMPTY_VERSION + 1;
+    uint32_t budget = 0;
+    uint32_t farUpdateInterval = 1;
+    bool staticCastersChanged = false;
+
+    LayerState& getState(uint32_t slot, uint32_t layer);
+
+    bool isDue(const LayerState &state) const {
+        return state.near || frame - state.lastUpdateFrame >= farUpdateInterval;
+    }
+
+public:
+    /**
+     * budget is the number of layers rendered per frame, 0 means unlimited. Layers that would be wrong are rendered
+     * even if budget is used up. farUpdateInterval is in frames, for the layers that are not near the player.
+     */
+    void setLimits(uint32_t budget, uint32_t farUpdateInterval) {
+        this->budget = budget;
+        this->farUpdateInterval = farUpdateInterval == 0 ? 1 : farUpdateInterval;
+    }
+
+    /**
+     * Called before the directional light steps. Cascade 0 is recalculated whenever the camera moves,
+     * further cascades are recalculated one per frame, oldest first, if they waited for the far interval.
+     * @return bitmask of the cascades to recalculate
+     */
+    uint32_t selectCascadesToRecalculate(uint32_t cascadeCount, bool playerCameraChanged);
+
+    /**
+     * Starts the decisions of this frame.
+     * @param movingCasterIDs       dynamic casters that moved or changed pose this frame
+     * @param staticCastersChanged  a static caster moved, added or removed. All static caches are invalidated.
+     */
+    void beginFrame(const std::vector<uint32_t> &movingCasterIDs, bool staticCastersChanged);
+
+    /**
+     * Adds a layer of an active light. Slot is the index of the light in active lights.
+     * @param visibleMovingCasters moving casters in range of the layer this frame, sorted
+     */
+    void addLayer(uint32_t slot, uint32_t layer, const Light *light, const glm::mat4 &shadowMatrix, bool near,
+                  const std::vector<uint32_t> &visibleMovingCasters);
+
+    /**
+     * Selects the layers to render this frame, slots that are not added this frame are released.
+     */
+    void schedule();
+
+    /**
+     * Dynamic casters the scheduled layer renders this frame. A caster in the map moving later, even out of the layer,
+     * updates the layer.
+     * @param casterIDs sorted
+     */
+    void setRenderedDynamicCasters(uint32_t slot, uint32_t layer, const std::vector<uint32_t> &casterIDs);
+
+    /**
+     * @param staticVersion caches that have this version can be used instead of rendering static casters
+     * @return true if the layer should be rendered this frame
+     */
+    bool isScheduled(uint32_t slot, uint32_t layer, uint64_t &staticVersion) const;
+
+    uint32_t getSlotCount() const {
+        return (uint32_t)slots.size();
+    }
+
+    uint32_t getLayerCount(uint32_t slot) const {
+        return slot < slots.size() ? (uint32_t)slots[slot].size() : 0;
+    }
+
+    const LayerStatistics& getStatistics(uint32_t slot, uint32_t layer) const {
+        return slots[slot][layer].statistics;
+    }
+};
+
+
+#endif //LIMONENGINE_SHADOWUPDATESCHEDULER_H
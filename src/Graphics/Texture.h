@@ -63,7 +63,7 @@ public:
     }
 
     Texture(GraphicsInterface* graphicsWrapper, GraphicsInterface::TextureTypes textureType, GraphicsInterface::InternalFormatTypes internalFormat, GraphicsInterface::FormatTypes format, GraphicsInterface::DataTypes dataType, uint32_t width, uint32_t height, uint32_t depth = 0)
-            : graphicsWrapper(graphicsWrapper) {
+            : graphicsWrapper(graphicsWrapper), height(height), width(width) {
         textureInfo.textureType = textureType;
         textureInfo.internalFormatType = internalFormat;
         textureInfo.formatType = format;
@@ -78,6 +78,16 @@ public:
         graphicsWrapper->loadTextureData(this->textureID, textureInfo.defaultSize[1], textureInfo.defaultSize[0], textureInfo.textureType, textureInfo.internalFormatType, textureInfo.formatType, textureInfo.dataType, textureInfo.depth, data, data2, data3, data4, data5, data6);
     }
 
+    /**
+     * Updates part of a 2D texture, returns false if the backend can't, loadData should be used then.
+     */
+    bool loadDataRegion(const void *data, int32_t x, int32_t y, uint32_t regionWidth, uint32_t regionHeight) {
+        if(textureInfo.textureType != GraphicsInterface::TextureTypes::T2D) {
+            return false;
+        }
+        return graphicsWrapper->loadTextureData2DRegion(this->textureID, x, y, regionWidth, regionHeight, textureInfo.formatType, textureInfo.dataType, data);
+    }
+
     ~Texture() {
         graphicsWrapper->deleteTexture(textureID);
     }
@@ -137,6 +147,17 @@ public:
         return textureInfo.defaultSize[0];
     }
 
+    /**
+     * Size the texture is created with, after the size options are applied. getHeight() and getWidth() return the defaults.
+     */
+    uint32_t getCurrentHeight() const {
+        return height;
+    }
+
+    uint32_t getCurrentWidth() const {
+        return width;
+    }
+
     uint32_t getSerializeID() const {
         return textureInfo.serializeID;
     }
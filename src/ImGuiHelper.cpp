@@ -41,6 +41,8 @@ void ImGuiHelper::RenderDrawLists()
         {-1.0f,                  1.0f,                   0.0f, 1.0f },
     };
 
+    static const UniformHandle<int> isArrayUniform("isArray");
+    static const UniformHandle<float> layerUniform("layer");
     program->setUniform("Texture", 1);
     program->setUniform("TextureArray", 2);
     program->setUniform("TextureCubeArray", 3);
@@ -90,17 +92,17 @@ void ImGuiHelper::RenderDrawLists()
                     switch (imGuiImageWrapper->texture->getType()) {
                         case GraphicsInterface::TextureTypes::T2D:
                             graphicsWrapper->attachTexture(imGuiImageWrapper->texture->getTextureID(), 1);
-                            program->setUniform("isArray", 0);
+                            program->setUniform(isArrayUniform, 0);
                             break;
                         case GraphicsInterface::TextureTypes::T2D_ARRAY:
                             graphicsWrapper->attach2DArrayTexture(imGuiImageWrapper->texture->getTextureID(), 2);
-                            program->setUniform("isArray", 1);
-                            program->setUniform("layer", (float)imGuiImageWrapper->layer);
+                            program->setUniform(isArrayUniform, 1);
+                            program->setUniform(layerUniform, (float)imGuiImageWrapper->layer);
                             break;
                         case GraphicsInterface::TextureTypes::TCUBE_MAP_ARRAY:
                             graphicsWrapper->attachCubeMapArrayTexture(imGuiImageWrapper->texture->getTextureID(), 3);
-                            program->setUniform("isArray", 2);
-                            program->setUniform("layer", (float)imGuiImageWrapper->layer);
+                            program->setUniform(isArrayUniform, 2);
+                            program->setUniform(layerUniform, (float)imGuiImageWrapper->layer);
                             break;
                         default:
                             std::cerr << "Unsupported texture type for IMGUI" << std::endl;
@@ -920,6 +920,7 @@ bool PipelineExtension::buildRenderPipelineRecursive(const Node *node,
         //now handle outputs
         // Directional depth map requires layer settings therefore it is not set by us.
         std::shared_ptr<Texture> depthMapDirectional = nullptr;
+        std::shared_ptr<Texture> depthMapPoint = nullptr;
 
         for (const Connection *connection:node->getOutputConnections()) {
             auto programOutputsMap = stageProgram->getOutputMap();
@@ -942,6 +943,12 @@ bool PipelineExtension::buildRenderPipelineRecursive(const Node *node,
                         GraphicsInterface::TextureTypes::T2D_ARRAY) {
                         depthMapDirectional = stageExtension->getOutputTexture(connection);
                     }
+                    if (stageExtension->getOutputTexture(connection)->getFormat() ==
+                        GraphicsInterface::FormatTypes::DEPTH &&
+                        stageExtension->getOutputTexture(connection)->getType() ==
+                        GraphicsInterface::TextureTypes::TCUBE_MAP_ARRAY) {
+                        depthMapPoint = stageExtension->getOutputTexture(connection);
+                    }
                     // at this point, we have a problem. All programs have depth output mapped, because it is not possible at program level whether it should or not.
                     // but for some programs, it should not be, and it should be skipped.
                     if (frameBufferAttachmentPoint == GraphicsInterface::FrameBufferAttachPoints::DEPTH &&
@@ -957,9 +964,11 @@ bool PipelineExtension::buildRenderPipelineRecursive(const Node *node,
         if(stageExtension->getMethodName() == "All directional shadows") {
             RenderMethods::RenderMethod functionToCall = renderMethods.getRenderMethodAllDirectionalLights(stageInfo->stage, depthMapDirectional, stageProgram, options);
             stageInfo->addRenderMethod(functionToCall);
+            stageInfo->clear = false;//shadow methods clear the layers they update, rest are kept
         } else if(stageExtension->getMethodName() == "All point shadows") {
-            RenderMethods::RenderMethod functionToCall = renderMethods.getRenderMethodAllPointLights(stageProgram);
+            RenderMethods::RenderMethod functionToCall = renderMethods.getRenderMethodAllPointLights(stageInfo->stage, depthMapPoint, stageProgram);
             stageInfo->addRenderMethod(functionToCall);
+            stageInfo->clear = false;
         } else {
             bool isFound = true;
             RenderMethods::RenderMethod functionToCall = renderMethods.getRenderMethod(
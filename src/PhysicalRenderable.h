@@ -11,7 +11,7 @@
 #include "GameObjects/Sound.h"
 #include <memory>
 
-class PhysicalRenderable : public Renderable {
+class PhysicalRenderable : public Renderable, public Transformation::UpdateListener {
 protected:
     glm::mat4 centerOffsetMatrix;
     glm::vec3 centerOffset;//init by list for constructor
@@ -29,8 +29,7 @@ protected:
 public:
     explicit PhysicalRenderable(GraphicsInterface* graphicsWrapper, float mass, bool disconnected)
             : Renderable(graphicsWrapper), centerOffset(glm::vec3(0, 0, 0)), mass(mass), disconnected(disconnected) {
-        transformation.setGenerateWorldTransform(std::bind(&PhysicalRenderable::processTransformForPyhsics, this));
-        transformation.setUpdateCallback(std::bind(&PhysicalRenderable::updatePhysicsFromTransform, this));
+        transformation.setUpdateListener(this);
     };
 
     btRigidBody *getRigidBody() { return rigidBody; };
@@ -59,19 +58,8 @@ public:
     /**
      * If there were any change with transform, trigger this
      */
-    glm::mat4 processTransformForPyhsics() {
-        //if animated, then the transform information will be updated according to bone transforms. Then we apply current center offset
-        if(centerOffset.x == 0.0f && centerOffset.y == 0.0f && centerOffset.z == 0.0f) {
-            return glm::translate(glm::mat4(1.0f), transformation.getTranslateSingle()) * glm::mat4_cast(transformation.getOrientationSingle()) *
-                   glm::scale(glm::mat4(1.0f), transformation.getScaleSingle());
-        } else {
-            //difference is the center offset
-            return glm::translate(glm::mat4(1.0f), transformation.getTranslateSingle()) *
-                   glm::mat4_cast(transformation.getOrientationSingle()) *
-                   glm::scale(glm::mat4(1.0f), transformation.getScaleSingle()) *
-                   glm::translate(glm::mat4(1.0f), -1.0f * centerOffset);
-        }
-
+    void transformChanged() override {
+        updatePhysicsFromTransform();
     }
 
     virtual void updateTransformFromPhysics();
@@ -78,11 +78,28 @@ void SDL2Helper::initWindow(const char* title, const GraphicsInterface::ContextI
     std::cout << "SDL window started." << std::endl;
 }
 
+/**
+ * No window and no GL context. Drawable size is taken from options, so screen size dependent code behaves the same.
+ */
+void SDL2Helper::initHeadless() {
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) < 0) {
+        std::cout << "Unable to initialize SDL";
+        exit(1);
+    }
+    options->setDrawableHeight(options->getScreenHeight());
+    options->setDrawableWidth(options->getScreenWidth());
+    options->setWindowWidth(options->getScreenWidth());
+    options->setWindowHeight(options->getScreenHeight());
+    std::cout << "SDL started headless." << std::endl;
+}
+
 SDL2Helper::~SDL2Helper() {
     /* Delete our opengl context, destroy our window, and shutdown SDL */
-    SDL_ShowCursor(SDL_ENABLE);
-    SDL_GL_DeleteContext(context);
-    SDL_DestroyWindow(window);
+    if(window != nullptr) {
+        SDL_ShowCursor(SDL_ENABLE);
+        SDL_GL_DeleteContext(context);
+        SDL_DestroyWindow(window);
+    }
     SDL_Quit();
 }
 
@@ -19,8 +19,8 @@
 
 class SDL2Helper {
 private:
-    SDL_Window *window;
-    SDL_GLContext context;
+    SDL_Window *window = nullptr;
+    SDL_GLContext context = nullptr;
     OptionsUtil::Options* options;
 
 public:
@@ -29,9 +29,13 @@ public:
 
     SDL2Helper(OptionsUtil::Options* options);
     void initWindow(const char*, const GraphicsInterface::ContextInformation& contextInformation);
+    void initHeadless();
     ~SDL2Helper();
 
     void swap() {
+        if(window == nullptr) {
+            return;//headless, nothing to present
+        }
         SDL_GL_SwapWindow(window);
         options->setIsWindowInFocus(SDL_GetWindowFlags(window) & SDL_WINDOW_MOUSE_FOCUS);
     };
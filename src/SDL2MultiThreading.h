@@ -7,11 +7,18 @@
 
 #include <SDL_atomic.h>
 #include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_cpuinfo.h>
 #include <functional>
 #include <string>
 #include <vector>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <iostream>
 #include "API/LimonTypes.h"
+#include "Utils/Profiler.h"
 
 class SDL2MultiThreading {
 public:
@@ -164,6 +171,365 @@ public:
             SDL_WaitThread(thread, &threadReturnValue);
         }
     };
+
+    /**
+     * Fixed size work stealing job system.
+     *
+     * Each worker has its own queue, it pushes and pops from the back, and steals from the front of other queues when
+     * it runs out of work. Jobs submitted by non worker threads (ex. main thread) go to a shared queue.
+     *
+     * Background jobs are kept in a separate queue that only workers process, so long running work (AI routes, asset loads)
+     * never ends up on the main thread while it is helping with frame work in waitFor().
+     */
+    class JobSystem {
+    public:
+        /**
+         * Counts the unfinished jobs submitted with it. Jobs can be set to start after a counter reaches zero,
+         * which is how dependencies are expressed.
+         */
+        class Counter {
+            friend class JobSystem;
+            std::atomic<uint32_t> pending;
+            mutable SpinLock continuationLock;//decrements and continuations are protected by this lock
+            std::vector<std::pair<std::function<void()>, Counter*>> continuations;
+        public:
+            Counter() : pending(0) {}
+
+            /**
+             * When this returns true, no job system code touches the counter anymore, so it is safe to delete.
+             */
+            bool isDone() const {
+                if(pending.load(std::memory_order_acquire) != 0) {
+                    return false;
+                }
+                //last finisher might still be releasing the continuations, wait for it to unlock
+                continuationLock.lock();
+                continuationLock.unlock();
+                return true;
+            }
+        };
+
+    private:
+        struct Job {
+            std::function<void()> function;
+            Counter* counter = nullptr;
+        };
+
+        struct WorkQueue {
+            SpinLock lock;
+            std::deque<Job> jobs;
+
+            void pushBack(Job&& job) {
+                lock.lock();
+                jobs.emplace_back(std::move(job));
+                lock.unlock();
+            }
+
+            bool popBack(Job& job) {
+                lock.lock();
+                if(jobs.empty()) {
+                    lock.unlock();
+                    return false;
+                }
+                job = std::move(jobs.back());
+                jobs.pop_back();
+                lock.unlock();
+                return true;
+            }
+
+            bool popFront(Job& job) {
+                lock.lock();
+                if(jobs.empty()) {
+                    lock.unlock();
+                    return false;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                lock.unlock();
+                return true;
+            }
+        };
+
+        struct WorkerStartInfo {
+            JobSystem* jobSystem;
+            int32_t workerIndex;
+        };
+
+        struct ThreadInfo {
+            JobSystem* jobSystem = nullptr;
+            int32_t workerIndex = -1;
+        };
+
+        std::vector<WorkQueue*> workerQueues;
+        WorkQueue sharedQueue;
+        WorkQueue backgroundQueue;
+        std::vector<SDL_Thread*> workers;
+        std::vector<WorkerStartInfo> workerStartInfos;
+        std::atomic<int64_t> queuedJobCount;//signed, a job can be popped before the push increments it
+        std::atomic<int64_t> unfinishedJobCount;//queued or running
+        std::atomic<uint32_t> sleepingWorkerCount;
+        SDL_mutex* sleepMutex;
+        SDL_cond* jobCondition;
+        std::atomic<bool> running;
+
+        static ThreadInfo& getThreadInfo() {
+            static thread_local ThreadInfo threadInfo;
+            return threadInfo;
+        }
+
+        int32_t getCurrentWorkerIndex() const {
+            const ThreadInfo& threadInfo = getThreadInfo();
+            if(threadInfo.jobSystem != this) {
+                return -1;
+            }
+            return threadInfo.workerIndex;
+        }
+
+        static int workerRunner(void* ptr) {
+            WorkerStartInfo* startInfo = static_cast<WorkerStartInfo*>(ptr);
+            getThreadInfo().jobSystem = startInfo->jobSystem;
+            getThreadInfo().workerIndex = startInfo->workerIndex;
+            Profiler::setThreadName("JobWorker" + std::to_string(startInfo->workerIndex));
+            startInfo->jobSystem->workerLoop(startInfo->workerIndex);
+            return 0;
+        }
+
+        void workerLoop(int32_t workerIndex) {
+            Job job;
+            while(running.load(std::memory_order_acquire)) {
+                if(popJob(workerIndex, true, job)) {
+                    execute(job);
+                } else {
+                    sleepUntilJobQueued();
+                }
+            }
+        }
+
+        void sleepUntilJobQueued() {
+            SDL_LockMutex(sleepMutex);
+            //pushers check this after increasing the queued count, so either they signal, or the count is seen here
+            sleepingWorkerCount.fetch_add(1);
+            while(queuedJobCount.load() <= 0 && running.load()) {
+                SDL_CondWait(jobCondition, sleepMutex);
+            }
+            sleepingWorkerCount.fetch_sub(1);
+            SDL_UnlockMutex(sleepMutex);
+        }
+
+        void jobQueued() {
+            unfinishedJobCount.fetch_add(1);
+            queuedJobCount.fetch_add(1);
+            if(sleepingWorkerCount.load() != 0) {
+                SDL_LockMutex(sleepMutex);
+                SDL_CondSignal(jobCondition);
+                SDL_UnlockMutex(sleepMutex);
+            }
+        }
+
+        bool popJob(int32_t workerIndex, bool allowBackground, Job& job) {
+            if(popAnyQueue(workerIndex, allowBackground, job)) {
+                queuedJobCount.fetch_sub(1);
+                return true;
+            }
+            return false;
+        }
+
+        bool popAnyQueue(int32_t workerIndex, bool allowBackground, Job& job) {
+            if(workerIndex >= 0 && workerQueues[workerIndex]->popBack(job)) {
+                return true;
+            }
+            if(sharedQueue.popFront(job)) {
+                return true;
+            }
+            //steal, start from the next worker so all of them don't hit the same queue
+            uint32_t queueCount = workerQueues.size();
+            uint32_t startIndex = workerIndex >= 0 ? workerIndex + 1 : 0;
+            for (uint32_t i = 0; i < queueCount; ++i) {
+                uint32_t victimIndex = (startIndex + i) % queueCount;
+                if((int32_t)victimIndex == workerIndex) {
+                    continue;
+                }
+                if(workerQueues[victimIndex]->popFront(job)) {
+                    return true;
+                }
+            }
+            if(allowBackground && backgroundQueue.popFront(job)) {
+                return true;
+            }
+            return false;
+        }
+
+        void push(Job&& job) {
+            int32_t workerIndex = getCurrentWorkerIndex();
+            if(workerIndex >= 0) {
+                workerQueues[workerIndex]->pushBack(std::move(job));
+            } else {
+                sharedQueue.pushBack(std::move(job));
+            }
+            jobQueued();
+        }
+
+        void execute(Job& job) {
+            job.function();
+            job.function = nullptr;//release captures before signaling
+            if(job.counter != nullptr) {
+                finish(job.counter);
+            }
+            unfinishedJobCount.fetch_sub(1);//after finish, so continuations are already counted
+        }
+
+        void finish(Counter* counter) {
+            std::vector<std::pair<std::function<void()>, Counter*>> readyJobs;
+            counter->continuationLock.lock();
+            if(counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                //counter reached zero, release jobs waiting for it
+                readyJobs.swap(counter->continuations);
+            }
+            counter->continuationLock.unlock();//after this, counter can be deleted by the waiting thread
+            for (auto& readyJob: readyJobs) {
+                Job job;
+                job.function = std::move(readyJob.first);
+                job.counter = readyJob.second;
+                push(std::move(job));
+            }
+        }
+
+    public:
+        /**
+         * @param workerCount 0 means number of cores - 1, as main thread helps while waiting
+         */
+        explicit JobSystem(uint32_t workerCount = 0) : queuedJobCount(0), unfinishedJobCount(0), sleepingWorkerCount(0), running(true) {
+            if(workerCount == 0) {
+                int cpuCount = SDL_GetCPUCount();
+                workerCount = cpuCount > 1 ? cpuCount - 1 : 1;
+            }
+            sleepMutex = SDL_CreateMutex();
+            jobCondition = SDL_CreateCond();
+            workerStartInfos.resize(workerCount);
+            for (uint32_t i = 0; i < workerCount; ++i) {
+                workerQueues.push_back(new WorkQueue());
+            }
+            for (uint32_t i = 0; i < workerCount; ++i) {
+                workerStartInfos[i].jobSystem = this;
+                workerStartInfos[i].workerIndex = i;
+                std::string threadName = "JobWorker" + std::to_string(i);
+                SDL_Thread* thread = SDL_CreateThread(&workerRunner, threadName.c_str(), &workerStartInfos[i]);
+                if(thread == nullptr) {
+                    std::string error = SDL_GetError();
+                    std::cerr << "Job worker launch failure, with error" << error << std::endl;
+                    continue;
+                }
+                workers.push_back(thread);
+            }
+        }
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /**
+         * Runs all queued jobs, including background ones, before stopping the workers. Counters of the queued jobs
+         * reach zero, so nothing waiting on them hangs.
+         */
+        ~JobSystem() {
+            Job job;
+            while(unfinishedJobCount.load() > 0) {
+                if(popJob(-1, true, job)) {
+                    execute(job);
+                } else {
+                    std::this_thread::yield();//workers are running the last jobs
+                }
+            }
+            SDL_LockMutex(sleepMutex);
+            running.store(false, std::memory_order_release);
+            SDL_CondBroadcast(jobCondition);
+            SDL_UnlockMutex(sleepMutex);
+            for (SDL_Thread* worker: workers) {
+                int threadReturnValue;
+                SDL_WaitThread(worker, &threadReturnValue);
+            }
+            for (WorkQueue* workQueue: workerQueues) {
+                delete workQueue;
+            }
+            SDL_DestroyCond(jobCondition);
+            SDL_DestroyMutex(sleepMutex);
+        }
+
+        uint32_t getWorkerCount() const {
+            return workers.size();
+        }
+
+        void submit(std::function<void()> function, Counter* counter = nullptr) {
+            if(counter != nullptr) {
+                counter->pending.fetch_add(1, std::memory_order_acq_rel);
+            }
+            Job job;
+            job.function = std::move(function);
+            job.counter = counter;
+            push(std::move(job));
+        }
+
+        /**
+         * Low priority jobs, only workers run them, and only when there is no other work.
+         */
+        void submitBackground(std::function<void()> function, Counter* counter = nullptr) {
+            if(counter != nullptr) {
+                counter->pending.fetch_add(1, std::memory_order_acq_rel);
+            }
+            Job job;
+            job.function = std::move(function);
+            job.counter = counter;
+            backgroundQueue.pushBack(std::move(job));
+            jobQueued();
+        }
+
+        /**
+         * Submits the job after dependency is done. Counter is increased immediately, so waiting for it covers this job too.
+         */
+        void submitAfter(Counter* dependency, std::function<void()> function, Counter* counter = nullptr) {
+            if(counter != nullptr) {
+                counter->pending.fetch_add(1, std::memory_order_acq_rel);
+            }
+            dependency->continuationLock.lock();
+            if(dependency->pending.load(std::memory_order_acquire) != 0) {
+                dependency->continuations.emplace_back(std::move(function), counter);
+                dependency->continuationLock.unlock();
+                return;
+            }
+            dependency->continuationLock.unlock();
+            Job job;
+            job.function = std::move(function);
+            job.counter = counter;
+            push(std::move(job));
+        }
+
+        /**
+         * Splits [0, elementCount) to batches, and runs body(start, end) for each batch as a separate job.
+         */
+        void parallelFor(uint32_t elementCount, uint32_t batchSize, const std::function<void(uint32_t, uint32_t)>& body, Counter* counter) {
+            if(batchSize == 0) {
+                batchSize = 1;
+            }
+            for (uint32_t start = 0; start < elementCount; start += batchSize) {
+                uint32_t end = std::min(start + batchSize, elementCount);
+                submit([body, start, end]() { body(start, end); }, counter);
+            }
+        }
+
+        /**
+         * Blocks until counter is done. Calling thread runs jobs while waiting, but never background ones.
+         */
+        void waitFor(Counter* counter) {
+            int32_t workerIndex = getCurrentWorkerIndex();
+            Job job;
+            while(!counter->isDone()) {
+                if(popJob(workerIndex, false, job)) {
+                    execute(job);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
 };
 
 
@@ -0,0 +1,219 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+#include "TransformHierarchy.h"
+
+const uint32_t TransformHierarchy::INVALID_INDEX;
+
+TransformHierarchy &TransformHierarchy::getInstance() {
+    //never deleted, so transformations of static objects can still be destroyed at exit
+    static TransformHierarchy* instance = new TransformHierarchy();
+    return *instance;
+}
+
+uint32_t TransformHierarchy::create(Transformation *owner) {
+    uint32_t handle;
+    if(freeHandles.empty()) {
+        handle = (uint32_t) handleSlots.size();
+        handleSlots.push_back(INVALID_INDEX);
+    } else {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    }
+
+    //a new node is a root, so any slot keeps the order valid
+    uint32_t slot;
+    if(freeSlots.empty()) {
+        slot = (uint32_t) nodes.size();
+        nodes.emplace_back();
+        locals.emplace_back();
+        pivotOffsets.emplace_back();
+        rawWorldTransforms.emplace_back();
+        worldTransforms.emplace_back();
+        worldTRSs.emplace_back();
+    } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    nodes[slot] = Node();
+    nodes[slot].handle = handle;
+    nodes[slot].owner = owner;
+    locals[slot] = LocalTRS();
+    pivotOffsets[slot] = glm::vec3(0.0f, 0.0f, 0.0f);
+    handleSlots[handle] = slot;
+    return handle;
+}
+
+void TransformHierarchy::destroy(uint32_t handle) {
+    uint32_t slot = handleSlots[handle];
+    if(nodes[slot].parent != INVALID_INDEX) {
+        unlink(slot);
+    }
+    for (uint32_t child = nodes[slot].firstChild; child != INVALID_INDEX; ) {
+        uint32_t next = nodes[child].nextSibling;
+        nodes[child].parent = INVALID_INDEX;
+        nodes[child].nextSibling = INVALID_INDEX;
+        markSubtreeDirty(child);
+        child = next;
+    }
+    nodes[slot] = Node();
+    nodes[slot].dirty = false;//so update pass skips it
+    handleSlots[handle] = INVALID_INDEX;
+    freeSlots.push_back(slot);
+    freeHandles.push_back(handle);
+}
+
+void TransformHierarchy::unlink(uint32_t slot) {
+    Node& parentNode = nodes[nodes[slot].parent];
+    if(parentNode.firstChild == slot) {
+        parentNode.firstChild = nodes[slot].nextSibling;
+    } else {
+        uint32_t sibling = parentNode.firstChild;
+        while(sibling != INVALID_INDEX && nodes[sibling].nextSibling != slot) {
+            sibling = nodes[sibling].nextSibling;
+        }
+        if(sibling != INVALID_INDEX) {
+            nodes[sibling].nextSibling = nodes[slot].nextSibling;
+        }
+    }
+    nodes[slot].parent = INVALID_INDEX;
+    nodes[slot].nextSibling = INVALID_INDEX;
+}
+
+void TransformHierarchy::setParent(uint32_t handle, uint32_t parentHandle) {
+    uint32_t slot = handleSlots[handle];
+    if(nodes[slot].parent != INVALID_INDEX) {
+        unlink(slot);
+    }
+    if(parentHandle != INVALID_INDEX) {
+        uint32_t parentSlot = handleSlots[parentHandle];
+        nodes[slot].parent = parentSlot;
+        //append, so children are visited in the order they are attached
+        if(nodes[parentSlot].firstChild == INVALID_INDEX) {
+            nodes[parentSlot].firstChild = slot;
+        } else {
+            uint32_t lastChild = nodes[parentSlot].firstChild;
+            while(nodes[lastChild].nextSibling != INVALID_INDEX) {
+                lastChild = nodes[lastChild].nextSibling;
+            }
+            nodes[lastChild].nextSibling = slot;
+        }
+        if(parentSlot > slot) {
+            orderDirty = true;
+        }
+    }
+    markSubtreeDirty(slot);
+}
+
+void TransformHierarchy::getChildren(uint32_t handle, std::vector<Transformation *> &children) const {
+    children.clear();
+    for (uint32_t child = nodes[handleSlots[handle]].firstChild; child != INVALID_INDEX; child = nodes[child].nextSibling) {
+        children.push_back(nodes[child].owner);
+    }
+}
+
+void TransformHierarchy::markSubtreeDirty(uint32_t slot) {
+    //a dirty node never has clean descendants, so there is nothing to do below it
+    if(nodes[slot].dirty) {
+        return;
+    }
+    nodes[slot].dirty = true;
+    for (uint32_t child = nodes[slot].firstChild; child != INVALID_INDEX; child = nodes[child].nextSibling) {
+        markSubtreeDirty(child);
+    }
+}
+
+void TransformHierarchy::compute(uint32_t slot) {
+    const LocalTRS& local = locals[slot];
+    glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), local.translate) * glm::mat4_cast(local.orientation) *
+                               glm::scale(glm::mat4(1.0f), local.scale);
+    uint32_t parentSlot = nodes[slot].parent;
+    if(parentSlot == INVALID_INDEX) {
+        rawWorldTransforms[slot] = localTransform;
+        worldTRSs[slot] = local;
+    } else {
+        rawWorldTransforms[slot] = rawWorldTransforms[parentSlot] * localTransform;
+        glm::vec3 temp1;//these are not used
+        glm::vec4 temp2;
+        LocalTRS& world = worldTRSs[slot];
+        glm::decompose(rawWorldTransforms[slot], world.scale, world.orientation, world.translate, temp1, temp2);
+    }
+    const glm::vec3& pivotOffset = pivotOffsets[slot];
+    if(pivotOffset.x == 0.0f && pivotOffset.y == 0.0f && pivotOffset.z == 0.0f) {
+        worldTransforms[slot] = rawWorldTransforms[slot];
+    } else {
+        worldTransforms[slot] = rawWorldTransforms[slot] * glm::translate(glm::mat4(1.0f), -1.0f * pivotOffset);
+    }
+    nodes[slot].dirty = false;
+}
+
+void TransformHierarchy::rebuildOrder() {
+    //depth first from each root, so every subtree ends up in a continuous range after its parent
+    std::vector<uint32_t> newOrder;
+    newOrder.reserve(nodes.size() - freeSlots.size());
+    std::vector<uint32_t> stack;
+    for (uint32_t rootSlot = 0; rootSlot < nodes.size(); ++rootSlot) {
+        if(nodes[rootSlot].owner == nullptr || nodes[rootSlot].parent != INVALID_INDEX) {
+            continue;
+        }
+        stack.push_back(rootSlot);
+        while(!stack.empty()) {
+            uint32_t slot = stack.back();
+            stack.pop_back();
+            newOrder.push_back(slot);
+            for (uint32_t child = nodes[slot].firstChild; child != INVALID_INDEX; child = nodes[child].nextSibling) {
+                stack.push_back(child);
+            }
+        }
+    }
+
+    std::vector<uint32_t> oldToNew(nodes.size(), INVALID_INDEX);
+    for (uint32_t newSlot = 0; newSlot < newOrder.size(); ++newSlot) {
+        oldToNew[newOrder[newSlot]] = newSlot;
+    }
+    auto remap = [&oldToNew](uint32_t slot) {
+        return slot == INVALID_INDEX ? INVALID_INDEX : oldToNew[slot];
+    };
+
+    std::vector<Node> newNodes(newOrder.size());
+    std::vector<LocalTRS> newLocals(newOrder.size());
+    std::vector<glm::vec3> newPivotOffsets(newOrder.size());
+    std::vector<glm::mat4> newRawWorldTransforms(newOrder.size());
+    std::vector<glm::mat4> newWorldTransforms(newOrder.size());
+    std::vector<LocalTRS> newWorldTRSs(newOrder.size());
+    for (uint32_t newSlot = 0; newSlot < newOrder.size(); ++newSlot) {
+        uint32_t oldSlot = newOrder[newSlot];
+        newNodes[newSlot] = nodes[oldSlot];
+        newNodes[newSlot].parent = remap(nodes[oldSlot].parent);
+        newNodes[newSlot].firstChild = remap(nodes[oldSlot].firstChild);
+        newNodes[newSlot].nextSibling = remap(nodes[oldSlot].nextSibling);
+        newLocals[newSlot] = locals[oldSlot];
+        newPivotOffsets[newSlot] = pivotOffsets[oldSlot];
+        newRawWorldTransforms[newSlot] = rawWorldTransforms[oldSlot];
+        newWorldTransforms[newSlot] = worldTransforms[oldSlot];
+        newWorldTRSs[newSlot] = worldTRSs[oldSlot];
+        handleSlots[nodes[oldSlot].handle] = newSlot;
+    }
+    nodes.swap(newNodes);
+    locals.swap(newLocals);
+    pivotOffsets.swap(newPivotOffsets);
+    rawWorldTransforms.swap(newRawWorldTransforms);
+    worldTransforms.swap(newWorldTransforms);
+    worldTRSs.swap(newWorldTRSs);
+    freeSlots.clear();//dead slots are dropped
+    orderDirty = false;
+}
+
+void TransformHierarchy::update() {
+    if(orderDirty) {
+        rebuildOrder();
+    }
+    for (uint32_t slot = 0; slot < nodes.size(); ++slot) {
+        if(nodes[slot].dirty) {
+            compute(slot);
+        }
+    }
+}
@@ -0,0 +1,153 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_TRANSFORMHIERARCHY_H
+#define LIMONENGINE_TRANSFORMHIERARCHY_H
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+class Transformation;
+
+/**
+ * Keeps transform data of all Transformation objects in flat arrays, sorted so a parent is always before its children.
+ * Transformations only keep a handle, because slots move when the order is rebuilt.
+ *
+ * A change marks the node and its subtree dirty. Reads resolve a dirty node using the cached matrix of its parent, so
+ * a query costs one matrix multiply instead of walking the whole parent chain. update() cleans all remaining dirty
+ * nodes in one linear pass, it is called once per frame before culling jobs start reading transforms.
+ *
+ * It is not thread safe. Transformations are created and changed on the main thread only.
+ */
+class TransformHierarchy {
+public:
+    static const uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    struct LocalTRS {
+        glm::vec3 translate = glm::vec3(0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+        glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    };
+
+private:
+    struct Node {
+        uint32_t parent = INVALID_INDEX;//these 3 are slots
+        uint32_t firstChild = INVALID_INDEX;
+        uint32_t nextSibling = INVALID_INDEX;
+        uint32_t handle = INVALID_INDEX;
+        Transformation* owner = nullptr;
+        bool dirty = true;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<LocalTRS> locals;
+    std::vector<glm::vec3> pivotOffsets;
+    std::vector<glm::mat4> rawWorldTransforms;//without pivot, this is what children are relative to
+    std::vector<glm::mat4> worldTransforms;
+    std::vector<LocalTRS> worldTRSs;//decomposed raw world transform, same as local for roots
+
+    std::vector<uint32_t> handleSlots;
+    std::vector<uint32_t> freeHandles;
+    std::vector<uint32_t> freeSlots;
+    bool orderDirty = false;
+
+    TransformHierarchy() = default;
+
+    void markSubtreeDirty(uint32_t slot);
+    void compute(uint32_t slot);
+    void unlink(uint32_t slot);
+    void rebuildOrder();
+
+    void resolve(uint32_t slot) {
+        if(!nodes[slot].dirty) {
+            return;
+        }
+        if(nodes[slot].parent != INVALID_INDEX) {
+            resolve(nodes[slot].parent);
+        }
+        compute(slot);
+    }
+
+public:
+    static TransformHierarchy& getInstance();
+
+    uint32_t create(Transformation* owner);
+
+    /**
+     * Node should not have a parent or children at this point.
+     */
+    void destroy(uint32_t handle);
+
+    /**
+     * Links node under parent, or makes it a root if parentHandle is INVALID_INDEX. Local values are not changed.
+     */
+    void setParent(uint32_t handle, uint32_t parentHandle);
+
+    Transformation* getParent(uint32_t handle) const {
+        uint32_t parentSlot = nodes[handleSlots[handle]].parent;
+        return parentSlot == INVALID_INDEX ? nullptr : nodes[parentSlot].owner;
+    }
+
+    /**
+     * Children are listed into the given vector, since listeners of children might change the hierarchy.
+     */
+    void getChildren(uint32_t handle, std::vector<Transformation*>& children) const;
+
+    bool hasChildren(uint32_t handle) const {
+        return nodes[handleSlots[handle]].firstChild != INVALID_INDEX;
+    }
+
+    const LocalTRS& getLocal(uint32_t handle) const {
+        return locals[handleSlots[handle]];
+    }
+
+    /**
+     * Caller should call markDirty after changing the values.
+     */
+    LocalTRS& getWritableLocal(uint32_t handle) {
+        return locals[handleSlots[handle]];
+    }
+
+    void setPivotOffset(uint32_t handle, const glm::vec3& pivotOffset) {
+        pivotOffsets[handleSlots[handle]] = pivotOffset;
+        markDirty(handle);
+    }
+
+    void markDirty(uint32_t handle) {
+        markSubtreeDirty(handleSlots[handle]);
+    }
+
+    const LocalTRS& getWorldTRS(uint32_t handle) {
+        uint32_t slot = handleSlots[handle];
+        resolve(slot);
+        return worldTRSs[slot];
+    }
+
+    const glm::mat4& getWorldTransform(uint32_t handle) {
+        uint32_t slot = handleSlots[handle];
+        resolve(slot);
+        return worldTransforms[slot];
+    }
+
+    const glm::mat4& getRawWorldTransform(uint32_t handle) {
+        uint32_t slot = handleSlots[handle];
+        resolve(slot);
+        return rawWorldTransforms[slot];
+    }
+
+    /**
+     * Recomputes all dirty nodes in order. Parents are before children, so a node's parent is always clean when it is reached.
+     */
+    void update();
+
+    uint32_t getNodeCount() const {
+        return (uint32_t)(nodes.size() - freeSlots.size());
+    }
+};
+
+
+#endif //LIMONENGINE_TRANSFORMHIERARCHY_H
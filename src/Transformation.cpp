@@ -15,9 +15,10 @@
 bool
 Transformation::addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm::mat4 &perspectiveMatrix, bool is2D) {
     static ImGuizmoState editorState;
-    static glm::vec3 preciseTranslatePoint = translateSingle;
+    static glm::vec3 preciseTranslatePoint = getTranslateSingle();
+    const TransformHierarchy::LocalTRS world = hierarchy().getWorldTRS(handle);
 
-    if(this->parentTransform != nullptr) {
+    if(this->getParentTransform() != nullptr) {
         ImGui::Text("This transform has a parent, and it is relative.");
     }
 
@@ -48,12 +49,12 @@ Transformation::addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm:
 
     switch (editorState.mode) {
         case TRANSLATE_MODE: {
-            if(this->parentTransform != nullptr ) {
-                ImGui::Text("Current Total Translate X: %s", std::to_string(translate.x).c_str());
-                ImGui::Text("Current Total Translate Y: %s", std::to_string(translate.y).c_str());
-                ImGui::Text("Current Total Translate Z: %s", std::to_string(translate.z).c_str());
+            if(this->getParentTransform() != nullptr ) {
+                ImGui::Text("Current Total Translate X: %s", std::to_string(world.translate.x).c_str());
+                ImGui::Text("Current Total Translate Y: %s", std::to_string(world.translate.y).c_str());
+                ImGui::Text("Current Total Translate Z: %s", std::to_string(world.translate.z).c_str());
             }
-            glm::vec3 tempTranslate = translateSingle;
+            glm::vec3 tempTranslate = getTranslateSingle();
             updated =
                     ImGui::DragFloat("Precise Position X", &(tempTranslate.x), 0.01f, preciseTranslatePoint.x - 5.0f,
                                      preciseTranslatePoint.x + 5.0f) || updated;
@@ -76,7 +77,7 @@ Transformation::addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm:
                 setTranslate(tempTranslate);
             }
             if (crudeUpdated) {
-                preciseTranslatePoint = translateSingle;
+                preciseTranslatePoint = getTranslateSingle();
             }
             ImGui::NewLine();
             ImGui::Checkbox("", &(editorState.useSnap));
@@ -85,13 +86,13 @@ Transformation::addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm:
             break;
         }
         case ROTATE_MODE: {
-            if(this->parentTransform != nullptr ) {
-                ImGui::Text("Current Total Rotate X: %s",  std::to_string(orientation.x).c_str());
-                ImGui::Text("Current Total Rotate Y: %s",  std::to_string(orientation.y).c_str());
-                ImGui::Text("Current Total Rotate Z: %s",  std::to_string(orientation.z).c_str());
-                ImGui::Text("Current Total Rotate W: %s",  std::to_string(orientation.w).c_str());
+            if(this->getParentTransform() != nullptr ) {
+                ImGui::Text("Current Total Rotate X: %s",  std::to_string(world.orientation.x).c_str());
+                ImGui::Text("Current Total Rotate Y: %s",  std::to_string(world.orientation.y).c_str());
+                ImGui::Text("Current Total Rotate Z: %s",  std::to_string(world.orientation.z).c_str());
+                ImGui::Text("Current Total Rotate W: %s",  std::to_string(world.orientation.w).c_str());
             }
-            glm::quat tempOrientation = orientationSingle;
+            glm::quat tempOrientation = getOrientationSingle();
             if(!is2D) {
                 updated = ImGui::DragFloat("Rotate X", &(tempOrientation.x), 0.001f, -1.0f, 1.0f) || updated;
                 updated = ImGui::DragFloat("Rotate Y", &(tempOrientation.y), 0.001f, -1.0f, 1.0f) || updated;
@@ -110,13 +111,13 @@ Transformation::addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm:
             break;
         }
         case SCALE_MODE: {
-            if(this->parentTransform != nullptr ) {
-                ImGui::Text("Current Total Scale X: %s", std::to_string(scale.x).c_str());
-                ImGui::Text("Current Total Scale Y: %s", std::to_string(scale.y).c_str());
-                ImGui::Text("Current Total Scale Z: %s", std::to_string(scale.z).c_str());
+            if(this->getParentTransform() != nullptr ) {
+                ImGui::Text("Current Total Scale X: %s", std::to_string(world.scale.x).c_str());
+                ImGui::Text("Current Total Scale Y: %s", std::to_string(world.scale.y).c_str());
+                ImGui::Text("Current Total Scale Z: %s", std::to_string(world.scale.z).c_str());
             }
 
-            glm::vec3 tempScale = scaleSingle;
+            glm::vec3 tempScale = getScaleSingle();
             updated = ImGui::DragFloat("Scale X", &(tempScale.x), 0.01, 0.01f, 10.0f) || updated;
             updated = ImGui::DragFloat("Scale Y", &(tempScale.y), 0.01, 0.01f, 10.0f) || updated;
             if(!is2D) {
@@ -159,10 +160,10 @@ bool Transformation::addImGuizmoElements(const ImGuizmoState &editorState, const
     }
     glm::mat4 objectMatrix;
     ImGuizmo::BeginFrame();
-    //before doing anything, make sure the values are actual.
-    this->getWorldTransform();
-    
-    glm::vec3 eulerRotation = glm::eulerAngles(orientation);
+    //copy, because the values in hierarchy are changed by manipulation below
+    glm::vec3 translate = getTranslate();
+    glm::vec3 scale = getScale();
+    glm::vec3 eulerRotation = glm::eulerAngles(getOrientation());
 
     eulerRotation = eulerRotation * 57.2957795f;
     ImGuizmo::RecomposeMatrixFromComponents(glm::value_ptr(translate),
@@ -231,18 +232,18 @@ bool Transformation::addImGuizmoElements(const ImGuizmoState &editorState, const
 void Transformation::getDifferenceAddition(const Transformation &otherTransformation, glm::vec3 &translate,
                                            glm::vec3 &scale, glm::quat &rotation) const {
 
-    translate = otherTransformation.translate - this->translate;
-    scale = otherTransformation.scale / this->scale;
-    rotation = this->orientation;
+    translate = otherTransformation.getTranslate() - this->getTranslate();
+    scale = otherTransformation.getScale() / this->getScale();
+    rotation = this->getOrientation();
     rotation = glm::inverse(rotation);
-    rotation = rotation * otherTransformation.orientation;
+    rotation = rotation * otherTransformation.getOrientation();
 }
 
 void Transformation::getDifferenceStacked(const Transformation &otherTransformation, glm::vec3 &translate,
                                           glm::vec3 &scale, glm::quat &rotation) const {
     //first, find out, what would convert this, to other. Simple substract won't work because these will stack, not add
-    glm::mat4 currentWT = generateRawWorldTransformWithOrWithoutParent();
-    glm::mat4 otherWt = otherTransformation.generateRawWorldTransformWithOrWithoutParent();
+    glm::mat4 currentWT = hierarchy().getRawWorldTransform(handle);
+    glm::mat4 otherWt = hierarchy().getRawWorldTransform(otherTransformation.handle);
     glm::mat4 differenceWT = glm::inverse(currentWT) * otherWt;
 
     glm::vec3 temp1;
@@ -254,45 +255,46 @@ void Transformation::getDifferenceStacked(const Transformation &otherTransformat
 
 bool Transformation::serialize(tinyxml2::XMLDocument &document, tinyxml2::XMLElement *parentNode) const {
     tinyxml2::XMLElement* currentElement;
+    const TransformHierarchy::LocalTRS& local = hierarchy().getLocal(handle);
     tinyxml2::XMLElement *classNode = document.NewElement("Transformation");
     parentNode->InsertEndChild(classNode);
 
     tinyxml2::XMLElement *parent = document.NewElement("Scale");
     currentElement = document.NewElement("X");
-    currentElement->SetText(scaleSingle.x);
+    currentElement->SetText(local.scale.x);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Y");
-    currentElement->SetText(scaleSingle.y);
+    currentElement->SetText(local.scale.y);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Z");
-    currentElement->SetText(scaleSingle.z);
+    currentElement->SetText(local.scale.z);
     parent->InsertEndChild(currentElement);
     classNode->InsertEndChild(parent);
 
     parent = document.NewElement("Translate");
     currentElement = document.NewElement("X");
-    currentElement->SetText(translateSingle.x);
+    currentElement->SetText(local.translate.x);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Y");
-    currentElement->SetText(translateSingle.y);
+    currentElement->SetText(local.translate.y);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Z");
-    currentElement->SetText(translateSingle.z);
+    currentElement->SetText(local.translate.z);
     parent->InsertEndChild(currentElement);
     classNode->InsertEndChild(parent);
 
     parent = document.NewElement("Rotate");
     currentElement = document.NewElement("X");
-    currentElement->SetText(orientationSingle.x);
+    currentElement->SetText(local.orientation.x);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Y");
-    currentElement->SetText(orientationSingle.y);
+    currentElement->SetText(local.orientation.y);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("Z");
-    currentElement->SetText(orientationSingle.z);
+    currentElement->SetText(local.orientation.z);
     parent->InsertEndChild(currentElement);
     currentElement = document.NewElement("W");
-    currentElement->SetText(orientationSingle.w);
+    currentElement->SetText(local.orientation.w);
     parent->InsertEndChild(currentElement);
     classNode->InsertEndChild(parent);
 
@@ -391,15 +393,16 @@ bool Transformation::deserialize(tinyxml2::XMLElement *transformationNode) {
 }
 
 void Transformation::combine(const Transformation &otherTransformation) {
-    this->orientation *= otherTransformation.getOrientation();
-    this->orientation = glm::normalize(this->orientation);
-    rotated = this->orientation.w < 0.99; // with rotation w gets smaller.
+    TransformHierarchy::LocalTRS& local = hierarchy().getWritableLocal(handle);
+    local.orientation *= otherTransformation.getOrientation();
+    local.orientation = glm::normalize(local.orientation);
+    rotated = local.orientation.w < 0.99; // with rotation w gets smaller.
 
-    this->scale *= otherTransformation.getScale();
+    local.scale *= otherTransformation.getScale();
 
-    this->translate += otherTransformation.getTranslate();
+    local.translate += otherTransformation.getTranslate();
 
-    isDirty = true;
+    hierarchy().markDirty(handle);
 
     propagateUpdate();
 }
@@ -16,8 +16,20 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
+#include "TransformHierarchy.h"
 
 class Transformation {
+public:
+    /**
+     * Notified when the world transform changes by a set method, including changes of a parent.
+     */
+    class UpdateListener {
+    public:
+        virtual ~UpdateListener() = default;
+        virtual void transformChanged() = 0;
+    };
+
+private:
     /* EDITOR INFORMATION PART */
     enum EditorModes {ROTATE_MODE, TRANSLATE_MODE, SCALE_MODE};
     struct ImGuizmoState {
@@ -27,149 +39,76 @@ class Transformation {
     };
     /* EDITOR INFORMATION PART */
 
-    mutable glm::mat4 worldTransform;//private
-
-    void setWorldTransform(const glm::mat4& transform) {
-        this->worldTransform = transform;
-        isDirty = false;
-    }
-
-    void propagateUpdate(){
-        if(this->updateCallback) {
-            updateCallback();
-        }
-    }
-
     /**
-     * If there is a parent, generateWorldTransform should count it
-     * If there are any child, they should be counted by updateCallBack
+     * Values are kept in TransformHierarchy, this is only a handle. Single values are relative to the parent, the
+     * others are world values. If there is no parent, they are the same.
      */
-    std::vector<Transformation*> childTransforms;
-    Transformation* parentTransform = nullptr;
-    
-    void updateChildren() {
-        for (auto iterator = childTransforms.begin(); iterator != childTransforms.end(); ++iterator) {
-            (*iterator)->isDirty = true;
-        }
-    }
-    
-protected:
-    glm::vec3 translate = glm::vec3(0.0f, 0.0f, 0.0f);
-    glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
-    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-    mutable bool isDirty = true;
+    uint32_t handle;
     bool rotated = false;
+    UpdateListener* updateListener = nullptr; //not copied
 
-    //ATTENTION These 2 method pointers are not set when copy constructed
-    std::function<glm::mat4()> generateWorldTransform;
-    std::function<void()> updateCallback = nullptr;
-
-    /**
-     * Saving these values for each and every transform is not optimal, but there is a trade off:
-     * 1) add a transformStack class, that adds a indirection and possibly data locality would suffer
-     * 2) don't save it anywhere, calculate when need. CPU time would suffer
-     * 3) save for all instances. Memory usage suffers, and by extension data locality suffers since there is more data.
-     *
-     * I choose 3. option, solely because it is easier to implement at the current state of the codebase. It can be reconsidered.
-     *
-     * This means even if there is no parent, single variants still needs to be updated.
-     */
-    glm::vec3 translateSingle = glm::vec3(0.0f, 0.0f, 0.0f);
-    glm::vec3 scaleSingle = glm::vec3(1.0f, 1.0f, 1.0f);
-    glm::quat orientationSingle = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-    std::function<glm::mat4()> generateWorldTransformSingle = nullptr; //these are backups, in case of stacking
-    std::function<void()> updateCallbackSingle = nullptr; //these are backups, in case of stacking
-
-    glm::mat4 generateWorldTransformDefault() const {
-        return glm::translate(glm::mat4(1.0f), translateSingle) * glm::mat4_cast(orientationSingle) *
-                               glm::scale(glm::mat4(1.0f), scaleSingle);
+    static TransformHierarchy& hierarchy() {
+        return TransformHierarchy::getInstance();
     }
 
-    glm::mat4 generateRawWorldTransformWithOrWithoutParent() const {
-        //glm::mat4 totalTransform = parentTransform->generateWorldTransformDefault() * this->generateWorldTransformSingle();
-        Transformation* parent = this->parentTransform;
-        glm::mat4 rawTotalTransform = this->generateWorldTransformDefault();
-        while(parent != nullptr) {
-            glm::mat4 parentTransformTemp = parent->generateWorldTransformDefault();
-            rawTotalTransform = parentTransformTemp * rawTotalTransform;
-            parent = parent->parentTransform;
+    void propagateUpdate() {
+        if(this->updateListener != nullptr) {
+            this->updateListener->transformChanged();
         }
-        return rawTotalTransform;
+        notifyChildren();
     }
 
-
-    glm::mat4 generateWorldTransformWithParent(){
-        //glm::mat4 totalTransform = parentTransform->generateWorldTransformDefault() * this->generateWorldTransformSingle();
-        glm::mat4 rawTotalTransform = this->generateWorldTransformDefault();
-        glm::mat4 totalTransform = this->generateWorldTransformSingle();
-        Transformation* parent = this->parentTransform;
-        while(parent != nullptr) {
-            glm::mat4 parentTransformTemp = parent->generateWorldTransformDefault();
-            rawTotalTransform = parentTransformTemp * rawTotalTransform;
-            totalTransform = parentTransformTemp * totalTransform;
-            parent = parent->parentTransform;
+    void notifyChildren() {
+        if(!hierarchy().hasChildren(handle)) {
+            return;
+        }
+        //listeners might change the hierarchy, so iterate over a copy
+        std::vector<Transformation*> children;
+        hierarchy().getChildren(handle, children);
+        for (auto iterator = children.begin(); iterator != children.end(); ++iterator) {
+            (*iterator)->rotated = this->rotated;
+            (*iterator)->propagateUpdate();
         }
-
-        //glm::mat4 rawTotalTransform = TotalRawTransform * this->generateWorldTransformDefault();
-        glm::vec3 temp1;//these are not used
-        glm::vec4 temp2;
-
-        glm::decompose(rawTotalTransform, scale, orientation, translate, temp1, temp2);//update the current of these
-        return totalTransform;
     }
 
-    void updateCallbackWithChild() {
-        if(this->updateCallbackSingle != nullptr) {
-            this->updateCallbackSingle();
-        }
-        for (auto iterator = childTransforms.begin(); iterator != childTransforms.end(); ++iterator) {
-            if((*iterator)->updateCallback != nullptr) {
-                (*iterator)->isDirty = true;
-                (*iterator)->rotated = this->rotated;
-                (*iterator)->updateCallback();
-            }
-        }
+    void setLocal(const glm::vec3 &translate, const glm::quat &orientation, const glm::vec3 &scale) {
+        TransformHierarchy::LocalTRS& local = hierarchy().getWritableLocal(handle);
+        local.translate = translate;
+        local.orientation = orientation;
+        local.scale = scale;
+        hierarchy().markDirty(handle);
     }
 
 public:
 
-    Transformation() {
-        generateWorldTransform = std::bind(&Transformation::generateWorldTransformDefault, this);
-    }
+    Transformation() : handle(hierarchy().create(this)) {}
 
     ~Transformation() {
         disconnectFromStack();
+        hierarchy().destroy(handle);
     }
 
-    Transformation(const Transformation& otherTransformation) {
-        generateWorldTransform = std::bind(&Transformation::generateWorldTransformDefault, this);
+    Transformation(const Transformation& otherTransformation) : handle(hierarchy().create(this)) {
         copyFromOtherTransform(otherTransformation);
     }
 
     void disconnectFromStack() {
-        std::vector<Transformation*> childTransformsBackup = childTransforms;//why backup? because remove parent invalidates
-        for (auto iterator = childTransformsBackup.begin(); iterator != childTransformsBackup.end(); ++iterator) {
+        std::vector<Transformation*> childTransforms;
+        hierarchy().getChildren(handle, childTransforms);
+        for (auto iterator = childTransforms.begin(); iterator != childTransforms.end(); ++iterator) {
             (*iterator)->removeParentTransform();
         }
         removeParentTransform();
     }
 
     void copyFromOtherTransform(const Transformation &otherTransformation) {
-        if(otherTransformation.parentTransform != nullptr) {
-            setParentTransform(otherTransformation.parentTransform);
+        Transformation* otherParent = hierarchy().getParent(otherTransformation.handle);
+        if(otherParent != nullptr) {
+            setParentTransform(otherParent);
         }
-
-        translate = otherTransformation.translate;
-        scale = otherTransformation.scale;
-        orientation = otherTransformation.orientation;
-
-        translateSingle = otherTransformation.translateSingle;
-        scaleSingle = otherTransformation.scaleSingle;
-        orientationSingle = otherTransformation.orientationSingle;
-
-        isDirty = otherTransformation.isDirty;
+        hierarchy().getWritableLocal(handle) = hierarchy().getLocal(otherTransformation.handle);
+        hierarchy().markDirty(handle);
         rotated = otherTransformation.rotated;
-        worldTransform = otherTransformation.worldTransform;
     }
 
     Transformation& operator=(const Transformation& otherTransformation) {
@@ -184,226 +123,149 @@ public:
     }
 
     const Transformation* getParentTransform() const {
-        return parentTransform;
+        return hierarchy().getParent(handle);
     }
 
     void setParentTransform(Transformation* transformation) {
-        if(this->parentTransform == transformation) {
+        if(hierarchy().getParent(handle) == transformation) {
             return; //no op
         }
-        if(this->parentTransform != nullptr) {
-            removeParentTransform();
-        }
-        this->parentTransform = transformation;
-
-        this->generateWorldTransformSingle = this->generateWorldTransform;
-        this->generateWorldTransform = std::bind(&Transformation::generateWorldTransformWithParent, this);
-        this->isDirty = true;
-
-        this->scaleSingle = this->scale;
-        this->translateSingle = this->translate;
-        this->orientationSingle = this->orientation;
-
-        if(transformation->childTransforms.size() == 0) {
-            transformation->updateCallbackSingle = transformation->updateCallback;
-            transformation->updateCallback = std::bind(&Transformation::updateCallbackWithChild, transformation);
-        }
-        transformation->childTransforms.push_back(this);
-
-        this->getWorldTransform();
+        //removing parent makes current world values single values, and they become relative to new parent
+        removeParentTransform();
+        hierarchy().setParent(handle, transformation->handle);
         this->propagateUpdate();
     }
 
     void removeParentTransform() {
-        if(this->parentTransform == nullptr) {
+        if(hierarchy().getParent(handle) == nullptr) {
             return;
         }
-        glm::vec3 translateBackUp = this->getTranslate();
-        glm::vec3 scaleBackUp = this->getScale();
-        glm::quat orientationBackUp = this->getOrientation();
-
-        auto element = std::find(this->parentTransform->childTransforms.begin(), this->parentTransform->childTransforms.end(), this);
-        if(element != this->parentTransform->childTransforms.end()) {
-            this->parentTransform->childTransforms.erase(element);
-            if(this->parentTransform->childTransforms.empty()) {
-                this->parentTransform->updateCallback = this->parentTransform->updateCallbackSingle;
-                this->parentTransform->updateCallbackSingle = nullptr;
-            }
-        } else {
-            std::cerr << "Parent transform doesn't have this child in the list, this shouldn't have happened!" << std::endl;
-        }
-
-        this->parentTransform = nullptr;
-        this->generateWorldTransform = this->generateWorldTransformSingle;
-        this->generateWorldTransformSingle = nullptr;
-
-        this->scale = this->scaleSingle = scaleBackUp;
-        this->translate = this->translateSingle = translateBackUp;
-        this->orientation = this->orientationSingle = orientationBackUp;
-        this->isDirty = true;
-        this->getWorldTransform();
+        TransformHierarchy::LocalTRS worldBackUp = hierarchy().getWorldTRS(handle);
+        hierarchy().setParent(handle, TransformHierarchy::INVALID_INDEX);
+        setLocal(worldBackUp.translate, worldBackUp.orientation, worldBackUp.scale);
         this->propagateUpdate();
     }
 
-    void setUpdateCallback(std::function<void()> updateCallback) {
-        this->updateCallback = updateCallback;
+    void setUpdateListener(UpdateListener* updateListener) {
+        this->updateListener = updateListener;
     }
 
-    void setGenerateWorldTransform(std::function<glm::mat4()> generateWorldTransform) {
-        this->generateWorldTransform = generateWorldTransform;
+    /**
+     * World transform is moved by -pivotOffset in local space. It is not applied to children, or to world values.
+     */
+    void setPivotOffset(const glm::vec3 &pivotOffset) {
+        hierarchy().setPivotOffset(handle, pivotOffset);
     }
 
     void addScale(const glm::vec3 &scale) {
-        //If there is no parent, keep both single and normal the same
-        //because sets are used rarely but gets are used often. It will remove a branch from gets.
-        if(this->parentTransform == nullptr) {
-            this->scale *= scale;
-        }
-        this->scaleSingle *= scale;
-        isDirty = true;
+        hierarchy().getWritableLocal(handle).scale *= scale;
+        hierarchy().markDirty(handle);
         propagateUpdate();
     }
 
     void setScale(const glm::vec3 &scale) {
-        if(this->parentTransform == nullptr) {
-            this->scale = scale;
-        }
-        this->scaleSingle = scale;
-        isDirty = true;
+        hierarchy().getWritableLocal(handle).scale = scale;
+        hierarchy().markDirty(handle);
         propagateUpdate();
     }
 
 
     const glm::vec3 getTranslateSingle() const {
-        return translateSingle;
+        return hierarchy().getLocal(handle).translate;
     }
 
     const glm::vec3 getTranslate() const {
-        return translate;
+        return hierarchy().getWorldTRS(handle).translate;
     }
 
     const glm::vec3 getScaleSingle() const {
-        return scaleSingle;
+        return hierarchy().getLocal(handle).scale;
     }
 
     const glm::vec3 getScale() const {
-        return scale;
+        return hierarchy().getWorldTRS(handle).scale;
     }
 
     const glm::quat getOrientationSingle() const {
-        return orientationSingle;
+        return hierarchy().getLocal(handle).orientation;
     }
 
     const glm::quat getOrientation() const {
-        return orientation;
+        return hierarchy().getWorldTRS(handle).orientation;
     }
 
     void addTranslate(const glm::vec3 &translate) {
-        if(this->parentTransform == nullptr) {
-            this->translateSingle += translate;
-            this->translate = this->translateSingle;
+        const Transformation* parentTransform = getParentTransform();
+        if(parentTransform == nullptr) {
+            hierarchy().getWritableLocal(handle).translate += translate;
         } else {
             glm::mat4 newTranslateMatrix = glm::translate(glm::mat4(1.0f), translate);
-            glm::mat4 parentInverseT = glm::inverseTranspose(this->parentTransform->worldTransform);
+            glm::mat4 parentInverseT = glm::inverseTranspose(parentTransform->getWorldTransform());
             glm::mat4 newTranslateDiff = parentInverseT * newTranslateMatrix;
             glm::vec3 newTranslateSet;
             newTranslateSet.x = newTranslateDiff[3][0];
             newTranslateSet.y = newTranslateDiff[3][1];
             newTranslateSet.z = newTranslateDiff[3][2];
-            this->translateSingle += newTranslateSet;
+            hierarchy().getWritableLocal(handle).translate += newTranslateSet;
         }
-        isDirty = true;
+        hierarchy().markDirty(handle);
         propagateUpdate();
     }
 
     void setTranslate(const glm::vec3 &translate) {
-        if(this->parentTransform == nullptr) {
-            this->translate = translate;
-        }
-        this->translateSingle = translate;
-        isDirty = true;
+        hierarchy().getWritableLocal(handle).translate = translate;
+        hierarchy().markDirty(handle);
         propagateUpdate();
     }
 
     void setOrientation(const glm::quat &orientation) {
-        this->orientationSingle = glm::normalize(orientation);
-        if(this->parentTransform == nullptr) {
-            this->orientation = orientationSingle;
-        }
-        rotated = this->orientation.w < 0.99 || this->orientationSingle.w < 0.99; // with rotation w gets smaller.
-        isDirty = true;
+        glm::quat orientationSingle = glm::normalize(orientation);
+        hierarchy().getWritableLocal(handle).orientation = orientationSingle;
+        hierarchy().markDirty(handle);
+        rotated = getOrientation().w < 0.99 || orientationSingle.w < 0.99; // with rotation w gets smaller.
         propagateUpdate();
     }
 
     void addOrientation(const glm::quat &orientation) {
-        this->orientationSingle *= orientation;
-        this->orientationSingle = glm::normalize(this->orientationSingle);
-        if(this->parentTransform == nullptr) {
-            this->orientation = this->orientationSingle;
-        }
-
-        rotated = this->orientationSingle.w < 0.99; // with rotation w gets smaller.
-        isDirty = true;
+        TransformHierarchy::LocalTRS& local = hierarchy().getWritableLocal(handle);
+        local.orientation = glm::normalize(local.orientation * orientation);
+        rotated = local.orientation.w < 0.99; // with rotation w gets smaller.
+        hierarchy().markDirty(handle);
         propagateUpdate();
     }
 
+    /**
+     * These don't call the listener of this transform, only children are notified.
+     */
     void setTransformationsNotPropagate(const glm::vec3& translate) {
-        if(this->parentTransform == nullptr) {
-            this->translate = translate;
-        }
-        this->translateSingle = translate;
-
-        for (auto childTransform = childTransforms.begin(); childTransform != childTransforms.end(); ++childTransform) {
-            (*childTransform)->isDirty = true;
-            (*childTransform)->updateCallback();
-        }
-        isDirty = true;
+        hierarchy().getWritableLocal(handle).translate = translate;
+        hierarchy().markDirty(handle);
+        notifyChildren();
     }
 
     void setTransformationsNotPropagate(const glm::vec3& translate, const::glm::quat& orientation) {
-        this->translateSingle = translate;
-        this->orientationSingle = glm::normalize(orientation);
-
-        if(this->parentTransform == nullptr) {
-            this->translate = translate;
-            this->orientation = orientationSingle;
-        }
-        for (auto childTransform = childTransforms.begin(); childTransform != childTransforms.end(); ++childTransform) {
-            (*childTransform)->isDirty = true;
-            (*childTransform)->updateCallback();
-        }
-        isDirty = true;
+        TransformHierarchy::LocalTRS& local = hierarchy().getWritableLocal(handle);
+        local.translate = translate;
+        local.orientation = glm::normalize(orientation);
+        hierarchy().markDirty(handle);
+        notifyChildren();
     }
 
     void setTransformationsNotPropagate(const glm::vec3& translate, const::glm::quat& orientation, const glm::vec3& scale) {
-        this->translateSingle = translate;
-        this->orientationSingle = glm::normalize(orientation);
-        this->scaleSingle = scale;
-        rotated = this->orientation.w < 0.99; // with rotation w gets smaller.
-
-        if(this->parentTransform == nullptr) {
-            this->scale = scale;
-            this->orientation = orientationSingle;//this is intentional, because it needs normalization
-            this->translate = translate;
-        }
-
-        for (auto childTransform = childTransforms.begin(); childTransform != childTransforms.end(); ++childTransform) {
-            (*childTransform)->isDirty = true;
-            (*childTransform)->updateCallback();
-        }
-        isDirty = true;
+        setLocal(translate, glm::normalize(orientation), scale);
+        rotated = hierarchy().getLocal(handle).orientation.w < 0.99; // with rotation w gets smaller.
+        notifyChildren();
     }
 
     bool isRotated() const {
         return rotated;
     }
 
-    const glm::mat4 &getWorldTransform() const {
-        if (isDirty) {
-            this->worldTransform = generateWorldTransform();
-            isDirty = false;
-        }
-        return worldTransform;
+    /**
+     * Returned by value, because the hierarchy storage moves when transformations are created.
+     */
+    glm::mat4 getWorldTransform() const {
+        return hierarchy().getWorldTransform(handle);
     }
 
     bool addImGuiEditorElements(const glm::mat4 &cameraMatrix, const glm::mat4 &perspectiveMatrix, bool is2D = false);
@@ -0,0 +1,62 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_FASTRANDOM_H
+#define LIMONENGINE_FASTRANDOM_H
+
+
+#include <cstdint>
+
+/**
+ * xoshiro128+ generator, seeded with splitmix64. Much cheaper than std::default_random_engine with a distribution,
+ * for the cases that need a lot of random numbers per frame and not high quality, like particles.
+ *
+ * Not thread safe, each user should have its own.
+ */
+class FastRandom {
+    uint32_t state[4];
+
+    static uint32_t rotateLeft(uint32_t value, int count) {
+        return (value << count) | (value >> (32 - count));
+    }
+
+    static uint64_t splitMix64(uint64_t &seed) {
+        uint64_t result = (seed += 0x9E3779B97F4A7C15ULL);
+        result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+        return result ^ (result >> 31);
+    }
+
+public:
+    explicit FastRandom(uint64_t seed) {
+        uint64_t first = splitMix64(seed);
+        uint64_t second = splitMix64(seed);
+        state[0] = (uint32_t)first;
+        state[1] = (uint32_t)(first >> 32);
+        state[2] = (uint32_t)second;
+        state[3] = (uint32_t)(second >> 32);
+    }
+
+    uint32_t next() {
+        const uint32_t result = state[0] + state[3];
+        const uint32_t shifted = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotateLeft(state[3], 11);
+        return result;
+    }
+
+    /**
+     * Uniform in [-1, 1). Lowest bits of xoshiro128+ are weak, so only the highest 24 bits are used.
+     */
+    float nextSigned() {
+        return (float)(next() >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+};
+
+
+#endif //LIMONENGINE_FASTRANDOM_H
@@ -0,0 +1,258 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "Profiler.h"
+#include "API/Graphics/GraphicsInterface.h"
+
+#include <mutex>
+#include <memory>
+#include <deque>
+#include <unordered_set>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+std::atomic<bool> Profiler::enabled(true);
+
+namespace {
+    /**
+     * Single writer ring, only the owner thread writes. Write index is published after the event is written.
+     */
+    struct ThreadBuffer {
+        std::string threadName;
+        uint32_t threadIndex = 0;
+        uint32_t depth = 0;
+        std::vector<Profiler::Event> events;
+        std::atomic<uint64_t> writeIndex{0};
+
+        ThreadBuffer() : events(Profiler::RING_SIZE) {}
+
+        void push(const Profiler::Event &event) {
+            uint64_t index = writeIndex.load(std::memory_order_relaxed);
+            events[index % Profiler::RING_SIZE] = event;
+            writeIndex.store(index + 1, std::memory_order_release);
+        }
+
+        void copyTo(uint64_t rangeStart, uint64_t rangeEnd, std::vector<Profiler::Event> &output) const {
+            uint64_t end = writeIndex.load(std::memory_order_acquire);
+            uint64_t begin = end > Profiler::RING_SIZE ? end - Profiler::RING_SIZE : 0;
+            size_t firstCopied = output.size();
+            std::vector<uint64_t> copiedIndices;
+            for (uint64_t index = begin; index < end; ++index) {
+                const Profiler::Event &event = events[index % Profiler::RING_SIZE];
+                if(event.end >= rangeStart && event.start <= rangeEnd) {
+                    output.push_back(event);
+                    copiedIndices.push_back(index);
+                }
+            }
+            //writer might have lapped us while copying, drop anything it could have touched
+            uint64_t endAfterCopy = writeIndex.load(std::memory_order_acquire);
+            uint64_t firstValid = endAfterCopy + 1 > Profiler::RING_SIZE ? endAfterCopy + 1 - Profiler::RING_SIZE : 0;
+            size_t keep = firstCopied;
+            for (size_t i = 0; i < copiedIndices.size(); ++i) {
+                if(copiedIndices[i] >= firstValid) {
+                    output[keep++] = output[firstCopied + i];
+                }
+            }
+            output.resize(keep);
+        }
+    };
+
+    struct GPUTimerRequest {
+        const char* name;
+        uint64_t cpuTime;
+    };
+
+    struct ProfilerState {
+        std::mutex registryMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+        std::unordered_set<std::string> names;
+        std::mutex namesMutex;
+        //main thread only
+        ThreadBuffer gpuBuffer;
+        std::deque<GPUTimerRequest> gpuRequests;
+        std::vector<GraphicsInterface::GPUTimerResult> gpuResults;
+        int64_t gpuClockOffset = 0;
+        bool gpuClockOffsetSet = false;
+        std::vector<uint64_t> frameStarts = std::vector<uint64_t>(Profiler::FRAME_HISTORY_SIZE, 0);
+        uint64_t frameCount = 0;
+
+        ProfilerState() {
+            gpuBuffer.threadName = "GPU";
+        }
+    };
+
+    ProfilerState& getState() {
+        static ProfilerState state;
+        return state;
+    }
+
+    ThreadBuffer& getThreadBuffer() {
+        thread_local ThreadBuffer* threadBuffer = nullptr;
+        if(threadBuffer == nullptr) {
+            ProfilerState& state = getState();
+            std::unique_lock<std::mutex> lock(state.registryMutex);
+            state.threadBuffers.emplace_back(new ThreadBuffer());
+            threadBuffer = state.threadBuffers.back().get();
+            threadBuffer->threadIndex = (uint32_t)state.threadBuffers.size() - 1;
+            threadBuffer->threadName = "Thread " + std::to_string(threadBuffer->threadIndex);
+        }
+        return *threadBuffer;
+    }
+
+    void writeJSONString(std::ofstream &output, const char* value) {
+        output << '"';
+        for (const char* character = value; *character != '\0'; ++character) {
+            if(*character == '"' || *character == '\\') {
+                output << '\\';
+            }
+            output << *character;
+        }
+        output << '"';
+    }
+}
+
+Profiler::Zone::Zone(const char *name) : name(name), start(0), active(isEnabled()) {
+    if(active) {
+        getThreadBuffer().depth++;
+        start = now();
+    }
+}
+
+Profiler::Zone::~Zone() {
+    if(active) {
+        Event event;
+        event.end = now();
+        ThreadBuffer& threadBuffer = getThreadBuffer();
+        threadBuffer.depth--;
+        event.name = name;
+        event.start = start;
+        event.depth = threadBuffer.depth;
+        threadBuffer.push(event);
+    }
+}
+
+Profiler::GPUZone::GPUZone(GraphicsInterface *graphicsWrapper, const char *name) : graphicsWrapper(graphicsWrapper), active(false) {
+    if(isEnabled()) {
+        uint64_t cpuTime = now();
+        active = graphicsWrapper->beginGPUTimer(name);
+        if(active) {
+            getState().gpuRequests.push_back(GPUTimerRequest{name, cpuTime});
+        }
+    }
+}
+
+Profiler::GPUZone::~GPUZone() {
+    if(active) {
+        graphicsWrapper->endGPUTimer();
+    }
+}
+
+void Profiler::setThreadName(const std::string &threadName) {
+    ThreadBuffer& threadBuffer = getThreadBuffer();
+    std::unique_lock<std::mutex> lock(getState().registryMutex);
+    threadBuffer.threadName = threadName;
+}
+
+const char *Profiler::internName(const std::string &name) {
+    ProfilerState& state = getState();
+    std::unique_lock<std::mutex> lock(state.namesMutex);
+    return state.names.insert(name).first->c_str();//set nodes never move
+}
+
+void Profiler::markFrame() {
+    ProfilerState& state = getState();
+    state.frameStarts[state.frameCount % FRAME_HISTORY_SIZE] = now();
+    state.frameCount++;
+}
+
+void Profiler::collectGPUTimers(GraphicsInterface *graphicsWrapper) {
+    ProfilerState& state = getState();
+    state.gpuResults.clear();
+    graphicsWrapper->collectGPUTimers(state.gpuResults);
+    for (const GraphicsInterface::GPUTimerResult &result : state.gpuResults) {
+        if(state.gpuRequests.empty()) {
+            std::cerr << "GPU timer result without request, dropping." << std::endl;
+            break;
+        }
+        GPUTimerRequest request = state.gpuRequests.front();
+        state.gpuRequests.pop_front();
+        //GPU can't start before the commands are sent, so the largest difference is the closest to the real clock offset
+        int64_t offset = (int64_t)request.cpuTime - (int64_t)result.start;
+        if(!state.gpuClockOffsetSet || offset > state.gpuClockOffset) {
+            state.gpuClockOffset = offset;
+            state.gpuClockOffsetSet = true;
+        }
+        Event event;
+        event.name = result.name;
+        event.start = (uint64_t)((int64_t)result.start + state.gpuClockOffset);
+        event.end = (uint64_t)((int64_t)result.end + state.gpuClockOffset);
+        event.depth = result.depth;
+        state.gpuBuffer.push(event);
+    }
+}
+
+bool Profiler::getLastFrame(uint64_t &frameStart, uint64_t &frameEnd) {
+    ProfilerState& state = getState();
+    if(state.frameCount < 2) {
+        return false;
+    }
+    frameStart = state.frameStarts[(state.frameCount - 2) % FRAME_HISTORY_SIZE];
+    frameEnd = state.frameStarts[(state.frameCount - 1) % FRAME_HISTORY_SIZE];
+    return true;
+}
+
+void Profiler::collect(uint64_t rangeStart, uint64_t rangeEnd, std::vector<ThreadEvents> &threadEvents) {
+    ProfilerState& state = getState();
+    std::unique_lock<std::mutex> lock(state.registryMutex);
+    threadEvents.resize(state.threadBuffers.size() + 1);
+    for (size_t i = 0; i < state.threadBuffers.size(); ++i) {
+        threadEvents[i].threadName = state.threadBuffers[i]->threadName;
+        threadEvents[i].threadIndex = state.threadBuffers[i]->threadIndex;
+        threadEvents[i].events.clear();
+        state.threadBuffers[i]->copyTo(rangeStart, rangeEnd, threadEvents[i].events);
+    }
+    ThreadEvents& gpuEvents = threadEvents.back();
+    gpuEvents.threadName = state.gpuBuffer.threadName;
+    gpuEvents.threadIndex = (uint32_t)state.threadBuffers.size();
+    gpuEvents.events.clear();
+    state.gpuBuffer.copyTo(rangeStart, rangeEnd, gpuEvents.events);
+}
+
+bool Profiler::exportChromeTrace(const std::string &fileName) {
+    std::vector<ThreadEvents> threadEvents;
+    collect(0, UINT64_MAX, threadEvents);
+    std::ofstream output(fileName);
+    if(!output.is_open()) {
+        std::cerr << "Profiler can't open " << fileName << " to export trace." << std::endl;
+        return false;
+    }
+    uint64_t firstTime = UINT64_MAX;
+    for (const ThreadEvents &thread : threadEvents) {
+        for (const Event &event : thread.events) {
+            firstTime = std::min(firstTime, event.start);
+        }
+    }
+    output << std::fixed << std::setprecision(3);
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const ThreadEvents &thread : threadEvents) {
+        output << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadIndex << ",\"args\":{\"name\":";
+        writeJSONString(output, thread.threadName.c_str());
+        output << "}}";
+        first = false;
+        for (const Event &event : thread.events) {
+            //chrome trace uses microseconds
+            output << ",\n{\"name\":";
+            writeJSONString(output, event.name);
+            output << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadIndex
+                   << ",\"ts\":" << (event.start - firstTime) / 1000.0
+                   << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+        }
+    }
+    output << "\n]}\n";
+    std::cout << "Profiler trace exported to " << fileName << std::endl;
+    return true;
+}
@@ -0,0 +1,122 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_PROFILER_H
+#define LIMONENGINE_PROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+class GraphicsInterface;
+
+/**
+ * Frame profiler with scoped zones.
+ *
+ * Each thread writes its zones to its own ring buffer, so recording never locks. Zones are written when they end,
+ * with start, end and nesting depth. Readers copy the rings and drop the entries that might have been overwritten
+ * while copying, so old zones can be lost, but zones of last frames are always available.
+ *
+ * GPU zones use the timer queries of the graphics backend, if it has them. Results are collected a few frames later,
+ * without waiting, and shown as their own track.
+ *
+ * Zone names must outlive the profiler, string literals or internName results should be used.
+ *
+ * Recording can be disabled in runtime by setEnabled, or completely compiled out by defining LIMON_DISABLE_PROFILER.
+ */
+class Profiler {
+public:
+    static constexpr uint32_t RING_SIZE = 16384;//per thread
+    static constexpr uint32_t FRAME_HISTORY_SIZE = 256;
+
+    struct Event {
+        const char* name = nullptr;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        uint32_t depth = 0;
+    };
+
+    struct ThreadEvents {
+        std::string threadName;
+        uint32_t threadIndex;
+        std::vector<Event> events;
+    };
+
+    class Zone {
+        const char* name;
+        uint64_t start;
+        bool active;
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+    };
+
+    class GPUZone {
+        GraphicsInterface* graphicsWrapper;
+        bool active;
+    public:
+        GPUZone(GraphicsInterface* graphicsWrapper, const char* name);
+        ~GPUZone();
+    };
+
+    static uint64_t now() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool isEnabled) {
+        enabled.store(isEnabled, std::memory_order_relaxed);
+    }
+
+    static void setThreadName(const std::string &threadName);
+
+    /**
+     * Returns a pointer that stays valid until exit, for zone names that are not literals.
+     */
+    static const char* internName(const std::string &name);
+
+    /**
+     * Marks start of a new frame. Should only be called by main thread.
+     */
+    static void markFrame();
+
+    /**
+     * Reads finished GPU timers from backend and moves them to GPU track. Should only be called by main thread.
+     */
+    static void collectGPUTimers(GraphicsInterface* graphicsWrapper);
+
+    /**
+     * Start and end of the last finished frame, returns false if there is none.
+     */
+    static bool getLastFrame(uint64_t &frameStart, uint64_t &frameEnd);
+
+    /**
+     * Copies zones overlapping [rangeStart, rangeEnd] from each thread, GPU track is the last one.
+     */
+    static void collect(uint64_t rangeStart, uint64_t rangeEnd, std::vector<ThreadEvents> &threadEvents);
+
+    static bool exportChromeTrace(const std::string &fileName);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+#define LIMON_PROFILE_CONCAT_INNER(a, b) a##b
+#define LIMON_PROFILE_CONCAT(a, b) LIMON_PROFILE_CONCAT_INNER(a, b)
+
+#ifndef LIMON_DISABLE_PROFILER
+#define LIMON_PROFILE_ZONE(name) Profiler::Zone LIMON_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define LIMON_PROFILE_GPU_ZONE(graphicsWrapper, name) Profiler::GPUZone LIMON_PROFILE_CONCAT(profileGPUZone, __LINE__)(graphicsWrapper, name)
+#else
+#define LIMON_PROFILE_ZONE(name)
+#define LIMON_PROFILE_GPU_ZONE(graphicsWrapper, name)
+#endif
+
+
+#endif //LIMONENGINE_PROFILER_H
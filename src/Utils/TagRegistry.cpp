@@ -0,0 +1,27 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#include "TagRegistry.h"
+
+const uint32_t TagRegistry::MAX_TAG_COUNT;
+const uint32_t TagRegistry::INVALID_INDEX;
+std::mutex TagRegistry::registryMutex;
+uint64_t TagRegistry::tagHashes[TagRegistry::MAX_TAG_COUNT];
+std::atomic<uint32_t> TagRegistry::tagCount(0);
+
+uint32_t TagRegistry::registerTag(const HashUtil::HashedString &tag) {
+    std::unique_lock<std::mutex> lock(registryMutex);
+    uint32_t index = findIndex(tag.hash);
+    if(index != INVALID_INDEX) {
+        return index;
+    }
+    uint32_t count = tagCount.load(std::memory_order_relaxed);
+    if(count >= MAX_TAG_COUNT) {
+        std::cerr << "Tag registry is full, tag [" << tag.text << "] can't be used for rendering. Maximum tag count is " << MAX_TAG_COUNT << std::endl;
+        return INVALID_INDEX;
+    }
+    tagHashes[count] = tag.hash;
+    tagCount.store(count + 1, std::memory_order_release);
+    return count;
+}
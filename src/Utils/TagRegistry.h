@@ -0,0 +1,68 @@
+//
+// Created by engin on 18/10/2026.
+//
+
+#ifndef LIMONENGINE_TAGREGISTRY_H
+#define LIMONENGINE_TAGREGISTRY_H
+
+#include <bitset>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <cstdint>
+#include "HashUtil.h"
+
+/**
+ * Assigns dense bit indices to tags, so objects and cameras can keep their tags as fixed width masks and tag matching
+ * becomes a mask and. Tag vocabulary is small, hard coded tags and render pipeline tags, so indices are never released.
+ *
+ * Hashed strings are still kept by the owners for serialization and editor.
+ *
+ * Lookups are lock free, they run in culling and render loops. Registration only appends, it writes the hash before
+ * publishing the new count, so readers never see an unwritten entry.
+ */
+class TagRegistry {
+public:
+    static const uint32_t MAX_TAG_COUNT = 64;
+    static const uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+    typedef std::bitset<MAX_TAG_COUNT> TagMask;
+
+    /**
+     * Returns the index of the tag, registering it if it is new. If registry is full, returns INVALID_INDEX.
+     */
+    static uint32_t registerTag(const HashUtil::HashedString& tag);
+
+    static uint32_t findIndex(uint64_t hash) {
+        uint32_t count = tagCount.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            if(tagHashes[i] == hash) {
+                return i;
+            }
+        }
+        return INVALID_INDEX;
+    }
+
+    /**
+     * Empty mask if the tag is not registered.
+     */
+    static TagMask getMask(uint64_t hash) {
+        TagMask mask;
+        uint32_t index = findIndex(hash);
+        if(index != INVALID_INDEX) {
+            mask.set(index);
+        }
+        return mask;
+    }
+
+    static uint32_t getTagCount() {
+        return tagCount.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::mutex registryMutex;//only for registration, world loading might register from multiple threads
+    static uint64_t tagHashes[MAX_TAG_COUNT];//index -> hash
+    static std::atomic<uint32_t> tagCount;
+};
+
+
+#endif //LIMONENGINE_TAGREGISTRY_H
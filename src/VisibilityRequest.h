@@ -6,23 +6,24 @@
 #define LIMONENGINE_VISIBILITYREQUEST_H
 
 
+#include "CameraVisibility.h"
+#include "Camera/AABBArray.h"
+#include "Camera/AABBTree.h"
+
+class Model;
+
+/**
+ * Culling state of a single camera. Culling runs in 2 steps:
+ *  1) objects are checked, and each object result is written to its own index in objectLods,
+ *  2) results are applied to the camera visibility by a single job.
+ * If the camera needs a full refill, step 1 queries the spatial tree, so objects far from the frustum are never visited.
+ * Otherwise only dirty objects matter, and object ranges are checked in parallel. Since the ranges never write to
+ * the same place, there is no locking in the hot path.
+ */
 class VisibilityRequest {
 public:
-        class uint64_vector_hasher {
-        public:
-            std::size_t operator()(std::vector<uint64_t> const &vec) const {
-                std::size_t seed = vec.size();
-                for (auto x: vec) {
-                    x = ((x >> 16) ^ x) * 0x45d9f3b;
-                    x = ((x >> 16) ^ x) * 0x45d9f3b;
-                    x = (x >> 16) ^ x;
-                    seed ^= x + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-                }
-                return seed;
-            }
-        };
+        static constexpr uint32_t NOT_PROCESSED = std::numeric_limits<uint32_t>::max();//object is not dirty, keep old result
 
-        static SDL2MultiThreading::Condition condition;
         const Camera* const camera;
         glm::vec3 playerPosition;
         const OptionsUtil::Options* options;
@@ -30,48 +31,43 @@ public:
         const OptionsUtil::Options::Option<double> skipRenderDistanceOption;
         const OptionsUtil::Options::Option<double> skipRenderSizeOption;
         const OptionsUtil::Options::Option<double> maxSkipRenderSizeOption;
-        const std::unordered_map<uint32_t, PhysicalRenderable *>* const objects;
-        std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>, uint64_vector_hasher> * visibility;
-        bool running = true;
-        std::atomic<uint32_t> frameCount;
-        SDL2MultiThreading::SpinLock inProgressLock;
-        SDL_mutex* blockMutex = SDL_CreateMutex();
-        VisibilityRequest(Camera* camera, std::unordered_map<uint32_t, PhysicalRenderable *>* objects, std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>, uint64_vector_hasher> * visibility, const glm::vec3& playerPosition, const OptionsUtil::Options* options) :
+        const std::vector<Model *>* const objects;
+        const AABBArray* const aabbs;
+        const AABBTree* const tree;
+        const std::vector<uint32_t>* const objectIndices;//objectID -> index in objects
+        CameraVisibility* const visibility;
+
+        /************ Per frame state, set by prepareVisibilityRequest ************/
+        std::vector<long> lodDistances;
+        float skipRenderDistance = 0, skipRenderSize = 0, maxSkipRenderSize = 0;
+        glm::mat4 viewMatrix;
+        bool fullRefill = true;
+        float maxLodDistance = AABBTree::NO_DISTANCE_LIMIT;//objects farther than this are skipped by lod anyway
+        std::vector<uint32_t> candidateObjectIDs;//tree query result
+        std::vector<uint32_t> objectLods;//lod per object, SKIP_LOD_LEVEL if not visible, NOT_PROCESSED if not dirty
+        std::vector<uint32_t> visibilityMask;//frustum test result per object, filled by Camera::cullAABBs
+
+        /************ Kept between frames, set by applyVisibilityResults ************/
+        std::vector<uint32_t> visibleObjectLods;//objectID -> lod, SKIP_LOD_LEVEL if not visible to this camera
+
+        SDL2MultiThreading::JobSystem::Counter rangeCounter;
+
+        VisibilityRequest(Camera* camera, const std::vector<Model *>* objects, const AABBArray* aabbs, const AABBTree* tree,
+                          const std::vector<uint32_t>* objectIndices, CameraVisibility* visibility, const glm::vec3& playerPosition, const OptionsUtil::Options* options) :
                 camera(camera), playerPosition(playerPosition), options(options),
                 lodDistancesOption(options->getOption<std::vector<long>>(HASH("LodDistanceList"))),
                 skipRenderDistanceOption(options->getOption<double>(HASH("SkipRenderDistance"))),
                 skipRenderSizeOption(options->getOption<double>(HASH("SkipRenderSize"))),
                 maxSkipRenderSizeOption(options->getOption<double>(HASH("MaxSkipRenderSize"))),
-                objects(objects), visibility(visibility), frameCount(0) {
+                objects(objects), aabbs(aabbs), tree(tree), objectIndices(objectIndices), visibility(visibility) {
 
         };
 
-        std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>>::iterator findHashEntry(uint64_t hash) const {
-            std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>>::iterator it = visibility->begin();
-            for (;
-                    it != visibility->end(); it++){
-                for(std::vector<uint64_t>::const_iterator hashIt = it->first.begin(); hashIt != it->first.end(); hashIt++){
-                    if((*hashIt) == hash) {
-                        return it;
-                    }
-                }
-            }
-            return it;//this returns the end iterator, so it needs to be checked by the caller
-        }
-
-        static std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>>::iterator findHashEntry(
-                std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>, uint64_vector_hasher> * visibility,
-                uint64_t hash)  {
-            std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>>::iterator it = visibility->begin();
-            for (;
-                    it != visibility->end(); it++){
-                for(std::vector<uint64_t>::const_iterator hashIt = it->first.begin(); hashIt != it->first.end(); hashIt++){
-                    if((*hashIt) == hash) {
-                        return it;
-                    }
-                }
+        uint32_t getVisibleLod(uint32_t objectID) const {
+            if(objectID >= visibleObjectLods.size()) {
+                return SKIP_LOD_LEVEL;
             }
-            return it;//this returns the end iterator, so it needs to be checked by the caller
+            return visibleObjectLods[objectID];
         }
 };
 
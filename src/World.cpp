@@ -15,6 +15,7 @@
 #include "Camera/PerspectiveCamera.h"
 #include "BulletDebugDrawer.h"
 #include "AI/AIMovementGrid.h"
+#include "AI/AIRouteService.h"
 
 
 #include "GameObjects/Players/FreeCursorPlayer.h"
@@ -33,6 +34,7 @@
 #include "Assets/Animations/AnimationCustom.h"
 #include "AnimationSequencer.h"
 #include "GUI/GUICursor.h"
+#include "GUI/GUISpriteBatch.h"
 #include "GameObjects/GUIText.h"
 #include "GameObjects/GUIImage.h"
 #include "GameObjects/GUIButton.h"
@@ -40,6 +42,8 @@
 #include "GameObjects/ModelGroup.h"
 #include "Graphics/PostProcess/QuadRender.h"
 #include "Editor/Editor.h"
+#include "Utils/Profiler.h"
+#include "API/Graphics/GraphicsProgramCache.h"
 
    const std::map<World::PlayerInfo::Types, std::string> World::PlayerInfo::typeNames =
     {
@@ -49,12 +53,10 @@
             { Types::MENU_PLAYER, "Menu" }
     };
 
-SDL2MultiThreading::Condition VisibilityRequest::condition; //FIXME this variable doesn't looks like it belongs here
-
 World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandler *inputHandler,
              std::shared_ptr<AssetManager> assetManager, OptionsUtil::Options *options)
         : assetManager(assetManager), options(options), graphicsWrapper(assetManager->getGraphicsWrapper()),
-        alHelper(assetManager->getAlHelper()), name(name), fontManager(graphicsWrapper),
+        alHelper(assetManager->getAlHelper()), jobSystem(assetManager->getJobSystem()), name(name), fontManager(graphicsWrapper),
         startingPlayer(startingPlayerType) {
     strncpy(worldSaveNameBuffer, name.c_str(), sizeof(worldSaveNameBuffer) -1 );
     editor = std::make_unique<Editor>(this);
@@ -84,6 +86,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
     renderCounts->set2dWorldTransform(glm::vec2(options->getScreenWidth() - 170, options->getScreenHeight() - 36), 0);
 
     cursor = new GUICursor(graphicsWrapper, assetManager, "./Data/Textures/crosshair.png");
+    guiSpriteBatch = new GUISpriteBatch(graphicsWrapper);
 
     cursor->set2dWorldTransform(glm::vec2(options->getScreenWidth()/2.0f, options->getScreenHeight()/2.0f), 0);
 
@@ -120,7 +123,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
     playerCamera->addRenderTag(HardCodedTags::OBJECT_MODEL_ANIMATED);
     playerCamera->addRenderTag(HardCodedTags::PICKED_OBJECT);
     playerCamera->addTag(HardCodedTags::CAMERA_PLAYER);
-    cullingResults.insert(std::make_pair(playerCamera, new std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>, VisibilityRequest::uint64_vector_hasher>()));//new camera, new visibility
+    cullingResults.insert(std::make_pair(playerCamera, new CameraVisibility()));//new camera, new visibility
     currentPlayer->registerToPhysicalWorld(dynamicsWorld, COLLIDE_PLAYER,
                                            COLLIDE_MODELS | COLLIDE_TRIGGER_VOLUME | COLLIDE_EVERYTHING,
                                            COLLIDE_MODELS | COLLIDE_EVERYTHING, worldAABBMin,
@@ -150,6 +153,12 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
     OptionsUtil::Options::Option<bool> multiThreadCullingOption = options->getOption<bool>(HASH("multiThreadedCulling"));
     renderInformationsOption = options->getOption<bool>(HASH("renderInformations"));
     multiThreadedCulling = multiThreadCullingOption.getOrDefault(true);
+    multiThreadedAnimation = options->getOption<bool>(HASH("multiThreadedAnimation")).getOrDefault(true);
+    animationLodIntervals = options->getOption<std::vector<long>>(HASH("AnimationLodIntervalList")).getOrDefault(std::vector<long>());
+    lightClusterDistance = (float)options->getOption<double>(HASH("LightClusterDistance")).getOrDefault(150.0);
+    particleOffscreenUpdateInterval = options->getOption<long>(HASH("ParticleOffscreenUpdateInterval")).getOrDefault(0L);
+    shadowUpdateScheduler.setLimits((uint32_t)options->getOption<long>(HASH("ShadowUpdateBudget")).getOrDefault(0L),
+                                    (uint32_t)options->getOption<long>(HASH("ShadowFarUpdateInterval")).getOrDefault(4L));
 
     /************ ImGui *****************************/
     // Setup ImGui binding
@@ -170,49 +179,120 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
        renderMethods.renderQuad                         = std::bind(&QuadRender::render,                                this->quadRender,   std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
 
        renderMethods.getLightsByType = std::bind(&World::getLightIndexes, this, std::placeholders::_1);
-       renderMethods.renderLight = std::bind(&World::renderLight, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+       renderMethods.renderLight = std::bind(&World::renderLight, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+       renderMethods.isShadowLayerScheduled = std::bind(&World::isShadowLayerScheduled, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
        return renderMethods;
    }
 
-   bool World::checkPlayerVisibility(const glm::vec3 &from, const std::string &fromName) {
-     //FIXME this debug draw creates a flicker, because we redraw frames that surpass 60. we need duration for debug draw to prevent it
-     //debugDrawer->drawLine(GLMConverter::GLMToBlt(from), camera.getRigidBody()->getCenterOfMassPosition(), btVector3(1,0,0));
-     btCollisionWorld::AllHitsRayResultCallback RayCallback(GLMConverter::GLMToBlt(from), GLMConverter::GLMToBlt(currentPlayer->getPosition()));
-
-     dynamicsWorld->rayTest(
-             GLMConverter::GLMToBlt(from),
-             GLMConverter::GLMToBlt(currentPlayer->getPosition()),
-             RayCallback
-     );
-
-
-     if (RayCallback.hasHit()) {
-         btVector3 closestDistance = btVector3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-         bool hasSeen = false;
-         for (int i = 0; i < RayCallback.m_collisionObjects.size(); ++i) {//it turns out, the hits are not ordered, so keep what we see
-             btVector3 distance = RayCallback.m_hitPointWorld[i] - RayCallback.m_rayFromWorld;
-             if(distance.length2() < closestDistance.length2()) {//length2 doesn't invoke sqtr, so it should be faster
-                 GameObject *gameObject = static_cast<GameObject *>(RayCallback.m_collisionObjects[i]->getUserPointer());
-                 if(gameObject->getName() == fromName) {
-                     continue; //self should not change closest hit
-                 }
-                 closestDistance = distance;
-                 if (gameObject->getTypeID() != GameObject::PLAYER && gameObject->getTypeID() != GameObject::TRIGGER ) { //trigger is ghost, so it should not block
-                     if(hasSeen) {
-                         //means we saw the player, and this is closer than player
-                         return false;
-                     }
-                 }
-                 if (gameObject->getTypeID() == GameObject::PLAYER) {
-                     hasSeen = true;
-                 }
-             }
-         }
+/**
+ * Emitters in player camera are simulated in parallel, one job per emitter. Simulation doesn't touch graphics, uploads
+ * are done after all jobs are done, on main thread.
+ *
+ * Emitters out of the camera are not simulated, or simulated every particleOffscreenUpdateInterval ms if it is set.
+ * They catch up with the missed ticks when they are simulated again. Particles are seeded per tick, so they don't depend
+ * on when the emitter is seen, unless the emitter was at its maximum count in the skipped ticks.
+ */
+void World::updateEmitters(long tickDuration) {
+    if(emitters.empty()) {
+        return;
+    }
+    //jobs read emitter positions, so nothing should be left to resolve lazily
+    TransformHierarchy::getInstance().update();
+    emitterAABBs.resize(emitters.size());
+    uint32_t emitterIndex = 0;
+    for (const auto &emitter: emitters) {
+        glm::vec3 aabbMin, aabbMax;
+        emitter.second->getBounds(tickDuration, aabbMin, aabbMax);
+        emitterAABBs.set(emitterIndex++, aabbMin, aabbMax);
+    }
+    emitterVisibilityMask.assign(AABBArray::getMaskWordCount(emitters.size()), 0);
+    playerCamera->cullAABBs(emitterAABBs, 0, emitters.size(), emitterVisibilityMask.data());
 
-         return hasSeen;
-     }
-     return false;//if ray did not hit anything, return false. This should never happen
- }
+    emitterUpdates.clear();
+    emitterIndex = 0;
+    for (const auto &emitter: emitters) {
+        bool visible = AABBArray::isVisible(emitterVisibilityMask.data(), emitterIndex++);
+        if(visible || (particleOffscreenUpdateInterval > 0 && gameTime - emitter.second->getLastSimulationTime() >= particleOffscreenUpdateInterval)) {
+            emitterUpdates.emplace_back(emitter.second.get(), visible);
+        }
+    }
+
+    long time = gameTime;
+    SDL2MultiThreading::JobSystem::Counter emitterCounter;
+    jobSystem->parallelFor(emitterUpdates.size(), 1, [this, time, tickDuration](uint32_t start, uint32_t end) {
+        for (uint32_t i = start; i < end; ++i) {
+            emitterUpdates[i].emitter->catchUp(time, tickDuration);
+        }
+    }, &emitterCounter);
+    jobSystem->waitFor(&emitterCounter);
+
+    LIMON_PROFILE_ZONE("Emitter uploads");
+    for (const EmitterUpdate &emitterUpdate: emitterUpdates) {
+        if(emitterUpdate.visible) {
+            emitterUpdate.emitter->uploadParticleData();
+        }
+    }
+}
+
+/**
+ * Sets up all visible models for the game time. Poses of animated models are calculated in parallel, each model writes
+ * only to its own bone buffer. Then physics is updated serially, since bullet compound shapes are not thread safe.
+ *
+ * If animation lod intervals are set, distant models calculate their poses less frequently. Lod of a model is the
+ * lowest lod it has in any camera.
+ */
+void World::setupVisibleModelsForTime() {
+    LIMON_PROFILE_ZONE("Animation");
+    poseSetups.clear();
+    poseSetupIndices.clear();
+    for (const auto &visibility: cullingResults) {
+        auto requestIt = visibilityRequests.find(visibility.first);
+        const VisibilityRequest* request = requestIt == visibilityRequests.end() ? nullptr : requestIt->second;
+        for (const auto &visibleTags: visibility.second->getVisibleTagSets()){
+            for (const auto &visibleAssets: visibleTags.getAssets()) {
+                for (const auto &visibleObjectId: visibleAssets.objectIDs) {
+                    uint32_t lod = request == nullptr ? visibleAssets.lod : request->getVisibleLod(visibleObjectId);
+                    auto setupIndexIt = poseSetupIndices.find(visibleObjectId);
+                    if (setupIndexIt != poseSetupIndices.end()) {
+                        poseSetups[setupIndexIt->second].lod = std::min(poseSetups[setupIndexIt->second].lod, lod);
+                        continue;
+                    }
+                    Model* model = dynamic_cast<Model*>(objects[visibleObjectId]);
+                    if(model == nullptr) {
+                        objects[visibleObjectId]->setupForTime(gameTime);
+                        poseSetupIndices[visibleObjectId] = std::numeric_limits<uint32_t>::max();
+                        continue;
+                    }
+                    poseSetupIndices[visibleObjectId] = poseSetups.size();
+                    poseSetups.emplace_back(model, lod);
+                }
+            }
+        }
+    }
+
+    auto evaluatePoses = [this](uint32_t start, uint32_t end) {
+        LIMON_PROFILE_ZONE("Pose evaluation");
+        for (uint32_t i = start; i < end; ++i) {
+            long updateInterval = 0;
+            if(!animationLodIntervals.empty()) {
+                updateInterval = animationLodIntervals[std::min((size_t)poseSetups[i].lod, animationLodIntervals.size() - 1)];
+            }
+            poseSetups[i].poseUpdated = poseSetups[i].model->evaluatePose(gameTime, updateInterval);
+        }
+    };
+    if(multiThreadedAnimation) {
+        SDL2MultiThreading::JobSystem::Counter poseCounter;
+        jobSystem->parallelFor(poseSetups.size(), 4, evaluatePoses, &poseCounter);
+        jobSystem->waitFor(&poseCounter);
+    } else {
+        evaluatePoses(0, poseSetups.size());
+    }
+
+    LIMON_PROFILE_ZONE("Apply poses");
+    for (PoseSetup &poseSetup: poseSetups) {
+        poseSetup.model->applyPose(poseSetup.poseUpdated);
+    }
+}
 
  /**
   * Simulates given time (it should be constantant), reads input, animates models etc.
@@ -222,6 +302,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
   * @return
   */
  void World::play(Uint32 simulationTimeFrame, InputHandler &inputHandler, uint64_t wallTime) {
+     LIMON_PROFILE_ZONE("World::play");
 
      // If not in editor mode, dont let imgGuiHelper get input
      // if in editor mode, but player press editor button, dont allow imgui to process input
@@ -236,6 +317,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
      this->wallTime = wallTime;
      //Seperating physics step and visibility, because physics is used by camera, and camera is used by visibility
      if(currentPlayersSettings->worldSimulation) {
+         LIMON_PROFILE_ZONE("Physics");
          //every time we call this method, we increase the time only by simulationTimeframe
          gameTime += simulationTimeFrame;
          dynamicsWorld->stepSimulation(simulationTimeFrame / 1000.0f);
@@ -248,57 +330,77 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
      }
 
      if(currentPlayersSettings->worldSimulation) {
-         for(const auto& emitter:emitters) {
-             emitter.second->setupForTime(gameTime);
-         }
+         {
+             LIMON_PROFILE_ZONE("Emitters");
+             updateEmitters(simulationTimeFrame);
 
-         for(const auto& gpuEmitter:gpuParticleEmitters) {
-             gpuEmitter.second->setupForTime(gameTime);
+             //GPU emitters only upload when their parameters change, so they are kept on main thread
+             for (const auto &gpuEmitter: gpuParticleEmitters) {
+                 gpuEmitter.second->setupForTime(gameTime);
+             }
          }
-
-         for(auto trigger = triggers.begin(); trigger != triggers.end(); trigger++) {
-             trigger->second->checkAndTrigger();
+         {
+             LIMON_PROFILE_ZONE("Triggers");
+             for (auto trigger = triggers.begin(); trigger != triggers.end(); trigger++) {
+                 trigger->second->checkAndTrigger();
+             }
          }
          animateCustomAnimations();
-         for(auto actorIt = actors.begin(); actorIt != actors.end(); ++actorIt) {
-             ActorInterface::ActorInformation information = fillActorInformation(actorIt->second);
-             actorIt->second->play(gameTime, information);
-         }
-         for (auto it = objects.begin(); it != objects.end(); ++it) {
-             if (!it->second->getRigidBody()->isStaticOrKinematicObject() && it->second->getRigidBody()->isActive()) {
-                 it->second->updateTransformFromPhysics();
-                 Model* model = dynamic_cast<Model*>(it->second);
-                 assert(model!= nullptr);
-                 updatedModels.push_back(model);
+         {
+             LIMON_PROFILE_ZONE("Actors");
+             if (routeService != nullptr) {
+                 routeService->update(gameTime);
+             }
+             //line of sight rays of all actors are tested together, before any actor plays
+             for (auto actorIt = actors.begin(); actorIt != actors.end(); ++actorIt) {
+                 auto objectIt = objects.find(actorIt->second->getModelID());
+                 if (objectIt != objects.end()) {
+                     perception.registerActor(actorIt->first, objectIt->second->getRigidBody(),
+                                              actorIt->second->getPosition() + glm::vec3(0, AIMovementGrid::floatingHeight + 1.0f, 0),
+                                              actorIt->second->getVisibilityUpdateInterval());
+                 }
+             }
+             perception.update(dynamicsWorld, currentPlayer->getPosition(), gameTime);
+             for (auto actorIt = actors.begin(); actorIt != actors.end(); ++actorIt) {
+                 ActorInterface::ActorInformation information = fillActorInformation(actorIt->second);
+                 actorIt->second->play(gameTime, information);
              }
          }
-
-         tempRenderedObjectsSet.clear();
-         for (const auto &visibility: cullingResults) {
-             for (const auto &visibleTags: *visibility.second){
-                 for (const auto &visibleAssets: visibleTags.second) {
-                     for (const auto &visibleObjectId: visibleAssets.second.first) {
-                         if (tempRenderedObjectsSet.find(visibleObjectId) == tempRenderedObjectsSet.end()) {
-                             objects[visibleObjectId]->setupForTime(gameTime);
-                             tempRenderedObjectsSet.insert(visibleObjectId);
-                         }
-                     }
+         {
+             LIMON_PROFILE_ZONE("Physics transforms");
+             for (auto it = objects.begin(); it != objects.end(); ++it) {
+                 if (!it->second->getRigidBody()->isStaticOrKinematicObject() && it->second->getRigidBody()->isActive()) {
+                     it->second->updateTransformFromPhysics();
+                     Model* model = dynamic_cast<Model*>(it->second);
+                     assert(model!= nullptr);
+                     updatedModels.push_back(model);
                  }
              }
          }
 
+         setupVisibleModelsForTime();
+
          //Player setup
          if(startingPlayer.attachedModel != nullptr) {
              startingPlayer.attachedModel->setupForTime(gameTime);
          }
      }
 
-     for (size_t j = 0; j < activeLights.size(); ++j) {
-         activeLights[j]->step(gameTime, playerCamera);
+     {
+         LIMON_PROFILE_ZONE("Lights");
+         for (size_t j = 0; j < activeLights.size(); ++j) {
+             uint32_t cascadeMask = 0;
+             if(activeLights[j]->getLightType() == Light::LightTypes::DIRECTIONAL) {
+                 cascadeMask = shadowUpdateScheduler.selectCascadesToRecalculate(activeLights[j]->getCameras().size(), playerCamera->isDirty());
+             }
+             activeLights[j]->step(gameTime, playerCamera, cascadeMask);
+         }
+         updateActiveLights(false);
+         updateLightClusters();
      }
-     updateActiveLights(false);
 
      fillVisibleObjectsUsingTags();
+     scheduleShadowUpdates();
 
      //FIXME moved out of fillVisible because for the time being we have 2 (fillVisibleObjects(), fillVisibleObjectsUsingTags()) once one is gone, these 2 clears should go in.
      updatedModels.clear();
@@ -307,6 +409,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
         sky->step(playerCamera);
     }
 
+    LIMON_PROFILE_ZONE("GUI");
     for (unsigned int i = 0; i < guiLayers.size(); ++i) {
         guiLayers[i]->setupForTime(gameTime);
     }
@@ -346,6 +449,7 @@ World::World(const std::string &name, PlayerInfo startingPlayerType, InputHandle
 }
 
 void World::animateCustomAnimations() {
+    LIMON_PROFILE_ZONE("Custom animations");
     // ATTENTION iterator is not increased in for, it is done manually.
     for(auto animIt = activeAnimations.begin(); animIt != activeAnimations.end();) {
         AnimationStatus* animationStatus = animIt->second;
@@ -430,178 +534,227 @@ void World::resetCameraTagsFromPipeline(const std::map<std::string, std::vector<
             if(cameraEntryForCulling.first->hasTag(HashUtil::hashString(renderTagListMapFromPipelineForCamera.first))) {
                 //we have a camera and a renderStage match, update the tag information.
                 // in renderTagListMapFromPipelineForCamera we have a list, in the list each element is a set of tags. we want to convert them and create new entries based on that
-                cameraEntryForCulling.second->clear();
-                for(std::set<std::string> tagSet:renderTagListMapFromPipelineForCamera.second) {
+                std::vector<std::vector<uint64_t>> tagSets;
+                for(const std::set<std::string>& tagSet:renderTagListMapFromPipelineForCamera.second) {
                     std::vector<uint64_t> tempHashList;
-                    for(std::string tagString: tagSet) {
-                        uint64_t tempHash = HashUtil::hashString(tagString);
-                        tempHashList.emplace_back(tempHash);
+                    for(const std::string& tagString: tagSet) {
+                        HashUtil::HashedString tag(tagString);
+                        TagRegistry::registerTag(tag);//so visibility can map the tag by its bit
+                        tempHashList.emplace_back(tag.hash);
                     }
-                    //One set is done, put it in the culling data structure
-                    cameraEntryForCulling.second->insert(std::make_pair(tempHashList, std::unordered_map<uint32_t,std::pair<std::vector<uint32_t>, uint32_t>>()));
+                    tagSets.emplace_back(tempHashList);
                 }
+                //tag sets are resolved to indexes here, so culling doesn't search for them per object
+                cameraEntryForCulling.second->setTagSets(tagSets);
             }
         }
     }
 }
 
-void* fillVisibleObjectPerCamera(const void* visibilityRequestRaw) {
-       const VisibilityRequest* visibilityRequest = static_cast<const VisibilityRequest *>(visibilityRequestRaw);
-       std::vector<long> lodDistances = visibilityRequest->lodDistancesOption.get();
-       float skipRenderDistance = 0, skipRenderSize = 0, maxSkipRenderSize = 0;
-       glm::mat4 viewMatrix;
-       if(visibilityRequest->camera->getType() == Camera::CameraTypes::PERSPECTIVE ||
-               visibilityRequest->camera->getType() == Camera::CameraTypes::ORTHOGRAPHIC) {
-           skipRenderDistance = visibilityRequest->skipRenderDistanceOption.get();
-           skipRenderSize = visibilityRequest->skipRenderSizeOption.get();
-           maxSkipRenderSize = visibilityRequest->maxSkipRenderSizeOption.get();
-           viewMatrix = visibilityRequest->camera->getProjectionMatrix() * visibilityRequest->camera->getCameraMatrixConst();
-       }
-       for (auto objectIt = visibilityRequest->objects->begin(); objectIt != visibilityRequest->objects->end(); ++objectIt) {
-           if(!visibilityRequest->camera->isDirty() && !objectIt->second->isDirtyForFrustum()) {
-               continue; //if neither object nor camera dirty, no need to recalculate
-           }
-           Model *currentModel = dynamic_cast<Model *>(objectIt->second);
-           for(const auto& tag: currentModel->getTags()) {
-               if(visibilityRequest->camera->hasRenderTag(tag.hash)){
-                   //does this camera have the entry for this tag?
-                   const auto& tagEntries = visibilityRequest->findHashEntry(tag.hash);
-                   if(tagEntries == visibilityRequest->visibility->end()) {
-                       /**
-                        * Lets understand what this means
-                        * 1) model had this tag
-                        * 2) camera for this culling request also has this render tag
-                        * 3) visibility request itself doesn't have this tag
-                        *
-                        * why would 3 happen? Because a tag that camera can render, doesn't mean we have a stage that render is meaningful
-                        * Stages are already filled in the World::cullingResults, so this is a case where we cancel
-                        */
-                       continue;
-
-                       //create the tag entry
-                       /*********************************************************************************************
-                        * *********************************************************************************************
-                        * *********************************************************************************************
-                        * *********************************************************************************************
-                        * *********************************************************************************************
-                        * *********************************************************************************************
-                        *
-                        */
-                        std::vector<uint64_t> temp;
-                        temp.push_back(tag.hash);
-                       (*visibilityRequest->visibility).insert(std::make_pair(temp, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>()));
-                   }
-                   //we matched a tag for this camera, we should add here, and then break so we don't add to others
-                   bool isVisible = visibilityRequest->camera->isVisible(*currentModel);//find if visible
-                   auto tagVisibilityEntry = visibilityRequest->findHashEntry(tag.hash);//no need to check, as we already created if didn't exist
-                   auto assetVisibilityEntry = tagVisibilityEntry->second.find(currentModel->getAssetID());
-                   if(isVisible) {
-                       if (assetVisibilityEntry == tagVisibilityEntry->second.end()) {
-                           tagVisibilityEntry->second[currentModel->getAssetID()] = std::make_pair(std::vector<uint32_t>(), SKIP_LOD_LEVEL);
-                       }
-
-                       uint32_t lod = World::getLodLevel(lodDistances, skipRenderDistance, skipRenderSize, maxSkipRenderSize, viewMatrix, visibilityRequest->playerPosition, objectIt->second);
-                       if(lod != SKIP_LOD_LEVEL) {
-                           tagVisibilityEntry->second[currentModel->getAssetID()].second = std::min(tagVisibilityEntry->second[currentModel->getAssetID()].second, lod);
-                           //check if this thing is already in the list of things to render
-                           auto objectIndexIterator = std::find(tagVisibilityEntry->second[currentModel->getAssetID()].first.begin(),
-                                                                tagVisibilityEntry->second[currentModel->getAssetID()].first.end(), currentModel->getWorldObjectID());
-                           if (objectIndexIterator == tagVisibilityEntry->second[currentModel->getAssetID()].first.end()) {
-                               tagVisibilityEntry->second[currentModel->getAssetID()].first.emplace_back(currentModel->getWorldObjectID());
-                           }
-                       }
-                   } else { //not visible
-                       if(assetVisibilityEntry == tagVisibilityEntry->second.end()) {
-                           //it was never in the visible set, ignore.
-                       } else {
-                           //this asset was in visible set, but was this game object in the visible set?
-                           for (auto modelIdIterator = assetVisibilityEntry->second.first.begin(); modelIdIterator != assetVisibilityEntry->second.first.end(); modelIdIterator++) {
-                               if((*modelIdIterator) == currentModel->getWorldObjectID()) {
-                                   assetVisibilityEntry->second.first.erase(modelIdIterator);
-                                   //so we removed the element. should we drop the entry itself?
-                                   if(assetVisibilityEntry->second.first.empty()) {
-                                       tagVisibilityEntry->second.erase(assetVisibilityEntry);
-                                   }
-                                   break;
-                               }
-                           }
-                       }
-                   }
-               }
-           }
-       }
-       return visibilityRequest->visibility;
-   }
+static const uint32_t CULLING_BATCH_SIZE = 256;
 
-static int staticOcclusionThread(void* visibilityRequestRaw) {
-    VisibilityRequest* visibilityRequest = static_cast<VisibilityRequest *>(visibilityRequestRaw);
-    //std::cout << "Thread for  " << visibilityRequest->camera->getName() << " launched, waiting for condition" << std::endl;
-    //std::cout << "Thread for  " << visibilityRequest->camera->getName() << " started" << std::endl;
-    while(visibilityRequest->running) {
-        visibilityRequest->frameCount.fetch_add(1);
-        fillVisibleObjectPerCamera(visibilityRequestRaw);
-        visibilityRequest->inProgressLock.unlock();
-        //std::cout << "Processing done for camera " << visibilityRequest->camera->getName() << " now waiting for condition" << std::endl;
-        VisibilityRequest::condition.waitCondition(visibilityRequest->blockMutex);
-        visibilityRequest->inProgressLock.lock();
-        //std::cout << "signal received by " << visibilityRequest->camera->getName() << " starting processing again" << std::endl;
-    }
-    visibilityRequest->inProgressLock.unlock();
-    return 0;
+static void prepareVisibilityRequest(VisibilityRequest* visibilityRequest) {
+    visibilityRequest->lodDistances = visibilityRequest->lodDistancesOption.get();
+    if(visibilityRequest->camera->getType() == Camera::CameraTypes::PERSPECTIVE ||
+       visibilityRequest->camera->getType() == Camera::CameraTypes::ORTHOGRAPHIC) {
+        visibilityRequest->skipRenderDistance = visibilityRequest->skipRenderDistanceOption.get();
+        visibilityRequest->skipRenderSize = visibilityRequest->skipRenderSizeOption.get();
+        visibilityRequest->maxSkipRenderSize = visibilityRequest->maxSkipRenderSizeOption.get();
+        visibilityRequest->viewMatrix = visibilityRequest->camera->getProjectionMatrix() * visibilityRequest->camera->getCameraMatrixConst();
+    }
+    visibilityRequest->fullRefill = visibilityRequest->camera->isDirty() || visibilityRequest->visibility->isRefillRequired();
+    if(!visibilityRequest->lodDistances.empty()) {
+        visibilityRequest->maxLodDistance = (float)visibilityRequest->lodDistances.back();
+    } else {
+        visibilityRequest->maxLodDistance = AABBTree::NO_DISTANCE_LIMIT;
+    }
+    visibilityRequest->objectLods.resize(visibilityRequest->objects->size());
+    visibilityRequest->visibilityMask.resize(AABBArray::getMaskWordCount(visibilityRequest->objects->size()));
 }
 
-std::map<VisibilityRequest*, SDL_Thread *> World::occlusionThreadManager() {
-    std::map<VisibilityRequest*, SDL_Thread*> visibilityProcessing;
-    for (auto &cameraVisibility: cullingResults) {
-        VisibilityRequest* request = new VisibilityRequest(cameraVisibility.first, &this->objects, cameraVisibility.second, currentPlayer->getPosition(), options);
-        SDL_Thread* thread = SDL_CreateThread(staticOcclusionThread, request->camera->getName().c_str(), request);
-        visibilityProcessing[request] = thread;
+static uint32_t calculateObjectLod(const VisibilityRequest* visibilityRequest, Model* currentModel, bool isVisible) {
+    if(!isVisible) {
+        return SKIP_LOD_LEVEL;
+    }
+    //object should have a tag that camera renders, and some stage of the pipeline renders for this camera
+    if((currentModel->getTagMask() & visibilityRequest->camera->getRenderTagMask() & visibilityRequest->visibility->getTagSetMask()).none()) {
+        return SKIP_LOD_LEVEL;
+    }
+    return World::getLodLevel(visibilityRequest->lodDistances, visibilityRequest->skipRenderDistance, visibilityRequest->skipRenderSize,
+                              visibilityRequest->maxSkipRenderSize, visibilityRequest->viewMatrix, visibilityRequest->playerPosition, currentModel);
+}
+
+/**
+ * Calculates lod for objects in [start, end). Only writes to objectLods entries of that range, so ranges can run in parallel.
+ */
+static void cullObjectRange(VisibilityRequest* visibilityRequest, uint32_t start, uint32_t end) {
+    LIMON_PROFILE_ZONE("Cull range");
+    const std::vector<Model *>& objects = *visibilityRequest->objects;
+    //frustum test for the whole range at once, it is cheaper than checking which objects are dirty first
+    visibilityRequest->camera->cullAABBs(*visibilityRequest->aabbs, start, end, visibilityRequest->visibilityMask.data());
+    for (uint32_t i = start; i < end; ++i) {
+        Model *currentModel = objects[i];
+        if(!visibilityRequest->fullRefill && !currentModel->isDirtyForFrustum()) {
+            visibilityRequest->objectLods[i] = VisibilityRequest::NOT_PROCESSED; //if neither object nor camera dirty, no need to recalculate
+            continue;
+        }
+        visibilityRequest->objectLods[i] = calculateObjectLod(visibilityRequest, currentModel,
+                                                              AABBArray::isVisible(visibilityRequest->visibilityMask.data(), i));
+    }
+}
+
+/**
+ * Used when camera results are cleared. Only the objects that the tree returns can be visible, others are left as not
+ * processed, which means not visible after a clear. Subtrees outside the frustum or the last lod distance are never visited.
+ */
+static void cullUsingTree(VisibilityRequest* visibilityRequest) {
+    LIMON_PROFILE_ZONE("Cull tree");
+    const std::vector<Model *>& objects = *visibilityRequest->objects;
+    const std::vector<uint32_t>& objectIndices = *visibilityRequest->objectIndices;
+    std::fill(visibilityRequest->objectLods.begin(), visibilityRequest->objectLods.end(), static_cast<uint32_t>(VisibilityRequest::NOT_PROCESSED));
+    visibilityRequest->candidateObjectIDs.clear();
+    visibilityRequest->camera->queryVisible(*visibilityRequest->tree, visibilityRequest->playerPosition, visibilityRequest->maxLodDistance,
+                                            visibilityRequest->candidateObjectIDs);
+    for (uint32_t objectID: visibilityRequest->candidateObjectIDs) {
+        if(objectID >= objectIndices.size() || objectIndices[objectID] >= objects.size()) {
+            continue;
+        }
+        uint32_t index = objectIndices[objectID];
+        Model *currentModel = objects[index];
+        //tree has fattened boxes, so candidates are checked against the exact ones
+        visibilityRequest->objectLods[index] = calculateObjectLod(visibilityRequest, currentModel, visibilityRequest->camera->isVisible(*currentModel));
+    }
+}
+
+/**
+ * Moves the range results to the camera visibility. Runs after all ranges of the camera are done.
+ */
+static void applyVisibilityResults(VisibilityRequest* visibilityRequest) {
+    LIMON_PROFILE_ZONE("Apply visibility");
+    const std::vector<Model *>& objects = *visibilityRequest->objects;
+    std::vector<uint32_t>& visibleObjectLods = visibilityRequest->visibleObjectLods;
+    visibleObjectLods.resize(visibilityRequest->objectIndices->size(), static_cast<uint32_t>(SKIP_LOD_LEVEL));
+    if(visibilityRequest->fullRefill) {
+        //not processed means not visible after a clear
+        std::fill(visibleObjectLods.begin(), visibleObjectLods.end(), static_cast<uint32_t>(SKIP_LOD_LEVEL));
+    }
+    for (size_t i = 0; i < objects.size(); ++i) {
+        uint32_t lod = visibilityRequest->objectLods[i];
+        if(lod == VisibilityRequest::NOT_PROCESSED) {
+            continue;
+        }
+        Model *currentModel = objects[i];
+        visibleObjectLods[currentModel->getWorldObjectID()] = lod;
+        /**
+         * Tags the camera can render, and some stage of the pipeline renders for this camera. Others are cancelled,
+         * tag sets are already filled by World::resetCameraTagsFromPipeline.
+         */
+        TagRegistry::TagMask renderedTags = currentModel->getTagMask() & visibilityRequest->camera->getRenderTagMask() & visibilityRequest->visibility->getTagSetMask();
+        for(uint32_t tagIndex = 0; renderedTags.any(); ++tagIndex) {
+            if(!renderedTags.test(tagIndex)) {
+                continue;
+            }
+            renderedTags.reset(tagIndex);
+            uint32_t tagSetIndex = visibilityRequest->visibility->findTagSetIndexByTag(tagIndex);
+            CameraVisibility::TagSetVisibility& tagSetVisibility = visibilityRequest->visibility->getWritableTagSet(tagSetIndex);
+            if(lod != SKIP_LOD_LEVEL) {
+                tagSetVisibility.insert(currentModel->getAssetID(), currentModel->getWorldObjectID(), lod);
+            } else {
+                tagSetVisibility.remove(currentModel->getAssetID(), currentModel->getWorldObjectID());
+            }
+        }
     }
-    return visibilityProcessing;
 }
 
 void World::fillVisibleObjectsUsingTags() {
+    LIMON_PROFILE_ZONE("Culling");
+    {
+        LIMON_PROFILE_ZONE("Transforms");
+        //culling jobs read transforms in parallel, so nothing should be left to resolve lazily
+        TransformHierarchy::getInstance().update();
+    }
      //first clear up dirty cameras
     for (auto &it: cullingResults) {
         if (it.first->isDirty()) {
-            for(auto renderEntries:*it.second) {
-                renderEntries.second.clear();
-            }
+            it.second->clearWritable();
         }
     }
-    if(multiThreadedCulling) {
-        if (visibilityThreadPool.empty()) {
-            visibilityThreadPool = occlusionThreadManager();
-            for (const auto &item: visibilityThreadPool) {
-                item.first->inProgressLock.lock();
-                item.first->inProgressLock.unlock();
+    if(cullingObjectsDirty) {
+        cullingObjects.clear();
+        cullingObjectIndices.clear();
+        for (auto objectIt = objects.begin(); objectIt != objects.end(); ++objectIt) {
+            Model* model = dynamic_cast<Model *>(objectIt->second);
+            if(model != nullptr) {
+                if(cullingObjectIndices.size() <= model->getWorldObjectID()) {
+                    cullingObjectIndices.resize(model->getWorldObjectID() + 1, std::numeric_limits<uint32_t>::max());
+                }
+                cullingObjectIndices[model->getWorldObjectID()] = cullingObjects.size();
+                cullingObjects.emplace_back(model);
             }
         }
+        //order changed, all AABBs should be refilled
+        cullingAABBs.resize(cullingObjects.size());
+        for (size_t i = 0; i < cullingObjects.size(); ++i) {
+            cullingAABBs.set(i, cullingObjects[i]->getAabbMin(), cullingObjects[i]->getAabbMax());
+            spatialTree.update(cullingObjects[i]->getWorldObjectID(), cullingObjects[i]->getAabbMin(), cullingObjects[i]->getAabbMax());
+        }
+        cullingObjectsDirty = false;
+        staticShadowCastersChanged = true;//objects added or removed
+    } else {
+        //only the objects that moved need their AABBs updated. This covers updatedModels, and objects moved by editor or API
+        for (size_t i = 0; i < cullingObjects.size(); ++i) {
+            if (cullingObjects[i]->isDirtyForFrustum()) {
+                movedCullingObjectIDs.push_back(cullingObjects[i]->getWorldObjectID());
+                cullingAABBs.set(i, cullingObjects[i]->getAabbMin(), cullingObjects[i]->getAabbMax());
+                spatialTree.update(cullingObjects[i]->getWorldObjectID(), cullingObjects[i]->getAabbMin(), cullingObjects[i]->getAabbMax());
+            }
+        }
+    }
+    for (auto &cameraVisibility: cullingResults) {
+        VisibilityRequest*& request = visibilityRequests[cameraVisibility.first];
+        if(request == nullptr) {
+            request = new VisibilityRequest(cameraVisibility.first, &this->cullingObjects, &this->cullingAABBs, &this->spatialTree,
+                                            &this->cullingObjectIndices, cameraVisibility.second, currentPlayer->getPosition(), options);
+        }
+        request->playerPosition = currentPlayer->getPosition();
+        prepareVisibilityRequest(request);
+    }
 
-        //std::cout << "          new frame, trigger occlusion threads" << std::endl;
-        uint32_t lastFrameCount = visibilityThreadPool.begin()->first->frameCount.load();
-        VisibilityRequest::condition.signalWaiting();
-
-        for (const auto &item: visibilityThreadPool) {
-            while (item.first->frameCount == lastFrameCount) {
-                //busy wait until frame starts
+    if(multiThreadedCulling) {
+        //cameras that need full refill query the tree in a single job,
+        //others are split to object ranges, and a camera's results are applied when all its ranges are done
+        SDL2MultiThreading::JobSystem::Counter cullingCounter;
+        for (auto &requestEntry: visibilityRequests) {
+            VisibilityRequest* request = requestEntry.second;
+            if(request->fullRefill) {
+                jobSystem->submit([request]() {
+                    cullUsingTree(request);
+                    applyVisibilityResults(request);
+                }, &cullingCounter);
+                continue;
             }
-            item.first->inProgressLock.lock();
-            item.first->playerPosition = currentPlayer->getPosition();
-            item.first->inProgressLock.unlock();
+            jobSystem->parallelFor(cullingObjects.size(), CULLING_BATCH_SIZE, [request](uint32_t start, uint32_t end) {
+                cullObjectRange(request, start, end);
+            }, &request->rangeCounter);
+            jobSystem->submitAfter(&request->rangeCounter, [request]() {
+                applyVisibilityResults(request);
+            }, &cullingCounter);
         }
+        //main thread helps with the culling jobs until all cameras are done
+        jobSystem->waitFor(&cullingCounter);
     } else {
-        if(visibilityThreadPool.empty()) {
-            for (auto &cameraVisibility: cullingResults) {
-                VisibilityRequest* request = new VisibilityRequest(cameraVisibility.first, &this->objects, cameraVisibility.second, currentPlayer->getPosition(), options);
-                visibilityThreadPool[request] = nullptr;
+        for (auto &requestEntry: visibilityRequests) {
+            if(requestEntry.second->fullRefill) {
+                cullUsingTree(requestEntry.second);
+            } else {
+                cullObjectRange(requestEntry.second, 0, cullingObjects.size());
             }
-        }
-        for (const auto &item: visibilityThreadPool) {
-            item.first->playerPosition = currentPlayer->getPosition();
-            fillVisibleObjectPerCamera(item.first);
+            applyVisibilityResults(requestEntry.second);
         }
     }
+    for (auto &requestEntry: visibilityRequests) {
+        requestEntry.second->visibility->publish();
+    }
     for (auto objectIt = objects.begin(); objectIt != objects.end(); ++objectIt) {
         //all cameras calculated, clear dirty for object
         objectIt->second->setCleanForFrustum();
@@ -611,15 +764,112 @@ void World::fillVisibleObjectsUsingTags() {
             it.first->clearDirty();//clear after processing so we can check while processing
         }
     }
+    for (Light *light: lights) {
+        //light changes are already applied to light uniforms and culling, so they shouldn't force a refill next frame
+        light->setFrustumChanged(false);
+    }
+}
+
+/**
+ * Collects the casters that moved this frame, and lets the scheduler pick the shadow layers to render.
+ * Static casters moving invalidates all static caches, dynamic ones only invalidate the layers they are visible in,
+ * or were rendered to at the last update of the layer.
+ */
+void World::scheduleShadowUpdates() {
+    LIMON_PROFILE_ZONE("Shadow scheduling");
+    movingShadowCasterIDs.clear();
+    const uint32_t staticTagIndex = getStaticTagIndex();
+    for (uint32_t objectID: movedCullingObjectIDs) {
+        auto objectIt = objects.find(objectID);
+        if(objectIt == objects.end()) {
+            continue;//removed after it moved
+        }
+        Model *model = dynamic_cast<Model *>(objectIt->second);
+        if(model == nullptr) {
+            continue;
+        }
+        if(isStaticShadowCaster(model, staticTagIndex)) {
+            staticShadowCastersChanged = true;
+        } else {
+            movingShadowCasterIDs.push_back(objectID);
+        }
+    }
+    movedCullingObjectIDs.clear();
+    for (const PoseSetup &poseSetup: poseSetups) {
+        if(poseSetup.poseUpdated) {
+            movingShadowCasterIDs.push_back(poseSetup.model->getWorldObjectID());
+        }
+    }
+    std::sort(movingShadowCasterIDs.begin(), movingShadowCasterIDs.end());
+    movingShadowCasterIDs.erase(std::unique(movingShadowCasterIDs.begin(), movingShadowCasterIDs.end()), movingShadowCasterIDs.end());
+
+    shadowUpdateScheduler.beginFrame(movingShadowCasterIDs, staticShadowCastersChanged);
+    staticShadowCastersChanged = false;
+    for (uint32_t slot = 0; slot < activeLights.size(); ++slot) {
+        const Light *light = activeLights[slot];
+        const std::vector<Camera *> &lightCameras = light->getCameras();
+        const std::vector<glm::mat4> &shadowMatrices = light->getShadowMatrices();
+        bool pointLight = light->getLightType() == Light::LightTypes::POINT;
+        for (uint32_t layer = 0; layer < lightCameras.size(); ++layer) {
+            //moved objects are always culled again, so the published results of the light camera are up to date for them
+            const auto visibilityIt = cullingResults.find(lightCameras[layer]);
+            if(visibilityIt == cullingResults.end()) {
+                visibleMovingCasterIDs = movingShadowCasterIDs;
+            } else {
+                visibleMovingCasterIDs.clear();
+                for (uint32_t casterID: movingShadowCasterIDs) {
+                    if(visibilityIt->second->isVisible(casterID)) {
+                        visibleMovingCasterIDs.push_back(casterID);
+                    }
+                }
+            }
+            bool near;
+            if(pointLight) {
+                near = glm::distance(currentPlayer->getPosition(), light->getPosition()) < light->getActiveDistance();
+            } else {
+                near = layer == 0;
+            }
+            //point lights render all faces in a single pass, first face is enough to detect light changes
+            const glm::mat4 &shadowMatrix = pointLight ? shadowMatrices[0] : shadowMatrices[layer];
+            shadowUpdateScheduler.addLayer(slot, layer, light, shadowMatrix, near, visibleMovingCasterIDs);
+        }
+    }
+    shadowUpdateScheduler.schedule();
+
+    //scheduler keeps the dynamic casters each layer renders, so a caster leaving the layer later still updates it
+    for (uint32_t slot = 0; slot < activeLights.size(); ++slot) {
+        const std::vector<Camera *> &lightCameras = activeLights[slot]->getCameras();
+        for (uint32_t layer = 0; layer < lightCameras.size(); ++layer) {
+            uint64_t staticVersion;
+            if(!shadowUpdateScheduler.isScheduled(slot, layer, staticVersion)) {
+                continue;
+            }
+            renderedDynamicCasterIDs.clear();
+            const auto visibilityIt = cullingResults.find(lightCameras[layer]);
+            if(visibilityIt != cullingResults.end()) {
+                for (const CameraVisibility::TagSetVisibility &tagSetVisibility: visibilityIt->second->getVisibleTagSets()) {
+                    for (const CameraVisibility::AssetVisibility &assetVisibility: tagSetVisibility.getAssets()) {
+                        for (uint32_t objectID: assetVisibility.objectIDs) {
+                            if(objectID < cullingObjectIndices.size() && cullingObjectIndices[objectID] < cullingObjects.size() &&
+                               !isStaticShadowCaster(cullingObjects[cullingObjectIndices[objectID]], staticTagIndex)) {
+                                renderedDynamicCasterIDs.push_back(objectID);
+                            }
+                        }
+                    }
+                }
+            }
+            std::sort(renderedDynamicCasterIDs.begin(), renderedDynamicCasterIDs.end());
+            renderedDynamicCasterIDs.erase(std::unique(renderedDynamicCasterIDs.begin(), renderedDynamicCasterIDs.end()), renderedDynamicCasterIDs.end());
+            shadowUpdateScheduler.setRenderedDynamicCasters(slot, layer, renderedDynamicCasterIDs);
+        }
+    }
 }
 
 ActorInterface::ActorInformation World::fillActorInformation(ActorInterface *actor) {
     ActorInterface::ActorInformation information;
     Model* actorModel = dynamic_cast<Model*>(objects[actor->getModelID()]);
     if(actorModel != nullptr) {
-        information.canSeePlayerDirectly = checkPlayerVisibility(
-                actor->getPosition() + glm::vec3(0, AIMovementGrid::floatingHeight+1.0f, 0),
-                actorModel->getName());
+        information.canSeePlayerDirectly = perception.canSeePlayer(actor->getWorldID());
         if (currentPlayer->isDead()) {
             information.playerDead = true;
         }
@@ -665,69 +915,32 @@ ActorInterface::ActorInformation World::fillActorInformation(ActorInterface *act
             information.isPlayerDown = false;
         }
         ActorInterface::InformationRequest requests = actor->getRequests();
-        if (requests.routeToPlayer == true && routeThreads.find(actor->getWorldID()) == routeThreads.end()) {//if no thread is working for route to player
-            std::vector<LimonTypes::GenericParameter> parameters;
-            parameters.push_back(LimonTypes::GenericParameter());
-
-            parameters[0].value.vectorValue = GLMConverter::GLMToLimon(
-                    actor->getPosition() + glm::vec3(0, AIMovementGrid::floatingHeight, 0));
-            parameters.push_back(LimonTypes::GenericParameter());
-            parameters[1].value.longValues[0] = 2;
-            parameters[1].value.longValues[1] = actor->getWorldID();
-            parameters[1].value.longValues[2] = information.maximumRouteDistance;
-
-            std::function<std::vector<LimonTypes::GenericParameter>(
-                    std::vector<LimonTypes::GenericParameter>)> functionToRun =
-                    std::bind(&World::fillRouteInformation, this, std::placeholders::_1);
-            routeThreads[actor->getWorldID()] = new SDL2MultiThreading::Thread("FillRouteForActor", functionToRun, parameters);
-            routeThreads[actor->getWorldID()]->run();
-        }
-
-        if (routeThreads.find(actor->getWorldID()) != routeThreads.end() && routeThreads[actor->getWorldID()]->isThreadDone()) {
-            const std::vector<LimonTypes::GenericParameter>* route = routeThreads[actor->getWorldID()]->getResult();
-            for (size_t i = 0; i < route->size(); ++i) {
-                information.routeToRequest.push_back(glm::vec3(GLMConverter::LimonToGLM(route->at(i).value.vectorValue)));
-            }
-            delete routeThreads[actor->getWorldID()];
-            routeThreads.erase(actor->getWorldID());
-
-            if (information.routeToRequest.empty()) {
-                information.routeFound = false;
-            } else {
-                information.routeFound = true;
+        if (routeService != nullptr) {
+            if (requests.routeToPlayer == true && !routeService->isRequestPending(actor->getWorldID())) {
+                //player height is found here, background jobs don't use the physics world
+                glm::vec3 playerPosWithGrid = currentPlayer->getPosition();
+                if (grid->setProperHeight(&playerPosWithGrid, AIMovementGrid::floatingHeight, 0.0f, dynamicsWorld)) {
+                    routeService->requestRoute(actor->getWorldID(),
+                                               actor->getPosition() + glm::vec3(0, AIMovementGrid::floatingHeight, 0),
+                                               playerPosWithGrid, information.maximumRouteDistance);
+                } else {
+                    routeService->failRequest(actor->getWorldID());
+                }
+            }
+
+            AIRouteService::RouteResult routeResult;
+            if (routeService->takeResult(actor->getWorldID(), routeResult)) {
+                information.routeToRequest = std::move(routeResult.route);
+                information.routeFound = routeResult.found && !information.routeToRequest.empty();
+                information.routeTime = routeResult.time;
+                information.routeReady = true;
             }
-            information.routeReady = true;
         }
     }
     return information;
 }
 
 
-   //std::function<std::vector<LimonTypes::ParameterRequest>(std::vector<LimonTypes::ParameterRequest>)> functionToRun
-
-std::vector<LimonTypes::GenericParameter>
-World::fillRouteInformation(std::vector<LimonTypes::GenericParameter> parameters) const {
-    glm::vec3 fromPosition = glm::vec3(GLMConverter::LimonToGLM(parameters[0].value.vectorValue));
-    uint32_t actorID = (uint32_t)parameters[1].value.longValues[1];
-    uint32_t maximumDistance = (uint32_t)parameters[1].value.longValues[2];
-    std::vector<glm::vec3> route;
-    glm::vec3 playerPosWithGrid = currentPlayer->getPosition();
-    bool isPlayerReachable = grid->setProperHeight(&playerPosWithGrid, AIMovementGrid::floatingHeight, 0.0f,
-                                                      dynamicsWorld);
-    if (isPlayerReachable && grid->coursePath(fromPosition, playerPosWithGrid, actorID, maximumDistance, &route)) {
-        if (!route.empty()) {             
-            //Normally, this information should be used for straightening the path, but not yet.             
-            reverse(std::begin(route), std::end(route));
-            }
-       }
-    std::vector<LimonTypes::GenericParameter> routeList;
-    for (size_t i = 0; i < route.size(); ++i) {
-        LimonTypes::GenericParameter pr;
-        pr.value.vectorValue = GLMConverter::GLMToLimon(route[i]);
-        routeList.push_back(pr);
-    }
-    return routeList;
-}
 
    bool World::handlePlayerInput(InputHandler &inputHandler) {
     if(inputHandler.getInputStates().getInputEvents(InputStates::Inputs::MOUSE_BUTTON_LEFT)) {
@@ -815,17 +1028,21 @@ World::fillRouteInformation(std::vector<LimonTypes::GenericParameter> parameters
 }
 
 void World:: render() {
+    LIMON_PROFILE_ZONE("World::render");
+    graphicsWrapper->flushModelTransforms();//upload all transform changes of this frame at once
     renderPipeline->render();
 }
 
 void World::renderGUIImages(const std::shared_ptr<GraphicsProgram>& renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) const {
-    cursor->renderWithProgram(renderProgram, 0);
+    guiSpriteBatch->clear();
+    cursor->appendToBatch(*guiSpriteBatch);
 
     for (auto it = guiLayers.begin(); it != guiLayers.end(); ++it) {
-        (*it)->renderImageWithProgram(renderProgram);
+        (*it)->addImagesToBatch(*guiSpriteBatch);
     }
     //render API gui layer
-    apiGUILayer->renderImageWithProgram(renderProgram);
+    apiGUILayer->addImagesToBatch(*guiSpriteBatch);
+    guiSpriteBatch->render(renderProgram);
 
 }
 
@@ -890,25 +1107,24 @@ void World::renderCameraByTag(const std::shared_ptr<GraphicsProgram> &renderProg
                 if(std::find(alreadyRenderedTagHashes.begin(), alreadyRenderedTagHashes.end(), renderTag.hash) != alreadyRenderedTagHashes.end()) {
                     continue;
                 }
-                const auto& taggedEntries = VisibilityRequest::findHashEntry(visibilityEntry.second,renderTag.hash);
-                if(taggedEntries != visibilityEntry.second->end()) {
+                uint32_t tagSetIndex = visibilityEntry.second->findTagSetIndex(renderTag.hash);
+                if(tagSetIndex != CameraVisibility::INVALID_INDEX) {
                     //We found what we will render, all these entries will render, so all the tags should be considered rendered
-                    for (const auto &item: taggedEntries->first){
+                    for (const auto &item: visibilityEntry.second->getTagSetHashes(tagSetIndex)){
                         alreadyRenderedTagHashes.emplace_back(item);
                     }
                     //there are tagged entries, we should iterate and render
-                    for (const auto &assetVisibility: taggedEntries->second){
+                    for (const auto &assetVisibility: visibilityEntry.second->getVisibleTagSets()[tagSetIndex].getAssets()){
                         //we don't care about the asset part, but knowing they are all same asset means instanced rendering
-                        if(!assetVisibility.second.first.empty()) {
-                            const auto& perAssetElement = assetVisibility.second;
+                        if(!assetVisibility.objectIDs.empty()) {
                             //if not empty, then lets find a sample
-                            uint32_t modelId = *perAssetElement.first.begin();
+                            uint32_t modelId = assetVisibility.objectIDs[0];
                             Model *sampleModel = dynamic_cast<Model *>(objects.at(modelId));
                             if (sampleModel == nullptr) {
                                 std::cerr << "Sample model detection got a non model object for id " << modelId << " this should not have happened" << std::endl;
                                 continue;
                             }
-                            sampleModel->renderWithProgramInstanced(perAssetElement.first, *(renderProgram), perAssetElement.second);
+                            sampleModel->renderWithProgramInstanced(assetVisibility.objectIDs, *(renderProgram), assetVisibility.lod);
                         }
                     }
                 }
@@ -963,36 +1179,55 @@ void World::renderSky(const std::shared_ptr<GraphicsProgram>& renderProgram, con
    }
 }
 
-void World::renderLight(unsigned int lightIndex, unsigned int renderLayer, const std::shared_ptr<GraphicsProgram> &renderProgram) const {
-   renderProgram->setUniform("renderLightIndex", (int) lightIndex);
-    renderProgram->setUniform("renderLightLayer", (int) renderLayer);
-   Light* selectedLight = lights[lightIndex];
+void World::renderLight(unsigned int lightIndex, unsigned int renderLayer, ShadowUpdateScheduler::ShadowCasters casters, const std::shared_ptr<GraphicsProgram> &renderProgram) const {
+    LIMON_PROFILE_ZONE(casters == ShadowUpdateScheduler::ShadowCasters::STATIC ? "Static shadow casters" :
+                       casters == ShadowUpdateScheduler::ShadowCasters::DYNAMIC ? "Dynamic shadow casters" : "Shadow casters");
+    static const UniformHandle<int> renderLightIndexUniform("renderLightIndex");
+    static const UniformHandle<int> renderLightLayerUniform("renderLightLayer");
+    static std::vector<uint32_t> casterIDs;//render is single threaded
+    renderProgram->setUniform(renderLightIndexUniform, (int) lightIndex);
+    renderProgram->setUniform(renderLightLayerUniform, (int) renderLayer);
+    //light index is the index in active lights, same as the uniforms
+   Light* selectedLight = activeLights[lightIndex];
         Camera* lightCamera = selectedLight->getCameras()[renderLayer];
 
     const auto &selectedVisibilities = cullingResults.find(lightCamera);
     if (selectedVisibilities != cullingResults.end()) {
         std::set<uint64_t> alreadyRenderedTagHashes;
+        const uint32_t staticTagIndex = getStaticTagIndex();
 
         for (const auto &renderTag: lightCamera->getRenderTags()) {
             if (alreadyRenderedTagHashes.find(renderTag.hash) != alreadyRenderedTagHashes.end()) {
                 continue;
             }
-            const auto &taggedVisibilities = VisibilityRequest::findHashEntry(selectedVisibilities->second, renderTag.hash);
-            if (taggedVisibilities != selectedVisibilities->second->end()) {
-                for (const auto &item: taggedVisibilities->first) {
+            uint32_t tagSetIndex = selectedVisibilities->second->findTagSetIndex(renderTag.hash);
+            if (tagSetIndex != CameraVisibility::INVALID_INDEX) {
+                for (const auto &item: selectedVisibilities->second->getTagSetHashes(tagSetIndex)) {
                     alreadyRenderedTagHashes.insert(item);
                 }
                 //so all objects that needs rendering is here, now render
-                for (const auto &assetIt: taggedVisibilities->second) {
-                    const auto &perAssetElement = assetIt.second;
-                    if (!perAssetElement.first.empty()) {
-                        uint32_t modelId = *perAssetElement.first.begin();
+                for (const auto &perAssetElement: selectedVisibilities->second->getVisibleTagSets()[tagSetIndex].getAssets()) {
+                    if (!perAssetElement.objectIDs.empty()) {
+                        uint32_t modelId = perAssetElement.objectIDs[0];
                         Model *sampleModel = dynamic_cast<Model *>(objects.at(modelId));
                         if (sampleModel == nullptr) {
                             std::cerr << "Sample model detection got a non model object for id " << modelId << " this should not have happened" << std::endl;
                             continue;
                         }
-                        sampleModel->renderWithProgramInstanced(perAssetElement.first, *(renderProgram), perAssetElement.second);
+                        if(casters == ShadowUpdateScheduler::ShadowCasters::ALL) {
+                            sampleModel->renderWithProgramInstanced(perAssetElement.objectIDs, *(renderProgram), perAssetElement.lod);
+                            continue;
+                        }
+                        bool renderStatic = casters == ShadowUpdateScheduler::ShadowCasters::STATIC;
+                        casterIDs.clear();
+                        for (uint32_t objectID: perAssetElement.objectIDs) {
+                            if(isStaticShadowCaster(static_cast<Model *>(objects.at(objectID)), staticTagIndex) == renderStatic) {
+                                casterIDs.push_back(objectID);
+                            }
+                        }
+                        if(!casterIDs.empty()) {
+                            sampleModel->renderWithProgramInstanced(casterIDs, *(renderProgram), perAssetElement.lod);
+                        }
                     }
                 }
             }
@@ -1142,13 +1377,7 @@ void World::removeActiveCustomAnimation(const AnimationCustom &animationToRemove
 
 World::~World() {
 
-    if(!routeThreads.empty()) {
-        std::cout << "Waiting for AI route threads to finish. " << std::endl;
-        for (auto threadIt = routeThreads.begin(); threadIt != routeThreads.end(); ++threadIt) {
-            threadIt->second->waitUntilDone();
-        }
-        std::cout << "AI route threads to finished." << std::endl;
-    }
+    delete routeService;//waits for running route jobs
 
     delete dynamicsWorld;
     delete animationInProgress;
@@ -1170,6 +1399,7 @@ World::~World() {
 
     for (std::vector<Light *>::iterator it = lights.begin(); it != lights.end(); ++it) {
         for (Camera* camera : (*it)->getCameras()) {
+            delete cullingResults[camera];
             cullingResults.erase(camera);
         }
         delete (*it);
@@ -1198,15 +1428,16 @@ World::~World() {
     delete renderCounts;
     delete fpsCounter;
     delete cursor;
+    delete guiSpriteBatch;
     delete debugOutputGUI;
 
     delete imgGuiHelper;
 
-    for (auto &item: visibilityThreadPool) {
-        delete item.first;
-        if (item.second) {
-            SDL_WaitThread(item.second, NULL);
-        }
+    for (auto &item: visibilityRequests) {
+        delete item.second;
+    }
+    for (auto &item: cullingResults) {
+        delete item.second;
     }
 }
 
@@ -1217,6 +1448,7 @@ bool World::addModelToWorld(Model *xmlModel) {
     }
     xmlModel->getTransformation()->getWorldTransform();
     objects[xmlModel->getWorldObjectID()] = xmlModel;
+    cullingObjectsDirty = true;
     rigidBodies.push_back(xmlModel->getRigidBody());
     xmlModel->updateAABB();
     if(xmlModel->isDisconnected()) {
@@ -1272,23 +1504,51 @@ void World::addActor(ActorInterface *actor) {
     this->actors[actor->getWorldID()] = actor;
 }
 
-void World::createGridFrom(const glm::vec3 &aiGridStartPoint) {
+void World::createGridFrom(const glm::vec3 &aiGridStartPoint, bool forceRegenerate) {
+    this->aiGridStartPoint = aiGridStartPoint;
+    //route jobs use the grid. Waiting actors get a failed route, so they can ask again
+    std::vector<uint32_t> waitingActors;
+    if(routeService != nullptr) {
+        waitingActors = routeService->getPendingRequesters();
+        delete routeService;
+        routeService = nullptr;
+    }
     if(grid != nullptr) {
         delete grid;
         grid = nullptr;
     }
-#ifdef CEREAL_SUPPORT
     std::string AIWalkBinaryName = this->name.substr(0, this->name.find_last_of(".")) + ".aiwalkb";
-    grid = AIMovementGrid::deserializeBinary(AIWalkBinaryName);
+    if(!forceRegenerate) {
+#ifdef CEREAL_SUPPORT
+        grid = AIMovementGrid::deserializeBinary(AIWalkBinaryName);
 #endif
-    if(grid == nullptr) {
-        std::string AIWalkName = this->name.substr(0, this->name.find_last_of(".")) + ".aiwalk";
-        grid = AIMovementGrid::deserialize(AIWalkName);
         if (grid == nullptr) {
-            grid = new AIMovementGrid(aiGridStartPoint, dynamicsWorld, worldAABBMin, worldAABBMax, COLLIDE_PLAYER,
-                                      COLLIDE_STATIC_MODELS | COLLIDE_EVERYTHING);
+            std::string AIWalkName = this->name.substr(0, this->name.find_last_of(".")) + ".aiwalk";
+            grid = AIMovementGrid::deserialize(AIWalkName);
         }
     }
+    if(grid == nullptr) {
+        uint32_t lastLogTime = SDL_GetTicks();
+        grid = new AIMovementGrid(aiGridStartPoint, dynamicsWorld, worldAABBMin, worldAABBMax, COLLIDE_PLAYER,
+                                  COLLIDE_STATIC_MODELS | COLLIDE_EVERYTHING, jobSystem,
+                                  [this, &lastLogTime](uint32_t processedNodeCount, uint32_t frontierNodeCount) {
+                                      if(SDL_GetTicks() - lastLogTime < 1000) {
+                                          return;
+                                      }
+                                      lastLogTime = SDL_GetTicks();
+                                      options->getLogger()->log(Logger::log_Subsystem_AI, Logger::log_level_INFO,
+                                                                "AI walk grid generation, done " + std::to_string(processedNodeCount) +
+                                                                " nodes, " + std::to_string(frontierNodeCount) + " waiting.");
+                                  });
+#ifdef CEREAL_SUPPORT
+        //so next load doesn't generate again
+        grid->serializeBinary(AIWalkBinaryName);
+#endif
+    }
+    routeService = new AIRouteService(grid->getNavigationGraph(), jobSystem);
+    for (uint32_t actorID : waitingActors) {
+        routeService->failRequest(actorID);
+    }
 }
 
 void World::setSky(SkyBox *skyBox) {
@@ -1305,8 +1565,7 @@ void World::addLight(Light *light) {
     }
     const std::vector<Camera*>& cameras = light->getCameras();
     for(Camera* camera : cameras) {
-        cullingResults.insert(std::make_pair(camera,
-                                             new std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t, std::pair<std::vector<uint32_t>, uint32_t>>, VisibilityRequest::uint64_vector_hasher>()));
+        cullingResults.insert(std::make_pair(camera, new CameraVisibility()));
     }
     updateActiveLights(false);
 }
@@ -1745,6 +2004,7 @@ bool World::removeObject(uint32_t objectID, const bool &removeChildren) {
     if (modelToRemove!= nullptr && modelToRemove->getAIID() != 0) {
         unusedIDs.push(modelToRemove->getAIID());
         actors.erase(modelToRemove->getAIID());
+        perception.removeActor(modelToRemove->getAIID());
     }
     //remove any active animations
     if(activeAnimations.find(modelToRemove) != activeAnimations.end()) {
@@ -1753,30 +2013,9 @@ bool World::removeObject(uint32_t objectID, const bool &removeChildren) {
     }
     onLoadAnimations.erase(modelToRemove);
 
-    bool removalDone = false;
     //of course we need to remove from the tag visibility lists too
     for (auto &perCameraVisibility: cullingResults) {
-        for(auto perTagVisibilityIt = perCameraVisibility.second->begin(); perTagVisibilityIt != perCameraVisibility.second->end(); perTagVisibilityIt++) {
-            auto assetSet = perTagVisibilityIt->second.find(modelToRemove->getAssetID());
-            if (assetSet != perTagVisibilityIt->second.end()) {
-                //found the asset, is the model in it?
-                for(auto modelIdIterator = assetSet->second.first.begin(); modelIdIterator != assetSet->second.first.end(); modelIdIterator++) {
-                    if((*modelIdIterator) == modelToRemove->getWorldObjectID()) {
-                        //model in it, remove
-                        assetSet->second.first.erase(modelIdIterator);
-                        removalDone = true;
-                        if(assetSet->second.first.empty()) {
-                            //the model we removed was the only model, we should drop the whole asset
-                            perTagVisibilityIt->second.erase(modelToRemove->getAssetID());
-                            break;//we have been iterating in the asset set, which doesn't exist anymore
-                        }
-                    }
-                }
-                if(removalDone) {
-                    break;
-                }
-            }
-        }
+        perCameraVisibility.second->removeObject(modelToRemove->getAssetID(), modelToRemove->getWorldObjectID());
     }
 
 	//remove its children
@@ -1794,6 +2033,8 @@ bool World::removeObject(uint32_t objectID, const bool &removeChildren) {
     //delete object itself
     delete modelToRemove;
     objects.erase(objectID);
+    spatialTree.remove(objectID);
+    cullingObjectsDirty = true;
     unusedIDs.push(objectID);
 
 
@@ -2559,6 +2800,7 @@ bool World::cancelTimedEventAPI(long handleId) {
 
 
 void World::checkAndRunTimedEvents() {
+    LIMON_PROFILE_ZONE("Timed events");
     //we need to check 2 different things
     while(!timedEvents.empty()) {
         bool nothingToRun = true;
@@ -2601,6 +2843,29 @@ std::vector<uint32_t> World::getModelChildrenAPI(uint32_t modelID) {
    return result;
 }
 
+std::vector<uint32_t> World::getObjectsInRadiusAPI(const LimonTypes::Vec4 &center, float radius) const {
+    std::vector<uint32_t> candidates;
+    glm::vec3 centerGLM = GLMConverter::LimonToGLMV3(center);
+    spatialTree.querySphere(centerGLM, radius, candidates);
+    //tree is updated once per frame with fattened boxes, so check the current AABBs
+    std::vector<uint32_t> result;
+    for (uint32_t objectID: candidates) {
+        auto objectIt = objects.find(objectID);
+        if(objectIt == objects.end()) {
+            continue;
+        }
+        glm::vec3 min = objectIt->second->getAabbMin();
+        glm::vec3 max = objectIt->second->getAabbMax();
+        float dx = std::max(min.x - centerGLM.x, std::max(0.0f, centerGLM.x - max.x));
+        float dy = std::max(min.y - centerGLM.y, std::max(0.0f, centerGLM.y - max.y));
+        float dz = std::max(min.z - centerGLM.z, std::max(0.0f, centerGLM.z - max.z));
+        if(dx * dx + dy * dy + dz * dz <= radius * radius) {
+            result.push_back(objectID);
+        }
+    }
+    return result;
+}
+
 std::string World::getModelAnimationNameAPI(uint32_t modelID) {
     Model* model = findModelByID(modelID);
         if(model != nullptr) {
@@ -2640,6 +2905,39 @@ bool World::setModelAnimationSpeedAPI(uint32_t modelID, float speed) {
     return false;
 }
 
+int32_t World::addModelAnimationLayerAPI(uint32_t modelID, const std::string& maskRootBoneName, bool isAdditive) {
+    Model* model = findModelByID(modelID);
+    if(model == nullptr || !model->isAnimated()) {
+        return -1;
+    }
+    return model->getAnimationGraph()->addLayer(isAdditive ? AnimationGraph::LayerMode::ADDITIVE : AnimationGraph::LayerMode::OVERRIDE, maskRootBoneName);
+}
+
+bool World::setModelAnimationLayerClipAPI(uint32_t modelID, uint32_t layerIndex, const std::string& animationName, float weight, bool isLooped) {
+    Model* model = findModelByID(modelID);
+    if(model == nullptr || !model->isAnimated()) {
+        return false;
+    }
+    return model->getAnimationGraph()->setClip(layerIndex, animationName, weight, isLooped);
+}
+
+bool World::setModelAnimationLayerWeightAPI(uint32_t modelID, uint32_t layerIndex, float weight) {
+    Model* model = findModelByID(modelID);
+    if(model == nullptr || !model->isAnimated()) {
+        return false;
+    }
+    return model->getAnimationGraph()->setLayerWeight(layerIndex, weight);
+}
+
+bool World::removeModelAnimationLayersAPI(uint32_t modelID) {
+    Model* model = findModelByID(modelID);
+    if(model == nullptr) {
+        return false;
+    }
+    model->removeAnimationLayers();
+    return true;
+}
+
 bool World::setModelAnimationWithBlendAPI(uint32_t modelID, const std::string& animationName, bool isLooped, long blendTime) {
     Model* model = findModelByID(modelID);
     if(model != nullptr) {
@@ -2694,6 +2992,7 @@ Model* World::findModelByIDChildren(PhysicalRenderable* parent,uint32_t modelID)
 
 bool World::changeRenderPipeline(const std::string &pipelineFileName) {
     std::unique_ptr<GraphicsPipeline> newPipeline = GraphicsPipeline::deserialize(pipelineFileName, this->graphicsWrapper, assetManager, options, buildRenderMethods());
+    GraphicsProgramCache::printReport(pipelineFileName);
     if(newPipeline != nullptr) {
         this->renderPipeline = std::move(newPipeline);
         //reset the
@@ -2862,6 +3161,7 @@ void World::updateActiveLights(bool forceUpdate) {
     }
 
     lastLightUpdatePlayerPosition = currentPlayer->getPosition();
+    std::vector<Light *> previousActiveLights = activeLights;
     activeLights.clear();
 
     // we have NR_POINT lights, and directional lights. we should have 1 directional light, and rest point lights.
@@ -2869,7 +3169,6 @@ void World::updateActiveLights(bool forceUpdate) {
     for (; fullLightsIndex < lights.size() && activeLights.size() < NR_POINT_LIGHTS; ++fullLightsIndex) {
         if(lights[fullLightsIndex]->getLightType() != Light::LightTypes::DIRECTIONAL) {
             activeLights.push_back(lights[fullLightsIndex]);
-            lights[fullLightsIndex]->setFrustumChanged(true);//since we needed update, force update;
         }
     }
     if(lights.size() > NR_POINT_LIGHTS) {
@@ -2886,7 +3185,6 @@ void World::updateActiveLights(bool forceUpdate) {
             }
             if(insertIndex != NR_POINT_LIGHTS-1) {
                 activeLights[insertIndex] = lights[fullLightsIndex];
-                lights[fullLightsIndex]->setFrustumChanged(true);
             } else {
                 //this means the light will not be used, there for it will not be needed for frustum culled;
                 lights[fullLightsIndex]->setFrustumChanged(false);//since we needed update, force update;
@@ -2897,7 +3195,12 @@ void World::updateActiveLights(bool forceUpdate) {
     //at this point, add the directional light to the end
     if(directionalLightIndex != -1) {
         activeLights.push_back(lights[directionalLightIndex]);
-        lights[directionalLightIndex]->setFrustumChanged(true);
+    }
+    //lights that stay active keep their culling, only the new ones are forced to update
+    for (Light *activeLight: activeLights) {
+        if(std::find(previousActiveLights.begin(), previousActiveLights.end(), activeLight) == previousActiveLights.end()) {
+            activeLight->setFrustumChanged(true);
+        }
     }
 
     for (size_t lightIndex = 0; lightIndex < activeLights.size(); ++lightIndex) {
@@ -2920,10 +3223,53 @@ void World::updateActiveLights(bool forceUpdate) {
 
 }
 
+/**
+ * Point lights in activeLights have shadows and use light slots, rest are culled to clusters of player camera, without shadows.
+ * Clusters are view space, so they are rebuilt when either camera or any of the lights change.
+ */
+void World::updateLightClusters() {
+    lightClusterBuilder.beginFrame(playerCamera->getProjectionMatrix(), playerCamera->getCameraMatrix(), lightClusterDistance);
+    for (const Light *light : lights) {
+        if(light->getLightType() != Light::LightTypes::POINT ||
+           std::find(activeLights.begin(), activeLights.end(), light) != activeLights.end()) {
+            continue;
+        }
+        if(!lightClusterBuilder.addLight(light->getPosition(), light->getActiveDistance(), light->getColor(),
+                                         light->getAttenuation(), light->getAmbientColor())) {
+            if(!clusteredLightLimitWarned) {
+                std::cerr << "Point light count is over the clustered light maximum " << NR_MAX_CLUSTERED_LIGHTS << ", rest of the lights are ignored." << std::endl;
+                clusteredLightLimitWarned = true;
+            }
+            break;
+        }
+    }
+    if(!lightClusterBuilder.needsBuild()) {
+        return;
+    }
+
+    LIMON_PROFILE_ZONE("Light clusters");
+    if(lightClusterBuilder.getLightCount() > 0) {
+        SDL2MultiThreading::JobSystem::Counter clusterCounter;
+        jobSystem->parallelFor(LightClusterBuilder::RANGE_COUNT, 1, [this](uint32_t start, uint32_t end) {
+            for (uint32_t rangeIndex = start; rangeIndex < end; ++rangeIndex) {
+                lightClusterBuilder.buildRange(rangeIndex);
+            }
+        }, &clusterCounter);
+        jobSystem->waitFor(&clusterCounter);
+        lightClusterBuilder.finish();
+    } else {
+        lightClusterBuilder.build();//only clears the clusters
+    }
+    graphicsWrapper->setClusteredLights(lightClusterBuilder.getLightData(), lightClusterBuilder.getClusterRanges(),
+                                        lightClusterBuilder.getLightIndices(), lightClusterBuilder.getDepthParameters());
+}
+
    void World::clearWorldRefsBeforeAttachment(PhysicalRenderable *attachment) {
        GameObject* gameObject = dynamic_cast<GameObject*>(attachment);
        if(gameObject != nullptr) {
            objects.erase(gameObject->getWorldObjectID());
+           spatialTree.remove(gameObject->getWorldObjectID());
+           cullingObjectsDirty = true;
            dynamicsWorld->removeRigidBody(attachment->getRigidBody());
            for (auto iterator = rigidBodies.begin(); iterator != rigidBodies.end(); ++iterator) {
                if ((*iterator) == attachment->getRigidBody()) {
@@ -29,6 +29,9 @@ static const int SKIP_LOD_LEVEL = 9999;
 #include "Graphics/GraphicsPipeline.h"
 #include "PhysicalRenderable.h"
 #include "VisibilityRequest.h"
+#include "AI/AIPerception.h"
+#include "Graphics/LightClusterBuilder.h"
+#include "Graphics/ShadowUpdateScheduler.h"
 #include "GameObjects/Model.h"
 
 class Editor;
@@ -37,6 +40,7 @@ class PerspectiveCamera;
 class BulletDebugDrawer;
 
 class AIMovementGrid;
+class AIRouteService;
 class TriggerInterface;
 
 class GUIText;
@@ -46,6 +50,7 @@ class GUITextBase;
 class GUIFPSCounter;
 class GUITextDynamic;
 class GUICursor;
+class GUISpriteBatch;
 class GUIButton;
 
 
@@ -234,19 +239,18 @@ private:
     // In case of a clear, we should not clear the hashes, as it is basically meaningless.
 
     /**
-     * this variable is used as camera list, so outermost one should never clear, and change only on camera creation/deletion.
-     * Since hashes are set by the render pipeline, first level in might reset on render pipeline changes.
-     * On all other cases, only the value of hash list should be reset.
+     * this variable is used as camera list, so it should change only on camera creation/deletion.
+     * Tag sets of each camera are set by the render pipeline, so they might reset on render pipeline changes.
+     * On all other cases, only the visible objects of the camera should change.
      * What is in this map?
      * For each camera
-     *      there is a list of tags, that is list of tags per render stage, so any match is enough
-     *      for each list of tags, there is a map, key is the asset id
-     *          for each asset Id, there is a pair of vector + uint
-     *              vector is the object Ids that needs rendering, uint is the Max LOD to use.
+     *      there is a list of tag sets, one per render stage, so any tag match is enough
+     *      for each tag set, there is a list of visible assets
+     *          for each asset, there is the list of object Ids that needs rendering, and the Max LOD to use.
+     * Check CameraVisibility for details.
      */
 
-    std::unordered_map<Camera*, std::unordered_map<std::vector<uint64_t>, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>, VisibilityRequest::uint64_vector_hasher>*> cullingResults;
-    //std::unordered_map<Camera*, std::unordered_map<uint64_t, std::unordered_map<uint32_t , std::pair<std::vector<uint32_t>, uint32_t>>>*> cullingResults;
+    std::unordered_map<Camera*, CameraVisibility*> cullingResults;
 
     /************************* End of redundant variables ******************************************/
     std::priority_queue<TimedEvent, std::vector<TimedEvent>, std::greater<>> timedEvents;
@@ -265,12 +269,23 @@ private:
     int32_t directionalLightIndex = -1;
     glm::vec3 lastLightUpdatePlayerPosition = glm::vec3(0,0,0);
     std::vector<Light *> activeLights; //this contains redundant pointers at most MAX_LIGHT elements, from lights array.
+    LightClusterBuilder lightClusterBuilder;//point lights that are not in activeLights, without shadows
+    float lightClusterDistance = 150.0f;
+    bool clusteredLightLimitWarned = false;
+    ShadowUpdateScheduler shadowUpdateScheduler;
+    std::vector<uint32_t> movedCullingObjectIDs;//models that moved this frame, collected while culling
+    std::vector<uint32_t> movingShadowCasterIDs;
+    std::vector<uint32_t> visibleMovingCasterIDs;
+    std::vector<uint32_t> renderedDynamicCasterIDs;
+    bool staticShadowCastersChanged = true;
     std::vector<GUILayer *> guiLayers;
     std::unordered_map<uint32_t, ActorInterface*> actors;
     AIMovementGrid *grid = nullptr;
+    glm::vec3 aiGridStartPoint = glm::vec3(0,0,0);//kept for regenerating from editor
     SkyBox *sky = nullptr;
     GraphicsInterface* graphicsWrapper;
     ALHelper *alHelper;
+    SDL2MultiThreading::JobSystem* jobSystem;
     std::string name;
     std::string loadingImage;
     char worldSaveNameBuffer[256] = {0};
@@ -304,6 +319,7 @@ private:
     GUIText* renderCounts;
     GUIFPSCounter* fpsCounter;
     GUICursor* cursor;
+    GUISpriteBatch* guiSpriteBatch;//all GUI images of the frame, including cursor
     GUIButton *hoveringButton = nullptr;
     GUITextDynamic* debugOutputGUI;
 
@@ -323,7 +339,8 @@ private:
     Model* objectToAttach = nullptr;
 
     std::shared_ptr<QuadRender> quadRender;
-    std::map<uint32_t, SDL2MultiThreading::Thread*> routeThreads;
+    AIRouteService *routeService = nullptr;//answers actor route requests, recreated with the grid
+    AIPerception perception;//line of sight of actors to player
 
     bool guiPickMode = false;
     enum class QuitResponse
@@ -342,7 +359,34 @@ private:
 
     std::map<uint32_t, std::shared_ptr<Emitter>> emitters;
     std::map<uint32_t, std::shared_ptr<GPUParticleEmitter>> gpuParticleEmitters;
+    struct EmitterUpdate {
+        Emitter* emitter;
+        bool visible;
+        EmitterUpdate(Emitter* emitter, bool visible) : emitter(emitter), visible(visible) {}
+    };
+    std::vector<EmitterUpdate> emitterUpdates;
+    AABBArray emitterAABBs;//same order as emitters
+    std::vector<uint32_t> emitterVisibilityMask;
+    long particleOffscreenUpdateInterval = 0;//ms, 0 means off screen emitters are updated when they become visible
     bool multiThreadedCulling = true;
+    bool multiThreadedAnimation = true;
+    std::vector<long> animationLodIntervals;//ms between pose updates per lod level, empty means every frame
+
+    /**
+     * Visible models are collected first, so animated ones can calculate their poses in parallel.
+     * Physics update of the poses is done after, on the main thread.
+     */
+    struct PoseSetup {
+        Model* model;
+        uint32_t lod;
+        bool poseUpdated = false;
+        PoseSetup(Model* model, uint32_t lod) : model(model), lod(lod) {}
+    };
+    std::vector<PoseSetup> poseSetups;
+    std::unordered_map<uint32_t, uint32_t> poseSetupIndices;//objectID -> index in poseSetups
+
+    void setupVisibleModelsForTime();
+    void updateEmitters(long tickDuration);
 
     bool addPlayerAttachmentUsedIDs(const PhysicalRenderable *attachment, std::set<uint32_t> &usedIDs, uint32_t &maxID);
 
@@ -355,7 +399,6 @@ private:
 
     bool handlePlayerInput(InputHandler &inputHandler);
 
-    bool checkPlayerVisibility(const glm::vec3 &from, const std::string &fromName);
 
     ActorInterface::ActorInformation fillActorInformation(ActorInterface *actor);
 
@@ -367,15 +410,23 @@ private:
     void resetVisibilityBufferForRenderPipelineChange();
     void resetCameraTagsFromPipeline(const std::map<std::string, std::vector<std::set<std::string>>> &cameraRenderTagListMap);
     void fillVisibleObjectsUsingTags();
-    std::map<VisibilityRequest*, SDL_Thread *> occlusionThreadManager();
-    std::map<VisibilityRequest*, SDL_Thread *> visibilityThreadPool;
+    std::vector<Model *> cullingObjects;//flat copy of objects, so culling jobs can split it to ranges
+    AABBArray cullingAABBs;//world space AABBs of cullingObjects, same order
+    std::vector<uint32_t> cullingObjectIndices;//objectID -> index in cullingObjects
+    bool cullingObjectsDirty = true;//set when objects are added or removed
+    AABBTree spatialTree;//model AABBs, used by culling and area queries
+    std::unordered_map<Camera*, VisibilityRequest*> visibilityRequests;
 
     GameObject *getPointedObject(int collisionType, int filterMask,
                                  glm::vec3 *collisionPosition = nullptr, glm::vec3 *collisionNormal = nullptr) const;
 
     void addActor(ActorInterface *actor);
 
-    void createGridFrom(const glm::vec3 &aiGridStartPoint);
+    /**
+     * Loads the grid from cache files if they exist, else generates it and saves the binary cache.
+     * If forceRegenerate is set, cache files are ignored.
+     */
+    void createGridFrom(const glm::vec3 &aiGridStartPoint, bool forceRegenerate = false);
 
     void setSky(SkyBox *skyBox);
 
@@ -408,9 +459,6 @@ private:
     Model* findModelByID(uint32_t modelID) const;
     Model* findModelByIDChildren(PhysicalRenderable* parent ,uint32_t modelID) const;
 
-    std::vector<LimonTypes::GenericParameter>
-    fillRouteInformation(std::vector<LimonTypes::GenericParameter> parameters) const;
-
     void clearWorldRefsBeforeAttachment(PhysicalRenderable *attachment);
 
     void createNodeGraph();
@@ -427,7 +475,26 @@ private:
     }
 
     void ImGuiFrameSetup(std::shared_ptr<GraphicsProgram> graphicsProgram, const std::string& cameraName[[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]);
-    void renderLight(unsigned int lightIndex, unsigned int renderLayer, const std::shared_ptr<GraphicsProgram> &renderProgram) const;
+    void renderLight(unsigned int lightIndex, unsigned int renderLayer, ShadowUpdateScheduler::ShadowCasters casters, const std::shared_ptr<GraphicsProgram> &renderProgram) const;
+    bool isShadowLayerScheduled(unsigned int lightIndex, unsigned int renderLayer, uint64_t &staticVersion) const {
+        return shadowUpdateScheduler.isScheduled(lightIndex, renderLayer, staticVersion);
+    }
+
+    /**
+     * Index of the static tag, so caster loops don't search the registry per object.
+     * INVALID_INDEX if no object has the tag yet.
+     */
+    static uint32_t getStaticTagIndex() {
+        static const uint64_t staticTagHash = HashUtil::hashString(HardCodedTags::OBJECT_MODEL_STATIC);
+        return TagRegistry::findIndex(staticTagHash);
+    }
+
+    /**
+     * Models that can't move or animate are static shadow casters, rest are dynamic.
+     */
+    static bool isStaticShadowCaster(const Model* model, uint32_t staticTagIndex) {
+        return staticTagIndex != TagRegistry::INVALID_INDEX && model->getTagMask().test(staticTagIndex) && !model->isAnimated();
+    }
     void renderParticleEmitters(const std::shared_ptr<GraphicsProgram>& renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) const;
     void renderGPUParticleEmitters(const std::shared_ptr<GraphicsProgram>& renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) const;
     void renderGUIImages(const std::shared_ptr<GraphicsProgram>& renderProgram, const std::string &cameraName [[gnu::unused]], const std::vector<HashUtil::HashedString> &tags [[gnu::unused]]) const;
@@ -555,11 +622,17 @@ public:
     uint32_t getPlayerAttachedModelAPI();
     std::vector<uint32_t> getModelChildrenAPI(uint32_t modelID);
 
+    std::vector<uint32_t> getObjectsInRadiusAPI(const LimonTypes::Vec4 &center, float radius) const;
+
     std::string getModelAnimationNameAPI(uint32_t modelID);
     bool getModelAnimationFinishedAPI(uint32_t modelID);
     bool setModelAnimationAPI(uint32_t modelID, const std::string& animationName, bool isLooped);
     bool setModelAnimationWithBlendAPI(uint32_t modelID, const std::string& animationName, bool isLooped, long blendTime);
     bool setModelAnimationSpeedAPI(uint32_t modelID, float speed);
+    int32_t addModelAnimationLayerAPI(uint32_t modelID, const std::string& maskRootBoneName, bool isAdditive);
+    bool setModelAnimationLayerClipAPI(uint32_t modelID, uint32_t layerIndex, const std::string& animationName, float weight, bool isLooped);
+    bool setModelAnimationLayerWeightAPI(uint32_t modelID, uint32_t layerIndex, float weight);
+    bool removeModelAnimationLayersAPI(uint32_t modelID);
 
     LimonTypes::Vec4 getPlayerModelOffsetAPI();
     bool setPlayerModelOffsetAPI(LimonTypes::Vec4 newOffset);
@@ -595,6 +668,10 @@ public:
 
     void updateActiveLights(bool forceUpdate = false);
 
+    void updateLightClusters();
+
+    void scheduleShadowUpdates();
+
     void addSkyBoxControls();
 
     void
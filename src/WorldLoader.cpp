@@ -96,12 +96,17 @@ void WorldLoader::attachedAPIMethodsToWorld(World *world, LimonAPI *limonAPI) co
     limonAPI->worldKillPlayer = std::bind(&World::killPlayerAPI, world);
     limonAPI->worldGetPlayerAttachedModel = std::bind(&World::getPlayerAttachedModelAPI, world);
     limonAPI->worldGetModelChildren = std::bind(&World::getModelChildrenAPI, world, std::placeholders::_1);
+    limonAPI->worldGetObjectsInRadius = std::bind(&World::getObjectsInRadiusAPI, world, std::placeholders::_1, std::placeholders::_2);
 
     limonAPI->worldGetModelAnimationName = std::bind(&World::getModelAnimationNameAPI, world, std::placeholders::_1);
     limonAPI->worldGetModelAnimationFinished = std::bind(&World::getModelAnimationFinishedAPI, world, std::placeholders::_1);
     limonAPI->worldSetAnimationOfModel = std::bind(&World::setModelAnimationAPI, world, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
     limonAPI->worldSetAnimationOfModelWithBlend = std::bind(&World::setModelAnimationWithBlendAPI, world, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
     limonAPI->worldSetModelAnimationSpeed = std::bind(&World::setModelAnimationSpeedAPI, world, std::placeholders::_1, std::placeholders::_2);
+    limonAPI->worldAddModelAnimationLayer = std::bind(&World::addModelAnimationLayerAPI, world, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    limonAPI->worldSetModelAnimationLayerClip = std::bind(&World::setModelAnimationLayerClipAPI, world, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5);
+    limonAPI->worldSetModelAnimationLayerWeight = std::bind(&World::setModelAnimationLayerWeightAPI, world, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+    limonAPI->worldRemoveModelAnimationLayers = std::bind(&World::removeModelAnimationLayersAPI, world, std::placeholders::_1);
     limonAPI->worldGetPlayerAttachmentOffset = std::bind(&World::getPlayerModelOffsetAPI, world);
     limonAPI->worldSetPlayerAttachmentOffset = std::bind(&World::setPlayerModelOffsetAPI, world, std::placeholders::_1);
     limonAPI->worldEnableParticleEmitter = std::bind(&World::enableParticleEmitter, world, std::placeholders::_1);
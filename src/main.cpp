@@ -8,7 +8,13 @@
 #include "World.h"
 #include "WorldLoader.h"
 #include "GameObjects/GUIImage.h"
+#include "Utils/Profiler.h"
+#include "API/Graphics/GraphicsProgramCache.h"
+#include "Benchmarks/Benchmarks.h"
 #include <pthread.h>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
 
 const std::string PROGRAM_NAME = "LimonEngine";
 const std::string RELEASE_FILE = "./Data/Release.xml";
@@ -23,6 +29,7 @@ bool GameEngine::loadAndChangeWorld(const std::string &worldFile) {
     }
     LimonAPI* apiInstance = getNewLimonAPI();
     World* newWorld = worldLoader->loadWorld(worldFile, apiInstance);
+    GraphicsProgramCache::printReport(worldFile);
     if(newWorld == nullptr) {
         delete apiInstance;
         return false;
@@ -68,6 +75,7 @@ bool GameEngine::returnOrLoadMap(const std::string &worldFile) {
         renderLoadingImage();
         LimonAPI* apiInstance = getNewLimonAPI();
         World* newWorld = worldLoader->loadWorld(worldFile, apiInstance);
+        GraphicsProgramCache::printReport(worldFile);
         if(newWorld == nullptr) {
             delete apiInstance;
             return false;
@@ -121,28 +129,34 @@ void GameEngine::returnPreviousMap() {
     previousGameTime = SDL_GetTicks64();
 }
 
-GameEngine::GameEngine() {
+GameEngine::GameEngine(bool headless) : headless(headless) {
     options = new OptionsUtil::Options();
 
     options->loadOptionsNew(OPTIONS_FILE);
     std::cout << "Options loaded successfully" << std::endl;
+    Profiler::setEnabled(options->getOption<bool>(HASH("profilerEnabled")).getOrDefault(true));
 
     sdlHelper = new SDL2Helper(options);
 
+    std::string graphicsBackendName = headless ? "HeadlessGraphicsBackend" : "GraphicsBackend";
     std::string graphicsBackendFileName;
 #ifdef _WIN32
-    graphicsBackendFileName = "libGraphicsBackend.dll";
+    graphicsBackendFileName = "lib" + graphicsBackendName + ".dll";
 #elif __APPLE__
-    graphicsBackendFileName = "./libGraphicsBackend.dylib";
+    graphicsBackendFileName = "./lib" + graphicsBackendName + ".dylib";
 #else
-    graphicsBackendFileName = "./libGraphicsBackend.so";
+    graphicsBackendFileName = "./lib" + graphicsBackendName + ".so";
 #endif
     graphicsWrapper = sdlHelper->loadGraphicsBackend(graphicsBackendFileName, options);
-    sdlHelper->initWindow(PROGRAM_NAME.c_str(), graphicsWrapper->getContextInformation());
     if(graphicsWrapper == nullptr) {
         std::cerr << "failed to load graphics backend. Please check " << graphicsBackendFileName << std::endl;
         exit(1);
     }
+    if(headless) {
+        sdlHelper->initHeadless();
+    } else {
+        sdlHelper->initWindow(PROGRAM_NAME.c_str(), graphicsWrapper->getContextInformation());
+    }
     if(!graphicsWrapper->createGraphicsBackend()) {
         std::cerr << "failed to create graphics backend. Please check " << graphicsBackendFileName << std::endl;
         exit(1);
@@ -160,7 +174,8 @@ GameEngine::GameEngine() {
     alHelper = new ALHelper();
 
     inputHandler = new InputHandler(sdlHelper->getWindow(), options);
-    assetManager = std::make_shared<AssetManager>(graphicsWrapper.get(), alHelper);
+    jobSystem = std::make_unique<SDL2MultiThreading::JobSystem>();
+    assetManager = std::make_shared<AssetManager>(graphicsWrapper.get(), alHelper, jobSystem.get());
 
     worldLoader = new WorldLoader(assetManager, inputHandler, options);
 }
@@ -187,6 +202,7 @@ void GameEngine::run() {
     previousGameTime = SDL_GetTicks64();
     uint64_t currentGameTime, frameTime, accumulatedTime = 0;
     while (!worldQuit) {
+        Profiler::markFrame();
         currentGameTime = SDL_GetTicks64();
         frameTime = currentGameTime - previousGameTime;
         previousGameTime = currentGameTime;
@@ -202,9 +218,103 @@ void GameEngine::run() {
         graphicsWrapper->clearFrame();
         currentWorld->render();
         sdlHelper->swap();
+        Profiler::collectGPUTimers(graphicsWrapper.get());
     }
 }
 
+void GameEngine::runHeadless(uint32_t frameCount, const std::string &traceFileName) {
+    const uint32_t worldUpdateTime = 1000 / TICK_PER_SECOND;
+    std::vector<double> playTimings, renderTimings, frameTimings;
+    playTimings.reserve(frameCount);
+    renderTimings.reserve(frameCount);
+    frameTimings.reserve(frameCount);
+    GraphicsInterface::FrameStatistics frameStatistics, totalStatistics;
+    bool statisticsAvailable = false;
+    uint64_t runHash = 14695981039346656037ull;
+    //game time is simulated too, so 2 runs of the same world get the same time values
+    uint64_t simulatedTime = 0;
+    uint64_t skippedUniformUploadsAtStart = GraphicsProgram::getSkippedUniformUploadCount();
+
+    graphicsWrapper->clearFrame();
+    for (uint32_t frame = 0; frame < frameCount && !worldQuit; ++frame) {
+        Profiler::markFrame();
+        auto frameStart = std::chrono::steady_clock::now();
+        simulatedTime += worldUpdateTime;
+        currentWorld->play(worldUpdateTime, *inputHandler, simulatedTime);
+        auto playEnd = std::chrono::steady_clock::now();
+        graphicsWrapper->clearFrame();
+        currentWorld->render();
+        sdlHelper->swap();
+        Profiler::collectGPUTimers(graphicsWrapper.get());
+        auto renderEnd = std::chrono::steady_clock::now();
+
+        playTimings.push_back(std::chrono::duration<double, std::milli>(playEnd - frameStart).count());
+        renderTimings.push_back(std::chrono::duration<double, std::milli>(renderEnd - playEnd).count());
+        frameTimings.push_back(std::chrono::duration<double, std::milli>(renderEnd - frameStart).count());
+
+        if(graphicsWrapper->getFrameStatistics(frameStatistics)) {
+            statisticsAvailable = true;
+            totalStatistics.drawCalls += frameStatistics.drawCalls;
+            totalStatistics.instances += frameStatistics.instances;
+            totalStatistics.triangles += frameStatistics.triangles;
+            totalStatistics.uniformSets += frameStatistics.uniformSets;
+            totalStatistics.programSwitches += frameStatistics.programSwitches;
+            totalStatistics.textureBinds += frameStatistics.textureBinds;
+            totalStatistics.renderStageSwitches += frameStatistics.renderStageSwitches;
+            totalStatistics.modelTransformSets += frameStatistics.modelTransformSets;
+            totalStatistics.modelTransformUploads += frameStatistics.modelTransformUploads;
+            totalStatistics.bufferBytesUploaded += frameStatistics.bufferBytesUploaded;
+            totalStatistics.textureBytesUploaded += frameStatistics.textureBytesUploaded;
+            runHash = (runHash ^ frameStatistics.commandHash) * 1099511628211ull;
+        }
+    }
+
+    uint32_t renderedFrames = (uint32_t)frameTimings.size();
+    std::cout << "Headless run finished, " << renderedFrames << " frames with " << worldUpdateTime << "ms fixed timestep." << std::endl;
+    printPhaseTimings("play", playTimings);
+    printPhaseTimings("render", renderTimings);
+    printPhaseTimings("frame", frameTimings);
+    if(statisticsAvailable && renderedFrames > 0) {
+        std::cout << "Per frame average: "
+                  << "draw calls " << totalStatistics.drawCalls / renderedFrames
+                  << ", instances " << totalStatistics.instances / renderedFrames
+                  << ", triangles " << totalStatistics.triangles / renderedFrames
+                  << ", uniform sets " << totalStatistics.uniformSets / renderedFrames
+                  << ", program switches " << totalStatistics.programSwitches / renderedFrames
+                  << ", texture binds " << totalStatistics.textureBinds / renderedFrames
+                  << ", render stages " << totalStatistics.renderStageSwitches / renderedFrames
+                  << ", model transforms " << totalStatistics.modelTransformSets / renderedFrames
+                  << " in " << totalStatistics.modelTransformUploads / renderedFrames << " uploads"
+                  << ", buffer bytes " << totalStatistics.bufferBytesUploaded / renderedFrames
+                  << ", texture bytes " << totalStatistics.textureBytesUploaded / renderedFrames
+                  << ", skipped uniform uploads " << (GraphicsProgram::getSkippedUniformUploadCount() - skippedUniformUploadsAtStart) / renderedFrames << std::endl;
+        std::cout << "Command hash of the run: " << std::hex << runHash << std::dec << std::endl;
+    }
+    if(!traceFileName.empty()) {
+        Profiler::exportChromeTrace(traceFileName);
+    }
+}
+
+bool GameEngine::runBenchmark(const std::string &benchmarkName) {
+    return Benchmarks::run(benchmarkName, assetManager);
+}
+
+void GameEngine::printPhaseTimings(const std::string &phaseName, std::vector<double> &timings) {
+    if(timings.empty()) {
+        return;
+    }
+    double total = 0;
+    for (double timing : timings) {
+        total += timing;
+    }
+    std::sort(timings.begin(), timings.end());
+    std::cout << phaseName << ": average " << total / timings.size() << "ms, "
+              << "min " << timings.front() << "ms, "
+              << "median " << timings[timings.size() / 2] << "ms, "
+              << "p95 " << timings[(timings.size() * 95) / 100] << "ms, "
+              << "max " << timings.back() << "ms" << std::endl;
+}
+
 GameEngine::~GameEngine() {
 
     for (auto iterator = loadedWorlds.begin(); iterator != loadedWorlds.end(); ++iterator) {
@@ -248,32 +358,60 @@ bool getWorldNameFromReleaseXML(std::string &worldName) {
 int main(int argc, char *argv[]) {
 
     std::string worldName;
-    if(argc == 1) {
+    bool headless = false;
+    uint32_t headlessFrameCount = 1000;
+    std::string traceFileName;
+    std::string benchmarkName;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if(argument == "--headless") {
+            headless = true;
+        } else if(argument == "--frames" && i + 1 < argc) {
+            headlessFrameCount = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if(argument == "--world" && i + 1 < argc) {
+            worldName = argv[++i];
+        } else if(argument == "--trace" && i + 1 < argc) {
+            traceFileName = argv[++i];
+        } else if(argument == "--benchmark" && i + 1 < argc) {
+            benchmarkName = argv[++i];
+            headless = true;
+        } else if(worldName.empty()) {
+            worldName = argument;
+        } else {
+            std::cout << PROGRAM_NAME + " only takes one map file. " << argument << " is discarded." << std::endl;
+        }
+    }
+    if(worldName.empty() && benchmarkName.empty()) {
         std::cout << "No world file specified, world select from release settings" << std::endl;
         if(!getWorldNameFromReleaseXML(worldName)) {
             std::cout << "release settings read failed, defaulting to ./Data/Maps/World001.xml" << std::endl;
             worldName = "./Data/Maps/World001.xml";
         }
-    } else if(argc == 2) {
-        worldName = argv[1];
+    } else if(!worldName.empty()) {
         std::cout << "Trying to load " <<  worldName << std::endl;
-    } else {
-        worldName = argv[1];
-        std::cout << "Trying to load " <<  worldName << std::endl;
-        std::cout << PROGRAM_NAME + " only takes one parameter. First one is processed as Map file, rest discarded." << std::endl;
     }
 
     pthread_setname_np(pthread_self(), "Main thread");
+    Profiler::setThreadName("Main thread");
 
-    GameEngine game;
+    GameEngine game(headless);
+
+    if(!benchmarkName.empty()) {
+        return game.runBenchmark(benchmarkName) ? 0 : 1;
+    }
 
+    auto loadStart = std::chrono::steady_clock::now();
     if(!game.loadAndChangeWorld(worldName)) {
         std::cerr << "WorldLoader didn't hand out a valid world. exiting.." << std::endl;
         exit(-1);
     }
 
-    game.run();
+    if(headless) {
+        std::cout << "World load took " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << "ms" << std::endl;
+        game.runHeadless(headlessFrameCount, traceFileName);
+    } else {
+        game.run();
+    }
 
     return 0;
 }
-
@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <memory>
 #include "Options.h"
+#include "SDL2MultiThreading.h"
 
 class World;
 class WorldLoader;
@@ -31,6 +32,7 @@ class GameEngine {
     ALHelper* alHelper = nullptr;
     std::shared_ptr<GraphicsInterface> graphicsWrapper = nullptr;
     InputHandler* inputHandler = nullptr;
+    std::unique_ptr<SDL2MultiThreading::JobSystem> jobSystem;//declared before assetManager, so it outlives it
     std::shared_ptr<AssetManager> assetManager = nullptr;
     SDL2Helper* sdlHelper = nullptr;
 
@@ -38,9 +40,12 @@ class GameEngine {
     std::vector<World*> returnWorldStack;//stack doesn't have clear, so I am using vector
     GUIImage* loadingImage = nullptr;
     uint64_t previousGameTime = 0;
+    bool headless = false;
+
+    static void printPhaseTimings(const std::string &phaseName, std::vector<double> &timings);
 public:
 
-    GameEngine();
+    explicit GameEngine(bool headless = false);
     ~GameEngine();
 
     void setWorldQuit() {
@@ -56,6 +61,17 @@ public:
 
     void run();
 
+    /**
+     * Runs the fixed timestep loop for frameCount frames without waiting for real time, then prints per phase timings.
+     * If traceFileName is not empty, profiler zones of the run are exported to it as Chrome trace.
+     */
+    void runHeadless(uint32_t frameCount, const std::string &traceFileName);
+
+    /**
+     * Runs the named micro benchmark, see Benchmarks. Engine should be created headless, no world is needed.
+     */
+    bool runBenchmark(const std::string &benchmarkName);
+
     void renderLoadingImage() const;
 
     LimonAPI *getNewLimonAPI();